@@ -40,6 +40,7 @@ CREPORTER_SYSTEM_SYSTEMD_SYSTEM_SERVICES = /lib/systemd/system
 CREPORTER_SYSTEM_ONESHOT = /usr/lib/oneshot.d
 CREPORTER_SETTINGS_PATH = $${CREPORTER_SYSTEM_SHARE}/crash-reporter-settings
 CREPORTER_DLG_PLUGINS_PATH = $$[QT_INSTALL_LIBS]/crash-reporter/dialogplugins
+CREPORTER_COLLECTOR_PLUGINS_PATH = $$[QT_INSTALL_LIBS]/crash-reporter/collector
 CREPORTER_TESTS_TESTDATA_INSTALL_LIBS = $$[QT_INSTALL_LIBS]/crash-reporter-tests/testdata
 CREPORTER_TESTS_TESTDATA_INSTALL_DOCS = $${CREPORTER_SYSTEM_SHARE}/crash-reporter-tests/testdata
 CREPORTER_TESTS_INSTALL_LIBS = $$[QT_INSTALL_LIBS]/crash-reporter-tests
@@ -49,6 +50,12 @@ CREPORTER_UI_TESTS_INSTALL_DOCS = $${CREPORTER_SYSTEM_SHARE}/crash-reporter-ui-t
 
 #DEFINES += CREPORTER_SDK_HOST
 
+# Static tracepoints, see src/libs/creporterprobes.h. CONFIG+=no_usdt
+# compiles them out.
+!no_usdt:exists($${CREPORTER_SYSTEM_INCLUDE}/sys/sdt.h) {
+    DEFINES += CREPORTER_USDT
+}
+
 include(version.pri)
 CRVERSION = $$VERSION
 DEFINES += CREPORTERVERSION=\\\"$$CRVERSION\\\"
@@ -54,21 +54,27 @@ settings.files += \
 	data/journalspy-expressions.conf \
 
 systemd_service.path = $${CREPORTER_SYSTEM_SYSTEMD_USER_SERVICES}
-systemd_service.files = data/crash-reporter.service
+systemd_service.files = \
+	data/crash-reporter.service \
+	data/crash-reporter-ondemand.service \
+	data/crash-reporter-ondemand.path
 
 MULTI_USER_TARGET_WANTS = \
 	$(INSTALL_ROOT)/$$CREPORTER_SYSTEM_SYSTEMD_SYSTEM_SERVICES/multi-user.target.wants
+SOCKETS_TARGET_WANTS = \
+	$(INSTALL_ROOT)/$$CREPORTER_SYSTEM_SYSTEMD_SYSTEM_SERVICES/sockets.target.wants
 
 systemd_services.path = $${CREPORTER_SYSTEM_SYSTEMD_SYSTEM_SERVICES}
 systemd_services.files = \
-	data/crash-reporter-endurance.service \
-	data/crash-reporter-journalspy.service
+	data/crash-reporter-collector.service \
+	data/crash-reporter-richcore-broker.service \
+	data/crash-reporter-richcore-broker.socket
 systemd_services.commands = \
-	mkdir $$MULTI_USER_TARGET_WANTS; \
-	ln -s ../crash-reporter-endurance.service \
-		$$MULTI_USER_TARGET_WANTS/crash-reporter-endurance.service; \
-	ln -s ../crash-reporter-journalspy.service \
-		$$MULTI_USER_TARGET_WANTS/crash-reporter-journalspy.service;
+	mkdir $$MULTI_USER_TARGET_WANTS $$SOCKETS_TARGET_WANTS; \
+	ln -s ../crash-reporter-collector.service \
+		$$MULTI_USER_TARGET_WANTS/crash-reporter-collector.service; \
+	ln -s ../crash-reporter-richcore-broker.socket \
+		$$SOCKETS_TARGET_WANTS/crash-reporter-richcore-broker.socket;
 
 endurance_script.path = $${CREPORTER_SYSTEM_LIBEXEC}
 endurance_script.files = scripts/endurance-collect
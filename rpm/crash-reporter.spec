@@ -15,12 +15,15 @@ BuildRequires:          qt5-qttools-linguist
 BuildRequires:          ssu-devel
 BuildRequires:          pkgconfig(dbus-1)
 BuildRequires:          pkgconfig(libiphb)
+BuildRequires:          pkgconfig(liblzma)
 BuildRequires:          pkgconfig(libudev)
 BuildRequires:          pkgconfig(libsystemd)
 BuildRequires:          pkgconfig(mce)
 BuildRequires:          pkgconfig(qt5-boostable)
 BuildRequires:          pkgconfig(nemonotifications-qt5)
 BuildRequires:          systemd
+BuildRequires:          lzo-devel
+BuildRequires:          elfutils-devel
 Requires:               sp-rich-core >= 1.71.2
 Requires:               sp-endurance
 Requires:               oneshot
@@ -86,10 +89,14 @@ install -m0644 -t %{buildroot}%{_docdir}/%{name}-%{version} README
 %{_bindir}/%{name}-*
 %{_oneshotdir}/*
 %{_userunitdir}/*
-%attr(0755,root,root) /usr/libexec/crash-reporter-journalspy
-%attr(0755,root,root) /usr/libexec/endurance-collect*
+%attr(0755,root,root) /usr/libexec/crash-reporter-collector
+%attr(0755,root,root) /usr/libexec/endurance-collect
+%attr(0755,root,root) /usr/libexec/endurance-packager
+%attr(0755,root,root) /usr/libexec/crash-reporter-dumper
 %attr(4755,root,root) /usr/libexec/rich-core-helper
+%attr(0755,root,root) /usr/libexec/rich-core-broker
 %attr(4750,root,privileged) /usr/libexec/crashreporter-servicehelper
+%{_libdir}/crash-reporter/collector/*.so
 %{_datadir}/%{name}
 %{_datadir}/dbus-1/services/*.service
 
@@ -122,6 +129,10 @@ install -m0644 -t %{buildroot}%{_docdir}/%{name}-%{version} README
 
 %post
 systemctl daemon-reload
+# Units enabled by older versions lack the D-Bus activation alias.
+if [ "$1" -ge 2 ]; then
+  su nemo -c "systemctl --user is-enabled -q crash-reporter.service && systemctl --user reenable crash-reporter.service" || :
+fi
 ## on first install
 #if [ "$1" -eq 1 ]; then
 #	add-oneshot --user --now crash-reporter-service-default
@@ -130,12 +141,15 @@ systemctl daemon-reload
 %preun
 if [ "$1" = 0 ]; then
   su nemo -c "systemctl --user stop crash-reporter.service"
-  systemctl stop crash-reporter-endurance.service
+  su nemo -c "systemctl --user stop crash-reporter-ondemand.path crash-reporter-ondemand.service"
+  systemctl stop crash-reporter-collector.service
+  systemctl stop crash-reporter-richcore-broker.socket crash-reporter-richcore-broker.service
 fi
 
 %postun
 if [ "$1" = 0 ]; then
   rm -rf /var/cache/core-dumps/{uploadlog,endurance-enabled-mark,endurance}
+  rm -rf /var/cache/crash-reporter/debuginfo
 fi
 
 %post -n libcrash-reporter0
@@ -36,9 +36,12 @@
 #include "creportersavedstate.h"
 #include "creporteruploadqueue.h"
 #include "creporteruploaditem.h"
+#include "creportertrace.h"
 #include "creporteruploadengine.h"
 #include "creporterutils.h"
 #include "creporterprivacysettingsmodel.h"
+#include "creporterloggingadaptor.h"
+#include "creporterstatsadaptor.h"
 
 #include "autouploader_adaptor.h" // generated
 
@@ -86,6 +89,8 @@ CReporterAutoUploader::CReporterAutoUploader()
 
     // Create adaptor class. Needs to be taken from the stack.
     new AutoUploaderAdaptor(this);
+    new CReporterLoggingAdaptor(this);
+    new CReporterStatsAdaptor(this);
     // Register service name and object.
     QDBusConnection::sessionBus().registerObject(CReporter::AutoUploaderObjectPath, this);
     QDBusConnection::sessionBus().registerService(CReporter::AutoUploaderServiceName);
@@ -105,6 +110,13 @@ CReporterAutoUploader::~CReporterAutoUploader()
 
 bool CReporterAutoUploader::uploadFiles(const QStringList &fileList,
                                         bool obeyNetworkRestrictions)
+{
+    return uploadFilesWithTraces(fileList, QStringList(), obeyNetworkRestrictions);
+}
+
+bool CReporterAutoUploader::uploadFilesWithTraces(const QStringList &fileList,
+                                                  const QStringList &traces,
+                                                  bool obeyNetworkRestrictions)
 {
     qCDebug(cr) << "Received a list of files to upload.";
 
@@ -124,11 +136,14 @@ bool CReporterAutoUploader::uploadFiles(const QStringList &fileList,
         return false;
     }
 
-    foreach (QString filename, fileList) {
+    for (int i = 0; i != fileList.size(); ++i) {
+        const QString &filename = fileList.at(i);
         if (!d_ptr->addedFiles.contains(filename)) {
             qCDebug(cr) << "Adding to upload queue: " << filename;
             // CReporterUploadQueue class will own the CReporterUploadItem instance.
-            d_ptr->queue.enqueue(new CReporterUploadItem(filename));
+            CReporterUploadItem *item = new CReporterUploadItem(filename);
+            item->setTrace(CReporterTrace::fromString(traces.value(i)));
+            d_ptr->queue.enqueue(item);
             d_ptr->addedFiles << filename;
         } else {
             qCDebug(cr) << filename << "was not added to queue because it had already been added before";
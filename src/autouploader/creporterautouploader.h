@@ -59,6 +59,18 @@ public slots:
      */
     bool uploadFiles(const QStringList &fileList, bool obeyNetworkRestrictions);
 
+    /**
+     * Queues given rich core files for upload, continuing their traces.
+     *
+     * @param fileList list of files to upload.
+     * @param traces text form of CReporterTrace for each file in @a fileList,
+     *               empty for files that aren't traced.
+     * @param obeyNetworkRestrictions see uploadFiles().
+     * @return @c true if files were successfully queued for upload.
+     */
+    bool uploadFilesWithTraces(const QStringList &fileList, const QStringList &traces,
+                               bool obeyNetworkRestrictions);
+
     /**
      * Makes auto-uploader exit its main loop.
      */
@@ -35,6 +35,7 @@
 #include "creporterutils.h"
 #include "creporterapplicationsettings.h"
 #include "creporterlogger.h"
+#include "creporterstats.h"
 
 using CReporter::LoggingCategory::cr;
 
@@ -55,6 +56,11 @@ int main(int argc, char **argv)
     qCDebug(cr) << CReporter::AutoUploaderBinaryName << "[" << app.applicationPid() << "]" << "started.";
     qCDebug(cr) << "Crash Reporter version is " << QString(CREPORTERVERSION);
 
+    QString statsDir(CReporterApplicationSettings::instance()->prometheusTextfileDir());
+    if (!statsDir.isEmpty()) {
+        CReporterStats::instance()->setTextfilePath(statsDir + "/" + app.applicationName() + ".prom");
+    }
+
     CReporterAutoUploader uploader;
 
     int retVal = app.exec();
@@ -0,0 +1,7 @@
+TEMPLATE = subdirs
+
+SUBDIRS = \
+	host \
+	journalspy \
+	powerexcess \
+	endurance \
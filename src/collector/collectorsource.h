@@ -0,0 +1,86 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef COLLECTORSOURCE_H
+#define COLLECTORSOURCE_H
+
+#include <QString>
+#include <QtPlugin>
+
+/*!
+ * @class CollectorContext
+ * @brief Services crash-reporter-collector offers to its sources.
+ */
+class CollectorContext
+{
+public:
+    virtual ~CollectorContext() {}
+
+    /*!
+     * Requests system logs to be collected into a rich core named after
+     * @a label, e.g. "PowerExcess" or "JournalSpy-oom".
+     *
+     * Requests for a label that was already triggered within the silent
+     * period of the source are dropped.
+     *
+     * @return @c true if the collection was requested.
+     */
+    virtual bool trigger(const QString &label) = 0;
+};
+
+/*!
+ * @class CollectorSource
+ * @brief Interface of the event sources crash-reporter-collector loads.
+ *
+ * A source is a Qt plugin whose instance implements this interface. Its
+ * metadata are read before the plugin is loaded:
+ *
+ *   "name"         Name of the source, as passed to crashreporter-servicehelper.
+ *   "enableMark"   File in the core-dumps directory that enables the source.
+ *                  The source always runs if there is none.
+ *   "silentPeriod" Seconds CollectorContext::trigger() ignores repeated
+ *                  requests for the same label.
+ *
+ * Sources watch their file descriptors in the event loop of the host and
+ * must not block it.
+ */
+class CollectorSource
+{
+public:
+    virtual ~CollectorSource() {}
+
+    /*!
+     * Starts watching for events.
+     *
+     * @param context Host services, valid until stop().
+     * @return @c false if the source can't run.
+     */
+    virtual bool start(CollectorContext *context) = 0;
+
+    //! Stops watching for events and releases all resources.
+    virtual void stop() = 0;
+};
+
+#define CollectorSource_iid "org.sailfishos.CrashReporter.CollectorSource/1.0"
+
+Q_DECLARE_INTERFACE(CollectorSource, CollectorSource_iid)
+
+#endif // COLLECTORSOURCE_H
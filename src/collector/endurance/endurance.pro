@@ -0,0 +1,31 @@
+include(../../../crash-reporter-conf.pri)
+
+TEMPLATE = lib
+TARGET = endurance
+
+QT = core dbus
+CONFIG += plugin link_pkgconfig
+
+INCLUDEPATH += \
+	.. \
+	../../libs \
+	../../libs/utils \
+
+HEADERS = \
+	../collectorsource.h \
+	endurancesource.h \
+
+SOURCES = \
+	endurancesource.cpp \
+
+OTHER_FILES += endurance.json
+
+LIBS += \
+	../../../lib/libcrashreporter.so \
+
+PKGCONFIG += \
+	libiphb \
+
+target.path = $$CREPORTER_COLLECTOR_PLUGINS_PATH
+
+INSTALLS = target
@@ -0,0 +1,461 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "endurancesource.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <iphbd/libiphb.h>
+#include <mce/dbus-names.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QSocketNotifier>
+#include <QTimer>
+
+#include "creporternamespace.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+
+const char SocketDir[] = "/run/crash-reporter";
+const char SocketPath[] = "/run/crash-reporter/endurance-collect.sock";
+const int MaxRequestLength = 64;
+
+const int SnapshotInterval = IPHB_GS_WAIT_1_HOUR; // seconds
+const int KeepaliveInterval = 30; // seconds
+const int AfterBootDelay = 5 * 60; // seconds
+const int HeartbeatWindow = 10; // seconds
+const int MinInterval = 60; // seconds
+// iphb_wait() takes the wake up window as unsigned shorts.
+const int MaxInterval = 18 * 60 * 60; // seconds
+
+//! @return Seconds until AfterBootDelay has passed since boot, 0 if it has.
+int afterBootDelay()
+{
+    QFile file("/proc/uptime");
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(cr) << "Couldn't open /proc/uptime.";
+        return 0;
+    }
+
+    int uptime = file.readLine().split('.').first().toInt();
+    int delay = AfterBootDelay - uptime;
+    if (delay <= 0) {
+        return 0;
+    }
+
+    qCDebug(cr) << "Too early after boot; waiting another" << delay << "seconds.";
+    return delay;
+}
+
+void mceMethod(const QString &method)
+{
+    QDBusMessage request(QDBusMessage::createMethodCall(MCE_SERVICE, MCE_REQUEST_PATH,
+                                                        MCE_REQUEST_IF, method));
+    if (!QDBusConnection::systemBus().send(request)) {
+        qCWarning(cr) << "Failed to send" << MCE_REQUEST_IF << method;
+    }
+}
+
+void reply(int fd, const QByteArray &message)
+{
+    if (send(fd, message.constData(), message.size(), MSG_NOSIGNAL) == -1) {
+        qCWarning(cr) << "Couldn't send reply:" << strerror(errno);
+    }
+}
+
+} // namespace
+
+class EnduranceSourcePrivate
+{
+public:
+    EnduranceSourcePrivate(EnduranceSource *parent);
+
+    bool open();
+    void close();
+
+    void onHeartbeat();
+    void sendKeepalive();
+    void onCollectionFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onCollectionError(QProcess::ProcessError error);
+    void acceptClient();
+    void handleRequest(int fd);
+
+private:
+    bool scheduleWakeup(int seconds);
+    void startCollection();
+    void collectionDone(bool failed);
+    bool openSocket();
+    QByteArray status() const;
+
+    iphb_t iphb;
+    QSocketNotifier *iphbNotifier;
+    QProcess *collection;
+    QTimer keepaliveTimer;
+    int listenFd;
+    QSocketNotifier *listenNotifier;
+    QHash<int, QSocketNotifier *> clients;
+
+    int snapshotInterval;
+
+    // Timing of the collections, for the status request and the log.
+    QElapsedTimer scheduledAt;
+    int scheduledDelay;
+    QElapsedTimer collectionStarted;
+    unsigned long collections;
+    unsigned long failures;
+    unsigned long keepalives;
+    qint64 lastWakeupDelayMs;
+    qint64 lastSpawnMs;
+    qint64 lastCollectionMs;
+
+    EnduranceSource *q_ptr;
+    Q_DECLARE_PUBLIC(EnduranceSource)
+};
+
+EnduranceSourcePrivate::EnduranceSourcePrivate(EnduranceSource *parent)
+    : iphb(0), iphbNotifier(0), collection(0), listenFd(-1), listenNotifier(0),
+      snapshotInterval(SnapshotInterval), scheduledDelay(0), collections(0),
+      failures(0), keepalives(0), lastWakeupDelayMs(-1), lastSpawnMs(-1),
+      lastCollectionMs(-1), q_ptr(parent)
+{
+    keepaliveTimer.setInterval(KeepaliveInterval * 1000);
+    QObject::connect(&keepaliveTimer, SIGNAL(timeout()), parent, SLOT(sendKeepalive()));
+}
+
+bool EnduranceSourcePrivate::open()
+{
+    Q_Q(EnduranceSource);
+
+    iphb = iphb_open(0);
+    int iphbFd = iphb ? iphb_get_fd(iphb) : -1;
+    if (iphbFd == -1) {
+        qCWarning(cr) << "Couldn't get iphb file descriptor.";
+        close();
+        return false;
+    }
+    fcntl(iphbFd, F_SETFL, O_NONBLOCK);
+    fcntl(iphbFd, F_SETFD, FD_CLOEXEC);
+    iphbNotifier = new QSocketNotifier(iphbFd, QSocketNotifier::Read, q);
+    QObject::connect(iphbNotifier, SIGNAL(activated(int)), q, SLOT(onHeartbeat()));
+
+    // The source works without the control socket, just can't be controlled.
+    openSocket();
+
+    int delay = afterBootDelay();
+    if (delay > 0) {
+        if (!scheduleWakeup(delay)) {
+            close();
+            return false;
+        }
+    } else {
+        lastWakeupDelayMs = 0;
+        startCollection();
+    }
+    return true;
+}
+
+void EnduranceSourcePrivate::close()
+{
+    keepaliveTimer.stop();
+    if (collection) {
+        // Let a running collection finish on its own.
+        collection->disconnect();
+        collection->setParent(0);
+        QObject::connect(collection, SIGNAL(finished(int)), collection, SLOT(deleteLater()));
+        collection = 0;
+        mceMethod(MCE_CPU_KEEPALIVE_STOP_REQ);
+    }
+
+    qDeleteAll(clients);
+    foreach (int fd, clients.keys()) {
+        ::close(fd);
+    }
+    clients.clear();
+
+    delete listenNotifier;
+    listenNotifier = 0;
+    if (listenFd != -1) {
+        ::close(listenFd);
+        unlink(SocketPath);
+        listenFd = -1;
+    }
+
+    delete iphbNotifier;
+    iphbNotifier = 0;
+    if (iphb) {
+        iphb_close(iphb);
+        iphb = 0;
+    }
+}
+
+bool EnduranceSourcePrivate::scheduleWakeup(int seconds)
+{
+    int min = seconds > HeartbeatWindow ? seconds - HeartbeatWindow : 0;
+
+    scheduledAt.start();
+    scheduledDelay = seconds;
+
+    if (iphb_wait(iphb, min, seconds + HeartbeatWindow, 0) < 0) {
+        qCWarning(cr) << "Couldn't wait for heartbeat timer.";
+        return false;
+    }
+    return true;
+}
+
+void EnduranceSourcePrivate::onHeartbeat()
+{
+    char buf[64];
+    while (read(iphbNotifier->socket(), buf, sizeof(buf)) > 0) {
+    }
+
+    lastWakeupDelayMs = scheduledAt.elapsed() - scheduledDelay * 1000;
+    startCollection();
+}
+
+void EnduranceSourcePrivate::sendKeepalive()
+{
+    qCDebug(cr) << "Sending MCE CPU keepalive.";
+    mceMethod(MCE_CPU_KEEPALIVE_START_REQ);
+    ++keepalives;
+}
+
+void EnduranceSourcePrivate::startCollection()
+{
+    Q_Q(EnduranceSource);
+
+    if (collection) {
+        qCWarning(cr) << "Previous snapshot collection is still running, "
+                         "not spawning a new one.";
+        return;
+    }
+
+    qCDebug(cr) << "Collecting endurance snapshot...";
+    sendKeepalive();
+
+    QElapsedTimer spawnTimer;
+    spawnTimer.start();
+
+    collection = new QProcess(q);
+    collection->setProcessChannelMode(QProcess::ForwardedChannels);
+    QObject::connect(collection, SIGNAL(finished(int, QProcess::ExitStatus)),
+                     q, SLOT(onCollectionFinished(int, QProcess::ExitStatus)));
+    QObject::connect(collection, SIGNAL(error(QProcess::ProcessError)),
+                     q, SLOT(onCollectionError(QProcess::ProcessError)));
+    collectionStarted.start();
+    collection->start("/bin/sh", QStringList() << "-c" << "/usr/libexec/endurance-collect");
+
+    if (collection) {
+        lastSpawnMs = spawnTimer.elapsed();
+        keepaliveTimer.start();
+    }
+}
+
+void EnduranceSourcePrivate::onCollectionFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    collectionDone(exitStatus != QProcess::NormalExit || exitCode != 0);
+}
+
+void EnduranceSourcePrivate::onCollectionError(QProcess::ProcessError error)
+{
+    // Crashes are reported by finished() as well.
+    if (error == QProcess::FailedToStart) {
+        qCWarning(cr) << "Couldn't invoke /usr/libexec/endurance-collect.";
+        collectionDone(true);
+    }
+}
+
+void EnduranceSourcePrivate::collectionDone(bool failed)
+{
+    lastCollectionMs = collectionStarted.elapsed();
+    ++collections;
+    if (failed) {
+        ++failures;
+    }
+
+    qCDebug(cr) << "Snapshot collection finished" << (failed ? "with failure:" : ":")
+                << "woke up" << lastWakeupDelayMs << "ms late, spawned in"
+                << lastSpawnMs << "ms, collected in" << lastCollectionMs << "ms,"
+                << keepalives << "keepalives sent in total.";
+
+    collection->deleteLater();
+    collection = 0;
+
+    keepaliveTimer.stop();
+    mceMethod(MCE_CPU_KEEPALIVE_STOP_REQ);
+
+    scheduleWakeup(snapshotInterval);
+}
+
+bool EnduranceSourcePrivate::openSocket()
+{
+    Q_Q(EnduranceSource);
+
+    listenFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd == -1) {
+        qCWarning(cr) << "Couldn't create control socket:" << strerror(errno);
+        return false;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, SocketPath, sizeof(addr.sun_path) - 1);
+
+    mkdir(SocketDir, 0755);
+    unlink(SocketPath);
+    if (bind(listenFd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == -1 ||
+            listen(listenFd, 4) == -1) {
+        qCWarning(cr) << "Couldn't listen on" << SocketPath << ":" << strerror(errno);
+        ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    // Changing the interval is for root only.
+    chmod(SocketPath, 0600);
+
+    listenNotifier = new QSocketNotifier(listenFd, QSocketNotifier::Read, q);
+    QObject::connect(listenNotifier, SIGNAL(activated(int)), q, SLOT(acceptClient()));
+    return true;
+}
+
+void EnduranceSourcePrivate::acceptClient()
+{
+    Q_Q(EnduranceSource);
+
+    int fd = accept4(listenFd, 0, 0, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd == -1) {
+        return;
+    }
+
+    QSocketNotifier *notifier = new QSocketNotifier(fd, QSocketNotifier::Read, q);
+    QObject::connect(notifier, SIGNAL(activated(int)), q, SLOT(handleRequest(int)));
+    clients.insert(fd, notifier);
+}
+
+QByteArray EnduranceSourcePrivate::status() const
+{
+    qint64 nextIn = 0;
+    if (!collection) {
+        nextIn = scheduledDelay - scheduledAt.elapsed() / 1000;
+    }
+
+    return QString("STATUS state=%1 interval=%2 next_in=%3 collections=%4 "
+                   "failures=%5 keepalives=%6 wakeup_delay_ms=%7 spawn_ms=%8 "
+                   "collection_ms=%9")
+           .arg(collection ? "collecting" : "idle").arg(snapshotInterval).arg(nextIn)
+           .arg(collections).arg(failures).arg(keepalives).arg(lastWakeupDelayMs)
+           .arg(lastSpawnMs).arg(lastCollectionMs).toLatin1();
+}
+
+void EnduranceSourcePrivate::handleRequest(int fd)
+{
+    /* One request per connection. The notifier is the sender of this slot,
+     * so it can't be deleted right away. Disabled before the fd is closed. */
+    QSocketNotifier *notifier = clients.take(fd);
+    notifier->setEnabled(false);
+    notifier->deleteLater();
+
+    char buf[MaxRequestLength];
+    ssize_t len = recv(fd, buf, sizeof(buf) - 1, MSG_DONTWAIT | MSG_TRUNC);
+    if (len <= 0) {
+        ::close(fd);
+        return;
+    } else if (size_t(len) >= sizeof(buf)) {
+        reply(fd, "ERR request too long");
+        ::close(fd);
+        return;
+    }
+    QByteArray request(QByteArray(buf, len).trimmed());
+
+    if (request == "status") {
+        reply(fd, status());
+    } else if (request == "collect") {
+        if (collection) {
+            reply(fd, "BUSY");
+        } else {
+            qCDebug(cr) << "Snapshot requested through control socket.";
+            lastWakeupDelayMs = 0;
+            startCollection();
+            reply(fd, collection ? "OK" : "ERR couldn't start collection");
+        }
+    } else if (request.startsWith("interval ")) {
+        bool ok;
+        int interval = request.mid(9).toInt(&ok);
+        if (!ok || interval < MinInterval || interval > MaxInterval) {
+            reply(fd, QString("ERR interval must be %1-%2 seconds")
+                  .arg(MinInterval).arg(MaxInterval).toLatin1());
+        } else {
+            qCDebug(cr) << "Snapshot interval changed to" << interval << "seconds.";
+            snapshotInterval = interval;
+            /* A running collection reschedules with the new interval when
+             * it finishes. */
+            if (!collection) {
+                scheduleWakeup(snapshotInterval);
+            }
+            reply(fd, "OK");
+        }
+    } else {
+        reply(fd, "ERR unknown request");
+    }
+
+    ::close(fd);
+}
+
+EnduranceSource::EnduranceSource()
+    : d_ptr(new EnduranceSourcePrivate(this))
+{
+}
+
+EnduranceSource::~EnduranceSource()
+{
+    stop();
+}
+
+bool EnduranceSource::start(CollectorContext *context)
+{
+    Q_D(EnduranceSource);
+
+    // Collections run endurance-collect rather than rich-core-dumper.
+    Q_UNUSED(context)
+    return d->open();
+}
+
+void EnduranceSource::stop()
+{
+    Q_D(EnduranceSource);
+
+    d->close();
+}
+
+#include "moc_endurancesource.cpp"
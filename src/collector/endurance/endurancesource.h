@@ -0,0 +1,76 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef ENDURANCESOURCE_H
+#define ENDURANCESOURCE_H
+
+#include <QObject>
+#include <QProcess>
+
+#include "collectorsource.h"
+
+class EnduranceSourcePrivate;
+
+/*!
+ * @class EnduranceSource
+ * @brief Collector source running /usr/libexec/endurance-collect once per
+ * snapshot interval.
+ *
+ * Wakeups come from the iphb heartbeat so that the device isn't kept awake
+ * in between, and an MCE CPU keepalive is held while a collection runs.
+ *
+ * The source can be controlled through a SOCK_SEQPACKET socket, one request
+ * per connection:
+ *
+ *   collect            take a snapshot now
+ *   status             report state, interval and timing of the last run
+ *   interval <secs>    change the snapshot interval
+ *
+ * "crash-reporter-collector --send <request>" sends a request and prints
+ * the reply.
+ */
+class EnduranceSource: public QObject, public CollectorSource
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID CollectorSource_iid FILE "endurance.json")
+    Q_INTERFACES(CollectorSource)
+
+public:
+    EnduranceSource();
+    ~EnduranceSource();
+
+    bool start(CollectorContext *context);
+    void stop();
+
+private:
+    Q_DISABLE_COPY(EnduranceSource)
+    Q_DECLARE_PRIVATE(EnduranceSource)
+    QScopedPointer<EnduranceSourcePrivate> d_ptr;
+
+    Q_PRIVATE_SLOT(d_func(), void onHeartbeat())
+    Q_PRIVATE_SLOT(d_func(), void sendKeepalive())
+    Q_PRIVATE_SLOT(d_func(), void onCollectionFinished(int, QProcess::ExitStatus))
+    Q_PRIVATE_SLOT(d_func(), void onCollectionError(QProcess::ProcessError))
+    Q_PRIVATE_SLOT(d_func(), void acceptClient())
+    Q_PRIVATE_SLOT(d_func(), void handleRequest(int))
+};
+
+#endif // ENDURANCESOURCE_H
@@ -0,0 +1,270 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "collectorhost.h"
+
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonObject>
+#include <QPluginLoader>
+#include <QSocketNotifier>
+
+#include "collectorsource.h"
+#include "creportercoreregistry.h"
+#include "creporternamespace.h"
+#include "creporterstats.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+
+//! Self-pipe for requestReload(), written to from signal handlers.
+int reloadFds[2] = { -1, -1 };
+
+//! Context of one source, holding its rate limit across restarts.
+class SourceContext : public CollectorContext
+{
+public:
+    SourceContext(const QString &name, qint64 silentPeriodMs)
+        : name(name), silentPeriodMs(silentPeriodMs)
+    {
+        clock.start();
+    }
+
+    bool trigger(const QString &label)
+    {
+        CReporterStats *stats = CReporterStats::instance();
+
+        qint64 now = clock.elapsed();
+        QHash<QString, qint64>::const_iterator last(lastTriggers.constFind(label));
+        if (last != lastTriggers.constEnd() && now - *last < silentPeriodMs) {
+            qCDebug(cr) << "Ignoring" << label << "from" << name << "within the silent period.";
+            stats->increment(QString("collector_triggers_suppressed_total{source=\"%1\"}")
+                             .arg(name));
+            return false;
+        }
+
+        stats->increment(QString("collector_triggers_total{source=\"%1\"}").arg(name));
+        if (!CReporterUtils::requestLogCollection(label)) {
+            qCWarning(cr) << "Problem requesting log collection" << label;
+            return false;
+        }
+        // A failed request doesn't start the silent period, it can be retried.
+        lastTriggers.insert(label, now);
+        return true;
+    }
+
+private:
+    QString name;
+    qint64 silentPeriodMs;
+    QElapsedTimer clock;
+    //! Time of the last successfully requested trigger of each label.
+    QHash<QString, qint64> lastTriggers;
+};
+
+struct Source {
+    QPluginLoader *loader;
+    QString name;
+    QString enableMark;
+    SourceContext *context;
+    CollectorSource *instance;
+};
+
+} // namespace
+
+class CollectorHostPrivate
+{
+public:
+    CollectorHostPrivate(CollectorHost *parent);
+    ~CollectorHostPrivate();
+
+    void findPlugins(const QString &pluginPath);
+    bool isEnabled(const Source &source) const;
+    void startSource(Source &source);
+    void stopSource(Source &source);
+    void onReloadRequested();
+
+    QList<Source> sources;
+    QSocketNotifier *reloadNotifier;
+
+    CollectorHost *q_ptr;
+    Q_DECLARE_PUBLIC(CollectorHost)
+};
+
+CollectorHostPrivate::CollectorHostPrivate(CollectorHost *parent)
+    : reloadNotifier(0), q_ptr(parent)
+{
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, reloadFds) == -1) {
+        qCWarning(cr) << "Couldn't create reload socket pair, reloading disabled.";
+        return;
+    }
+    reloadNotifier = new QSocketNotifier(reloadFds[1], QSocketNotifier::Read, parent);
+    QObject::connect(reloadNotifier, SIGNAL(activated(int)), parent, SLOT(onReloadRequested()));
+}
+
+CollectorHostPrivate::~CollectorHostPrivate()
+{
+    for (QList<Source>::iterator it = sources.begin(); it != sources.end(); ++it) {
+        stopSource(*it);
+        delete it->context;
+        delete it->loader;
+    }
+
+    delete reloadNotifier;
+    if (reloadFds[0] != -1) {
+        close(reloadFds[0]);
+        close(reloadFds[1]);
+        reloadFds[0] = reloadFds[1] = -1;
+    }
+}
+
+void CollectorHostPrivate::findPlugins(const QString &pluginPath)
+{
+    QDir dir(pluginPath);
+    foreach (const QString &fileName, dir.entryList(QStringList() << "*.so", QDir::Files)) {
+        QPluginLoader *loader = new QPluginLoader(dir.absoluteFilePath(fileName));
+        // Only the metadata are read, the plugin is loaded once enabled.
+        QJsonObject metaData(loader->metaData());
+        if (metaData.value("IID").toString() != CollectorSource_iid) {
+            qCWarning(cr) << fileName << "isn't a collector source.";
+            delete loader;
+            continue;
+        }
+        QJsonObject sourceData(metaData.value("MetaData").toObject());
+
+        Source source;
+        source.loader = loader;
+        source.name = sourceData.value("name").toString(fileName);
+        source.enableMark = sourceData.value("enableMark").toString();
+        source.context = new SourceContext(source.name,
+                                           sourceData.value("silentPeriod").toInt() * 1000LL);
+        source.instance = 0;
+        sources << source;
+
+        qCDebug(cr) << "Found collector source" << source.name;
+    }
+}
+
+bool CollectorHostPrivate::isEnabled(const Source &source) const
+{
+    if (source.enableMark.isEmpty()) {
+        return true;
+    }
+
+    QStringList corePaths(CReporterCoreRegistry::instance()->getCoreLocationPaths());
+    return !corePaths.isEmpty()
+           && QFile::exists(corePaths.first() + '/' + source.enableMark);
+}
+
+void CollectorHostPrivate::startSource(Source &source)
+{
+    CollectorSource *instance = qobject_cast<CollectorSource *>(source.loader->instance());
+    if (!instance) {
+        qCWarning(cr) << "Couldn't load collector source" << source.name << ":"
+                      << source.loader->errorString();
+        source.loader->unload();
+        return;
+    }
+
+    if (!instance->start(source.context)) {
+        qCWarning(cr) << "Collector source" << source.name << "failed to start.";
+        source.loader->unload();
+        return;
+    }
+
+    source.instance = instance;
+    qCDebug(cr) << "Started collector source" << source.name;
+}
+
+void CollectorHostPrivate::stopSource(Source &source)
+{
+    if (source.instance) {
+        source.instance->stop();
+        source.instance = 0;
+        // Deletes the instance and unmaps the plugin.
+        source.loader->unload();
+        qCDebug(cr) << "Stopped collector source" << source.name;
+    }
+}
+
+void CollectorHostPrivate::onReloadRequested()
+{
+    Q_Q(CollectorHost);
+
+    char buf[16];
+    while (read(reloadFds[1], buf, sizeof(buf)) > 0) {
+    }
+
+    qCDebug(cr) << "Reloading collector sources.";
+    if (q->reload() == 0) {
+        qCDebug(cr) << "No collector sources enabled.";
+        emit q->finished();
+    }
+}
+
+CollectorHost::CollectorHost(const QString &pluginPath, QObject *parent)
+    : QObject(parent), d_ptr(new CollectorHostPrivate(this))
+{
+    Q_D(CollectorHost);
+
+    d->findPlugins(pluginPath);
+}
+
+CollectorHost::~CollectorHost()
+{
+}
+
+int CollectorHost::reload()
+{
+    Q_D(CollectorHost);
+
+    int running = 0;
+    for (QList<Source>::iterator it = d->sources.begin(); it != d->sources.end(); ++it) {
+        bool enabled = d->isEnabled(*it);
+        if (enabled && !it->instance) {
+            d->startSource(*it);
+        } else if (!enabled && it->instance) {
+            d->stopSource(*it);
+        }
+        if (it->instance) {
+            ++running;
+        }
+    }
+    return running;
+}
+
+void CollectorHost::requestReload()
+{
+    if (reloadFds[0] != -1) {
+        char c = 0;
+        ssize_t ignored = write(reloadFds[0], &c, 1);
+        Q_UNUSED(ignored)
+    }
+}
+
+#include "moc_collectorhost.cpp"
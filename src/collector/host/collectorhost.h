@@ -0,0 +1,79 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef COLLECTORHOST_H
+#define COLLECTORHOST_H
+
+#include <QObject>
+#include <QScopedPointer>
+
+class CollectorHostPrivate;
+
+/*!
+ * @class CollectorHost
+ * @brief Runs the collector sources in one process.
+ *
+ * Sources are plugins implementing CollectorSource. A source runs while its
+ * enable mark exists in the core-dumps directory; plugins of disabled
+ * sources are not loaded. Log collections the sources trigger are rate
+ * limited per label and requested from rich-core-broker.
+ */
+class CollectorHost : public QObject
+{
+    Q_OBJECT
+
+public:
+    /*!
+     * @param pluginPath Directory to load the source plugins from.
+     * @param parent The parent QObject.
+     */
+    explicit CollectorHost(const QString &pluginPath, QObject *parent = 0);
+    ~CollectorHost();
+
+public Q_SLOTS:
+    /*!
+     * Starts sources that have been enabled and stops ones that have been
+     * disabled since the last call.
+     *
+     * @return Number of running sources.
+     */
+    int reload();
+
+public:
+    /*!
+     * Asks the host to reload() from its event loop. Async-signal-safe, for
+     * use in a SIGHUP handler.
+     */
+    static void requestReload();
+
+Q_SIGNALS:
+    //! Sent when a requested reload left no source running.
+    void finished();
+
+private:
+    Q_DISABLE_COPY(CollectorHost)
+    Q_DECLARE_PRIVATE(CollectorHost)
+    QScopedPointer<CollectorHostPrivate> d_ptr;
+
+    Q_PRIVATE_SLOT(d_func(), void onReloadRequested())
+};
+
+#endif // COLLECTORHOST_H
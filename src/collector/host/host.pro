@@ -0,0 +1,30 @@
+include(../../../crash-reporter-conf.pri)
+
+TEMPLATE = app
+TARGET = crash-reporter-collector
+
+QT = core
+
+DEFINES += CREPORTER_COLLECTOR_PLUGINS_PATH=\\\"$$CREPORTER_COLLECTOR_PLUGINS_PATH\\\"
+
+INCLUDEPATH += \
+	.. \
+	../../libs \
+	../../libs/coredir \
+	../../libs/settings \
+	../../libs/utils \
+
+HEADERS = \
+	../collectorsource.h \
+	collectorhost.h \
+
+SOURCES = \
+	main.cpp \
+	collectorhost.cpp \
+
+LIBS += \
+	../../../lib/libcrashreporter.so \
+
+target.path = $$CREPORTER_SYSTEM_LIBEXEC
+
+INSTALLS = target
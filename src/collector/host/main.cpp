@@ -0,0 +1,144 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFileInfo>
+
+#include "collectorhost.h"
+#include "creporterapplicationsettings.h"
+#include "creporterstats.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+
+const char DefaultControlSocket[] = "/run/crash-reporter/endurance-collect.sock";
+
+void signalHandler(int signal)
+{
+    Q_UNUSED(signal)
+
+    QCoreApplication::exit(0);
+}
+
+void reloadHandler(int signal)
+{
+    Q_UNUSED(signal)
+
+    CollectorHost::requestReload();
+}
+
+//! Sends @a request to a source's control socket and prints the reply.
+int sendRequest(const QByteArray &path, const QByteArray &request)
+{
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        perror("socket");
+        return EXIT_FAILURE;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.constData(), sizeof(addr.sun_path) - 1);
+
+    struct timeval timeout = { 5, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    char answer[256];
+    ssize_t len = -1;
+    if (::connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == 0 &&
+            send(fd, request.constData(), request.size(), MSG_NOSIGNAL) != -1) {
+        len = recv(fd, answer, sizeof(answer) - 1, 0);
+    }
+    close(fd);
+
+    if (len <= 0) {
+        fprintf(stderr, "No reply from %s.\n", path.constData());
+        return EXIT_FAILURE;
+    }
+    answer[len] = '\0';
+    printf("%s\n", answer);
+
+    return strncmp(answer, "ERR", 3) == 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    QByteArray controlSocket(DefaultControlSocket);
+    QByteArray request;
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            controlSocket = argv[++i];
+        } else if (qstrcmp(argv[i], "--send") == 0 && i + 1 < argc) {
+            request = argv[++i];
+        } else {
+            fprintf(stderr, "usage: crash-reporter-collector\n"
+                    "       crash-reporter-collector [--socket PATH] --send "
+                    "collect|status|\"interval SECONDS\"\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!request.isEmpty()) {
+        return sendRequest(controlSocket, request);
+    }
+
+    signal(SIGINT, &signalHandler);
+    signal(SIGTERM, &signalHandler);
+    signal(SIGHUP, &reloadHandler);
+
+    QCoreApplication app(argc, argv);
+
+    qCDebug(cr) << qPrintable(QFileInfo(argv[0]).fileName()) << CREPORTERVERSION
+                << "[" << app.applicationPid() << "] started.";
+
+    QString statsDir(CReporterApplicationSettings::instance()->prometheusTextfileDir());
+    if (!statsDir.isEmpty()) {
+        CReporterStats::instance()->setTextfilePath(statsDir + "/" + app.applicationName() + ".prom");
+    }
+
+    CollectorHost host(CREPORTER_COLLECTOR_PLUGINS_PATH);
+    if (host.reload() == 0) {
+        qCDebug(cr) << "No collector sources enabled.";
+        return EXIT_SUCCESS;
+    }
+
+    QObject::connect(&host, SIGNAL(finished()), &app, SLOT(quit()));
+
+    int result = app.exec();
+
+    qCDebug(cr) << "Shutting down the collector process.";
+
+    CReporterApplicationSettings::instance()->freeSingleton();
+    return result;
+}
@@ -0,0 +1,210 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <systemd/sd-journal.h>
+
+#include <QDebug>
+#include <QFile>
+#include <QSocketNotifier>
+
+#include "creporternamespace.h"
+#include "creporterprobes.h"
+#include "creporterutils.h"
+#include "journalspy.h"
+#include "journalspyexpression.h"
+
+using CReporter::LoggingCategory::cr;
+
+CREPORTER_PROBE_SEMAPHORE(journal_entries);
+
+namespace {
+
+//! Current entry of an open systemd journal.
+class SdJournalEntry : public JournalSpyExpression::Entry
+{
+public:
+    SdJournalEntry(sd_journal *journal)
+        : journal(journal)
+    {
+    }
+
+    bool field(const QByteArray &name, const char **value, size_t *length) const
+    {
+        if (sd_journal_get_data(journal, name.constData(),
+                                reinterpret_cast<const void **>(value), length) < 0) {
+            return false;
+        }
+
+        // Cut off "FIELD=" at the beginning of the data.
+        *value += name.size() + 1;
+        *length -= name.size() + 1;
+        return true;
+    }
+
+private:
+    sd_journal *journal;
+};
+
+} // namespace
+
+class JournalSpyPrivate
+{
+public:
+    JournalSpyPrivate(JournalSpy *parent);
+    ~JournalSpyPrivate();
+
+    bool open();
+    void close();
+    void handleJournalEntries();
+
+    CollectorContext *context;
+
+private:
+    void loadExpressions();
+
+    JournalSpy *q_ptr;
+    sd_journal *journal;
+    QSocketNotifier *notifier;
+
+    QList<JournalSpyExpression> expressions;
+
+    Q_DECLARE_PUBLIC(JournalSpy)
+};
+
+JournalSpyPrivate::JournalSpyPrivate(JournalSpy *parent)
+    : context(0), q_ptr(parent), journal(0), notifier(0)
+{
+}
+
+bool JournalSpyPrivate::open()
+{
+    Q_Q(JournalSpy);
+
+    loadExpressions();
+    if (expressions.isEmpty()) {
+        qCWarning(cr) << "No defined expressions to watch.";
+        return false;
+    }
+
+    if (sd_journal_open(&journal, SD_JOURNAL_LOCAL_ONLY | SD_JOURNAL_SYSTEM)) {
+        qCWarning(cr) << "Failed to open systemd journal.";
+        journal = 0;
+        return false;
+    }
+
+    int fd = sd_journal_get_fd(journal);
+    if (fd < 0) {
+        qCWarning(cr) << "sd_journal_get_fd() failed.";
+        close();
+        return false;
+    }
+
+    if (sd_journal_seek_tail(journal)) {
+        qCWarning(cr) << "sd_journal_seek_tail() failed.";
+        close();
+        return false;
+    }
+    // Workaround for https://bugzilla.redhat.com/show_bug.cgi?id=979487.
+    sd_journal_previous_skip(journal, 1);
+
+    notifier = new QSocketNotifier(fd, QSocketNotifier::Read, q);
+    QObject::connect(notifier, SIGNAL(activated(int)),
+                     q, SLOT(handleJournalEntries()));
+    return true;
+}
+
+void JournalSpyPrivate::close()
+{
+    delete notifier;
+    notifier = 0;
+    sd_journal_close(journal);
+    journal = 0;
+    expressions.clear();
+}
+
+void JournalSpyPrivate::handleJournalEntries()
+{
+    CREPORTER_PROBE_TIMER(probeTimer);
+    int entries = 0;
+    int matches = 0;
+
+    sd_journal_process(journal);
+
+    SdJournalEntry entry(journal);
+    while (sd_journal_next(journal)) {
+        ++entries;
+        foreach (const JournalSpyExpression &e, expressions) {
+            if (e.matches(entry)) {
+                ++matches;
+                // The host drops repeated matches within the silent period.
+                if (context->trigger(CReporter::JournalSpyPrefix + "-" + e.name())) {
+                    qCDebug(cr) << "Triggered log collection upon found match in "
+                                "the journal:" << e.name();
+                }
+                break;
+            }
+        }
+    }
+
+    CREPORTER_PROBE3(journal_entries, entries, matches,
+                     CREPORTER_PROBE_ELAPSED_US(probeTimer));
+}
+
+void JournalSpyPrivate::loadExpressions()
+{
+    QFile file(CReporter::SystemSettingsLocation +
+               "/crash-reporter-settings/journalspy-expressions.conf");
+    if (file.open(QIODevice::ReadOnly)) {
+        expressions = JournalSpyExpression::parse(file);
+    }
+}
+
+JournalSpyPrivate::~JournalSpyPrivate()
+{
+    close();
+}
+
+JournalSpy::JournalSpy()
+    : d_ptr(new JournalSpyPrivate(this))
+{
+}
+
+JournalSpy::~JournalSpy()
+{
+}
+
+bool JournalSpy::start(CollectorContext *context)
+{
+    Q_D(JournalSpy);
+
+    d->context = context;
+    return d->open();
+}
+
+void JournalSpy::stop()
+{
+    Q_D(JournalSpy);
+
+    d->close();
+    d->context = 0;
+}
+
+#include "moc_journalspy.cpp"
@@ -24,23 +24,32 @@
 
 #include <QObject>
 
+#include "collectorsource.h"
+
 class JournalSpyPrivate;
 
-class JournalSpy: public QObject
+/*!
+ * @class JournalSpy
+ * @brief Collector source requesting log collection when a journal entry
+ * matches one of the expressions in journalspy-expressions.conf.
+ */
+class JournalSpy: public QObject, public CollectorSource
 {
     Q_OBJECT
+    Q_PLUGIN_METADATA(IID CollectorSource_iid FILE "journalspy.json")
+    Q_INTERFACES(CollectorSource)
 
 public:
     JournalSpy();
     ~JournalSpy();
 
+    bool start(CollectorContext *context);
+    void stop();
+
 private:
     Q_DECLARE_PRIVATE(JournalSpy)
     QScopedPointer<JournalSpyPrivate> d_ptr;
 
-    // No more than 4 matches per expression each day.
-    static const qint64 SILENT_PERIOD_MS = 6 * 60 * 60 * 1000;
-
     Q_PRIVATE_SLOT(d_func(), void handleJournalEntries())
 };
 
@@ -0,0 +1,124 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDebug>
+#include <QIODevice>
+
+#include "creporternamespace.h"
+#include "journalspyexpression.h"
+
+using CReporter::LoggingCategory::cr;
+
+JournalSpyExpression::JournalSpyExpression(const QString &name)
+    : m_name(name)
+{
+}
+
+QString JournalSpyExpression::name() const
+{
+    return m_name;
+}
+
+bool JournalSpyExpression::addPattern(const QByteArray &field, const QString &pattern)
+{
+    QList<QPair<QByteArray, QRegularExpression> >::const_iterator it;
+    for (it = m_patterns.constBegin(); it != m_patterns.constEnd(); ++it) {
+        if (it->first == field) {
+            return false;
+        }
+    }
+
+    QRegularExpression rexp(pattern);
+    if (!rexp.isValid()) {
+        qCWarning(cr) << "Invalid regular expression" << pattern;
+        return false;
+    }
+
+    qCDebug(cr) << "Watching journal for expression" << field.constData() << '='
+                << qPrintable(pattern);
+    m_patterns.append(qMakePair(field, rexp));
+    return true;
+}
+
+bool JournalSpyExpression::isEmpty() const
+{
+    return m_patterns.isEmpty();
+}
+
+bool JournalSpyExpression::matches(const Entry &entry) const
+{
+    QList<QPair<QByteArray, QRegularExpression> >::const_iterator it;
+    for (it = m_patterns.constBegin(); it != m_patterns.constEnd(); ++it) {
+        const char *val;
+        size_t len;
+        if (!entry.field(it->first, &val, &len)) {
+            return false;
+        }
+
+        QRegularExpressionMatch match = it->second.match(QString::fromUtf8(val, len));
+        if (!match.hasMatch()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+QList<JournalSpyExpression> JournalSpyExpression::parse(QIODevice &io)
+{
+    QList<JournalSpyExpression> expressions;
+
+    while (!io.atEnd()) {
+        QByteArray line = io.readLine().trimmed();
+        if (!line.startsWith(';')) {
+            continue;
+        }
+
+        JournalSpyExpression expression(QString::fromUtf8(line.mid(1)));
+
+        while (!io.atEnd()) {
+            char nextChar = '\0';
+            io.peek(&nextChar, 1);
+            if (nextChar == ';') {
+                break;
+            }
+
+            line = io.readLine().trimmed();
+            if (line.isEmpty() || line.startsWith('#')) {
+                continue;
+            }
+
+            int separator = line.indexOf('=');
+            if (separator == -1) {
+                continue;
+            }
+
+            expression.addPattern(line.left(separator),
+                                  QString::fromUtf8(line.mid(separator + 1)));
+        }
+
+        if (!expression.isEmpty()) {
+            expressions.append(expression);
+        }
+    }
+
+    return expressions;
+}
@@ -0,0 +1,94 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef JOURNALSPYEXPRESSION_H
+#define JOURNALSPYEXPRESSION_H
+
+#include <QByteArray>
+#include <QList>
+#include <QPair>
+#include <QRegularExpression>
+#include <QString>
+
+class QIODevice;
+
+/*!
+ * @class JournalSpyExpression
+ * @brief Named set of journal field patterns that must all match an entry.
+ *
+ * The matching doesn't depend on libsystemd, the entry is accessed through
+ * JournalSpyExpression::Entry so that it can also be replayed from a journal
+ * export.
+ */
+class JournalSpyExpression
+{
+public:
+    //! Fields of a single journal entry.
+    class Entry
+    {
+    public:
+        virtual ~Entry() {}
+
+        /*!
+         * Looks up a field of the entry.
+         *
+         * @param name Field name, e.g. "MESSAGE".
+         * @param value Set to the field value, without the "NAME=" prefix.
+         * @param length Set to the length of @a value.
+         * @return @c false if the entry doesn't have the field.
+         */
+        virtual bool field(const QByteArray &name, const char **value,
+                           size_t *length) const = 0;
+    };
+
+    explicit JournalSpyExpression(const QString &name);
+
+    QString name() const;
+
+    /*!
+     * Adds a pattern the value of a field must match. Only the first pattern
+     * of each field is used.
+     *
+     * @return @c false if the field already has a pattern or @a pattern is
+     * not a valid regular expression.
+     */
+    bool addPattern(const QByteArray &field, const QString &pattern);
+
+    bool isEmpty() const;
+
+    //! @return @c true if every pattern matches its field in @a entry.
+    bool matches(const Entry &entry) const;
+
+    /*!
+     * Reads expressions in the journalspy-expressions.conf format.
+     *
+     * @param io Device to read the configuration from.
+     * @return Expressions having at least one valid pattern.
+     */
+    static QList<JournalSpyExpression> parse(QIODevice &io);
+
+private:
+    QString m_name;
+    // Field names are kept encoded to avoid converting them for every entry.
+    QList<QPair<QByteArray, QRegularExpression> > m_patterns;
+};
+
+#endif // JOURNALSPYEXPRESSION_H
@@ -0,0 +1,31 @@
+include(../../../crash-reporter-conf.pri)
+
+TEMPLATE = lib
+TARGET = powerexcess
+
+QT = core
+CONFIG += plugin link_pkgconfig
+
+INCLUDEPATH += \
+	.. \
+	../../libs \
+	../../libs/utils \
+
+HEADERS = \
+	../collectorsource.h \
+	powerexcesssource.h \
+
+SOURCES = \
+	powerexcesssource.cpp \
+
+OTHER_FILES += powerexcess.json
+
+LIBS += \
+	../../../lib/libcrashreporter.so \
+
+PKGCONFIG += \
+	libudev \
+
+target.path = $$CREPORTER_COLLECTOR_PLUGINS_PATH
+
+INSTALLS = target
@@ -19,7 +19,7 @@
  * 02110-1301 USA
  */
 
-#include "powerexcesshandler.h"
+#include "powerexcesssource.h"
 
 #include "creporternamespace.h"
 #include "creporterutils.h"
@@ -31,9 +31,12 @@
 
 using CReporter::LoggingCategory::cr;
 
-class PowerExcessHandlerPrivate
+class PowerExcessSourcePrivate
 {
 public:
+    PowerExcessSourcePrivate();
+
+    CollectorContext *context;
     udev *udevHandle;
     udev_monitor *udevMonitor;
     QSocketNotifier *udevSocketNotifier;
@@ -41,13 +44,28 @@ public:
     void handleUdevNotification();
 };
 
-PowerExcessHandler::PowerExcessHandler(QObject *parent)
-    : QObject(parent), d_ptr(new PowerExcessHandlerPrivate)
+PowerExcessSourcePrivate::PowerExcessSourcePrivate()
+    : context(0), udevHandle(0), udevMonitor(0), udevSocketNotifier(0)
+{
+}
+
+PowerExcessSource::PowerExcessSource()
+    : d_ptr(new PowerExcessSourcePrivate)
 {
-    Q_D(PowerExcessHandler);
+}
+
+bool PowerExcessSource::start(CollectorContext *context)
+{
+    Q_D(PowerExcessSource);
 
+    d->context = context;
     d->udevHandle = udev_new();
     d->udevMonitor = udev_monitor_new_from_netlink(d->udevHandle, "udev");
+    if (!d->udevMonitor) {
+        qCWarning(cr) << "Couldn't create udev monitor.";
+        stop();
+        return false;
+    }
     udev_monitor_filter_add_match_subsystem_devtype(d->udevMonitor, "misc", 0);
     udev_monitor_enable_receiving(d->udevMonitor);
 
@@ -56,9 +74,27 @@ PowerExcessHandler::PowerExcessHandler(QObject *parent)
                             QSocketNotifier::Read, this);
     connect(d->udevSocketNotifier, SIGNAL(activated(int)),
             this, SLOT(handleUdevNotification()));
+    return true;
 }
 
-void PowerExcessHandlerPrivate::handleUdevNotification()
+void PowerExcessSource::stop()
+{
+    Q_D(PowerExcessSource);
+
+    delete d->udevSocketNotifier;
+    d->udevSocketNotifier = 0;
+    if (d->udevMonitor) {
+        udev_monitor_unref(d->udevMonitor);
+        d->udevMonitor = 0;
+    }
+    if (d->udevHandle) {
+        udev_unref(d->udevHandle);
+        d->udevHandle = 0;
+    }
+    d->context = 0;
+}
+
+void PowerExcessSourcePrivate::handleUdevNotification()
 {
     udev_device *dev = udev_monitor_receive_device(udevMonitor);
     if (!dev) {
@@ -75,21 +111,16 @@ void PowerExcessHandlerPrivate::handleUdevNotification()
         if (event == EVENT_WAKELOCK_DUMP || event == EVENT_SUBSYSTEM) {
             qCDebug(cr) << "Power excess detected, requesting dump of "
                         "system logs.";
-            if (!CReporterUtils::invokeLogCollection(CReporter::PowerExcessPrefix)) {
-                qCWarning(cr) << "Problem invoking rich-core-dumper.";
-            }
+            context->trigger(CReporter::PowerExcessPrefix);
         }
     }
 
     udev_device_unref(dev);
 }
 
-PowerExcessHandler::~PowerExcessHandler()
+PowerExcessSource::~PowerExcessSource()
 {
-    Q_D(PowerExcessHandler);
-
-    udev_monitor_unref(d->udevMonitor);
-    udev_unref(d->udevHandle);
+    stop();
 }
 
-#include "moc_powerexcesshandler.cpp"
+#include "moc_powerexcesssource.cpp"
@@ -0,0 +1,57 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef POWEREXCESSSOURCE_H
+#define POWEREXCESSSOURCE_H
+
+#include <QObject>
+
+#include "collectorsource.h"
+
+class PowerExcessSourcePrivate;
+
+/*!
+ * @class PowerExcessSource
+ * @brief Collector source requesting log collection when the kernel reports
+ * a power excess through a kevent udev event.
+ */
+class PowerExcessSource: public QObject, public CollectorSource
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID CollectorSource_iid FILE "powerexcess.json")
+    Q_INTERFACES(CollectorSource)
+
+public:
+    PowerExcessSource();
+    ~PowerExcessSource();
+
+    bool start(CollectorContext *context);
+    void stop();
+
+private:
+    Q_DISABLE_COPY(PowerExcessSource)
+    Q_DECLARE_PRIVATE(PowerExcessSource)
+    QScopedPointer<PowerExcessSourcePrivate> d_ptr;
+
+    Q_PRIVATE_SLOT(d_func(), void handleUdevNotification())
+};
+
+#endif // POWEREXCESSSOURCE_H
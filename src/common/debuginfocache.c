@@ -0,0 +1,494 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "debuginfocache.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define INDEX_MAGIC "CRDBGIX1"
+#define INDEX_VERSION 1
+
+#define COPY_BUFFER_SIZE (64 * 1024)
+
+struct index_record {
+    unsigned char build_id[DEBUGINFO_MAX_BUILD_ID];
+    uint8_t build_id_len;
+    uint8_t reserved[7];
+    uint64_t size;
+    int64_t last_used;
+};
+
+struct debuginfo_index {
+    char magic[8];
+    uint32_t version;
+    uint32_t count;
+    uint64_t max_size;
+    uint64_t total_size;
+    struct index_record records[];
+};
+
+static int64_t now_ms()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+static int compare_build_ids(const unsigned char *a, size_t a_len,
+                             const unsigned char *b, size_t b_len)
+{
+    int result = memcmp(a, b, a_len < b_len ? a_len : b_len);
+    if (result != 0) {
+        return result;
+    }
+    return a_len < b_len ? -1 : a_len > b_len;
+}
+
+static void make_path(const struct debuginfo_cache *cache, const char *name,
+                      char *path, size_t size)
+{
+    snprintf(path, size, "%s/%s", cache->dir, name);
+}
+
+static void object_path(const struct debuginfo_cache *cache, const unsigned char *build_id,
+                        size_t build_id_len, char *path, size_t size)
+{
+    int len = snprintf(path, size, "%s/.build-id/%02x/", cache->dir, build_id[0]);
+    size_t i;
+    for (i = 1; i != build_id_len && len > 0 && (size_t)len + 3 < size; ++i) {
+        len += snprintf(path + len, size - len, "%02x", build_id[i]);
+    }
+    snprintf(path + len, size - len, ".debug");
+}
+
+static int make_dirs(const char *dir)
+{
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s", dir);
+
+    char *p;
+    for (p = path + 1; *p; ++p) {
+        if (*p == '/') {
+            *p = '\0';
+            if (mkdir(path, 0755) != 0 && errno != EEXIST) {
+                return -1;
+            }
+            *p = '/';
+        }
+    }
+    return mkdir(path, 0755) != 0 && errno != EEXIST ? -1 : 0;
+}
+
+static void unmap_index(struct debuginfo_cache *cache)
+{
+    if (cache->index) {
+        munmap(cache->index, cache->index_size);
+        cache->index = NULL;
+        cache->index_size = 0;
+    }
+}
+
+/* A missing or malformed index means an empty cache. */
+static void map_index(struct debuginfo_cache *cache)
+{
+    unmap_index(cache);
+
+    char path[PATH_MAX];
+    make_path(cache, "index", path, sizeof(path));
+
+    int fd = open(path, (cache->writable ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+    if (fd == -1 && cache->writable && (errno == EACCES || errno == EROFS)) {
+        /* Still good for lookups. */
+        cache->writable = 0;
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+    }
+    if (fd == -1) {
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(struct debuginfo_index)) {
+        int prot = PROT_READ | (cache->writable ? PROT_WRITE : 0);
+        void *map = mmap(NULL, st.st_size, prot, MAP_SHARED, fd, 0);
+        if (map != MAP_FAILED) {
+            struct debuginfo_index *index = map;
+            if (memcmp(index->magic, INDEX_MAGIC, sizeof(index->magic)) == 0 &&
+                index->version == INDEX_VERSION &&
+                (size_t)st.st_size == sizeof(*index) +
+                                      index->count * sizeof(struct index_record)) {
+                cache->index = index;
+                cache->index_size = st.st_size;
+            } else {
+                munmap(map, st.st_size);
+            }
+        }
+    }
+    close(fd);
+}
+
+int debuginfo_cache_open(struct debuginfo_cache *cache, const char *dir, int writable)
+{
+    memset(cache, 0, sizeof(*cache));
+    cache->dir = strdup(dir);
+    if (!cache->dir) {
+        return -1;
+    }
+    cache->writable = writable;
+
+    map_index(cache);
+    return 0;
+}
+
+void debuginfo_cache_close(struct debuginfo_cache *cache)
+{
+    unmap_index(cache);
+    free(cache->dir);
+    cache->dir = NULL;
+}
+
+size_t debuginfo_cache_count(const struct debuginfo_cache *cache)
+{
+    return cache->index ? cache->index->count : 0;
+}
+
+uint64_t debuginfo_cache_max_size(const struct debuginfo_cache *cache)
+{
+    return cache->index ? cache->index->max_size : DEBUGINFO_CACHE_DEFAULT_MAX_SIZE;
+}
+
+uint64_t debuginfo_cache_total_size(const struct debuginfo_cache *cache)
+{
+    return cache->index ? cache->index->total_size : 0;
+}
+
+void debuginfo_cache_entry(const struct debuginfo_cache *cache, size_t i,
+                           struct debuginfo_entry *entry)
+{
+    const struct index_record *record = &cache->index->records[i];
+    memcpy(entry->build_id, record->build_id, record->build_id_len);
+    entry->build_id_len = record->build_id_len;
+    entry->size = record->size;
+    entry->last_used = record->last_used;
+}
+
+static struct index_record *find(struct index_record *records, size_t count,
+                                 const unsigned char *build_id, size_t build_id_len)
+{
+    size_t low = 0;
+    size_t high = count;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        int c = compare_build_ids(records[middle].build_id, records[middle].build_id_len,
+                                  build_id, build_id_len);
+        if (c == 0) {
+            return &records[middle];
+        } else if (c < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return NULL;
+}
+
+int debuginfo_cache_lookup(struct debuginfo_cache *cache, const unsigned char *build_id,
+                           size_t build_id_len, char **path)
+{
+    if (!cache->index) {
+        return -1;
+    }
+
+    struct index_record *record = find(cache->index->records, cache->index->count,
+                                       build_id, build_id_len);
+    if (!record) {
+        return -1;
+    }
+
+    char file[PATH_MAX];
+    object_path(cache, build_id, build_id_len, file, sizeof(file));
+    int fd = open(file, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return -1;
+    }
+
+    if (cache->writable) {
+        record->last_used = now_ms();
+    }
+    if (path) {
+        *path = strdup(file);
+    }
+    return fd;
+}
+
+static int copy_file(const char *from, const char *to, uint64_t *size)
+{
+    int in = open(from, O_RDONLY | O_CLOEXEC);
+    if (in == -1) {
+        return -1;
+    }
+
+    char tmp[PATH_MAX];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", to);
+    int out = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out == -1) {
+        close(in);
+        return -1;
+    }
+
+    static char buf[COPY_BUFFER_SIZE];
+    int result = 0;
+    ssize_t r;
+    *size = 0;
+    while (result == 0 && (r = read(in, buf, sizeof(buf))) != 0) {
+        if (r < 0 && errno == EINTR) {
+            continue;
+        } else if (r < 0) {
+            result = -1;
+            break;
+        }
+        ssize_t done = 0;
+        while (done < r) {
+            ssize_t w = write(out, buf + done, r - done);
+            if (w < 0 && errno == EINTR) {
+                continue;
+            } else if (w < 0) {
+                result = -1;
+                break;
+            }
+            done += w;
+        }
+        *size += r;
+    }
+
+    close(in);
+    if (close(out) != 0) {
+        result = -1;
+    }
+    if (result == 0 && rename(tmp, to) != 0) {
+        result = -1;
+    }
+    if (result != 0) {
+        unlink(tmp);
+    }
+    return result;
+}
+
+/* Orders by build-id, the most recently used first among equal ones. */
+static int compare_records(const void *a, const void *b)
+{
+    const struct index_record *x = a;
+    const struct index_record *y = b;
+    int c = compare_build_ids(x->build_id, x->build_id_len, y->build_id, y->build_id_len);
+    if (c != 0) {
+        return c;
+    }
+    return x->last_used > y->last_used ? -1 : x->last_used < y->last_used;
+}
+
+static int compare_last_used(const void *a, const void *b)
+{
+    const struct index_record *x = *(const struct index_record * const *)a;
+    const struct index_record *y = *(const struct index_record * const *)b;
+    return x->last_used < y->last_used ? -1 : x->last_used > y->last_used;
+}
+
+/* Removes the least recently used files until the rest fits into max_size.
+ * Returns the new number of records. */
+static size_t evict(struct debuginfo_cache *cache, struct index_record *records,
+                    size_t count, uint64_t max_size, uint64_t *total_size)
+{
+    if (*total_size <= max_size) {
+        return count;
+    }
+
+    struct index_record **by_use = malloc(count * sizeof(struct index_record *));
+    if (!by_use) {
+        return count;
+    }
+    size_t i;
+    for (i = 0; i != count; ++i) {
+        by_use[i] = &records[i];
+    }
+    qsort(by_use, count, sizeof(by_use[0]), compare_last_used);
+
+    for (i = 0; i != count && *total_size > max_size; ++i) {
+        char path[PATH_MAX];
+        object_path(cache, by_use[i]->build_id, by_use[i]->build_id_len, path, sizeof(path));
+        unlink(path);
+        *total_size -= by_use[i]->size;
+        /* Marks the record as evicted. */
+        by_use[i]->build_id_len = 0;
+    }
+    free(by_use);
+
+    size_t kept = 0;
+    for (i = 0; i != count; ++i) {
+        if (records[i].build_id_len != 0) {
+            records[kept++] = records[i];
+        }
+    }
+    return kept;
+}
+
+static int write_index(struct debuginfo_cache *cache, const struct debuginfo_index *header,
+                       const struct index_record *records)
+{
+    char path[PATH_MAX];
+    char tmp[PATH_MAX];
+    make_path(cache, "index", path, sizeof(path));
+    make_path(cache, "index.tmp", tmp, sizeof(tmp));
+
+    FILE *file = fopen(tmp, "we");
+    if (!file) {
+        return -1;
+    }
+    int result = 0;
+    if (fwrite(header, sizeof(*header), 1, file) != 1 ||
+        (header->count > 0 &&
+         fwrite(records, sizeof(*records), header->count, file) != header->count)) {
+        result = -1;
+    }
+    if (fclose(file) != 0) {
+        result = -1;
+    }
+    if (result == 0 && rename(tmp, path) != 0) {
+        result = -1;
+    }
+    if (result != 0) {
+        unlink(tmp);
+    }
+    return result;
+}
+
+int debuginfo_cache_add(struct debuginfo_cache *cache, const struct debuginfo_file *files,
+                        size_t count, uint64_t max_size)
+{
+    if (!cache->writable) {
+        errno = EACCES;
+        return -1;
+    }
+
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/.build-id", cache->dir);
+    if (make_dirs(path) != 0) {
+        return -1;
+    }
+
+    make_path(cache, "lock", path, sizeof(path));
+    int lock = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (lock == -1) {
+        return -1;
+    }
+    if (flock(lock, LOCK_EX) != 0) {
+        close(lock);
+        return -1;
+    }
+
+    /* Picks up changes made since the cache was opened. */
+    map_index(cache);
+    size_t old_count = debuginfo_cache_count(cache);
+    if (max_size == 0) {
+        max_size = debuginfo_cache_max_size(cache);
+    }
+
+    int added = -1;
+    struct index_record *records = calloc(old_count + count + 1, sizeof(struct index_record));
+    if (!records) {
+        goto out;
+    }
+    if (old_count > 0) {
+        memcpy(records, cache->index->records, old_count * sizeof(struct index_record));
+    }
+
+    size_t record_count = old_count;
+    int64_t now = now_ms();
+    added = 0;
+    size_t i;
+    for (i = 0; i != count; ++i) {
+        const struct debuginfo_file *file = &files[i];
+        if (file->build_id_len == 0 || file->build_id_len > DEBUGINFO_MAX_BUILD_ID) {
+            continue;
+        }
+
+        char object[PATH_MAX];
+        snprintf(object, sizeof(object), "%s/.build-id/%02x", cache->dir, file->build_id[0]);
+        if (mkdir(object, 0755) != 0 && errno != EEXIST) {
+            continue;
+        }
+        object_path(cache, file->build_id, file->build_id_len, object, sizeof(object));
+
+        struct index_record *record = &records[record_count];
+        if (copy_file(file->path, object, &record->size) != 0) {
+            continue;
+        }
+        memcpy(record->build_id, file->build_id, file->build_id_len);
+        record->build_id_len = file->build_id_len;
+        record->last_used = now;
+        ++record_count;
+        ++added;
+    }
+
+    /* Files added again replace their old records. */
+    qsort(records, record_count, sizeof(records[0]), compare_records);
+    size_t unique = 0;
+    uint64_t total_size = 0;
+    for (i = 0; i != record_count; ++i) {
+        if (unique > 0 && compare_build_ids(records[unique - 1].build_id,
+                                            records[unique - 1].build_id_len,
+                                            records[i].build_id,
+                                            records[i].build_id_len) == 0) {
+            continue;
+        }
+        records[unique++] = records[i];
+        total_size += records[i].size;
+    }
+
+    record_count = evict(cache, records, unique, max_size, &total_size);
+
+    struct debuginfo_index header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = INDEX_VERSION;
+    header.count = record_count;
+    header.max_size = max_size;
+    header.total_size = total_size;
+    if (write_index(cache, &header, records) != 0) {
+        added = -1;
+    }
+    free(records);
+
+    map_index(cache);
+
+out:
+    flock(lock, LOCK_UN);
+    close(lock);
+    return added;
+}
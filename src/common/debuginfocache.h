@@ -0,0 +1,104 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef DEBUGINFOCACHE_H
+#define DEBUGINFOCACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * On-device store of debuginfo files, keyed by the build-id of the module
+ * they belong to. Files are kept as DIR/.build-id/xx/yyyy.debug, the layout
+ * of /usr/lib/debug, so the directory also works as a debug file directory
+ * of gdb or elfutils.
+ *
+ * DIR/index lists the files sorted by build-id, with their sizes and when
+ * they were last used. It's a flat array that is mapped into memory as is,
+ * so opening the cache costs a single mmap() and lookups are a binary
+ * search. Lookups record the time of use in the mapped index in place.
+ *
+ * The total size of the files is capped. Adding files evicts the least
+ * recently used ones above the cap. Changes are serialized by a lock on
+ * DIR/lock and the index is replaced atomically, so readers never need to
+ * lock; uses they record while the index is replaced may get lost, which
+ * only affects the order of eviction.
+ */
+
+#define DEBUGINFO_CACHE_DIR "/var/cache/crash-reporter/debuginfo"
+#define DEBUGINFO_CACHE_DEFAULT_MAX_SIZE (512ULL * 1024 * 1024)
+#define DEBUGINFO_MAX_BUILD_ID 40
+
+struct debuginfo_index;
+
+struct debuginfo_cache {
+    char *dir;
+    int writable;
+    struct debuginfo_index *index;
+    size_t index_size;
+};
+
+struct debuginfo_entry {
+    unsigned char build_id[DEBUGINFO_MAX_BUILD_ID];
+    size_t build_id_len;
+    uint64_t size;
+    /* Milliseconds since the epoch. */
+    int64_t last_used;
+};
+
+struct debuginfo_file {
+    const unsigned char *build_id;
+    size_t build_id_len;
+    const char *path;
+};
+
+/* Opens the cache in dir, which doesn't need to exist yet. A read-only cache
+ * doesn't record uses and can't be changed. Returns 0 on success. */
+int debuginfo_cache_open(struct debuginfo_cache *cache, const char *dir, int writable);
+
+void debuginfo_cache_close(struct debuginfo_cache *cache);
+
+/* Returns the number of files in the cache. */
+size_t debuginfo_cache_count(const struct debuginfo_cache *cache);
+
+/* Returns the maximum total size of the files. */
+uint64_t debuginfo_cache_max_size(const struct debuginfo_cache *cache);
+
+/* Returns the total size of the files. */
+uint64_t debuginfo_cache_total_size(const struct debuginfo_cache *cache);
+
+/* Fills entry with the i-th file, in the order of build-ids. */
+void debuginfo_cache_entry(const struct debuginfo_cache *cache, size_t i,
+                           struct debuginfo_entry *entry);
+
+/* Opens the file for the build-id for reading and records the use. Returns
+ * a file descriptor, -1 if there's no such file. When path isn't NULL, it's
+ * set to the path of the file, allocated with malloc(). */
+int debuginfo_cache_lookup(struct debuginfo_cache *cache, const unsigned char *build_id,
+                           size_t build_id_len, char **path);
+
+/* Copies files into the cache and evicts the least recently used files
+ * above max_size, which is kept for later additions if not 0. Files added
+ * now count as used now. Returns the number of files added, -1 on error. */
+int debuginfo_cache_add(struct debuginfo_cache *cache, const struct debuginfo_file *files,
+                        size_t count, uint64_t max_size);
+
+#endif // DEBUGINFOCACHE_H
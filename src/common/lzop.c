@@ -0,0 +1,663 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013-2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "lzop.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syslog.h>
+#include <time.h>
+#include <unistd.h>
+#include <lzo/lzo1x.h>
+
+static const unsigned char LZOP_MAGIC[9] =
+    { 0x89, 0x4c, 0x5a, 0x4f, 0x00, 0x0d, 0x0a, 0x1a, 0x0a };
+
+#define F_ADLER32_D     0x00000001
+#define F_ADLER32_C     0x00000002
+#define F_H_EXTRA_FIELD 0x00000040
+#define F_CRC32_D       0x00000100
+#define F_CRC32_C       0x00000200
+#define F_H_FILTER      0x00000800
+#define F_OS_UNIX       0x03000000
+
+#define M_LZO1X_1       1
+#define M_LZO1X_1_15    2
+#define M_LZO1X_999     3
+
+/* Same as lzop's default block size and upper limit. */
+#define WRITER_BLOCK_SIZE (256 * 1024)
+#define MAX_BLOCK_SIZE (64 * 1024 * 1024)
+
+static int read_full(int fd, void *buf, size_t len)
+{
+    unsigned char *p = buf;
+    while (len > 0) {
+        ssize_t r = read(fd, p, len);
+        if (r < 0 && errno == EINTR) {
+            continue;
+        } else if (r <= 0) {
+            return -1;
+        }
+        p += r;
+        len -= r;
+    }
+    return 0;
+}
+
+static int write_full(int fd, const void *buf, size_t len)
+{
+    const unsigned char *p = buf;
+    while (len > 0) {
+        ssize_t w = write(fd, p, len);
+        if (w < 0 && errno == EINTR) {
+            continue;
+        } else if (w < 0) {
+            return -1;
+        }
+        p += w;
+        len -= w;
+    }
+    return 0;
+}
+
+static int read_u8(int fd, uint32_t *value)
+{
+    unsigned char b;
+    if (read_full(fd, &b, 1) != 0) {
+        return -1;
+    }
+    *value = b;
+    return 0;
+}
+
+static int read_u16(int fd, uint32_t *value)
+{
+    unsigned char b[2];
+    if (read_full(fd, b, 2) != 0) {
+        return -1;
+    }
+    *value = (b[0] << 8) | b[1];
+    return 0;
+}
+
+static int read_u32(int fd, uint32_t *value)
+{
+    unsigned char b[4];
+    if (read_full(fd, b, 4) != 0) {
+        return -1;
+    }
+    *value = ((uint32_t)b[0] << 24) | (b[1] << 16) | (b[2] << 8) | b[3];
+    return 0;
+}
+
+static unsigned char *put_u16(unsigned char *p, uint32_t value)
+{
+    *p++ = value >> 8;
+    *p++ = value;
+    return p;
+}
+
+static unsigned char *put_u32(unsigned char *p, uint32_t value)
+{
+    *p++ = value >> 24;
+    *p++ = value >> 16;
+    *p++ = value >> 8;
+    *p++ = value;
+    return p;
+}
+
+/* Returns 1 when a header was parsed, 0 at the end of file, -1 on error. */
+static int parse_header(struct lzop_reader *reader)
+{
+    unsigned char magic[sizeof(LZOP_MAGIC)];
+    ssize_t r = read(reader->fd, magic, sizeof(magic));
+    if (r == 0) {
+        return 0;
+    }
+    if (r != sizeof(magic) || memcmp(magic, LZOP_MAGIC, sizeof(magic)) != 0) {
+        return -1;
+    }
+
+    uint32_t version, lib_version, version_needed, method, level, filter;
+    uint32_t mtime_low, mtime_high = 0, name_len, checksum;
+    if (read_u16(reader->fd, &version) != 0 ||
+        read_u16(reader->fd, &lib_version) != 0) {
+        return -1;
+    }
+    if (version >= 0x0940 && read_u16(reader->fd, &version_needed) != 0) {
+        return -1;
+    }
+    if (read_u8(reader->fd, &method) != 0) {
+        return -1;
+    }
+    if (version >= 0x0940 && read_u8(reader->fd, &level) != 0) {
+        return -1;
+    }
+    if (method != M_LZO1X_1 && method != M_LZO1X_1_15 && method != M_LZO1X_999) {
+        syslog(LOG_ERR, "Unsupported lzop compression method %u.", method);
+        return -1;
+    }
+    if (read_u32(reader->fd, &reader->flags) != 0) {
+        return -1;
+    }
+    if ((reader->flags & F_H_FILTER) && read_u32(reader->fd, &filter) != 0) {
+        return -1;
+    }
+    if (read_u32(reader->fd, &reader->mode) != 0 ||
+        read_u32(reader->fd, &mtime_low) != 0) {
+        return -1;
+    }
+    if (version >= 0x0940 && read_u32(reader->fd, &mtime_high) != 0) {
+        return -1;
+    }
+    reader->mtime = (time_t)(((uint64_t)mtime_high << 32) | mtime_low);
+
+    /* Original file name is of no use to us, skip it together with the
+     * header checksum. */
+    if (read_u8(reader->fd, &name_len) != 0 ||
+        lseek(reader->fd, name_len, SEEK_CUR) == -1 ||
+        read_u32(reader->fd, &checksum) != 0) {
+        return -1;
+    }
+
+    if (reader->flags & F_H_EXTRA_FIELD) {
+        uint32_t extra_len;
+        if (read_u32(reader->fd, &extra_len) != 0 ||
+            lseek(reader->fd, extra_len + 4, SEEK_CUR) == -1) {
+            return -1;
+        }
+    }
+
+    return 1;
+}
+
+/* Reads block header, returns 1 when there's a block, 0 at the end of the
+ * last stream and -1 on error. */
+static int read_block_header(struct lzop_reader *reader, uint32_t *dst_len,
+                             uint32_t *src_len, uint32_t *adler32)
+{
+    uint32_t checksum;
+
+    while (1) {
+        if (read_u32(reader->fd, dst_len) != 0) {
+            return -1;
+        }
+        if (*dst_len != 0) {
+            break;
+        }
+        /* End of stream. lzop files can be concatenated (e.g. when rich core
+         * notes get appended), so check for another header. */
+        int result = parse_header(reader);
+        if (result <= 0) {
+            return result;
+        }
+    }
+
+    if (*dst_len > MAX_BLOCK_SIZE || read_u32(reader->fd, src_len) != 0 ||
+        *src_len > *dst_len) {
+        return -1;
+    }
+
+    *adler32 = 0;
+    if ((reader->flags & F_ADLER32_D) && read_u32(reader->fd, adler32) != 0) {
+        return -1;
+    }
+    if ((reader->flags & F_CRC32_D) && read_u32(reader->fd, &checksum) != 0) {
+        return -1;
+    }
+    if (*src_len < *dst_len) {
+        if ((reader->flags & F_ADLER32_C) && read_u32(reader->fd, &checksum) != 0) {
+            return -1;
+        }
+        if ((reader->flags & F_CRC32_C) && read_u32(reader->fd, &checksum) != 0) {
+            return -1;
+        }
+    }
+
+    return 1;
+}
+
+int lzop_reader_open(struct lzop_reader *reader, const char *path)
+{
+    memset(reader, 0, sizeof(*reader));
+
+    if (lzo_init() != LZO_E_OK) {
+        return -1;
+    }
+
+    reader->fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (reader->fd == -1) {
+        return -1;
+    }
+
+    if (parse_header(reader) != 1) {
+        syslog(LOG_ERR, "%s is not a valid lzop file.", path);
+        close(reader->fd);
+        reader->fd = -1;
+        return -1;
+    }
+
+    return 0;
+}
+
+int64_t lzop_uncompressed_size(struct lzop_reader *reader)
+{
+    off_t start = lseek(reader->fd, 0, SEEK_CUR);
+    uint32_t saved_flags = reader->flags;
+    uint32_t saved_mode = reader->mode;
+    time_t saved_mtime = reader->mtime;
+    int64_t size = 0;
+    uint32_t dst_len, src_len, adler32;
+    int result;
+
+    while ((result = read_block_header(reader, &dst_len, &src_len, &adler32)) == 1) {
+        size += dst_len;
+        if (lseek(reader->fd, src_len, SEEK_CUR) == -1) {
+            result = -1;
+            break;
+        }
+    }
+
+    lseek(reader->fd, start, SEEK_SET);
+    reader->flags = saved_flags;
+    reader->mode = saved_mode;
+    reader->mtime = saved_mtime;
+
+    return result == 0 ? size : -1;
+}
+
+static int read_block(struct lzop_reader *reader)
+{
+    uint32_t dst_len, src_len, adler32;
+    int result = read_block_header(reader, &dst_len, &src_len, &adler32);
+    if (result <= 0) {
+        return result;
+    }
+
+    if (dst_len > reader->block_size) {
+        unsigned char *block = realloc(reader->block, dst_len);
+        unsigned char *input = realloc(reader->input, dst_len);
+        if (block) {
+            reader->block = block;
+        }
+        if (input) {
+            reader->input = input;
+        }
+        if (!block || !input) {
+            return -1;
+        }
+        reader->block_size = dst_len;
+    }
+
+    if (src_len < dst_len) {
+        lzo_uint out_len = dst_len;
+        if (read_full(reader->fd, reader->input, src_len) != 0 ||
+            lzo1x_decompress_safe(reader->input, src_len, reader->block,
+                                  &out_len, NULL) != LZO_E_OK ||
+            out_len != dst_len) {
+            return -1;
+        }
+    } else if (read_full(reader->fd, reader->block, dst_len) != 0) {
+        /* Block was stored uncompressed. */
+        return -1;
+    }
+
+    if ((reader->flags & F_ADLER32_D) &&
+        lzo_adler32(1, reader->block, dst_len) != adler32) {
+        return -1;
+    }
+
+    reader->block_pos = 0;
+    reader->block_len = dst_len;
+
+    return 1;
+}
+
+ssize_t lzop_read(struct lzop_reader *reader, void *buf, size_t len)
+{
+    if (reader->block_pos == reader->block_len) {
+        if (reader->eof) {
+            return 0;
+        }
+        int result = read_block(reader);
+        if (result < 0) {
+            return -1;
+        } else if (result == 0) {
+            reader->eof = 1;
+            return 0;
+        }
+    }
+
+    size_t available = reader->block_len - reader->block_pos;
+    if (len > available) {
+        len = available;
+    }
+    memcpy(buf, reader->block + reader->block_pos, len);
+    reader->block_pos += len;
+
+    return len;
+}
+
+void lzop_reader_close(struct lzop_reader *reader)
+{
+    if (reader->fd != -1) {
+        close(reader->fd);
+    }
+    free(reader->block);
+    free(reader->input);
+    memset(reader, 0, sizeof(*reader));
+    reader->fd = -1;
+}
+
+enum block_state {
+    BLOCK_EMPTY,
+    BLOCK_QUEUED,
+    BLOCK_BUSY,
+    BLOCK_DONE
+};
+
+struct lzop_block {
+    unsigned char *data;
+    size_t len;
+    unsigned char *compressed;
+    lzo_uint compressed_len;
+    uint32_t adler32;
+    void *work_mem;
+    enum block_state state;
+    int result;
+};
+
+static void compress_block(struct lzop_block *block)
+{
+    block->adler32 = lzo_adler32(1, block->data, block->len);
+    block->result = lzo1x_1_compress(block->data, block->len, block->compressed,
+                                     &block->compressed_len, block->work_mem) == LZO_E_OK ? 0 : -1;
+}
+
+/* Compresses queued blocks in the order they were queued until the writer
+ * finishes. */
+static void *compress_thread(void *arg)
+{
+    struct lzop_writer *writer = arg;
+
+    pthread_mutex_lock(&writer->lock);
+    while (1) {
+        struct lzop_block *block = &writer->blocks[writer->next_job];
+        if (block->state == BLOCK_QUEUED) {
+            block->state = BLOCK_BUSY;
+            writer->next_job = (writer->next_job + 1) % writer->block_count;
+            pthread_mutex_unlock(&writer->lock);
+
+            compress_block(block);
+
+            pthread_mutex_lock(&writer->lock);
+            block->state = BLOCK_DONE;
+            pthread_cond_broadcast(&writer->compressed);
+        } else if (writer->quit) {
+            break;
+        } else {
+            pthread_cond_wait(&writer->queued, &writer->lock);
+        }
+    }
+    pthread_mutex_unlock(&writer->lock);
+
+    return NULL;
+}
+
+/* Stops the compression threads and frees the blocks. */
+static void release_writer(struct lzop_writer *writer)
+{
+    int i;
+
+    if (writer->threads) {
+        pthread_mutex_lock(&writer->lock);
+        writer->quit = 1;
+        pthread_cond_broadcast(&writer->queued);
+        pthread_mutex_unlock(&writer->lock);
+
+        for (i = 0; i != writer->thread_count; ++i) {
+            pthread_join(writer->threads[i], NULL);
+        }
+        pthread_mutex_destroy(&writer->lock);
+        pthread_cond_destroy(&writer->queued);
+        pthread_cond_destroy(&writer->compressed);
+        free(writer->threads);
+        writer->threads = NULL;
+    }
+
+    if (writer->blocks) {
+        for (i = 0; i != writer->block_count; ++i) {
+            free(writer->blocks[i].data);
+            free(writer->blocks[i].compressed);
+            free(writer->blocks[i].work_mem);
+        }
+        free(writer->blocks);
+        writer->blocks = NULL;
+    }
+}
+
+int lzop_writer_open(struct lzop_writer *writer, int fd)
+{
+    return lzop_writer_open_threaded(writer, fd, 0);
+}
+
+int lzop_writer_open_threaded(struct lzop_writer *writer, int fd, int threads)
+{
+    memset(writer, 0, sizeof(*writer));
+
+    if (lzo_init() != LZO_E_OK) {
+        return -1;
+    }
+
+    writer->fd = fd;
+
+    /* Two blocks per thread let the caller fill the next block while the
+     * previous ones are being compressed. */
+    writer->block_count = threads > 0 ? 2 * threads : 1;
+    writer->blocks = calloc(writer->block_count, sizeof(struct lzop_block));
+    if (!writer->blocks) {
+        return -1;
+    }
+    int i;
+    for (i = 0; i != writer->block_count; ++i) {
+        struct lzop_block *block = &writer->blocks[i];
+        block->data = malloc(WRITER_BLOCK_SIZE);
+        block->compressed = malloc(WRITER_BLOCK_SIZE + WRITER_BLOCK_SIZE / 16 + 64 + 3);
+        block->work_mem = malloc(LZO1X_1_MEM_COMPRESS);
+        if (!block->data || !block->compressed || !block->work_mem) {
+            release_writer(writer);
+            return -1;
+        }
+    }
+
+    if (threads > 0) {
+        writer->threads = calloc(threads, sizeof(pthread_t));
+        if (!writer->threads) {
+            release_writer(writer);
+            return -1;
+        }
+        pthread_mutex_init(&writer->lock, NULL);
+        pthread_cond_init(&writer->queued, NULL);
+        pthread_cond_init(&writer->compressed, NULL);
+        for (i = 0; i != threads; ++i) {
+            int error = pthread_create(&writer->threads[i], NULL, compress_thread, writer);
+            if (error != 0) {
+                syslog(LOG_WARNING, "Couldn't start compression thread: %s", strerror(error));
+                break;
+            }
+        }
+        /* Blocks compress in the caller's thread when none could start. */
+        writer->thread_count = i;
+    }
+
+    unsigned char header[64];
+    unsigned char *p = header;
+    memcpy(p, LZOP_MAGIC, sizeof(LZOP_MAGIC));
+    p += sizeof(LZOP_MAGIC);
+
+    unsigned char *checked = p;
+    p = put_u16(p, 0x1030); /* lzop version we're compatible with */
+    p = put_u16(p, lzo_version());
+    p = put_u16(p, 0x0940); /* version needed to extract */
+    *p++ = M_LZO1X_1;
+    *p++ = 3; /* compression level, informational */
+    p = put_u32(p, F_OS_UNIX | F_ADLER32_D);
+    p = put_u32(p, 0100644); /* mode */
+    p = put_u32(p, time(NULL));
+    p = put_u32(p, 0); /* mtime high */
+    *p++ = 0; /* no file name */
+    p = put_u32(p, lzo_adler32(1, checked, p - checked));
+
+    writer->bytes_out = p - header;
+    if (write_full(fd, header, p - header) != 0) {
+        release_writer(writer);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int write_block(struct lzop_writer *writer, struct lzop_block *block)
+{
+    if (block->result != 0) {
+        return -1;
+    }
+
+    const unsigned char *data = block->compressed;
+    lzo_uint compressed_len = block->compressed_len;
+    if (compressed_len >= block->len) {
+        /* Incompressible data is stored as is. */
+        compressed_len = block->len;
+        data = block->data;
+    }
+
+    unsigned char header[12];
+    unsigned char *p = header;
+    p = put_u32(p, block->len);
+    p = put_u32(p, compressed_len);
+    p = put_u32(p, block->adler32);
+
+    if (write_full(writer->fd, header, sizeof(header)) != 0 ||
+        write_full(writer->fd, data, compressed_len) != 0) {
+        return -1;
+    }
+
+    writer->bytes_out += sizeof(header) + compressed_len;
+    block->len = 0;
+
+    return 0;
+}
+
+/* Waits until the oldest queued block is compressed and writes it out. */
+static int write_oldest(struct lzop_writer *writer)
+{
+    struct lzop_block *block = &writer->blocks[writer->oldest];
+
+    pthread_mutex_lock(&writer->lock);
+    while (block->state != BLOCK_DONE) {
+        pthread_cond_wait(&writer->compressed, &writer->lock);
+    }
+    block->state = BLOCK_EMPTY;
+    pthread_mutex_unlock(&writer->lock);
+
+    writer->oldest = (writer->oldest + 1) % writer->block_count;
+    --writer->pending;
+
+    return write_block(writer, block);
+}
+
+/* Hands the block being filled over for compression and moves on to the
+ * next one, which gets written out first if it still holds an earlier
+ * block. */
+static int submit_block(struct lzop_writer *writer)
+{
+    struct lzop_block *block = &writer->blocks[writer->fill];
+
+    if (writer->thread_count == 0) {
+        compress_block(block);
+        return write_block(writer, block);
+    }
+
+    pthread_mutex_lock(&writer->lock);
+    block->state = BLOCK_QUEUED;
+    pthread_cond_signal(&writer->queued);
+    pthread_mutex_unlock(&writer->lock);
+
+    writer->fill = (writer->fill + 1) % writer->block_count;
+    if (++writer->pending == writer->block_count) {
+        return write_oldest(writer);
+    }
+
+    return 0;
+}
+
+int lzop_write(struct lzop_writer *writer, const void *data, size_t len)
+{
+    const unsigned char *p = data;
+    writer->bytes_in += len;
+
+    while (len > 0) {
+        struct lzop_block *block = &writer->blocks[writer->fill];
+        size_t chunk = WRITER_BLOCK_SIZE - block->len;
+        if (chunk > len) {
+            chunk = len;
+        }
+        memcpy(block->data + block->len, p, chunk);
+        block->len += chunk;
+        p += chunk;
+        len -= chunk;
+
+        if (block->len == WRITER_BLOCK_SIZE && submit_block(writer) != 0) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int lzop_writer_finish(struct lzop_writer *writer)
+{
+    unsigned char end[4] = { 0, 0, 0, 0 };
+    int result = 0;
+
+    if (!writer->blocks) {
+        /* Opening failed, nothing to finish. */
+        return -1;
+    }
+
+    if (writer->blocks[writer->fill].len > 0) {
+        result = submit_block(writer);
+    }
+    while (result == 0 && writer->pending > 0) {
+        result = write_oldest(writer);
+    }
+    if (result == 0 && write_full(writer->fd, end, sizeof(end)) != 0) {
+        result = -1;
+    }
+    writer->bytes_out += sizeof(end);
+
+    release_writer(writer);
+
+    return result;
+}
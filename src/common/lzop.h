@@ -0,0 +1,99 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013-2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef LZOP_H
+#define LZOP_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+/*
+ * Minimal reader and writer of the lzop container format, enough to stream
+ * rich core sections in and out without spawning lzop.
+ */
+
+struct lzop_reader {
+    int fd;
+    uint32_t flags;
+    uint32_t mode;
+    time_t mtime;
+    unsigned char *block;
+    unsigned char *input;
+    size_t block_size;
+    size_t block_pos;
+    size_t block_len;
+    int eof;
+};
+
+struct lzop_block;
+
+struct lzop_writer {
+    int fd;
+    struct lzop_block *blocks;
+    int block_count;
+    /* Indices of the block being filled, of the oldest block not yet written
+     * out and of the next block for a compression thread to pick up. */
+    int fill;
+    int oldest;
+    int next_job;
+    int pending;
+    pthread_t *threads;
+    int thread_count;
+    pthread_mutex_t lock;
+    pthread_cond_t queued;
+    pthread_cond_t compressed;
+    int quit;
+    uint64_t bytes_in;
+    uint64_t bytes_out;
+};
+
+/* Opens lzop file at path and parses its header. Returns 0 on success. */
+int lzop_reader_open(struct lzop_reader *reader, const char *path);
+
+/* Returns the total size of uncompressed data in the file by walking the block
+ * headers, without decompressing anything. Must be called before the first
+ * lzop_read(). Returns -1 on a malformed file. */
+int64_t lzop_uncompressed_size(struct lzop_reader *reader);
+
+/* Reads up to len bytes of uncompressed data. Returns number of bytes read,
+ * 0 at the end of the stream and -1 on error. */
+ssize_t lzop_read(struct lzop_reader *reader, void *buf, size_t len);
+
+void lzop_reader_close(struct lzop_reader *reader);
+
+/* Writes lzop header into fd. Returns 0 on success; on failure nothing is
+ * left to release and lzop_writer_finish() just returns -1. */
+int lzop_writer_open(struct lzop_writer *writer, int fd);
+
+/* Same as lzop_writer_open(), but blocks are compressed by the given number
+ * of threads while the caller keeps writing. Blocks are still written out in
+ * order, so the output is the same. */
+int lzop_writer_open_threaded(struct lzop_writer *writer, int fd, int threads);
+
+int lzop_write(struct lzop_writer *writer, const void *data, size_t len);
+
+/* Writes the remaining block and the end of stream marker. Doesn't close the
+ * file descriptor. */
+int lzop_writer_finish(struct lzop_writer *writer);
+
+#endif // LZOP_H
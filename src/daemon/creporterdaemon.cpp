@@ -25,56 +25,83 @@
  *
  */
 
+#include <algorithm>
+
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QSet>
+
 #include <notification.h>
 
 #include "creporterdaemon.h"
 #include "creporterdaemon_p.h"
 #include "creporterdaemonadaptor.h"
+#include "creporterloggingadaptor.h"
+#include "creporterstatsadaptor.h"
 #include "creporterdaemonmonitor.h"
+#include "creporterdaemonsnapshot.h"
+#include "creporterreportindex.h"
 #include "creporternwsessionmgr.h"
 #include "creportersavedstate.h"
 #include "creportercoreregistry.h"
 #include "creporterutils.h"
 #include "creporternamespace.h"
 #include "creporterprivacysettingsmodel.h"
-#include "powerexcesshandler.h"
+#include "creporterstats.h"
+#include "creportertrace.h"
+#include "autouploader_interface.h" // generated
 
 using CReporter::LoggingCategory::cr;
 
+namespace {
+//! Name of the snapshot file in the settings directory.
+const char SnapshotFileName[] = "daemon-snapshot";
+}
+
 CReporterDaemon::CReporterDaemon()
     : d_ptr(new CReporterDaemonPrivate(this))
 {
+    CReporterCoreRecord::registerMetaType();
+
     // Adaptor class is deleted automatically, when the class, it is
     // attached to is deleted.
     new CReporterDaemonAdaptor(this);
-
-#ifndef CREPORTER_UNIT_TEST
-    new PowerExcessHandler(this);
-#endif
+    new CReporterLoggingAdaptor(this);
+    new CReporterStatsAdaptor(this);
 }
 
 CReporterDaemon::~CReporterDaemon()
 {
+    Q_D(CReporterDaemon);
+
     qCDebug(cr) << "Daemon destroyed.";
 
+    d->saveSnapshot();
+
     CReporterPrivacySettingsModel::instance()->freeSingleton();
     CReporterSavedState::freeSingleton();
 }
 
-void CReporterDaemon::setDelayedStartup(int timeout)
+void CReporterDaemon::setIdleTimeout(int timeout)
 {
     Q_D(CReporterDaemon);
 
-    qCDebug(cr) << "Delaying startup for" << timeout / 1000 << "seconds.";
-    if (timeout > 0) {
-        d->timerId = startTimer(timeout);
-    }
+    qCDebug(cr) << "Exiting after" << timeout / 1000 << "seconds of inactivity.";
+    d->idleTimeout = timeout;
+    d->restartIdleTimer();
 }
 
 bool CReporterDaemon::initiateDaemon()
 {
+    Q_D(CReporterDaemon);
+
     qCDebug(cr) << "Starting daemon...";
 
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+
     if (!CReporterPrivacySettingsModel::instance()->isValid()) {
         qCWarning(cr) << "Invalid settings, exiting";
         // Exit, if settings are missing.
@@ -83,6 +110,49 @@ bool CReporterDaemon::initiateDaemon()
 
     QString filename = CReporterPrivacySettingsModel::instance()->settingsFile();
 
+    bool restored = false;
+    QStringList unhandledReports;
+    if (!d->reportIndex) {
+        // Index is ready before clients can ask for it over D-Bus.
+        CReporterDaemonSnapshot snapshot;
+        QStringList corePaths(CReporterCoreRegistry::instance()->getCoreLocationPaths());
+        bool loaded = snapshot.load(d->snapshotPath());
+        if (loaded && snapshot.isCurrent(corePaths)) {
+            d->reportIndex = new CReporterReportIndex(snapshot.records(), this);
+            // A report might have appeared before the index watched for it.
+            if (!snapshot.isCurrent(corePaths)) {
+                d->reportIndex->refresh();
+            }
+            restored = true;
+        } else {
+            d->reportIndex = new CReporterReportIndex(this);
+        }
+        if (loaded && !restored) {
+            /* Reports written while the daemon wasn't running aren't in the
+             * snapshot. They are handled as new ones below. */
+            QSet<QString> known;
+            foreach (const CReporterCoreRecord &record, snapshot.records()) {
+                known.insert(record.filePath);
+            }
+            foreach (const QString &filePath, d->reportIndex->reports()) {
+                if (!known.contains(filePath)) {
+                    unhandledReports << filePath;
+                }
+            }
+        }
+        // Duplicate counters stay valid even if reports changed meanwhile.
+        d->restoredDuplicates = snapshot.duplicates();
+
+        connect(d->reportIndex, SIGNAL(reportAdded(QString, quint64)),
+                this, SIGNAL(reportAdded(QString, quint64)));
+        connect(d->reportIndex, SIGNAL(reportRemoved(QString, quint64)),
+                this, SIGNAL(reportRemoved(QString, quint64)));
+        connect(d->reportIndex, SIGNAL(reportAdded(QString, quint64)),
+                this, SLOT(restartIdleTimer()));
+        connect(d->reportIndex, SIGNAL(reportRemoved(QString, quint64)),
+                this, SLOT(restartIdleTimer()));
+    }
+
     if (!startService()) {
         qCWarning(cr) << "Failed to start D-Bus service, exiting";
         return false;
@@ -98,19 +168,20 @@ bool CReporterDaemon::initiateDaemon()
     // Each time daemon is started, we count successful core uploads from zero.
     CReporterSavedState *state = CReporterSavedState::instance();
     state->setUploadSuccessCount(0);
-    state->writeSettings();
 #endif
 
-    if (CReporterPrivacySettingsModel::instance()->automaticSendingEnabled()) {
-        QStringList files = collectAllCoreFiles();
+    if (d->monitor && !unhandledReports.isEmpty()) {
+        /* Notifies about the reports and requests uploading of all stored
+         * ones like the monitor does for any new report. */
+        d->monitor->processReports(unhandledReports);
+    } else if (CReporterPrivacySettingsModel::instance()->automaticSendingEnabled()) {
+        QStringList files = d->reportIndex->reports();
 
-        if (!files.isEmpty() &&
-                CReporterNwSessionMgr::canUseNetworkConnection() &&
-                !CReporterUtils::notifyAutoUploader(files)) {
-            qCDebug(cr) << "Failed to add files to the queue.";
+        if (!files.isEmpty() && CReporterNwSessionMgr::canUseNetworkConnection()) {
+            d->requestUpload(files);
         }
     } else if (CReporterPrivacySettingsModel::instance()->notificationsEnabled()) {
-        QStringList files = collectAllCoreFiles();
+        QStringList files = d->reportIndex->reports();
 
         if (!files.isEmpty()) {
             Notification notification;
@@ -122,6 +193,11 @@ bool CReporterDaemon::initiateDaemon()
         }
     }
 
+    qint64 startupUs = startupTimer.nsecsElapsed() / 1000;
+    CReporterStats::instance()->observe("startup_duration_us", startupUs);
+    qCDebug(cr) << "Daemon ready in" << startupUs << "us, report index"
+                << (restored ? "restored from snapshot." : "scanned.");
+
     return true;
 }
 
@@ -135,6 +211,10 @@ void CReporterDaemon::startCoreMonitoring(const bool fromDBus)
         // Create monitor instance and start monitoring cores.
         d->monitor = new CReporterDaemonMonitor(this);
         Q_CHECK_PTR(d->monitor);
+        connect(d->monitor, SIGNAL(uploadRequested(QStringList)),
+                this, SLOT(onUploadRequested(QStringList)));
+        connect(d->monitor, SIGNAL(richCoreNotify(QString)),
+                this, SLOT(restartIdleTimer()));
 
         qCDebug(cr) << "Core monitoring started.";
 
@@ -144,6 +224,10 @@ void CReporterDaemon::startCoreMonitoring(const bool fromDBus)
         }
         d->monitor->setAutoDeleteMaxSimilarCores(
             CReporterPrivacySettingsModel::instance()->autoDeleteMaxSimilarCores());
+        if (!d->restoredDuplicates.isEmpty()) {
+            d->monitor->setDuplicateRecords(d->restoredDuplicates);
+            d->restoredDuplicates.clear();
+        }
     }
 }
 
@@ -153,6 +237,7 @@ void CReporterDaemon::stopCoreMonitoring(const bool fromDBus)
 
     if (d->monitor) {
         // Delete monitor instance and stop core monitoring.
+        d->restoredDuplicates = d->monitor->duplicateRecords();
         delete d->monitor;
         d->monitor = 0;
 
@@ -170,19 +255,105 @@ QStringList CReporterDaemon::collectAllCoreFiles()
     return CReporterCoreRegistry::instance()->collectAllCoreFiles();
 }
 
-void CReporterDaemon::timerEvent(QTimerEvent *event)
+QStringList CReporterDaemon::reportSnapshot()
+{
+    Q_D(CReporterDaemon);
+
+    return d->reportIndex ? d->reportIndex->reports() : QStringList();
+}
+
+quint64 CReporterDaemon::reportGeneration()
+{
+    Q_D(CReporterDaemon);
+
+    return d->reportIndex ? d->reportIndex->generation() : 0;
+}
+
+namespace {
+
+bool newerThan(const CReporterCoreRecord &a, const CReporterCoreRecord &b)
+{
+    if (a.modified != b.modified) {
+        return a.modified > b.modified;
+    }
+    return a.filePath < b.filePath;
+}
+
+} // namespace
+
+CReporterCoreRecordList CReporterDaemon::coreFileRecords(uint offset, uint limit,
+        const QVariantMap &filter, uint *total)
 {
     Q_D(CReporterDaemon);
-    qCDebug(cr) << "Startup timer elapsed -> start now.";
 
-    if (event->timerId() != d->timerId) return;
+    if (!d->reportIndex) {
+        *total = 0;
+        return CReporterCoreRecordList();
+    }
+
+    QList<int> classes;
+    QVariant classFilter(filter.value("reportClass"));
+    if (classFilter.type() == QVariant::List) {
+        foreach (const QVariant &reportClass, classFilter.toList()) {
+            classes << reportClass.toInt();
+        }
+    } else if (classFilter.isValid()) {
+        classes << classFilter.toInt();
+    }
+    QString application(filter.value("application").toString());
+
+    CReporterCoreRecordList result;
+    foreach (const CReporterCoreRecord &record, d->reportIndex->records()) {
+        if ((classes.isEmpty() || classes.contains(record.reportClass)) &&
+                (application.isEmpty() || record.applicationName == application)) {
+            result << record;
+        }
+    }
+    std::sort(result.begin(), result.end(), newerThan);
+
+    *total = result.size();
+    // Offset and limit come from D-Bus as uint, don't let them wrap to int.
+    if (offset >= uint(result.size())) {
+        result.clear();
+    } else {
+        uint available = result.size() - offset;
+        result = result.mid(int(offset), (limit && limit < available) ? int(limit) : -1);
+    }
+
+    if (d->monitor) {
+        for (CReporterCoreRecordList::iterator it = result.begin(); it != result.end(); ++it) {
+            it->duplicateCount = d->monitor->duplicateCount(it->applicationName, it->signal);
+        }
+    }
+
+    return result;
+}
+
+QVariantMap CReporterDaemon::uploadTraceSummary()
+{
+    QStringList corePaths(CReporterCoreRegistry::instance()->getCoreLocationPaths());
+    if (corePaths.isEmpty()) {
+        return QVariantMap();
+    }
+
+    return CReporterTrace::summary(
+               CReporterTrace::readUploadLog(corePaths.first() + '/' + CReporter::UploadLogFileName));
+}
+
+void CReporterDaemon::timerEvent(QTimerEvent *event)
+{
+    Q_D(CReporterDaemon);
 
-    // Kill timer and initiate daemon.
-    killTimer(d->timerId);
-    d->timerId = 0;
+    if (event->timerId() == d->idleTimerId) {
+        if (d->pendingUploads > 0) {
+            qCDebug(cr) << "Idle, but waiting for" << d->pendingUploads << "upload requests.";
+            d->restartIdleTimer();
+            return;
+        }
 
-    if (!initiateDaemon()) {
-        // If D-Bus registration fails, quit application.
+        qCDebug(cr) << "Idle timer elapsed -> exit.";
+        killTimer(d->idleTimerId);
+        d->idleTimerId = 0;
         qApp->quit();
     }
 }
@@ -224,7 +395,8 @@ void CReporterDaemon::stopService()
 }
 
 CReporterDaemonPrivate::CReporterDaemonPrivate(CReporterDaemon *parent)
-    : monitor(0), timerId(0), q_ptr(parent)
+    : monitor(0), reportIndex(0), idleTimeout(0), idleTimerId(0),
+      pendingUploads(0), q_ptr(parent)
 {
     Q_Q(CReporterDaemon);
 
@@ -233,6 +405,91 @@ CReporterDaemonPrivate::CReporterDaemonPrivate(CReporterDaemon *parent)
                      q, SLOT(onNotificationsSettingChanged()));
 }
 
+void CReporterDaemonPrivate::onUploadRequested(const QStringList &files)
+{
+    CReporterStats *stats = CReporterStats::instance();
+    stats->increment("upload_requests_total");
+    stats->increment("upload_requested_files_total", files.size());
+
+    if (reportIndex) {
+        // Reports still around from an earlier request failed to upload.
+        int retries = reportIndex->setUploadQueued(files);
+        if (retries > 0) {
+            stats->increment("upload_retries_total", retries);
+        }
+    }
+}
+
+QString CReporterDaemonPrivate::snapshotPath() const
+{
+    QFileInfo savedState(CReporterSavedState::instance()->settingsFile());
+    return savedState.absolutePath() + '/' + SnapshotFileName;
+}
+
+void CReporterDaemonPrivate::saveSnapshot()
+{
+    if (!reportIndex) {
+        // The daemon never started, keep the previous snapshot.
+        return;
+    }
+
+    CReporterDaemonSnapshot snapshot;
+    snapshot.setDirectories(CReporterCoreRegistry::instance()->getCoreLocationPaths());
+    // Anything written after the directories were examined invalidates the snapshot.
+    reportIndex->refresh();
+    snapshot.setRecords(reportIndex->records());
+    snapshot.setDuplicates(monitor ? monitor->duplicateRecords() : restoredDuplicates);
+
+    if (snapshot.save(snapshotPath())) {
+        qCDebug(cr) << "Saved snapshot of" << snapshot.records().size() << "reports.";
+    }
+}
+
+void CReporterDaemonPrivate::requestUpload(const QStringList &files)
+{
+    Q_Q(CReporterDaemon);
+
+    qCDebug(cr) << "Requesting crash-reporter-autouploader to upload"
+                << files.size() << "files.";
+
+    ComNokiaCrashReporterAutoUploaderInterface proxy(CReporter::AutoUploaderServiceName,
+            CReporter::AutoUploaderObjectPath, QDBusConnection::sessionBus());
+
+    // Not waited for, starting the auto uploader mustn't hold up the daemon.
+    QDBusPendingCallWatcher *watcher =
+        new QDBusPendingCallWatcher(proxy.uploadFiles(files, true), q);
+    watcher->setProperty("files", files);
+    QObject::connect(watcher, SIGNAL(finished(QDBusPendingCallWatcher *)),
+                     q, SLOT(onUploadReplied(QDBusPendingCallWatcher *)));
+    ++pendingUploads;
+}
+
+void CReporterDaemonPrivate::onUploadReplied(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<bool> reply(*watcher);
+    if (reply.isError()) {
+        qCDebug(cr) << "Failed to add files to the queue:" << reply.error().message();
+    } else if (reportIndex) {
+        reportIndex->setUploadQueued(watcher->property("files").toStringList());
+    }
+
+    --pendingUploads;
+    watcher->deleteLater();
+}
+
+void CReporterDaemonPrivate::restartIdleTimer()
+{
+    Q_Q(CReporterDaemon);
+
+    if (idleTimerId) {
+        q->killTimer(idleTimerId);
+        idleTimerId = 0;
+    }
+    if (idleTimeout > 0) {
+        idleTimerId = q->startTimer(idleTimeout);
+    }
+}
+
 void CReporterDaemonPrivate::onNotificationsSettingChanged()
 {
     Q_Q(CReporterDaemon);
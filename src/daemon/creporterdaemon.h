@@ -27,8 +27,12 @@
 
 #include <QObject>
 #include <QStringList>
+#include <QVariantMap>
+
+#include "creportercorerecord.h"
 
 class CReporterDaemonPrivate;
+class QDBusPendingCallWatcher;
 
 /*!
  * @class CReporterDaemon
@@ -44,11 +48,16 @@ public:
     ~CReporterDaemon();
 
     /*!
-      * @brief Sets delayed start up for daemon.
+      * @brief Makes the daemon exit once it has been idle for a while.
+      *
+      * Used when the daemon is started on demand by systemd or D-Bus
+      * activation. Calls to the daemon D-Bus interface, index changes and
+      * new reports count as activity; the daemon also stays up while upload
+      * requests are pending. Logging and statistics calls don't keep it up.
       *
-      * @param timeout Millisecond value to delay startup.
+      * @param timeout Millisecond value to stay idle, 0 to never exit.
       */
-    void setDelayedStartup(int timeout);
+    void setIdleTimeout(int timeout);
 
 public Q_SLOTS:
     /*!
@@ -84,6 +93,57 @@ public Q_SLOTS:
      */
     QStringList collectAllCoreFiles();
 
+    /*!
+     * @brief Returns the reports in the report index.
+     *
+     * @return List of absolute core file paths.
+     * @sa reportGeneration
+     */
+    QStringList reportSnapshot();
+
+    /*!
+     * @brief Returns the generation of the report index.
+     */
+    quint64 reportGeneration();
+
+    /*!
+     * @brief Returns descriptions of indexed reports, newest first.
+     *
+     * @param offset Number of matching reports to skip.
+     * @param limit Maximum number of reports to return, 0 for no limit.
+     * @param filter Only reports matching all entries are returned.
+     *  Recognized keys are "reportClass" (int or list of ints, see
+     *  CReporterCrashInfo::ReportClass) and "application" (string).
+     * @param total Set to the number of matching reports.
+     * @return Matching reports in the range.
+     */
+    CReporterCoreRecordList coreFileRecords(uint offset, uint limit,
+                                            const QVariantMap &filter, uint *total);
+
+    /*!
+     * @brief Summarises the traces of uploaded reports stored in the uploadlog.
+     *
+     * @return See CReporterTrace::summary().
+     */
+    QVariantMap uploadTraceSummary();
+
+Q_SIGNALS:
+    /*!
+     * @brief Sent when a report is added to the report index.
+     *
+     * @param filePath Absolute path of the report.
+     * @param generation Generation of the index after the change.
+     */
+    void reportAdded(const QString &filePath, quint64 generation);
+
+    /*!
+     * @brief Sent when a report is removed from the report index.
+     *
+     * @param filePath Absolute path of the report.
+     * @param generation Generation of the index after the change.
+     */
+    void reportRemoved(const QString &filePath, quint64 generation);
+
 private slots:
     /*!
       * @brief Called, when timer elapses.
@@ -111,6 +171,9 @@ private:
     QScopedPointer<CReporterDaemonPrivate> d_ptr;
 
     Q_PRIVATE_SLOT(d_func(), void onNotificationsSettingChanged())
+    Q_PRIVATE_SLOT(d_func(), void onUploadRequested(const QStringList &))
+    Q_PRIVATE_SLOT(d_func(), void onUploadReplied(QDBusPendingCallWatcher *))
+    Q_PRIVATE_SLOT(d_func(), void restartIdleTimer())
 
 #ifdef CREPORTER_UNIT_TEST
     friend class Ut_CReporterDaemon;
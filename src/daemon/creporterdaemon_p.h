@@ -25,7 +25,11 @@
 #ifndef CREPORTERDAEMON_P_H
 #define CREPORTERDAEMON_P_H
 
+#include "creporterdaemonsnapshot.h"
+
 class CReporterDaemonMonitor;
+class CReporterReportIndex;
+class QDBusPendingCallWatcher;
 
 /*!
  * \class CReporterDaemonPrivate
@@ -39,10 +43,29 @@ public:
     CReporterDaemonPrivate(CReporterDaemon *parent);
 
     CReporterDaemonMonitor *monitor;
-    //! @arg Startup delay timer Id.
-    int timerId;
+    CReporterReportIndex *reportIndex;
+    //! @arg Idle timeout in milliseconds, 0 if the daemon stays resident.
+    int idleTimeout;
+    //! @arg Idle timer Id.
+    int idleTimerId;
+    //! @arg Number of upload requests without a reply yet.
+    int pendingUploads;
+    //! @arg Duplicate counters to hand over to the next monitor.
+    CReporterDuplicateRecordList restoredDuplicates;
+
+    //! @return Path of the daemon snapshot file.
+    QString snapshotPath() const;
+    //! Persists the report index and duplicate counters.
+    void saveSnapshot();
+    //! Asks the auto uploader to upload @a files without waiting for it.
+    void requestUpload(const QStringList &files);
+    //! Starts counting idle time from now, if an idle timeout is set.
+    void restartIdleTimer();
+
 private:
     void onNotificationsSettingChanged();
+    void onUploadRequested(const QStringList &files);
+    void onUploadReplied(QDBusPendingCallWatcher *watcher);
 
     Q_DECLARE_PUBLIC(CReporterDaemon);
     CReporterDaemon *q_ptr;
@@ -27,6 +27,16 @@
 
 #include "creporterdaemonadaptor.h"
 
+namespace {
+
+//! Calls to the daemon interface count as activity for the idle timeout.
+void restartIdleTimer(QObject *daemon)
+{
+    QMetaObject::invokeMethod(daemon, "restartIdleTimer");
+}
+
+} // namespace
+
 CReporterDaemonAdaptor::CReporterDaemonAdaptor(QObject *parent)
     : QDBusAbstractAdaptor(parent)
 {
@@ -39,6 +49,7 @@ CReporterDaemonAdaptor::~CReporterDaemonAdaptor()
 
 void CReporterDaemonAdaptor::startCoreMonitoring()
 {
+    restartIdleTimer(parent());
     // Handle method call com.nokia.Maemo.CrashReporterDaemon.startCoreMonitoring
     QMetaObject::invokeMethod(parent(), "startCoreMonitoring",
                               Q_ARG(bool, true));
@@ -46,6 +57,7 @@ void CReporterDaemonAdaptor::startCoreMonitoring()
 
 void CReporterDaemonAdaptor::stopCoreMonitoring()
 {
+    restartIdleTimer(parent());
     // Handle method call com.nokia.Maemo.CrashReporterDaemon.stopCoreMonitoring
     QMetaObject::invokeMethod(parent(), "stopCoreMonitoring",
                               Q_ARG(bool, true));
@@ -53,9 +65,52 @@ void CReporterDaemonAdaptor::stopCoreMonitoring()
 
 QStringList CReporterDaemonAdaptor::getAllCoreFiles()
 {
+    restartIdleTimer(parent());
     QStringList out;
     // Handle method call com.nokia.Maemo.CrashReporterDaemon.getAllCoreFiles
     QMetaObject::invokeMethod(parent(), "collectAllCoreFiles",
                               Q_RETURN_ARG(QStringList, out));
     return out;
 }
+
+QStringList CReporterDaemonAdaptor::getReportSnapshot(qulonglong &generation)
+{
+    restartIdleTimer(parent());
+    QStringList out;
+    quint64 outGeneration = 0;
+    // Handle method call com.nokia.CrashReporter.Daemon.getReportSnapshot
+    QMetaObject::invokeMethod(parent(), "reportSnapshot",
+                              Q_RETURN_ARG(QStringList, out));
+    QMetaObject::invokeMethod(parent(), "reportGeneration",
+                              Q_RETURN_ARG(quint64, outGeneration));
+    generation = outGeneration;
+    return out;
+}
+
+CReporterCoreRecordList CReporterDaemonAdaptor::getCoreFileRecords(uint offset, uint limit,
+        const QVariantMap &filter, uint &total, qulonglong &generation)
+{
+    restartIdleTimer(parent());
+    CReporterCoreRecordList out;
+    uint *outTotal = &total;
+    quint64 outGeneration = 0;
+    // Handle method call com.nokia.CrashReporter.Daemon.getCoreFileRecords
+    QMetaObject::invokeMethod(parent(), "coreFileRecords",
+                              Q_RETURN_ARG(CReporterCoreRecordList, out),
+                              Q_ARG(uint, offset), Q_ARG(uint, limit),
+                              Q_ARG(QVariantMap, filter), Q_ARG(uint *, outTotal));
+    QMetaObject::invokeMethod(parent(), "reportGeneration",
+                              Q_RETURN_ARG(quint64, outGeneration));
+    generation = outGeneration;
+    return out;
+}
+
+QVariantMap CReporterDaemonAdaptor::getUploadTraceSummary()
+{
+    restartIdleTimer(parent());
+    QVariantMap out;
+    // Handle method call com.nokia.CrashReporter.Daemon.getUploadTraceSummary
+    QMetaObject::invokeMethod(parent(), "uploadTraceSummary",
+                              Q_RETURN_ARG(QVariantMap, out));
+    return out;
+}
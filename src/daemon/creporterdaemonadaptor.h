@@ -27,6 +27,8 @@
 
 #include <QtDBus/QtDBus>
 
+#include "creportercorerecord.h"
+
 class QStringList;
 class CReporterDaemonAdaptorPrivate;
 
@@ -73,6 +75,56 @@ public Q_SLOTS:
      */
     QStringList getAllCoreFiles();
 
+    /*!
+     * @brief Returns the reports in the daemon's report index.
+     *
+     * @param generation Generation of the index the list corresponds to.
+     * @return List of absolute core file paths.
+     * @sa reportAdded, reportRemoved
+     */
+    QStringList getReportSnapshot(qulonglong &generation);
+
+    /*!
+     * @brief Returns descriptions of the reports in the daemon's report index,
+     * newest first.
+     *
+     * @param offset Number of matching reports to skip.
+     * @param limit Maximum number of reports to return, 0 for no limit.
+     * @param filter Keys "reportClass" and "application" restrict the result.
+     * @param total Number of matching reports.
+     * @param generation Generation of the index the result corresponds to.
+     * @return Matching reports in the range.
+     */
+    CReporterCoreRecordList getCoreFileRecords(uint offset, uint limit,
+                                               const QVariantMap &filter,
+                                               uint &total, qulonglong &generation);
+
+    /*!
+     * @brief Returns percentiles of the time reports spent in each stage
+     * from their creation to the server's reply.
+     *
+     * @return Map from stage name and "total" to a map with "count", "p50",
+     *  "p90", "p99" and "max" durations in microseconds.
+     */
+    QVariantMap getUploadTraceSummary();
+
+Q_SIGNALS:
+    /*!
+     * @brief Relayed from the daemon when a report is added to the index.
+     *
+     * @param filePath Absolute path of the report.
+     * @param generation Generation of the index after the change.
+     */
+    void reportAdded(const QString &filePath, quint64 generation);
+
+    /*!
+     * @brief Relayed from the daemon when a report is removed from the index.
+     *
+     * @param filePath Absolute path of the report.
+     * @param generation Generation of the index after the change.
+     */
+    void reportRemoved(const QString &filePath, quint64 generation);
+
 private:
     Q_DECLARE_PRIVATE(CReporterDaemonAdaptor)
     CReporterDaemonAdaptorPrivate *d_ptr;
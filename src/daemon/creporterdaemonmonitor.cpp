@@ -39,29 +39,72 @@
 #include "creporterdaemonmonitor.h"
 #include "creporterdaemonmonitor_p.h"
 #include "creportercoreregistry.h"
+#include "creportercrashinfo.h"
 #include "creporternwsessionmgr.h"
 #include "creportersavedstate.h"
 #include "creporterutils.h"
 #include "creporternamespace.h"
 #include "creporterprivacysettingsmodel.h"
+#include "creporterprobes.h"
+#include "creporterstats.h"
+#include "creportertrace.h"
 #include "autouploader_interface.h" // generated
 
 using CReporter::LoggingCategory::cr;
 
+CREPORTER_PROBE_SEMAPHORE(directory_changed);
+CREPORTER_PROBE_SEMAPHORE(duplicate_deleted);
+CREPORTER_PROBE_SEMAPHORE(core_handled);
+
+namespace {
+
+//! @return Label value for statistics of the report class.
+const char *reportClassLabel(CReporterCrashInfo::ReportClass reportClass)
+{
+    switch (reportClass) {
+    case CReporterCrashInfo::ApplicationCrash:
+        return "crash";
+    case CReporterCrashInfo::QuickFeedback:
+        return "quickie";
+    case CReporterCrashInfo::EndurancePackage:
+        return "endurance";
+    case CReporterCrashInfo::PowerExcess:
+        return "power_excess";
+    case CReporterCrashInfo::OneshotFailure:
+        return "oneshot";
+    case CReporterCrashInfo::HWReboot:
+        return "hw_reboot";
+    case CReporterCrashInfo::HWSMPL:
+        return "hw_smpl";
+    case CReporterCrashInfo::OverheatShutdown:
+        return "overheat";
+    case CReporterCrashInfo::JournalSpy:
+        return "journal_spy";
+    }
+    return "unknown";
+}
+
+} // namespace
+
 CReporterHandledRichCore::CReporterHandledRichCore(const QString &filePath)
     : lastCountReset(QDateTime::currentDateTimeUtc())
 {
-    // Parse needed info for file path.
-    QStringList rCoreInfo = CReporterUtils::parseCrashInfoFromFilename(filePath);
+    CReporterCrashInfo info(CReporterCoreRegistry::instance()->crashInfo(filePath));
 
-    binaryName = rCoreInfo[0];
-    signalNumber = rCoreInfo[2].toInt();
+    binaryName = info.applicationName().toString();
+    signalNumber = info.signal();
 
     count = 0;
 
     qCDebug(cr) << "Name:" << binaryName << ", Signal:" << signalNumber;
 }
 
+CReporterHandledRichCore::CReporterHandledRichCore(const CReporterDuplicateRecord &record)
+    : binaryName(record.applicationName), signalNumber(record.signal),
+      count(record.count), lastCountReset(record.lastCountReset)
+{
+}
+
 CReporterHandledRichCore::~CReporterHandledRichCore()
 {
 }
@@ -133,6 +176,10 @@ void CReporterDaemonMonitorPrivate::handleDirectoryChanged(const QString &path)
 {
     qCDebug(cr) << "Directory:" << path << "has changed.";
 
+    CReporterTrace trace;
+    trace.mark(CReporterTrace::DirectoryChanged);
+    CREPORTER_PROBE1(directory_changed, qPrintable(path));
+
     QDir changedDir(path);
     // QFileSystemWatcher will send signal if monitored directory was removed.
     if (!changedDir.exists()) {
@@ -164,9 +211,27 @@ void CReporterDaemonMonitorPrivate::handleDirectoryChanged(const QString &path)
     // New core found.
     qCDebug(cr) << "New rich-core file found: " << filePath;
 
-    QStringList details = CReporterUtils::parseCrashInfoFromFilename(filePath);
-    bool isUserTerminated = (details[2].toInt() == SIGQUIT);
-    QString appName = details[0];
+    if (handleRichCore(filePath, &trace)) {
+        QHash<QString, CReporterTrace> traces;
+        traces.insert(filePath, trace);
+        requestUpload(traces);
+    }
+}
+
+bool CReporterDaemonMonitorPrivate::handleRichCore(const QString &filePath, CReporterTrace *trace)
+{
+    CReporterCoreRegistry *registry = CReporterCoreRegistry::instance();
+
+    QFileInfo fileInfo(filePath);
+    trace->setTimestamp(CReporterTrace::FileAppeared,
+                        CReporterTrace::fromDateTime(fileInfo.lastModified()));
+
+    CReporterCrashInfo info(registry->crashInfo(filePath));
+    bool isUserTerminated = (info.signal() == SIGQUIT);
+    QString appName = info.applicationName().toString();
+
+    CReporterStats::instance()->increment(QString("cores_detected_total{class=\"%1\"}")
+                                          .arg(reportClassLabel(info.reportClass())));
 
     emit q_ptr->richCoreNotify(filePath);
 
@@ -187,10 +252,14 @@ void CReporterDaemonMonitorPrivate::handleDirectoryChanged(const QString &path)
             notification.setPreviewBody(qtTrId("crash_reporter-notify-duplicate_deleted"));
             notification.publish();
         }
+        CReporterStats::instance()->increment("duplicates_suppressed_total");
+        CREPORTER_PROBE2(duplicate_deleted, qPrintable(filePath), fileInfo.size());
         CReporterUtils::removeFile(filePath);
-        return;
+        return false;
     }
 
+    trace->mark(CReporterTrace::DuplicateChecked);
+
     if (!settings.automaticSendingEnabled()) {
         /* TODO: Here multiple-choice notification should be displayed
          * with options to send or delete the crash report. So far
@@ -203,13 +272,13 @@ void CReporterDaemonMonitorPrivate::handleDirectoryChanged(const QString &path)
             QString body;
             QString summary;
 
-            if (filePath.contains(CReporter::QuickFeedbackPrefix)) {
+            if (info.reportClass() == CReporterCrashInfo::QuickFeedback) {
                 //% "New feedback message is ready."
                 summary = qtTrId("crash_reporter-notify-quickie_ready");
-            } else if (filePath.contains(CReporter::EndurancePackagePrefix)) {
+            } else if (info.reportClass() == CReporterCrashInfo::EndurancePackage) {
                 //% "New endurance report is ready."
                 summary = qtTrId("crash_reporter-notify-endurance_ready");
-            } else if (filePath.contains(CReporter::PowerExcessPrefix)) {
+            } else if (info.reportClass() == CReporterCrashInfo::PowerExcess) {
                 //% "Power excess detected."
                 summary = qtTrId("crash_reporter-notify-power_excess_detected");
             } else if (isUserTerminated) {
@@ -231,18 +300,33 @@ void CReporterDaemonMonitorPrivate::handleDirectoryChanged(const QString &path)
             crashNotification->setItemCount(crashCount);
             crashNotification->publish();
         }
-        if (!CReporterNwSessionMgr::canUseNetworkConnection()) {
-            qCDebug(cr) << "WiFi not available, not uploading now.";
-        } else {
-            /* In auto-upload mode try to upload all crash reports each
-             * time a new one appears. */
-            if (!CReporterUtils::notifyAutoUploader(registry->collectAllCoreFiles())) {
-                qCWarning(cr) << "Failed to start Auto Uploader.";
-            }
-        }
+        trace->mark(CReporterTrace::Notified);
+    }
+
+    CREPORTER_PROBE3(core_handled, qPrintable(filePath), fileInfo.size(),
+                     (CReporterTrace::now() - trace->timestamp(CReporterTrace::DirectoryChanged)));
+
+    return settings.automaticSendingEnabled();
+}
+
+void CReporterDaemonMonitorPrivate::requestUpload(const QHash<QString, CReporterTrace> &traces)
+{
+    if (!CReporterNwSessionMgr::canUseNetworkConnection()) {
+        qCDebug(cr) << "WiFi not available, not uploading now.";
+        return;
+    }
+
+    /* In auto-upload mode try to upload all crash reports each
+     * time a new one appears. */
+    QStringList files(CReporterCoreRegistry::instance()->collectAllCoreFiles());
+    if (!CReporterUtils::notifyAutoUploader(files, traces)) {
+        qCWarning(cr) << "Failed to start Auto Uploader.";
+    } else {
+        emit q_ptr->uploadRequested(files);
     }
 }
 
+
 void CReporterDaemonMonitorPrivate::handleParentDirectoryChanged()
 {
     qCDebug(cr) << "Parent dir has changed. Trying to re-add directory watchers.";
@@ -269,7 +353,7 @@ void CReporterDaemonMonitorPrivate::handleParentDirectoryChanged()
 bool CReporterDaemonMonitorPrivate::checkForDuplicates(const QString &path)
 {
     // Ignore reports that don't contain core dumps.
-    if (!CReporterUtils::reportIncludesCrash(path)) {
+    if (!CReporterCoreRegistry::instance()->crashInfo(path).includesCrash()) {
         return false;
     }
 
@@ -362,3 +446,61 @@ void CReporterDaemonMonitor::setAutoDeleteMaxSimilarCores(int value)
 {
     d_ptr->autoDeleteMaxSimilarCores = value;
 }
+
+int CReporterDaemonMonitor::duplicateCount(const QString &applicationName, int signal) const
+{
+    foreach (const CReporterHandledRichCore *handled, d_ptr->handledRichCores) {
+        if (handled->binaryName == applicationName && handled->signalNumber == signal) {
+            return handled->count;
+        }
+    }
+
+    return 0;
+}
+
+CReporterDuplicateRecordList CReporterDaemonMonitor::duplicateRecords() const
+{
+    CReporterDuplicateRecordList records;
+    foreach (const CReporterHandledRichCore *handled, d_ptr->handledRichCores) {
+        CReporterDuplicateRecord record;
+        record.applicationName = handled->binaryName;
+        record.signal = handled->signalNumber;
+        record.count = handled->count;
+        record.lastCountReset = handled->lastCountReset;
+        records << record;
+    }
+
+    return records;
+}
+
+void CReporterDaemonMonitor::setDuplicateRecords(const CReporterDuplicateRecordList &records)
+{
+    qDeleteAll(d_ptr->handledRichCores);
+    d_ptr->handledRichCores.clear();
+
+    foreach (const CReporterDuplicateRecord &record, records) {
+        d_ptr->handledRichCores << new CReporterHandledRichCore(record);
+    }
+}
+
+void CReporterDaemonMonitor::processReports(const QStringList &files)
+{
+    QHash<QString, CReporterTrace> traces;
+    foreach (const QString &filePath, files) {
+        if (!QFileInfo::exists(filePath)) {
+            continue;
+        }
+
+        qCDebug(cr) << "Processing report found at startup:" << filePath;
+
+        CReporterTrace trace;
+        trace.mark(CReporterTrace::DirectoryChanged);
+        if (d_ptr->handleRichCore(filePath, &trace)) {
+            traces.insert(filePath, trace);
+        }
+    }
+
+    if (!traces.isEmpty()) {
+        d_ptr->requestUpload(traces);
+    }
+}
@@ -26,8 +26,11 @@
 #define CREPORTERDAEMONMONITOR_H
 
 #include <QObject>
+#include <QStringList>
 #include <QVariantList>
 
+#include "creporterdaemonsnapshot.h"
+
 class CReporterCoreRegistry;
 class CReporterDaemonMonitorPrivate;
 
@@ -70,6 +73,38 @@ public:
       */
     void setAutoDeleteMaxSimilarCores(int value);
 
+    /*!
+      * @brief Returns how many times a similar crash was handled.
+      *
+      * @param applicationName Binary name of the crashed application.
+      * @param signal Signal number the application crashed with.
+      * @return Value of the duplicate counter, 0 if no such crash was seen.
+      */
+    int duplicateCount(const QString &applicationName, int signal) const;
+
+    /*!
+      * @brief Returns the duplicate counters of all handled crashes.
+      */
+    CReporterDuplicateRecordList duplicateRecords() const;
+
+    /*!
+      * @brief Replaces the duplicate counters, e.g. with ones persisted
+      * by an earlier run of the daemon.
+      *
+      * @param records Duplicate counters to restore.
+      */
+    void setDuplicateRecords(const CReporterDuplicateRecordList &records);
+
+    /*!
+      * @brief Handles reports that appeared while the daemon wasn't running
+      * as if they had just been found in a monitored directory.
+      *
+      * Uploading is requested once for all of them.
+      *
+      * @param files Absolute paths of the reports.
+      */
+    void processReports(const QStringList &files);
+
 signals:
     /*!
       * @brief Sent, when new rich-core dump is found.
@@ -78,12 +113,20 @@ signals:
       */
     void richCoreNotify(const QString &path);
 
+    /*!
+      * @brief Sent, when reports were handed over to the auto-uploader.
+      *
+      * @param files Absolute paths of the reports.
+      */
+    void uploadRequested(const QStringList &files);
+
 private:
     Q_DECLARE_PRIVATE(CReporterDaemonMonitor)
     CReporterDaemonMonitorPrivate *d_ptr;
 
 #ifdef CREPORTER_UNIT_TEST
     friend class Ut_CReporterDaemonMonitor;
+    friend class Bm_DaemonMonitor;
 #endif
 };
 
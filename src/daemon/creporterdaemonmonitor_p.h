@@ -27,8 +27,12 @@
 
 #include <QDateTime>
 #include <QFileSystemWatcher>
+#include <QHash>
+
+#include "creporterdaemonsnapshot.h"
 
 class CReporterDaemonMonitor;
+class CReporterTrace;
 class Notification;
 
 /*!
@@ -46,6 +50,13 @@ public:
       */
     CReporterHandledRichCore(const QString &filePath);
 
+    /*!
+      * @brief Restores a handled rich-core from the daemon snapshot.
+      *
+      * @param record Persisted duplicate counter.
+      */
+    CReporterHandledRichCore(const CReporterDuplicateRecord &record);
+
     ~CReporterHandledRichCore();
 
     /*!
@@ -145,8 +156,29 @@ private:
      */
     bool checkForDuplicates(const QString &path);
 
+    /*!
+     * Checks a new report for duplicates and notifies the user about it.
+     *
+     * @param filePath File path of the report.
+     * @param trace Trace of the report, updated as it is handled.
+     * @return @c true if the report should be uploaded.
+     */
+    bool handleRichCore(const QString &filePath, CReporterTrace *trace);
+
+    /*!
+     * Hands all stored reports over to the auto uploader, if the network
+     * may be used.
+     *
+     * @param traces Traces of the reports that triggered the upload.
+     */
+    void requestUpload(const QHash<QString, CReporterTrace> &traces);
+
 private slots:
     void onSetAutoUploadChanged();
+
+#ifdef CREPORTER_UNIT_TEST
+    friend class Bm_DaemonMonitor;
+#endif
 };
 
 #endif // CREPORTERDAEMONMONITOR_P_H
@@ -0,0 +1,219 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creporterdaemonsnapshot.h"
+
+#include <sys/stat.h>
+#include <time.h>
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+const quint32 SnapshotMagic = 0x43524453; // "CRDS"
+//! Increment whenever the layout changes, older snapshots are then ignored.
+const quint32 SnapshotVersion = 1;
+/*! Directories modified more recently aren't recorded. Timestamps are as
+ * coarse as the kernel tick, a later change could leave them unchanged. */
+const qint64 ModificationSettleNs = 1000000000;
+
+qint64 realTimeNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+}
+
+CReporterDaemonSnapshot::CReporterDaemonSnapshot()
+{
+}
+
+bool CReporterDaemonSnapshot::load(const QString &path)
+{
+    m_directories.clear();
+    m_records.clear();
+    m_duplicates.clear();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != SnapshotMagic || version != SnapshotVersion) {
+        qCDebug(cr) << "Ignoring snapshot" << path << "of version" << version;
+        return false;
+    }
+
+    QList<DirectoryState> directories;
+    quint32 count = 0;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        DirectoryState state;
+        in >> state.path >> state.device >> state.inode >> state.linkCount
+           >> state.modifiedNs;
+        directories << state;
+    }
+
+    CReporterCoreRecordList records;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        CReporterCoreRecord record;
+        in >> record.filePath >> record.size >> record.modified
+           >> record.applicationName >> record.signal >> record.pid
+           >> record.reportClass >> record.uploadState;
+        records << record;
+    }
+
+    CReporterDuplicateRecordList duplicates;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        CReporterDuplicateRecord duplicate;
+        in >> duplicate.applicationName >> duplicate.signal >> duplicate.count
+           >> duplicate.lastCountReset;
+        duplicates << duplicate;
+    }
+
+    if (in.status() != QDataStream::Ok || !in.atEnd()) {
+        qCWarning(cr) << "Snapshot" << path << "is corrupt.";
+        return false;
+    }
+
+    m_directories = directories;
+    m_records = records;
+    m_duplicates = duplicates;
+    return true;
+}
+
+bool CReporterDaemonSnapshot::save(const QString &path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(cr) << "Can't write snapshot" << path << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_6);
+
+    out << SnapshotMagic << SnapshotVersion;
+
+    out << quint32(m_directories.size());
+    foreach (const DirectoryState &state, m_directories) {
+        out << state.path << state.device << state.inode << state.linkCount
+            << state.modifiedNs;
+    }
+
+    out << quint32(m_records.size());
+    foreach (const CReporterCoreRecord &record, m_records) {
+        out << record.filePath << record.size << record.modified
+            << record.applicationName << record.signal << record.pid
+            << record.reportClass << record.uploadState;
+    }
+
+    out << quint32(m_duplicates.size());
+    foreach (const CReporterDuplicateRecord &duplicate, m_duplicates) {
+        out << duplicate.applicationName << duplicate.signal << duplicate.count
+            << duplicate.lastCountReset;
+    }
+
+    return file.commit();
+}
+
+void CReporterDaemonSnapshot::setDirectories(const QStringList &corePaths)
+{
+    m_directories.clear();
+    qint64 now = realTimeNs();
+    foreach (const QString &path, corePaths) {
+        DirectoryState state;
+        if (directoryState(path, &state) && now - state.modifiedNs > ModificationSettleNs) {
+            m_directories << state;
+        }
+    }
+}
+
+bool CReporterDaemonSnapshot::isCurrent(const QStringList &corePaths) const
+{
+    if (corePaths.size() != m_directories.size()) {
+        return false;
+    }
+
+    for (int i = 0; i < corePaths.size(); ++i) {
+        const DirectoryState &saved = m_directories.at(i);
+        DirectoryState current;
+        if (!directoryState(corePaths.at(i), &current) ||
+                current.path != saved.path ||
+                current.device != saved.device ||
+                current.inode != saved.inode ||
+                current.linkCount != saved.linkCount ||
+                current.modifiedNs != saved.modifiedNs) {
+            qCDebug(cr) << "Core directory" << corePaths.at(i) << "changed since the snapshot.";
+            return false;
+        }
+    }
+    return true;
+}
+
+CReporterCoreRecordList CReporterDaemonSnapshot::records() const
+{
+    return m_records;
+}
+
+void CReporterDaemonSnapshot::setRecords(const CReporterCoreRecordList &records)
+{
+    m_records = records;
+}
+
+CReporterDuplicateRecordList CReporterDaemonSnapshot::duplicates() const
+{
+    return m_duplicates;
+}
+
+void CReporterDaemonSnapshot::setDuplicates(const CReporterDuplicateRecordList &duplicates)
+{
+    m_duplicates = duplicates;
+}
+
+bool CReporterDaemonSnapshot::directoryState(const QString &path, DirectoryState *state)
+{
+    struct stat st;
+    if (stat(QFile::encodeName(path).constData(), &st) != 0) {
+        return false;
+    }
+
+    state->path = path;
+    state->device = st.st_dev;
+    state->inode = st.st_ino;
+    state->linkCount = st.st_nlink;
+    state->modifiedNs = qint64(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    return true;
+}
@@ -0,0 +1,116 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERDAEMONSNAPSHOT_H
+#define CREPORTERDAEMONSNAPSHOT_H
+
+#include <QDateTime>
+#include <QList>
+#include <QStringList>
+
+#include "creportercorerecord.h"
+
+/*!
+ * @brief Duplicate counter of a crash kept by the daemon's monitor.
+ */
+struct CReporterDuplicateRecord
+{
+    //! @arg Binary name of the crashed application.
+    QString applicationName;
+    //! @arg Signal the application crashed with.
+    int signal;
+    //! @arg Number of similar crashes handled since the last reset.
+    int count;
+    //! @arg When the counter was last reset.
+    QDateTime lastCountReset;
+};
+
+typedef QList<CReporterDuplicateRecord> CReporterDuplicateRecordList;
+
+/*!
+ * @class CReporterDaemonSnapshot
+ * @brief State of the daemon persisted between its runs.
+ *
+ * The daemon saves its report index and duplicate counters when it exits.
+ * Next time, the index is restored instead of rescanning the core
+ * directories, provided they haven't changed since. A directory is taken
+ * as unchanged if its device, inode, link count and modification time are
+ * the same, which takes one stat() per directory to check.
+ */
+class CReporterDaemonSnapshot
+{
+public:
+    CReporterDaemonSnapshot();
+
+    /*!
+     * @brief Reads the snapshot from a file.
+     *
+     * @return @c false if the file is missing, corrupt or of another version.
+     *  The snapshot is left empty then.
+     */
+    bool load(const QString &path);
+
+    /*!
+     * @brief Writes the snapshot to a file, replacing it atomically.
+     *
+     * @return @c true on success.
+     */
+    bool save(const QString &path) const;
+
+    /*!
+     * @brief Records the current state of the core directories.
+     *
+     * Call it before the index is last refreshed, so that any change
+     * after the refresh invalidates the snapshot. Directories modified
+     * within the last second are left out, since a change in the same
+     * clock tick wouldn't show in their timestamp.
+     */
+    void setDirectories(const QStringList &corePaths);
+
+    /*!
+     * @return @c true if @a corePaths are the directories recorded with
+     *  setDirectories() and none of them has changed since.
+     */
+    bool isCurrent(const QStringList &corePaths) const;
+
+    CReporterCoreRecordList records() const;
+    void setRecords(const CReporterCoreRecordList &records);
+
+    CReporterDuplicateRecordList duplicates() const;
+    void setDuplicates(const CReporterDuplicateRecordList &duplicates);
+
+private:
+    struct DirectoryState {
+        QString path;
+        quint64 device;
+        quint64 inode;
+        quint64 linkCount;
+        qint64 modifiedNs;
+    };
+
+    static bool directoryState(const QString &path, DirectoryState *state);
+
+    QList<DirectoryState> m_directories;
+    CReporterCoreRecordList m_records;
+    CReporterDuplicateRecordList m_duplicates;
+};
+
+#endif // CREPORTERDAEMONSNAPSHOT_H
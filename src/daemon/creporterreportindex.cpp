@@ -0,0 +1,222 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creporterreportindex.h"
+
+#include <sys/stat.h>
+
+#include <QFile>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+
+#include "creportercoreregistry.h"
+#include "creportercrashinfo.h"
+#include "creporternamespace.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+//! Time to let a burst of directory changes settle before a rescan.
+const int RefreshDelay = 200;
+}
+
+class CReporterReportIndexPrivate
+{
+public:
+    CReporterReportIndexPrivate(CReporterReportIndex *q);
+
+    void watchCoreLocations();
+    void scheduleRefresh();
+
+    //! Describes the file once, when it enters the index.
+    static CReporterCoreRecord createRecord(const QString &filePath);
+
+    QFileSystemWatcher watcher;
+    QTimer refreshTimer;
+    QHash<QString, CReporterCoreRecord> records;
+    quint64 generation;
+};
+
+CReporterReportIndexPrivate::CReporterReportIndexPrivate(CReporterReportIndex *q)
+    : generation(0)
+{
+    refreshTimer.setSingleShot(true);
+    refreshTimer.setInterval(RefreshDelay);
+    QObject::connect(&refreshTimer, SIGNAL(timeout()), q, SLOT(refresh()));
+
+    QObject::connect(&watcher, SIGNAL(directoryChanged(const QString &)),
+                     q, SLOT(scheduleRefresh()));
+
+    CReporterCoreRegistry *registry = CReporterCoreRegistry::instance();
+    // Core directories come and go with mass storage mode and memory cards.
+    QObject::connect(registry, SIGNAL(coreLocationsUpdated()),
+                     q, SLOT(watchCoreLocations()));
+    QObject::connect(registry, SIGNAL(registryRefreshNeeded()),
+                     q, SLOT(watchCoreLocations()));
+
+    QStringList corePaths(registry->getCoreLocationPaths());
+    if (!corePaths.isEmpty()) {
+        watcher.addPaths(corePaths);
+    }
+}
+
+CReporterCoreRecord CReporterReportIndexPrivate::createRecord(const QString &filePath)
+{
+    CReporterCoreRecord record;
+    record.filePath = filePath;
+
+    struct stat st;
+    if (stat(QFile::encodeName(filePath).constData(), &st) == 0) {
+        record.size = st.st_size;
+        record.modified = qint64(st.st_mtim.tv_sec) * 1000 + st.st_mtim.tv_nsec / 1000000;
+    }
+
+    CReporterCrashInfo info(CReporterCoreRegistry::instance()->crashInfo(filePath));
+    record.applicationName = info.applicationName().toString();
+    record.signal = info.signal();
+    record.pid = info.pid();
+    record.reportClass = info.reportClass();
+
+    return record;
+}
+
+void CReporterReportIndexPrivate::watchCoreLocations()
+{
+    QStringList corePaths(CReporterCoreRegistry::instance()->getCoreLocationPaths());
+    int watched = watcher.directories().size();
+    if (!corePaths.isEmpty()) {
+        // Paths that don't exist or are already watched are skipped.
+        watcher.addPaths(corePaths);
+    }
+
+    /* Changes in directories watched all along were already seen. Rescan
+     * only when a directory (re)appeared, e.g. after mass storage mode. */
+    if (watcher.directories().size() > watched) {
+        scheduleRefresh();
+    }
+}
+
+void CReporterReportIndexPrivate::scheduleRefresh()
+{
+    if (!refreshTimer.isActive()) {
+        refreshTimer.start();
+    }
+}
+
+CReporterReportIndex::CReporterReportIndex(QObject *parent)
+    : QObject(parent), d_ptr(new CReporterReportIndexPrivate(this))
+{
+    Q_D(CReporterReportIndex);
+
+    foreach (const QString &filePath, CReporterCoreRegistry::instance()->collectAllCoreFiles()) {
+        d->records.insert(filePath, CReporterReportIndexPrivate::createRecord(filePath));
+    }
+}
+
+CReporterReportIndex::CReporterReportIndex(const CReporterCoreRecordList &records, QObject *parent)
+    : QObject(parent), d_ptr(new CReporterReportIndexPrivate(this))
+{
+    Q_D(CReporterReportIndex);
+
+    foreach (const CReporterCoreRecord &record, records) {
+        d->records.insert(record.filePath, record);
+    }
+}
+
+CReporterReportIndex::~CReporterReportIndex()
+{
+}
+
+QStringList CReporterReportIndex::reports() const
+{
+    Q_D(const CReporterReportIndex);
+
+    return d->records.keys();
+}
+
+CReporterCoreRecordList CReporterReportIndex::records() const
+{
+    Q_D(const CReporterReportIndex);
+
+    return d->records.values();
+}
+
+int CReporterReportIndex::setUploadQueued(const QStringList &filePaths)
+{
+    Q_D(CReporterReportIndex);
+
+    int requeued = 0;
+    foreach (const QString &filePath, filePaths) {
+        QHash<QString, CReporterCoreRecord>::iterator it = d->records.find(filePath);
+        if (it != d->records.end()) {
+            if (it->uploadState == CReporterCoreRecord::UploadQueued) {
+                ++requeued;
+            }
+            it->uploadState = CReporterCoreRecord::UploadQueued;
+        }
+    }
+    return requeued;
+}
+
+quint64 CReporterReportIndex::generation() const
+{
+    Q_D(const CReporterReportIndex);
+
+    return d->generation;
+}
+
+void CReporterReportIndex::refresh()
+{
+    Q_D(CReporterReportIndex);
+
+    d->refreshTimer.stop();
+
+    QSet<QString> current;
+    foreach (const QString &filePath,
+             CReporterCoreRegistry::instance()->collectAllCoreFiles()) {
+        current.insert(filePath);
+    }
+
+    QHash<QString, CReporterCoreRecord>::iterator it = d->records.begin();
+    while (it != d->records.end()) {
+        if (current.contains(it.key())) {
+            ++it;
+            continue;
+        }
+        QString filePath(it.key());
+        it = d->records.erase(it);
+        emit reportRemoved(filePath, ++d->generation);
+    }
+
+    foreach (const QString &filePath, current) {
+        if (!d->records.contains(filePath)) {
+            d->records.insert(filePath, CReporterReportIndexPrivate::createRecord(filePath));
+            emit reportAdded(filePath, ++d->generation);
+        }
+    }
+
+    qCDebug(cr) << "Report index has" << d->records.size()
+                << "reports, generation" << d->generation;
+}
+
+#include "moc_creporterreportindex.cpp"
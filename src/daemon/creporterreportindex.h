@@ -0,0 +1,100 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERREPORTINDEX_H
+#define CREPORTERREPORTINDEX_H
+
+#include <QObject>
+#include <QStringList>
+
+#include "creportercorerecord.h"
+
+class CReporterReportIndexPrivate;
+
+/*!
+ * @class CReporterReportIndex
+ * @brief Keeps the list of rich core files pending in the core directories.
+ *
+ * The core directories are watched and rescanned once a burst of changes
+ * settles. Every added or removed report bumps a generation counter, which
+ * lets clients mirroring the index over D-Bus detect a missed change.
+ */
+class CReporterReportIndex: public QObject
+{
+    Q_OBJECT
+
+public:
+    /*!
+     * @brief Creates the index by scanning the core directories.
+     */
+    CReporterReportIndex(QObject *parent = 0);
+
+    /*!
+     * @brief Creates the index from records known to be current, e.g. ones
+     * restored from a CReporterDaemonSnapshot, without scanning.
+     */
+    CReporterReportIndex(const CReporterCoreRecordList &records, QObject *parent = 0);
+    ~CReporterReportIndex();
+
+    /*!
+     * @return Paths of all indexed reports.
+     */
+    QStringList reports() const;
+
+    /*!
+     * @return Descriptions of all indexed reports, in no particular order.
+     */
+    CReporterCoreRecordList records() const;
+
+    /*!
+     * @brief Marks reports as handed over to the uploader.
+     *
+     * @param filePaths Paths of the reports, ones not in the index are ignored.
+     * @return Number of the reports that had been handed over before, i.e.
+     *  whose earlier upload didn't succeed.
+     */
+    int setUploadQueued(const QStringList &filePaths);
+
+    /*!
+     * @return Generation of the index, incremented with every change.
+     */
+    quint64 generation() const;
+
+public Q_SLOTS:
+    /*!
+     * @brief Rescans the core directories immediately.
+     */
+    void refresh();
+
+Q_SIGNALS:
+    void reportAdded(const QString &filePath, quint64 generation);
+    void reportRemoved(const QString &filePath, quint64 generation);
+
+private:
+    Q_DISABLE_COPY(CReporterReportIndex)
+    Q_DECLARE_PRIVATE(CReporterReportIndex)
+    QScopedPointer<CReporterReportIndexPrivate> d_ptr;
+
+    Q_PRIVATE_SLOT(d_func(), void watchCoreLocations())
+    Q_PRIVATE_SLOT(d_func(), void scheduleRefresh())
+};
+
+#endif // CREPORTERREPORTINDEX_H
@@ -29,7 +29,6 @@ TARGET = crash-reporter-daemon
 CONFIG += link_pkgconfig
 
 PKGCONFIG += \
-    libudev \
     nemonotifications-qt5
 
 packagesExist(qt5-boostable) {
@@ -61,14 +60,16 @@ SOURCES += main.cpp \
            creporterdaemon.cpp \
            creporterdaemonadaptor.cpp \
            creporterdaemonmonitor.cpp \
-           powerexcesshandler.cpp \
+           creporterdaemonsnapshot.cpp \
+           creporterreportindex.cpp \
 
 HEADERS += creporterdaemon.h \
            creporterdaemon_p.h \
            creporterdaemonadaptor.h \
            creporterdaemonmonitor.h \
            creporterdaemonmonitor_p.h \
-           powerexcesshandler.h \
+           creporterdaemonsnapshot.h \
+           creporterreportindex.h \
 
 service.files = com.nokia.CrashReporter.Daemon.service
 service.path = $$CREPORTER_SYSTEM_DBUS_SERVICES
@@ -36,45 +36,12 @@
 #include "creporternamespace.h"
 #include "creporterapplicationsettings.h"
 #include "creporterlogger.h"
+#include "creporterstats.h"
 
 using CReporter::LoggingCategory::cr;
 
-#define CREPORTER_PID_FILE      "/tmp/crash-reporter-daemon.pid"
-#define CREPORTER_STARTUP_DELAY 30000 // 30 sec timer to delay start up
 #define LOG_FILE    "/tmp/crash-reporter-daemon.log"
 
-/*!
- * @brief Gets crash-reporter-daemon pid and saves it to file.
- *
- * @param app Reference to application.
- * @return True, if first startup; otherwise false.
- */
-bool getPid(QCoreApplication &app)
-{
-    QFile pidFile(CREPORTER_PID_FILE);
-    qint64 pid = 0;
-    bool firstStartup = true;
-
-    // Get new PID.
-    pid = app.applicationPid();
-    qCDebug(cr) << CReporter::DaemonBinaryName << "[" << pid << "] starting...";
-
-    if (pidFile.exists()) {
-        firstStartup = false;
-        qCDebug(cr) << "Removing stale PID file.";
-        pidFile.remove();
-    }
-
-    if (pidFile.open(QIODevice::WriteOnly)) {
-        QTextStream out(&pidFile);
-        out << pid;
-        pidFile.close();
-    }
-
-    qCDebug(cr) << "Startup delayed =" << firstStartup;
-    return firstStartup;
-}
-
 void signalHandler(int signal)
 {
     Q_UNUSED(signal)
@@ -99,17 +66,23 @@ Q_DECL_EXPORT int main(int argc, char **argv)
     translator->load(QLocale(), "crash-reporter", "/usr/share/translations");
     app.installTranslator(translator);
 
-    bool firstStartup = getPid(app);
+    qCDebug(cr) << CReporter::DaemonBinaryName << "[" << app.applicationPid() << "] starting...";
+
+    QString statsDir(CReporterApplicationSettings::instance()->prometheusTextfileDir());
+    if (!statsDir.isEmpty()) {
+        CReporterStats::instance()->setTextfilePath(statsDir + "/" + app.applicationName() + ".prom");
+    }
 
     CReporterDaemon daemon;
 
-    if (firstStartup) {
-        // If no PID file was found, delay startup.
-        daemon.setDelayedStartup(CREPORTER_STARTUP_DELAY);
-    } else if (!daemon.initiateDaemon()) {
+    /* When started by the path unit or D-Bus activation, exit once idle.
+     * The report index is persisted and restored on the next start. */
+    if (app.arguments().contains("--on-demand")) {
+        daemon.setIdleTimeout(CReporterApplicationSettings::instance()->idleTimeout() * 1000);
+    }
+
+    if (!daemon.initiateDaemon()) {
         // Connecting to D-BUS user session most propably failed.
-        // Remove PID file (to delay next startup) and quit application.
-        QFile::remove(CREPORTER_PID_FILE);
         return EXIT_FAILURE;
     }
 
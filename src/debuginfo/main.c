@@ -0,0 +1,284 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+/*
+ * crash-reporter-debuginfo manages the debuginfo cache that the dumper
+ * uses for unwinding when DOWNLOAD_DEBUGINFO is on (see debuginfocache.h).
+ *
+ *   import DIR...  adds the debuginfo files found under the directories,
+ *                  e.g. an unpacked -debuginfo package
+ *   list           prints the files in the cache
+ *   trim           evicts files above the size limit
+ */
+
+#define _GNU_SOURCE /* for nftw() */
+
+#include <fcntl.h>
+#include <ftw.h>
+#include <gelf.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "debuginfocache.h"
+
+#ifndef NT_GNU_BUILD_ID
+#define NT_GNU_BUILD_ID 3
+#endif
+
+struct found_file {
+    unsigned char build_id[DEBUGINFO_MAX_BUILD_ID];
+    size_t build_id_len;
+    char *path;
+};
+
+static struct found_file *found;
+static size_t found_count;
+static size_t found_size;
+
+/* Reads the build-id of an ELF file that has debugging information or a
+ * symbol table. Returns its length, 0 if the file isn't such a file. */
+static size_t read_build_id(const char *path, unsigned char *build_id)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return 0;
+    }
+
+    size_t build_id_len = 0;
+    int has_debug = 0;
+    size_t shstrndx;
+    Elf *elf = elf_begin(fd, ELF_C_READ_MMAP, NULL);
+    if (elf && elf_kind(elf) == ELF_K_ELF && elf_getshdrstrndx(elf, &shstrndx) == 0) {
+        Elf_Scn *scn = NULL;
+        while ((scn = elf_nextscn(elf, scn)) != NULL) {
+            GElf_Shdr shdr;
+            if (!gelf_getshdr(scn, &shdr) || shdr.sh_type == SHT_NOBITS) {
+                continue;
+            }
+
+            const char *name = elf_strptr(elf, shstrndx, shdr.sh_name);
+            if (name && (strcmp(name, ".debug_info") == 0 ||
+                         strcmp(name, ".debug_frame") == 0 ||
+                         strcmp(name, ".symtab") == 0)) {
+                has_debug = 1;
+            }
+
+            if (shdr.sh_type != SHT_NOTE) {
+                continue;
+            }
+            Elf_Data *data = elf_getdata(scn, NULL);
+            GElf_Nhdr nhdr;
+            size_t offset = 0;
+            size_t name_offset;
+            size_t desc_offset;
+            while (data && (offset = gelf_getnote(data, offset, &nhdr, &name_offset,
+                                                  &desc_offset)) > 0) {
+                if (nhdr.n_type == NT_GNU_BUILD_ID && nhdr.n_namesz == 4 &&
+                    memcmp((const char *)data->d_buf + name_offset, "GNU", 4) == 0 &&
+                    nhdr.n_descsz > 0 && nhdr.n_descsz <= DEBUGINFO_MAX_BUILD_ID) {
+                    memcpy(build_id, (const char *)data->d_buf + desc_offset,
+                           nhdr.n_descsz);
+                    build_id_len = nhdr.n_descsz;
+                }
+            }
+        }
+    }
+    if (elf) {
+        elf_end(elf);
+    }
+    close(fd);
+
+    return has_debug ? build_id_len : 0;
+}
+
+static int visit(const char *path, const struct stat *st, int type, struct FTW *ftw)
+{
+    (void)st;
+    (void)ftw;
+
+    if (type != FTW_F) {
+        return 0;
+    }
+
+    unsigned char build_id[DEBUGINFO_MAX_BUILD_ID];
+    size_t build_id_len = read_build_id(path, build_id);
+    if (build_id_len == 0) {
+        return 0;
+    }
+
+    if (found_count == found_size) {
+        size_t size = found_size ? found_size * 2 : 64;
+        struct found_file *files = realloc(found, size * sizeof(struct found_file));
+        if (!files) {
+            return -1;
+        }
+        found = files;
+        found_size = size;
+    }
+    struct found_file *file = &found[found_count];
+    memcpy(file->build_id, build_id, build_id_len);
+    file->build_id_len = build_id_len;
+    file->path = strdup(path);
+    if (!file->path) {
+        return -1;
+    }
+    ++found_count;
+
+    return 0;
+}
+
+static int import(struct debuginfo_cache *cache, char **dirs, int count, uint64_t max_size)
+{
+    elf_version(EV_CURRENT);
+
+    int i;
+    for (i = 0; i != count; ++i) {
+        /* Symlinks, such as those in .build-id directories, aren't
+         * followed; the files they point to are found anyway. */
+        if (nftw(dirs[i], visit, 16, FTW_PHYS) != 0) {
+            fprintf(stderr, "Couldn't search %s\n", dirs[i]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct debuginfo_file *files = calloc(found_count + 1, sizeof(struct debuginfo_file));
+    if (!files) {
+        return EXIT_FAILURE;
+    }
+    size_t f;
+    for (f = 0; f != found_count; ++f) {
+        files[f].build_id = found[f].build_id;
+        files[f].build_id_len = found[f].build_id_len;
+        files[f].path = found[f].path;
+    }
+
+    int added = debuginfo_cache_add(cache, files, found_count, max_size);
+    free(files);
+    if (added < 0) {
+        fprintf(stderr, "Couldn't update the cache in %s\n", cache->dir);
+        return EXIT_FAILURE;
+    }
+
+    printf("Added %d of %zu debuginfo files, %zu files in the cache.\n", added,
+           found_count, debuginfo_cache_count(cache));
+    return EXIT_SUCCESS;
+}
+
+static int list(struct debuginfo_cache *cache)
+{
+    size_t count = debuginfo_cache_count(cache);
+    size_t i;
+    for (i = 0; i != count; ++i) {
+        struct debuginfo_entry entry;
+        debuginfo_cache_entry(cache, i, &entry);
+
+        char build_id[2 * DEBUGINFO_MAX_BUILD_ID + 1];
+        size_t b;
+        for (b = 0; b != entry.build_id_len; ++b) {
+            sprintf(build_id + 2 * b, "%02x", entry.build_id[b]);
+        }
+
+        char date[32];
+        time_t last_used = entry.last_used / 1000;
+        struct tm tm;
+        strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", localtime_r(&last_used, &tm));
+
+        printf("%s %12llu %s\n", build_id, (unsigned long long)entry.size, date);
+    }
+
+    printf("%zu files, %llu of %llu bytes used.\n", count,
+           (unsigned long long)debuginfo_cache_total_size(cache),
+           (unsigned long long)debuginfo_cache_max_size(cache));
+    return EXIT_SUCCESS;
+}
+
+static void print_usage()
+{
+    fprintf(stderr, "usage: crash-reporter-debuginfo [--cache-dir=DIR] [--max-size=MB] "
+            "import DIR...\n"
+            "       crash-reporter-debuginfo [--cache-dir=DIR] [--max-size=MB] trim\n"
+            "       crash-reporter-debuginfo [--cache-dir=DIR] list\n");
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option options[] = {
+        { "cache-dir", required_argument, NULL, 'd' },
+        { "max-size", required_argument, NULL, 'm' },
+        { NULL, 0, NULL, 0 }
+    };
+
+    const char *dir = DEBUGINFO_CACHE_DIR;
+    uint64_t max_size = 0;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (opt) {
+        case 'd':
+            dir = optarg;
+            break;
+        case 'm':
+            max_size = strtoull(optarg, NULL, 10) * 1024 * 1024;
+            if (max_size == 0) {
+                print_usage();
+                return EXIT_FAILURE;
+            }
+            break;
+        default:
+            print_usage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (optind == argc) {
+        print_usage();
+        return EXIT_FAILURE;
+    }
+    const char *command = argv[optind++];
+    int writable = strcmp(command, "list") != 0;
+
+    struct debuginfo_cache cache;
+    if (debuginfo_cache_open(&cache, dir, writable) != 0) {
+        return EXIT_FAILURE;
+    }
+
+    int result = EXIT_FAILURE;
+    if (strcmp(command, "import") == 0 && optind < argc) {
+        result = import(&cache, argv + optind, argc - optind, max_size);
+    } else if (strcmp(command, "trim") == 0 && optind == argc) {
+        if (debuginfo_cache_add(&cache, NULL, 0, max_size) >= 0) {
+            result = list(&cache);
+        } else {
+            fprintf(stderr, "Couldn't update the cache in %s\n", dir);
+        }
+    } else if (strcmp(command, "list") == 0 && optind == argc) {
+        result = list(&cache);
+    } else {
+        print_usage();
+    }
+
+    debuginfo_cache_close(&cache);
+    return result;
+}
@@ -0,0 +1,621 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#include "corereducer.h"
+
+#include <elf.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syslog.h>
+#include <unistd.h>
+
+/* Kept below the stack pointer, for the red zone and frames being set up. */
+#define STACK_BELOW_SP 4096
+#define STACK_ABOVE_SP (256 * 1024)
+/* Kept from the start of larger read-only segments, enough for the ELF
+ * headers and the build-id note of a module. */
+#define MODULE_HEADER_SIZE 4096
+/* Read-only segments up to this size are kept whole (vDSO, vectors). */
+#define SMALL_SEGMENT_SIZE (64 * 1024)
+#define PIECE_ALIGN 16
+
+#define MAX_THREADS 4096
+#define MAX_PREFIX_SIZE (16 * 1024 * 1024)
+#define COPY_BUFFER_SIZE (64 * 1024)
+
+#ifndef EM_AARCH64
+#define EM_AARCH64 183
+#endif
+
+/* Where the stack pointer is in NT_PRSTATUS. pr_reg starts at 72 bytes on
+ * 32-bit and at 112 bytes on 64-bit architectures. */
+static const struct {
+    int machine;
+    int is64;
+    size_t sp_offset;
+} architectures[] = {
+    { EM_ARM, 0, 72 + 13 * 4 },
+    { EM_386, 0, 72 + 15 * 4 },
+    { EM_X86_64, 1, 112 + 19 * 8 },
+    { EM_AARCH64, 1, 112 + 31 * 8 },
+};
+
+struct piece {
+    uint64_t vaddr;
+    uint64_t offset;
+    uint64_t len;
+    uint32_t flags;
+    uint64_t align;
+};
+
+struct reducer {
+    int fd;
+    core_write_fn write;
+    void *context;
+    struct core_reducer_stats *stats;
+
+    /* Everything read before deciding whether the core can be reduced. */
+    unsigned char *prefix;
+    size_t prefix_len;
+    uint64_t pos;
+
+    int is64;
+    size_t sp_offset;
+    Elf64_Ehdr ehdr;
+    Elf64_Phdr *phdrs;
+
+    uint64_t sps[MAX_THREADS];
+    int sp_count;
+
+    struct piece *pieces;
+    size_t piece_count;
+    size_t piece_size;
+};
+
+static int read_input(struct reducer *r, void *buf, size_t len)
+{
+    unsigned char *p = buf;
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = read(r->fd, p + done, len - done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0) {
+            return -1;
+        } else if (n == 0) {
+            break;
+        }
+        done += n;
+    }
+    r->pos += done;
+    return done;
+}
+
+static int emit(struct reducer *r, const void *data, size_t len)
+{
+    if (r->write(r->context, data, len) != 0) {
+        return -1;
+    }
+    r->stats->output_size += len;
+    return 0;
+}
+
+static int emit_zeros(struct reducer *r, uint64_t len)
+{
+    static const unsigned char zeros[4096];
+    while (len > 0) {
+        size_t chunk = len < sizeof(zeros) ? len : sizeof(zeros);
+        if (emit(r, zeros, chunk) != 0) {
+            return -1;
+        }
+        len -= chunk;
+    }
+    return 0;
+}
+
+/* Copies or skips input up to offset, then copies len bytes to the output.
+ * A truncated core is padded with zeros to keep the headers valid. */
+static int copy_input(struct reducer *r, uint64_t offset, uint64_t len)
+{
+    static unsigned char buf[COPY_BUFFER_SIZE];
+
+    if (r->pos > offset) {
+        return -1;
+    }
+    while (r->pos < offset) {
+        uint64_t chunk = offset - r->pos;
+        int n = read_input(r, buf, chunk < sizeof(buf) ? chunk : sizeof(buf));
+        if (n < 0) {
+            return -1;
+        } else if (n == 0) {
+            return emit_zeros(r, len);
+        }
+    }
+
+    while (len > 0) {
+        int n = read_input(r, buf, len < sizeof(buf) ? len : sizeof(buf));
+        if (n < 0) {
+            return -1;
+        } else if (n == 0) {
+            return emit_zeros(r, len);
+        }
+        if (emit(r, buf, n) != 0) {
+            return -1;
+        }
+        len -= n;
+    }
+
+    return 0;
+}
+
+/* Reads the rest of the core; the kernel waits until it's all consumed. */
+static int drain_input(struct reducer *r)
+{
+    static unsigned char buf[COPY_BUFFER_SIZE];
+    int n;
+    while ((n = read_input(r, buf, sizeof(buf))) > 0) {
+    }
+    return n;
+}
+
+static int copy_unreduced(struct reducer *r)
+{
+    static unsigned char buf[COPY_BUFFER_SIZE];
+    int n;
+
+    if (emit(r, r->prefix, r->prefix_len) != 0) {
+        return -1;
+    }
+    while ((n = read_input(r, buf, sizeof(buf))) > 0) {
+        if (emit(r, buf, n) != 0) {
+            return -1;
+        }
+    }
+    return n < 0 ? -1 : 1;
+}
+
+static int read_prefix(struct reducer *r, size_t len)
+{
+    if (len <= r->prefix_len) {
+        return 0;
+    }
+    unsigned char *prefix = realloc(r->prefix, len);
+    if (!prefix) {
+        return -1;
+    }
+    r->prefix = prefix;
+
+    int n = read_input(r, r->prefix + r->prefix_len, len - r->prefix_len);
+    if (n < 0) {
+        return -1;
+    }
+    r->prefix_len += n;
+    return r->prefix_len == len ? 0 : -1;
+}
+
+/* Returns 0 when the headers describe a core we can reduce. */
+static int parse_headers(struct reducer *r)
+{
+    if (read_prefix(r, EI_NIDENT) != 0 ||
+        memcmp(r->prefix, ELFMAG, SELFMAG) != 0) {
+        return -1;
+    }
+
+    r->is64 = r->prefix[EI_CLASS] == ELFCLASS64;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (r->prefix[EI_DATA] != ELFDATA2LSB) {
+#else
+    if (r->prefix[EI_DATA] != ELFDATA2MSB) {
+#endif
+        return -1;
+    }
+
+    if (r->is64) {
+        if (read_prefix(r, sizeof(Elf64_Ehdr)) != 0) {
+            return -1;
+        }
+        memcpy(&r->ehdr, r->prefix, sizeof(Elf64_Ehdr));
+    } else {
+        Elf32_Ehdr ehdr;
+        if (r->prefix[EI_CLASS] != ELFCLASS32 || read_prefix(r, sizeof(ehdr)) != 0) {
+            return -1;
+        }
+        memcpy(&ehdr, r->prefix, sizeof(ehdr));
+        memcpy(r->ehdr.e_ident, ehdr.e_ident, EI_NIDENT);
+        r->ehdr.e_type = ehdr.e_type;
+        r->ehdr.e_machine = ehdr.e_machine;
+        r->ehdr.e_version = ehdr.e_version;
+        r->ehdr.e_phoff = ehdr.e_phoff;
+        r->ehdr.e_flags = ehdr.e_flags;
+        r->ehdr.e_ehsize = ehdr.e_ehsize;
+        r->ehdr.e_phentsize = ehdr.e_phentsize;
+        r->ehdr.e_phnum = ehdr.e_phnum;
+    }
+
+    size_t phentsize = r->is64 ? sizeof(Elf64_Phdr) : sizeof(Elf32_Phdr);
+    if (r->ehdr.e_type != ET_CORE || r->ehdr.e_phentsize != phentsize ||
+        r->ehdr.e_phnum == 0 || r->ehdr.e_phnum == PN_XNUM ||
+        r->ehdr.e_phoff + (uint64_t)r->ehdr.e_phnum * phentsize > MAX_PREFIX_SIZE) {
+        return -1;
+    }
+
+    size_t i;
+    r->sp_offset = 0;
+    for (i = 0; i != sizeof(architectures) / sizeof(architectures[0]); ++i) {
+        if (architectures[i].machine == r->ehdr.e_machine &&
+            architectures[i].is64 == r->is64) {
+            r->sp_offset = architectures[i].sp_offset;
+        }
+    }
+    if (r->sp_offset == 0) {
+        syslog(LOG_INFO, "Can't reduce cores of machine type %d.", r->ehdr.e_machine);
+        return -1;
+    }
+
+    if (read_prefix(r, r->ehdr.e_phoff + r->ehdr.e_phnum * phentsize) != 0) {
+        return -1;
+    }
+
+    r->phdrs = calloc(r->ehdr.e_phnum, sizeof(Elf64_Phdr));
+    if (!r->phdrs) {
+        return -1;
+    }
+    for (i = 0; i != r->ehdr.e_phnum; ++i) {
+        const unsigned char *p = r->prefix + r->ehdr.e_phoff + i * phentsize;
+        if (r->is64) {
+            memcpy(&r->phdrs[i], p, sizeof(Elf64_Phdr));
+        } else {
+            Elf32_Phdr phdr;
+            memcpy(&phdr, p, sizeof(phdr));
+            r->phdrs[i].p_type = phdr.p_type;
+            r->phdrs[i].p_flags = phdr.p_flags;
+            r->phdrs[i].p_offset = phdr.p_offset;
+            r->phdrs[i].p_vaddr = phdr.p_vaddr;
+            r->phdrs[i].p_filesz = phdr.p_filesz;
+            r->phdrs[i].p_memsz = phdr.p_memsz;
+            r->phdrs[i].p_align = phdr.p_align;
+        }
+    }
+
+    /* Notes must come before any segment data for a single pass. */
+    uint64_t notes_end = 0;
+    uint64_t loads_start = UINT64_MAX;
+    for (i = 0; i != r->ehdr.e_phnum; ++i) {
+        const Elf64_Phdr *phdr = &r->phdrs[i];
+        if (phdr->p_type == PT_NOTE && phdr->p_offset + phdr->p_filesz > notes_end) {
+            notes_end = phdr->p_offset + phdr->p_filesz;
+        } else if (phdr->p_type == PT_LOAD && phdr->p_filesz > 0 &&
+                   phdr->p_offset < loads_start) {
+            loads_start = phdr->p_offset;
+        }
+    }
+    if (notes_end > loads_start || r->prefix_len > loads_start ||
+        notes_end > MAX_PREFIX_SIZE ||
+        read_prefix(r, notes_end) != 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+static void parse_notes(struct reducer *r, const Elf64_Phdr *phdr)
+{
+    const unsigned char *p = r->prefix + phdr->p_offset;
+    const unsigned char *end = p + phdr->p_filesz;
+    size_t reg_size = r->is64 ? 8 : 4;
+
+    while (p + sizeof(Elf32_Nhdr) <= end) {
+        Elf32_Nhdr nhdr;
+        memcpy(&nhdr, p, sizeof(nhdr));
+        p += sizeof(nhdr);
+
+        const unsigned char *desc = p + ((nhdr.n_namesz + 3) & ~3u);
+        p = desc + ((nhdr.n_descsz + 3) & ~3u);
+        if (p > end || desc > end) {
+            break;
+        }
+
+        if (nhdr.n_type == NT_PRSTATUS && nhdr.n_descsz >= r->sp_offset + reg_size &&
+            r->sp_count < MAX_THREADS) {
+            uint64_t sp = 0;
+            if (r->is64) {
+                memcpy(&sp, desc + r->sp_offset, 8);
+            } else {
+                uint32_t sp32;
+                memcpy(&sp32, desc + r->sp_offset, 4);
+                sp = sp32;
+            }
+            r->sps[r->sp_count++] = sp;
+        }
+    }
+}
+
+static uint64_t align_up(uint64_t value, uint64_t align)
+{
+    return (value + align - 1) & ~(align - 1);
+}
+
+static int add_piece(struct reducer *r, const Elf64_Phdr *phdr, uint64_t start,
+                     uint64_t end)
+{
+    /* Readers such as libdwfl round segment bounds to the page size, so the
+     * pieces must start and end at page boundaries too. */
+    uint64_t page = phdr->p_align;
+    if (page > 1 && (page & (page - 1)) == 0) {
+        start &= ~(page - 1);
+        end = align_up(end, page);
+        if (start < phdr->p_vaddr) {
+            start = phdr->p_vaddr;
+        }
+        if (end > phdr->p_vaddr + phdr->p_filesz) {
+            end = phdr->p_vaddr + phdr->p_filesz;
+        }
+    }
+
+    /* Windows of threads sharing a stack segment can overlap. */
+    if (r->piece_count > 0) {
+        struct piece *last = &r->pieces[r->piece_count - 1];
+        if (last->vaddr + last->len >= start && last->flags == phdr->p_flags &&
+            last->vaddr <= start && last->offset - last->vaddr == phdr->p_offset - phdr->p_vaddr) {
+            if (end > last->vaddr + last->len) {
+                last->len = end - last->vaddr;
+            }
+            return 0;
+        }
+    }
+
+    if (r->piece_count == r->piece_size) {
+        size_t size = r->piece_size ? 2 * r->piece_size : 64;
+        struct piece *pieces = realloc(r->pieces, size * sizeof(struct piece));
+        if (!pieces) {
+            return -1;
+        }
+        r->pieces = pieces;
+        r->piece_size = size;
+    }
+
+    struct piece *piece = &r->pieces[r->piece_count++];
+    piece->vaddr = start;
+    piece->offset = phdr->p_offset + (start - phdr->p_vaddr);
+    piece->len = end - start;
+    piece->flags = phdr->p_flags;
+    piece->align = phdr->p_align;
+    return 0;
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static int compare_offsets(const void *a, const void *b)
+{
+    const Elf64_Phdr *x = *(const Elf64_Phdr * const *)a;
+    const Elf64_Phdr *y = *(const Elf64_Phdr * const *)b;
+    return x->p_offset < y->p_offset ? -1 : x->p_offset > y->p_offset;
+}
+
+/* Picks the parts of the segments to keep, in input file order. */
+static int select_pieces(struct reducer *r)
+{
+    const Elf64_Phdr **loads = calloc(r->ehdr.e_phnum, sizeof(Elf64_Phdr *));
+    if (!loads) {
+        return -1;
+    }
+    size_t load_count = 0;
+    size_t i;
+    for (i = 0; i != r->ehdr.e_phnum; ++i) {
+        if (r->phdrs[i].p_type == PT_LOAD && r->phdrs[i].p_filesz > 0) {
+            loads[load_count++] = &r->phdrs[i];
+        }
+    }
+    qsort(loads, load_count, sizeof(loads[0]), compare_offsets);
+    qsort(r->sps, r->sp_count, sizeof(r->sps[0]), compare_u64);
+
+    int result = 0;
+    for (i = 0; result == 0 && i != load_count; ++i) {
+        const Elf64_Phdr *phdr = loads[i];
+        uint64_t start = phdr->p_vaddr;
+        uint64_t end = start + phdr->p_filesz;
+
+        if (!(phdr->p_flags & PF_W)) {
+            if (phdr->p_filesz > SMALL_SEGMENT_SIZE) {
+                end = start + MODULE_HEADER_SIZE;
+            }
+            result = add_piece(r, phdr, start, end);
+            continue;
+        }
+
+        int t;
+        for (t = 0; result == 0 && t != r->sp_count; ++t) {
+            uint64_t sp = r->sps[t];
+            if (sp < start || sp >= end) {
+                continue;
+            }
+            uint64_t window_start = sp - start > STACK_BELOW_SP ? sp - STACK_BELOW_SP : start;
+            uint64_t window_end = end - sp > STACK_ABOVE_SP ? sp + STACK_ABOVE_SP : end;
+            result = add_piece(r, phdr, window_start, window_end);
+        }
+    }
+
+    free(loads);
+    return result;
+}
+
+static int write_reduced(struct reducer *r)
+{
+    size_t phentsize = r->is64 ? sizeof(Elf64_Phdr) : sizeof(Elf32_Phdr);
+    size_t ehsize = r->is64 ? sizeof(Elf64_Ehdr) : sizeof(Elf32_Ehdr);
+    size_t note_count = 0;
+    size_t i;
+    for (i = 0; i != r->ehdr.e_phnum; ++i) {
+        if (r->phdrs[i].p_type == PT_NOTE) {
+            ++note_count;
+        }
+    }
+
+    size_t phnum = note_count + r->piece_count;
+    if (phnum >= PN_XNUM) {
+        return 1;
+    }
+
+    /* Lays out the notes, then the pieces in input order. */
+    size_t out_phdrs_size = phnum * sizeof(Elf64_Phdr);
+    Elf64_Phdr *out_phdrs = calloc(phnum, sizeof(Elf64_Phdr));
+    if (!out_phdrs) {
+        return -1;
+    }
+    uint64_t offset = ehsize + phnum * phentsize;
+    size_t n = 0;
+    for (i = 0; i != r->ehdr.e_phnum; ++i) {
+        if (r->phdrs[i].p_type == PT_NOTE) {
+            out_phdrs[n] = r->phdrs[i];
+            out_phdrs[n].p_offset = offset;
+            offset += r->phdrs[i].p_filesz;
+            ++n;
+        }
+    }
+    for (i = 0; i != r->piece_count; ++i, ++n) {
+        offset = align_up(offset, PIECE_ALIGN);
+        out_phdrs[n].p_type = PT_LOAD;
+        out_phdrs[n].p_flags = r->pieces[i].flags;
+        out_phdrs[n].p_offset = offset;
+        out_phdrs[n].p_vaddr = r->pieces[i].vaddr;
+        out_phdrs[n].p_filesz = r->pieces[i].len;
+        out_phdrs[n].p_memsz = r->pieces[i].len;
+        out_phdrs[n].p_align = r->pieces[i].align;
+        offset += r->pieces[i].len;
+    }
+
+    /* Headers in the class of the input. */
+    unsigned char *headers = calloc(1, ehsize + phnum * phentsize);
+    int result = headers ? 0 : -1;
+    if (result == 0 && r->is64) {
+        Elf64_Ehdr ehdr = r->ehdr;
+        ehdr.e_phoff = ehsize;
+        ehdr.e_phnum = phnum;
+        ehdr.e_shoff = 0;
+        ehdr.e_shnum = 0;
+        ehdr.e_shentsize = 0;
+        ehdr.e_shstrndx = SHN_UNDEF;
+        memcpy(headers, &ehdr, ehsize);
+        memcpy(headers + ehsize, out_phdrs, out_phdrs_size);
+    } else if (result == 0) {
+        Elf32_Ehdr ehdr;
+        memcpy(&ehdr, r->prefix, sizeof(ehdr));
+        ehdr.e_phoff = ehsize;
+        ehdr.e_phnum = phnum;
+        ehdr.e_shoff = 0;
+        ehdr.e_shnum = 0;
+        ehdr.e_shentsize = 0;
+        ehdr.e_shstrndx = SHN_UNDEF;
+        memcpy(headers, &ehdr, ehsize);
+        for (i = 0; i != phnum; ++i) {
+            Elf32_Phdr phdr;
+            phdr.p_type = out_phdrs[i].p_type;
+            phdr.p_offset = out_phdrs[i].p_offset;
+            phdr.p_vaddr = out_phdrs[i].p_vaddr;
+            phdr.p_paddr = out_phdrs[i].p_paddr;
+            phdr.p_filesz = out_phdrs[i].p_filesz;
+            phdr.p_memsz = out_phdrs[i].p_memsz;
+            phdr.p_flags = out_phdrs[i].p_flags;
+            phdr.p_align = out_phdrs[i].p_align;
+            memcpy(headers + ehsize + i * phentsize, &phdr, phentsize);
+        }
+    }
+
+    if (result == 0) {
+        result = emit(r, headers, ehsize + phnum * phentsize);
+    }
+    for (i = 0; result == 0 && i != r->ehdr.e_phnum; ++i) {
+        if (r->phdrs[i].p_type == PT_NOTE) {
+            result = emit(r, r->prefix + r->phdrs[i].p_offset, r->phdrs[i].p_filesz);
+        }
+    }
+
+    uint64_t written = ehsize + phnum * phentsize;
+    for (i = 0; i != note_count; ++i) {
+        written += out_phdrs[i].p_filesz;
+    }
+    for (i = 0; result == 0 && i != r->piece_count; ++i) {
+        const Elf64_Phdr *out = &out_phdrs[note_count + i];
+        result = emit_zeros(r, out->p_offset - written);
+        if (result == 0) {
+            result = copy_input(r, r->pieces[i].offset, r->pieces[i].len);
+        }
+        written = out->p_offset + out->p_filesz;
+    }
+    if (result == 0 && drain_input(r) < 0) {
+        result = -1;
+    }
+
+    r->stats->segments = r->piece_count;
+    free(headers);
+    free(out_phdrs);
+    return result;
+}
+
+int core_reduce(int fd, core_write_fn write, void *context,
+                struct core_reducer_stats *stats)
+{
+    struct reducer *r = calloc(1, sizeof(struct reducer));
+    if (!r) {
+        return -1;
+    }
+    r->fd = fd;
+    r->write = write;
+    r->context = context;
+    r->stats = stats;
+    memset(stats, 0, sizeof(*stats));
+
+    int result;
+    if (parse_headers(r) != 0) {
+        result = copy_unreduced(r);
+    } else {
+        size_t i;
+        for (i = 0; i != r->ehdr.e_phnum; ++i) {
+            if (r->phdrs[i].p_type == PT_NOTE) {
+                parse_notes(r, &r->phdrs[i]);
+            }
+        }
+        stats->threads = r->sp_count;
+
+        result = select_pieces(r);
+        if (result == 0) {
+            result = write_reduced(r);
+        }
+        if (result == 1) {
+            result = copy_unreduced(r);
+        }
+    }
+
+    stats->input_size = r->pos;
+
+    free(r->prefix);
+    free(r->phdrs);
+    free(r->pieces);
+    free(r);
+    return result;
+}
@@ -0,0 +1,58 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#ifndef COREREDUCER_H
+#define COREREDUCER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Reduces an ELF core to what server side unwinding needs, in the spirit of
+ * a minidump: the notes with the registers of all threads, a window of each
+ * thread's stack around its stack pointer, the headers of mapped modules
+ * (which carry their build-ids) and small read-only segments such as the
+ * vDSO. Everything else is left out. The result is still an ELF core, so
+ * gdb and elfutils read it like any other; memory that was left out just
+ * isn't available.
+ *
+ * The core is read in a single pass, so it can come straight from the
+ * kernel's core pipe.
+ */
+
+struct core_reducer_stats {
+    uint64_t input_size;
+    uint64_t output_size;
+    int threads;
+    int segments;
+};
+
+/* Receives the reduced core. Returns 0 on success. */
+typedef int (*core_write_fn)(void *context, const void *data, size_t len);
+
+/* Reads a core from fd until its end and writes it, reduced, through write.
+ * Returns 0 when the core was reduced, 1 when it couldn't be (not a core,
+ * unsupported architecture) and was copied as is, -1 on error. */
+int core_reduce(int fd, core_write_fn write, void *context,
+                struct core_reducer_stats *stats);
+
+#endif // COREREDUCER_H
@@ -0,0 +1,50 @@
+# This file is part of crash-reporter
+#
+# Copyright (C) 2014 Jolla Ltd.
+# Contact: Jakub Adam <jakub.adam@jollamobile.com>
+#
+# This program is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public License
+# version 2.1 as published by the Free Software Foundation.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+# 02110-1301 USA
+
+
+include(../../crash-reporter-conf.pri)
+
+TEMPLATE = app
+TARGET = crash-reporter-dumper
+
+CONFIG -= qt
+
+INCLUDEPATH += ../common
+
+HEADERS = \
+    corereducer.h \
+    stacktrace.h \
+    ../common/debuginfocache.h \
+    ../common/lzop.h \
+
+SOURCES = \
+    main.c \
+    corereducer.c \
+    stacktrace.c \
+    ../common/debuginfocache.c \
+    ../common/lzop.c \
+
+LIBS += -llzo2 -ldw -lelf -lpthread
+
+# qmake uses C++ linker by default, unnecessarily pulling in libstdc++
+QMAKE_LINK = $$QMAKE_LINK_C
+
+target.path = $$CREPORTER_SYSTEM_LIBEXEC
+
+INSTALLS = target
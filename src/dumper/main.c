@@ -0,0 +1,689 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+/*
+ * crash-reporter-dumper writes a rich core report in a single pass. It can
+ * serve as the kernel's core_pattern pipe handler:
+ *
+ *   |/usr/libexec/crash-reporter-dumper --pid=%P --uid=%u --signal=%s --name=%e
+ *
+ * The core is streamed from stdin straight into the report while the other
+ * sections are collected by one thread each. Unless REDUCE_CORE is off, the
+ * core is reduced on the way (see corereducer.h). Blocks of the report are
+ * lzop compressed by a pool of threads, so nothing but the finished report
+ * is ever written to storage. kernel.core_pipe_limit should be non-zero, so
+ * that /proc/<pid> of the crashed process stays around until the dumper
+ * exits.
+ *
+ * With INCLUDE_STACK_TRACE on, the reduced core is also kept in memory and
+ * unwound once it's complete (see stacktrace.h), at idle priority and for
+ * at most --trace-budget milliseconds. The trace goes into the report even
+ * when the core itself doesn't. With DOWNLOAD_DEBUGINFO on, debuginfo from
+ * the cache that crash-reporter-debuginfo fills is used as well.
+ *
+ * Without --pid, only the system sections are collected. The command line
+ * is compatible with rich-core-dumper --name=LABEL --signal=N, which is how
+ * rich-core-helper and rich-core-broker request log collections.
+ */
+
+#define _GNU_SOURCE /* for readlinkat() and the "e" mode of popen() */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <limits.h>
+#include <pthread.h>
+#include <pwd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syslog.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "corereducer.h"
+#include "debuginfocache.h"
+#include "lzop.h"
+#include "stacktrace.h"
+
+#define DEFAULT_OUTPUT_DIR "/var/cache/core-dumps"
+#define SYSTEM_SETTINGS "/usr/share/crash-reporter-settings/crash-reporter-privacy.conf"
+#define USER_SETTINGS "/.config/crash-reporter-settings/crash-reporter-privacy.conf"
+
+#define COPY_BUFFER_SIZE (256 * 1024)
+#define MAX_COMPRESSION_THREADS 4
+#define DEFAULT_TRACE_BUDGET_MS 2000
+/* Larger cores aren't kept in memory for unwinding. */
+#define MAX_TRACE_CORE_SIZE (64 * 1024 * 1024)
+
+/* Settings affecting the report, all but INCLUDE_STACK_TRACE and
+ * DOWNLOAD_DEBUGINFO enabled by default. */
+#define DUMPING_ENABLED     0x01
+#define INCLUDE_CORE        0x02
+#define INCLUDE_SYSLOG      0x04
+#define INCLUDE_PKGLIST     0x08
+#define REDUCE_CORE         0x10
+#define INCLUDE_STACK_TRACE 0x20
+#define DOWNLOAD_DEBUGINFO  0x40
+
+/* Section requirements. */
+#define NEEDS_PROCESS   0x100
+
+struct buffer {
+    char *data;
+    size_t len;
+    size_t size;
+};
+
+struct dumper {
+    pid_t pid;
+    uid_t uid;
+    int signal;
+    char name[NAME_MAX / 2];
+    int flags;
+};
+
+struct section {
+    /* Section header, "%d" stands for the PID. NULL for data that don't go
+     * into the report. */
+    const char *name;
+    int (*collect)(const struct dumper *d, const char *arg, struct buffer *out);
+    const char *arg;
+    int flags;
+};
+
+struct task {
+    const struct section *section;
+    const struct dumper *dumper;
+    struct buffer out;
+    int result;
+    int started;
+    pthread_t thread;
+};
+
+static int buffer_append(struct buffer *buffer, const void *data, size_t len)
+{
+    if (buffer->len + len > buffer->size) {
+        size_t size = buffer->size ? buffer->size : 4096;
+        while (size < buffer->len + len) {
+            size *= 2;
+        }
+        char *new_data = realloc(buffer->data, size);
+        if (!new_data) {
+            return -1;
+        }
+        buffer->data = new_data;
+        buffer->size = size;
+    }
+    memcpy(buffer->data + buffer->len, data, len);
+    buffer->len += len;
+    return 0;
+}
+
+static int read_fd(int fd, struct buffer *out)
+{
+    char buf[16 * 1024];
+    ssize_t r;
+    while ((r = read(fd, buf, sizeof(buf))) != 0) {
+        if (r < 0 && errno == EINTR) {
+            continue;
+        } else if (r < 0 || buffer_append(out, buf, r) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int collect_file(const struct dumper *d, const char *arg, struct buffer *out)
+{
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), arg, d->pid);
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return -1;
+    }
+    int result = read_fd(fd, out);
+    close(fd);
+
+    return result;
+}
+
+static int collect_cmdline(const struct dumper *d, const char *arg, struct buffer *out)
+{
+    if (collect_file(d, arg, out) != 0) {
+        return -1;
+    }
+
+    /* Arguments are separated by NULs. */
+    size_t i;
+    for (i = 0; i != out->len; ++i) {
+        if (out->data[i] == '\0') {
+            out->data[i] = ' ';
+        }
+    }
+    return buffer_append(out, "\n", 1);
+}
+
+static int collect_fds(const struct dumper *d, const char *arg, struct buffer *out)
+{
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), arg, d->pid);
+
+    DIR *dir = opendir(path);
+    if (!dir) {
+        return -1;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+
+        char target[PATH_MAX];
+        ssize_t len = readlinkat(dirfd(dir), entry->d_name, target, sizeof(target) - 1);
+        if (len < 0) {
+            continue;
+        }
+        target[len] = '\0';
+
+        char line[PATH_MAX + 32];
+        int line_len = snprintf(line, sizeof(line), "%s -> %s\n", entry->d_name, target);
+        if (line_len > 0 && (size_t)line_len < sizeof(line)) {
+            buffer_append(out, line, line_len);
+        }
+    }
+    closedir(dir);
+
+    return 0;
+}
+
+static int collect_date(const struct dumper *d, const char *arg, struct buffer *out)
+{
+    (void)d;
+    (void)arg;
+
+    char date[64];
+    time_t now = time(NULL);
+    struct tm tm;
+    size_t len = strftime(date, sizeof(date), "%a %b %e %H:%M:%S %Z %Y\n",
+                          localtime_r(&now, &tm));
+
+    return buffer_append(out, date, len);
+}
+
+static int collect_command(const struct dumper *d, const char *arg, struct buffer *out)
+{
+    (void)d;
+
+    /* The child mustn't get the core pipe as its stdin. */
+    char command[256];
+    snprintf(command, sizeof(command), "%s </dev/null 2>/dev/null", arg);
+
+    FILE *pipe = popen(command, "re");
+    if (!pipe) {
+        return -1;
+    }
+    int result = read_fd(fileno(pipe), out);
+    if (pclose(pipe) != 0) {
+        result = -1;
+    }
+
+    return result;
+}
+
+static const struct section sections[] = {
+    { "date", collect_date, NULL, 0 },
+    { "/etc/os-release", collect_file, "/etc/os-release", 0 },
+    { "/proc/%d/cmdline", collect_cmdline, "/proc/%d/cmdline", NEEDS_PROCESS },
+    { "/proc/%d/status", collect_file, "/proc/%d/status", NEEDS_PROCESS },
+    { "/proc/%d/smaps", collect_file, "/proc/%d/smaps", NEEDS_PROCESS },
+    { "fd", collect_fds, "/proc/%d/fd", NEEDS_PROCESS },
+    { "df", collect_command, "df -k", 0 },
+    { "packagelist", collect_command,
+      "rpm -qa --queryformat '%{name} %{version}-%{release}\\n'", INCLUDE_PKGLIST },
+    { "syslog", collect_command,
+      "journalctl --no-pager -a -n 1000 -o short-precise", INCLUDE_SYSLOG },
+};
+
+/* Goes into the report file name. */
+static const struct section hwid_section = { NULL, collect_command, "ssu-sysinfo -m", 0 };
+
+#define TASK_COUNT (sizeof(sections) / sizeof(sections[0]) + 1)
+
+static void *task_thread(void *arg)
+{
+    struct task *task = arg;
+    task->result = task->section->collect(task->dumper, task->section->arg, &task->out);
+    return NULL;
+}
+
+static void start_task(struct task *task, const struct section *section,
+                       const struct dumper *d)
+{
+    memset(task, 0, sizeof(*task));
+    task->section = section;
+    task->dumper = d;
+
+    int privacy = section->flags & (INCLUDE_SYSLOG | INCLUDE_PKGLIST);
+    if ((section->flags & NEEDS_PROCESS) && d->pid == 0) {
+        return;
+    }
+    if ((d->flags & privacy) != privacy) {
+        return;
+    }
+
+    if (pthread_create(&task->thread, NULL, task_thread, task) == 0) {
+        task->started = 1;
+    } else {
+        /* Collect it right away then. */
+        task_thread(task);
+    }
+}
+
+static void finish_task(struct task *task)
+{
+    if (task->started) {
+        pthread_join(task->thread, NULL);
+        task->started = 0;
+    }
+}
+
+static void read_settings(const char *path, struct dumper *d)
+{
+    static const struct {
+        const char *group;
+        const char *key;
+        int flag;
+    } keys[] = {
+        { "Settings", "coredumping", DUMPING_ENABLED },
+        { "Privacy", "INCLUDE_CORE", INCLUDE_CORE },
+        { "Privacy", "INCLUDE_SYSLOG", INCLUDE_SYSLOG },
+        { "Privacy", "INCLUDE_PKGLIST", INCLUDE_PKGLIST },
+        { "Privacy", "REDUCE_CORE", REDUCE_CORE },
+        { "Privacy", "INCLUDE_STACK_TRACE", INCLUDE_STACK_TRACE },
+        { "Privacy", "DOWNLOAD_DEBUGINFO", DOWNLOAD_DEBUGINFO },
+    };
+
+    FILE *file = fopen(path, "re");
+    if (!file) {
+        return;
+    }
+
+    char line[256];
+    char group[64] = "";
+    while (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n")] = '\0';
+
+        if (line[0] == '[') {
+            snprintf(group, sizeof(group), "%.*s", (int)strcspn(line + 1, "]"), line + 1);
+            continue;
+        }
+
+        char *value = strchr(line, '=');
+        if (!value) {
+            continue;
+        }
+        *value++ = '\0';
+
+        size_t i;
+        for (i = 0; i != sizeof(keys) / sizeof(keys[0]); ++i) {
+            if (strcmp(group, keys[i].group) == 0 && strcmp(line, keys[i].key) == 0) {
+                if (strcmp(value, "true") == 0) {
+                    d->flags |= keys[i].flag;
+                } else {
+                    d->flags &= ~keys[i].flag;
+                }
+            }
+        }
+    }
+    fclose(file);
+}
+
+/* User settings of the crashed process' owner override the system ones. */
+static void read_all_settings(struct dumper *d, int have_uid)
+{
+    read_settings(SYSTEM_SETTINGS, d);
+
+    if (have_uid) {
+        struct passwd pwd, *result = NULL;
+        char buf[1024];
+        if (getpwuid_r(d->uid, &pwd, buf, sizeof(buf), &result) == 0 && result) {
+            char path[PATH_MAX];
+            snprintf(path, sizeof(path), "%s" USER_SETTINGS, pwd.pw_dir);
+            read_settings(path, d);
+        }
+    }
+}
+
+/* Replaces anything that could confuse file name parsing. Dashes are fine,
+ * the application name is parsed from the end. */
+static void sanitize(char *dst, size_t size, const char *src, size_t len)
+{
+    size_t i;
+    for (i = 0; i != len && i + 1 < size && src[i] != '\0'; ++i) {
+        char c = src[i];
+        int safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                   (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '+' ||
+                   (c == '.' && i != 0);
+        dst[i] = safe ? c : '_';
+    }
+    dst[i] = '\0';
+}
+
+static int write_section_header(struct lzop_writer *out, const char *name, pid_t pid)
+{
+    char title[PATH_MAX];
+    snprintf(title, sizeof(title), name, pid);
+
+    char header[PATH_MAX + 32];
+    int len = snprintf(header, sizeof(header), "\n[---rich-core: %s---]\n", title);
+    return lzop_write(out, header, len);
+}
+
+struct core_sink {
+    /* NULL if the core doesn't go into the report. */
+    struct lzop_writer *out;
+    /* NULL if the core isn't kept for unwinding. */
+    struct buffer *capture;
+};
+
+static int write_core(void *context, const void *data, size_t len)
+{
+    struct core_sink *sink = context;
+
+    if (sink->capture && (sink->capture->len + len > MAX_TRACE_CORE_SIZE ||
+                          buffer_append(sink->capture, data, len) != 0)) {
+        syslog(LOG_WARNING, "The core is too large to unwind.");
+        free(sink->capture->data);
+        memset(sink->capture, 0, sizeof(*sink->capture));
+        sink->capture = NULL;
+    }
+
+    return sink->out ? lzop_write(sink->out, data, len) : 0;
+}
+
+/* Streams stdin into the report and capture, or just drains it when the
+ * core isn't wanted; the kernel needs the whole core to be read either
+ * way. */
+static int stream_core(struct lzop_writer *out, int reduce, struct buffer *capture,
+                       uint64_t *core_size)
+{
+    static char buf[COPY_BUFFER_SIZE];
+    struct core_sink sink = { out, capture };
+    ssize_t r;
+
+    if (out && write_section_header(out, "coredump", 0) != 0) {
+        return -1;
+    }
+
+    /* A core that is only unwound doesn't need more than the reduced one. */
+    if ((out && reduce) || (!out && capture)) {
+        struct core_reducer_stats stats;
+        int result = core_reduce(STDIN_FILENO, write_core, &sink, &stats);
+        *core_size = stats.input_size;
+        if (result == 0) {
+            syslog(LOG_DEBUG, "Reduced the core from %llu to %llu bytes, "
+                   "%d threads in %d segments.", (unsigned long long)stats.input_size,
+                   (unsigned long long)stats.output_size, stats.threads, stats.segments);
+        }
+        return result < 0 ? -1 : 0;
+    }
+
+    *core_size = 0;
+    while ((r = read(STDIN_FILENO, buf, sizeof(buf))) != 0) {
+        if (r < 0 && errno == EINTR) {
+            continue;
+        } else if (r < 0) {
+            syslog(LOG_ERR, "Couldn't read the core: %s", strerror(errno));
+            return -1;
+        }
+        *core_size += r;
+        if (write_core(&sink, buf, r) != 0) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static long elapsed_ms(const struct timespec *since)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - since->tv_sec) * 1000 +
+           (now.tv_nsec - since->tv_nsec) / 1000000;
+}
+
+static void print_usage()
+{
+    fprintf(stderr, "usage: crash-reporter-dumper --name=NAME --signal=SIGNAL "
+            "[--pid=PID] [--uid=UID]\n"
+            "                             [--output-dir=DIR] [--hwid=HWID] "
+            "[--threads=N]\n"
+            "                             [--trace-budget=MS]\n");
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option options[] = {
+        { "name", required_argument, NULL, 'n' },
+        { "signal", required_argument, NULL, 's' },
+        { "pid", required_argument, NULL, 'p' },
+        { "uid", required_argument, NULL, 'u' },
+        { "output-dir", required_argument, NULL, 'o' },
+        { "hwid", required_argument, NULL, 'h' },
+        { "threads", required_argument, NULL, 't' },
+        { "trace-budget", required_argument, NULL, 'b' },
+        { NULL, 0, NULL, 0 }
+    };
+
+    struct dumper d;
+    memset(&d, 0, sizeof(d));
+    d.flags = DUMPING_ENABLED | INCLUDE_CORE | INCLUDE_SYSLOG | INCLUDE_PKGLIST |
+              REDUCE_CORE;
+
+    const char *name = NULL;
+    const char *output_dir = DEFAULT_OUTPUT_DIR;
+    const char *hwid = NULL;
+    int have_uid = 0;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    long trace_budget = DEFAULT_TRACE_BUDGET_MS;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (opt) {
+        case 'n':
+            name = optarg;
+            break;
+        case 's':
+            d.signal = atoi(optarg);
+            break;
+        case 'p':
+            d.pid = atoi(optarg);
+            break;
+        case 'u':
+            d.uid = atoi(optarg);
+            have_uid = 1;
+            break;
+        case 'o':
+            output_dir = optarg;
+            break;
+        case 'h':
+            hwid = optarg;
+            break;
+        case 't':
+            threads = atoi(optarg);
+            break;
+        case 'b':
+            trace_budget = atol(optarg);
+            break;
+        default:
+            print_usage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!name || optind != argc) {
+        print_usage();
+        return EXIT_FAILURE;
+    }
+
+    openlog("crash-reporter-dumper", LOG_PID, LOG_USER);
+
+    struct timespec started;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+
+    /* Started by the kernel with an empty environment. */
+    setenv("PATH", "/usr/sbin:/usr/bin:/sbin:/bin", 1);
+
+    read_all_settings(&d, have_uid);
+    if (!(d.flags & DUMPING_ENABLED)) {
+        uint64_t core_size;
+        if (d.pid != 0) {
+            stream_core(NULL, 0, NULL, &core_size);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    sanitize(d.name, sizeof(d.name), name, strlen(name));
+
+    /* Starts all sections before the core begins streaming, /proc/<pid> is
+     * only guaranteed to be there until the dumper exits. */
+    struct task tasks[TASK_COUNT];
+    size_t i;
+    for (i = 0; i != TASK_COUNT - 1; ++i) {
+        start_task(&tasks[i], &sections[i], &d);
+    }
+    struct task *hwid_task = &tasks[TASK_COUNT - 1];
+    if (hwid) {
+        memset(hwid_task, 0, sizeof(*hwid_task));
+        hwid_task->result = -1;
+    } else {
+        start_task(hwid_task, &hwid_section, &d);
+    }
+
+    pid_t pid = d.pid ? d.pid : getpid();
+    char tmp_output[PATH_MAX];
+    snprintf(tmp_output, sizeof(tmp_output), "%s/.%s-%d.tmp", output_dir, d.name, pid);
+    int fd = open(tmp_output, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        syslog(LOG_ERR, "Couldn't create %s: %s", tmp_output, strerror(errno));
+    }
+
+    if (threads > MAX_COMPRESSION_THREADS) {
+        threads = MAX_COMPRESSION_THREADS;
+    }
+    struct lzop_writer out;
+    int result = fd == -1 ? -1 : lzop_writer_open_threaded(&out, fd, threads);
+
+    uint64_t core_size = 0;
+    long core_ms = 0;
+    struct buffer core = { NULL, 0, 0 };
+    if (d.pid != 0) {
+        int include = result == 0 && (d.flags & INCLUDE_CORE);
+        int unwind = result == 0 && (d.flags & INCLUDE_STACK_TRACE);
+        if (stream_core(include ? &out : NULL, d.flags & REDUCE_CORE,
+                        unwind ? &core : NULL, &core_size) != 0) {
+            result = -1;
+        }
+        core_ms = elapsed_ms(&started);
+    }
+
+    for (i = 0; i != TASK_COUNT; ++i) {
+        struct task *task = &tasks[i];
+        finish_task(task);
+        if (result == 0 && task->section && task->section->name && task->out.len > 0) {
+            result = write_section_header(&out, task->section->name, d.pid);
+            if (result == 0) {
+                result = lzop_write(&out, task->out.data, task->out.len);
+            }
+        }
+    }
+
+    if (result == 0 && core.len > 0) {
+        struct stack_trace trace;
+        const char *debuginfo_dir =
+                (d.flags & DOWNLOAD_DEBUGINFO) ? DEBUGINFO_CACHE_DIR : NULL;
+        if (stack_trace_collect(core.data, core.len, trace_budget, debuginfo_dir,
+                                &trace) == 0) {
+            syslog(LOG_INFO, "Unwound %d threads, %d frames%s, fingerprint %016llx.",
+                   trace.threads, trace.frames, trace.truncated ? " (out of time)" : "",
+                   (unsigned long long)trace.fingerprint);
+            result = write_section_header(&out, "stack-trace", 0);
+            if (result == 0) {
+                result = lzop_write(&out, trace.text, trace.len);
+            }
+            stack_trace_free(&trace);
+        }
+    } else {
+        free(core.data);
+    }
+
+    if (!hwid) {
+        hwid = "unknown";
+        if (hwid_task->result == 0 && hwid_task->out.len > 0 &&
+            buffer_append(&hwid_task->out, "", 1) == 0) {
+            hwid = hwid_task->out.data;
+        }
+    }
+    char hwid_name[64];
+    sanitize(hwid_name, sizeof(hwid_name), hwid, strcspn(hwid, "\n"));
+
+    char output[PATH_MAX];
+    snprintf(output, sizeof(output), "%s/%s-%s-%d-%d.rcore.lzo", output_dir,
+             d.name, hwid_name, d.signal, pid);
+
+    if (fd != -1) {
+        if (lzop_writer_finish(&out) != 0 && result == 0) {
+            result = -1;
+        }
+        if (close(fd) != 0) {
+            result = -1;
+        }
+        if (result == 0 && rename(tmp_output, output) != 0) {
+            syslog(LOG_ERR, "Couldn't rename %s to %s: %s", tmp_output, output,
+                   strerror(errno));
+            result = -1;
+        }
+        if (result != 0) {
+            unlink(tmp_output);
+        }
+    }
+
+    for (i = 0; i != TASK_COUNT; ++i) {
+        free(tasks[i].out.data);
+    }
+
+    if (result != 0) {
+        syslog(LOG_ERR, "Couldn't write rich core of %s.", d.name);
+        return EXIT_FAILURE;
+    }
+
+    syslog(LOG_INFO, "Wrote %s, %llu bytes from a %llu byte core, in %ld ms "
+           "(core streamed in %ld ms).", output,
+           (unsigned long long)out.bytes_out, (unsigned long long)core_size,
+           elapsed_ms(&started), core_ms);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,422 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#define _GNU_SOURCE /* for SCHED_IDLE */
+
+#include "stacktrace.h"
+
+#include "debuginfocache.h"
+
+#include <elfutils/libdwfl.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syslog.h>
+#include <time.h>
+
+#define MAX_FRAMES 128
+/* Frames of the crashed thread that make up the fingerprint. */
+#define FINGERPRINT_FRAMES 5
+/* How long an unwinder that ran out of time gets to wrap up. */
+#define GRACE_MS 250
+
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+struct unwinder {
+    char *core;
+    size_t size;
+    char *debuginfo_dir;
+    struct timespec deadline;
+
+    pthread_mutex_t lock;
+    pthread_cond_t finished;
+    int done;
+    int abandoned;
+
+    Dwfl *dwfl;
+    struct stack_trace trace;
+    size_t text_size;
+    int result;
+
+    /* State of the thread being unwound. */
+    int thread_frames;
+    int crashed;
+};
+
+static char *debuginfo_path = NULL;
+
+/* libdwfl callbacks have no context of their own, but they are called only
+ * from the unwinder thread. */
+static __thread struct debuginfo_cache *debuginfo_cache;
+
+/* Installed debuginfo packages are looked for first, then the cache. */
+static int find_debuginfo(Dwfl_Module *mod, void **userdata, const char *modname,
+                          Dwarf_Addr base, const char *file_name,
+                          const char *debuglink_file, GElf_Word debuglink_crc,
+                          char **debuginfo_file_name)
+{
+    int fd = dwfl_standard_find_debuginfo(mod, userdata, modname, base, file_name,
+                                          debuglink_file, debuglink_crc,
+                                          debuginfo_file_name);
+    if (fd < 0 && debuginfo_cache) {
+        const unsigned char *build_id;
+        GElf_Addr vaddr;
+        int len = dwfl_module_build_id(mod, &build_id, &vaddr);
+        if (len > 0) {
+            fd = debuginfo_cache_lookup(debuginfo_cache, build_id, len,
+                                        debuginfo_file_name);
+        }
+    }
+    return fd;
+}
+
+static const Dwfl_Callbacks callbacks = {
+    .find_elf = dwfl_build_id_find_elf,
+    .find_debuginfo = find_debuginfo,
+    .debuginfo_path = &debuginfo_path,
+};
+
+static int append(struct unwinder *u, const char *format, ...)
+{
+    struct stack_trace *trace = &u->trace;
+    va_list args;
+
+    for (;;) {
+        size_t space = u->text_size - trace->len;
+        va_start(args, format);
+        int len = vsnprintf(trace->text + trace->len, space, format, args);
+        va_end(args);
+
+        if (len < 0) {
+            return -1;
+        } else if ((size_t)len < space) {
+            trace->len += len;
+            return 0;
+        }
+
+        size_t size = u->text_size ? u->text_size * 2 : 4096;
+        while (size < trace->len + len + 1) {
+            size *= 2;
+        }
+        char *text = realloc(trace->text, size);
+        if (!text) {
+            return -1;
+        }
+        trace->text = text;
+        u->text_size = size;
+    }
+}
+
+static uint64_t hash_string(uint64_t hash, const char *str)
+{
+    for (; *str; ++str) {
+        hash = (hash ^ (unsigned char)*str) * FNV_PRIME;
+    }
+    return (hash ^ '\n') * FNV_PRIME;
+}
+
+static int out_of_time(struct unwinder *u)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (now.tv_sec > u->deadline.tv_sec ||
+        (now.tv_sec == u->deadline.tv_sec && now.tv_nsec >= u->deadline.tv_nsec)) {
+        u->trace.truncated = 1;
+        return 1;
+    }
+    return 0;
+}
+
+static const char *base_name(const char *path)
+{
+    const char *slash = strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+static int frame_callback(Dwfl_Frame *frame, void *arg)
+{
+    struct unwinder *u = arg;
+
+    Dwarf_Addr pc;
+    bool activation;
+    if (!dwfl_frame_pc(frame, &pc, &activation)) {
+        return DWARF_CB_ABORT;
+    }
+
+    /* The return address of a call may already be in the next function. */
+    Dwarf_Addr lookup = activation ? pc : pc - 1;
+
+    const char *module = "??";
+    Dwarf_Addr start = 0;
+    const char *function = NULL;
+    GElf_Off offset = 0;
+    Dwfl_Module *mod = dwfl_addrmodule(u->dwfl, lookup);
+    if (mod) {
+        const char *name = dwfl_module_info(mod, NULL, &start, NULL, NULL, NULL,
+                                            NULL, NULL);
+        if (name) {
+            module = base_name(name);
+        }
+        GElf_Sym sym;
+        function = dwfl_module_addrinfo(mod, lookup, &offset, &sym, NULL, NULL, NULL);
+    }
+
+    if (append(u, "#%-2d 0x%016" PRIx64 " %s", u->thread_frames, (uint64_t)pc,
+               module) != 0 ||
+        (mod && append(u, "+0x%" PRIx64, (uint64_t)(pc - start)) != 0)) {
+        return DWARF_CB_ABORT;
+    }
+    if (function && append(u, " %s+0x%" PRIx64, function,
+                           (uint64_t)offset + (pc - lookup)) != 0) {
+        return DWARF_CB_ABORT;
+    }
+    if (append(u, "\n") != 0) {
+        return DWARF_CB_ABORT;
+    }
+
+    if (u->crashed && u->thread_frames < FINGERPRINT_FRAMES) {
+        char key[512];
+        if (function) {
+            snprintf(key, sizeof(key), "%s!%s", module, function);
+        } else if (!mod) {
+            snprintf(key, sizeof(key), "??");
+        } else {
+            snprintf(key, sizeof(key), "%s+0x%" PRIx64, module,
+                     (uint64_t)(lookup - start));
+        }
+        u->trace.fingerprint = hash_string(u->trace.fingerprint, key);
+    }
+
+    ++u->thread_frames;
+    ++u->trace.frames;
+
+    if (u->thread_frames == MAX_FRAMES || out_of_time(u)) {
+        return DWARF_CB_ABORT;
+    }
+    return DWARF_CB_OK;
+}
+
+static int thread_callback(Dwfl_Thread *thread, void *arg)
+{
+    struct unwinder *u = arg;
+
+    if (out_of_time(u)) {
+        return DWARF_CB_ABORT;
+    }
+
+    /* The thread that got the signal comes first in the core. */
+    u->crashed = u->trace.threads == 0;
+    u->thread_frames = 0;
+    ++u->trace.threads;
+
+    if (append(u, "\nthread %d%s\n", (int)dwfl_thread_tid(thread),
+               u->crashed ? " (crashed)" : "") != 0) {
+        return DWARF_CB_ABORT;
+    }
+
+    /* Unwinding ends with an error at the outermost frame more often than
+     * not, whatever was unwound until then is still useful. */
+    if (dwfl_thread_getframes(thread, frame_callback, u) != 0 &&
+        u->thread_frames == 0) {
+        append(u, "(%s)\n", dwfl_errmsg(-1));
+    }
+
+    return u->trace.truncated ? DWARF_CB_ABORT : DWARF_CB_OK;
+}
+
+static int unwind(struct unwinder *u)
+{
+    int result = -1;
+
+    elf_version(EV_CURRENT);
+    Elf *elf = elf_memory(u->core, u->size);
+    if (!elf) {
+        syslog(LOG_ERR, "Couldn't read the core: %s", elf_errmsg(-1));
+        return -1;
+    }
+
+    u->dwfl = dwfl_begin(&callbacks);
+    if (!u->dwfl) {
+        goto out;
+    }
+
+    dwfl_report_begin(u->dwfl);
+    if (dwfl_core_file_report(u->dwfl, elf, NULL) < 0 ||
+        dwfl_report_end(u->dwfl, NULL, NULL) != 0 ||
+        dwfl_core_file_attach(u->dwfl, elf) < 0) {
+        syslog(LOG_ERR, "Couldn't unwind the core: %s", dwfl_errmsg(-1));
+        goto out;
+    }
+
+    u->trace.fingerprint = FNV_OFFSET_BASIS;
+    dwfl_getthreads(u->dwfl, thread_callback, u);
+    if (u->trace.truncated) {
+        append(u, "\n(out of time)\n");
+    }
+
+    if (u->trace.frames > 0) {
+        char header[64];
+        int len = snprintf(header, sizeof(header), "fingerprint: %016" PRIx64 "\n",
+                           u->trace.fingerprint);
+        /* The fingerprint goes first, ahead of the threads. */
+        if (append(u, "%s", header) == 0) {
+            memmove(u->trace.text + len, u->trace.text, u->trace.len - len);
+            memcpy(u->trace.text, header, len);
+            result = 0;
+        }
+    }
+
+out:
+    if (u->dwfl) {
+        dwfl_end(u->dwfl);
+    }
+    elf_end(elf);
+
+    return result;
+}
+
+static void free_unwinder(struct unwinder *u)
+{
+    pthread_cond_destroy(&u->finished);
+    pthread_mutex_destroy(&u->lock);
+    free(u->trace.text);
+    free(u->debuginfo_dir);
+    free(u->core);
+    free(u);
+}
+
+static void *unwinder_thread(void *arg)
+{
+    struct unwinder *u = arg;
+
+    /* Never compete with anything else on the device. */
+    struct sched_param param = { .sched_priority = 0 };
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+
+    struct debuginfo_cache cache;
+    if (u->debuginfo_dir && debuginfo_cache_open(&cache, u->debuginfo_dir, 1) == 0) {
+        debuginfo_cache = &cache;
+    }
+
+    int result = unwind(u);
+
+    if (debuginfo_cache) {
+        debuginfo_cache_close(debuginfo_cache);
+        debuginfo_cache = NULL;
+    }
+
+    pthread_mutex_lock(&u->lock);
+    u->result = result;
+    u->done = 1;
+    int abandoned = u->abandoned;
+    pthread_cond_signal(&u->finished);
+    pthread_mutex_unlock(&u->lock);
+
+    if (abandoned) {
+        free_unwinder(u);
+    }
+    return NULL;
+}
+
+static void add_ms(struct timespec *ts, long ms)
+{
+    ts->tv_sec += ms / 1000;
+    ts->tv_nsec += (ms % 1000) * 1000000;
+    if (ts->tv_nsec >= 1000000000) {
+        ts->tv_sec += 1;
+        ts->tv_nsec -= 1000000000;
+    }
+}
+
+int stack_trace_collect(char *core, size_t size, long budget_ms,
+                        const char *debuginfo_dir, struct stack_trace *trace)
+{
+    memset(trace, 0, sizeof(*trace));
+
+    struct unwinder *u = calloc(1, sizeof(*u));
+    if (!u) {
+        free(core);
+        return -1;
+    }
+    u->core = core;
+    u->size = size;
+    if (debuginfo_dir) {
+        u->debuginfo_dir = strdup(debuginfo_dir);
+    }
+    pthread_mutex_init(&u->lock, NULL);
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&u->finished, &attr);
+    pthread_condattr_destroy(&attr);
+
+    clock_gettime(CLOCK_MONOTONIC, &u->deadline);
+    add_ms(&u->deadline, budget_ms);
+    struct timespec wait_until = u->deadline;
+    add_ms(&wait_until, GRACE_MS);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, unwinder_thread, u) != 0) {
+        free_unwinder(u);
+        return -1;
+    }
+    pthread_detach(thread);
+
+    pthread_mutex_lock(&u->lock);
+    while (!u->done) {
+        if (pthread_cond_timedwait(&u->finished, &u->lock, &wait_until) == ETIMEDOUT) {
+            break;
+        }
+    }
+    int done = u->done;
+    u->abandoned = !done;
+    pthread_mutex_unlock(&u->lock);
+
+    if (!done) {
+        syslog(LOG_WARNING, "Unwinding took longer than %ld ms, no stack trace.",
+               budget_ms);
+        return -1;
+    }
+
+    int result = u->result;
+    if (result == 0) {
+        *trace = u->trace;
+        u->trace.text = NULL;
+    }
+    free_unwinder(u);
+
+    return result;
+}
+
+void stack_trace_free(struct stack_trace *trace)
+{
+    free(trace->text);
+    trace->text = NULL;
+    trace->len = 0;
+}
@@ -0,0 +1,72 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#ifndef STACKTRACE_H
+#define STACKTRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Unwinds all threads of an ELF core held in memory, using the CFI of the
+ * modules installed on the device and their debuginfo where available,
+ * either installed or in the debuginfo cache (see debuginfocache.h). A
+ * reduced core (see corereducer.h) is enough, it keeps the registers and
+ * stacks that unwinding needs.
+ *
+ * The trace is text, one block per thread, the crashed thread first:
+ *
+ *   fingerprint: 5f0e3c9a1b2d4e68
+ *
+ *   thread 1234 (crashed)
+ *   #0  0x0000007f8a1b2c3d libc.so.6+0x2c3d raise+0x3c
+ *   #1  0x0000007f8a1b3e4f libc.so.6+0x3e4f abort+0x10f
+ *   ...
+ *
+ * The fingerprint hashes the top frames of the crashed thread by module
+ * offset or function, so it doesn't depend on where the modules were
+ * loaded and identifies duplicate crashes. Function names are preferred,
+ * they survive rebuilds of a module as long as its symbols are available.
+ */
+
+struct stack_trace {
+    char *text;
+    size_t len;
+    uint64_t fingerprint;
+    int threads;
+    int frames;
+    /* Unwinding ran out of time, some frames are missing. */
+    int truncated;
+};
+
+/* Unwinds the core in a thread of idle priority, waiting at most about
+ * budget_ms for it. Takes over core, which must have been allocated with
+ * malloc(); an unwinder that overruns the budget is left behind and frees
+ * it when it's done. The debuginfo cache in debuginfo_dir is used unless
+ * it's NULL. Returns 0 and fills trace, which must then be released with
+ * stack_trace_free(), or -1 if no trace could be produced. */
+int stack_trace_collect(char *core, size_t size, long budget_ms,
+                        const char *debuginfo_dir, struct stack_trace *trace);
+
+void stack_trace_free(struct stack_trace *trace);
+
+#endif // STACKTRACE_H
@@ -0,0 +1,303 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013-2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "delta.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Base is indexed in blocks of this size, shorter matches aren't worth an
+ * instruction. */
+#define BLOCK 32
+#define HASH_MULTIPLIER 0x01000193u
+
+#define OP_LITERAL 0x00
+#define OP_COPY 0x01
+
+static const unsigned char MAGIC[4] = { 'C', 'R', 'D', '1' };
+
+static uint32_t adler32(const unsigned char *data, size_t len)
+{
+    uint32_t a = 1, b = 0;
+    while (len > 0) {
+        /* 5552 is the largest n such that the sums don't overflow. */
+        size_t chunk = len < 5552 ? len : 5552;
+        len -= chunk;
+        while (chunk--) {
+            a += *data++;
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (b << 16) | a;
+}
+
+int delta_buffer_reserve(struct delta_buffer *buffer, size_t len)
+{
+    if (buffer->len + len <= buffer->size) {
+        return 0;
+    }
+
+    size_t size = buffer->size ? buffer->size : 4096;
+    while (size < buffer->len + len) {
+        size *= 2;
+    }
+
+    unsigned char *data = realloc(buffer->data, size);
+    if (!data) {
+        return -1;
+    }
+    buffer->data = data;
+    buffer->size = size;
+    return 0;
+}
+
+int delta_buffer_append(struct delta_buffer *buffer, const void *data, size_t len)
+{
+    if (delta_buffer_reserve(buffer, len) != 0) {
+        return -1;
+    }
+    memcpy(buffer->data + buffer->len, data, len);
+    buffer->len += len;
+    return 0;
+}
+
+static int put_varint(struct delta_buffer *buffer, uint64_t value)
+{
+    unsigned char bytes[10];
+    size_t len = 0;
+    do {
+        bytes[len] = value & 0x7f;
+        value >>= 7;
+        if (value) {
+            bytes[len] |= 0x80;
+        }
+        ++len;
+    } while (value);
+    return delta_buffer_append(buffer, bytes, len);
+}
+
+static int get_varint(const unsigned char **p, const unsigned char *end,
+                      uint64_t *value)
+{
+    int shift = 0;
+    *value = 0;
+    while (*p != end && shift < 64) {
+        unsigned char byte = *(*p)++;
+        *value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return 0;
+        }
+        shift += 7;
+    }
+    return -1;
+}
+
+static uint32_t block_hash(const unsigned char *data)
+{
+    uint32_t hash = 0;
+    int i;
+    for (i = 0; i != BLOCK; ++i) {
+        hash = hash * HASH_MULTIPLIER + data[i];
+    }
+    return hash;
+}
+
+static int put_literal(struct delta_buffer *out, const unsigned char *data,
+                       size_t len)
+{
+    if (len == 0) {
+        return 0;
+    }
+    unsigned char op = OP_LITERAL;
+    if (delta_buffer_append(out, &op, 1) != 0 || put_varint(out, len) != 0 ||
+        delta_buffer_append(out, data, len) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+static int put_copy(struct delta_buffer *out, size_t offset, size_t len)
+{
+    unsigned char op = OP_COPY;
+    if (delta_buffer_append(out, &op, 1) != 0 || put_varint(out, offset) != 0 ||
+        put_varint(out, len) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+int delta_encode(const unsigned char *base, size_t base_len,
+                 const unsigned char *target, size_t target_len,
+                 struct delta_buffer *out)
+{
+    out->len = 0;
+    if (delta_buffer_append(out, MAGIC, sizeof(MAGIC)) != 0 ||
+        put_varint(out, base_len) != 0 || put_varint(out, target_len) != 0) {
+        return -1;
+    }
+
+    /* Index every block of the base by its hash. Later blocks override
+     * earlier ones on collision, which is good enough for snapshots where
+     * matching data is usually at about the same offset. */
+    size_t blocks = base_len / BLOCK;
+    size_t table_size = 1024;
+    while (table_size < blocks * 2) {
+        table_size *= 2;
+    }
+    uint32_t *table = malloc(table_size * sizeof(uint32_t));
+    if (!table) {
+        return -1;
+    }
+    memset(table, 0xff, table_size * sizeof(uint32_t));
+
+    size_t b;
+    for (b = 0; b != blocks; ++b) {
+        table[block_hash(base + b * BLOCK) & (table_size - 1)] = b * BLOCK;
+    }
+
+    /* HASH_MULTIPLIER^BLOCK, to remove the outgoing byte from rolling hash. */
+    uint32_t outgoing_factor = 1;
+    int i;
+    for (i = 0; i != BLOCK; ++i) {
+        outgoing_factor *= HASH_MULTIPLIER;
+    }
+
+    int result = 0;
+    size_t literal_start = 0;
+    size_t pos = 0;
+    uint32_t hash = target_len >= BLOCK ? block_hash(target) : 0;
+
+    while (result == 0 && blocks > 0 && pos + BLOCK <= target_len) {
+        uint32_t candidate = table[hash & (table_size - 1)];
+        if (candidate != UINT32_MAX &&
+            memcmp(base + candidate, target + pos, BLOCK) == 0) {
+            size_t match_base = candidate;
+            size_t match_target = pos;
+            size_t match_len = BLOCK;
+
+            /* Extend the match in both directions. */
+            while (match_target > literal_start && match_base > 0 &&
+                   base[match_base - 1] == target[match_target - 1]) {
+                --match_base;
+                --match_target;
+                ++match_len;
+            }
+            while (match_base + match_len < base_len &&
+                   match_target + match_len < target_len &&
+                   base[match_base + match_len] == target[match_target + match_len]) {
+                ++match_len;
+            }
+
+            result = put_literal(out, target + literal_start,
+                                 match_target - literal_start);
+            if (result == 0) {
+                result = put_copy(out, match_base, match_len);
+            }
+
+            pos = match_target + match_len;
+            literal_start = pos;
+            if (pos + BLOCK <= target_len) {
+                hash = block_hash(target + pos);
+            }
+            continue;
+        }
+
+        if (pos + BLOCK < target_len) {
+            hash = hash * HASH_MULTIPLIER + target[pos + BLOCK] -
+                   outgoing_factor * target[pos];
+        }
+        ++pos;
+    }
+
+    free(table);
+
+    if (result == 0) {
+        result = put_literal(out, target + literal_start, target_len - literal_start);
+    }
+    if (result == 0) {
+        uint32_t checksum = adler32(target, target_len);
+        unsigned char bytes[4] = { checksum >> 24, checksum >> 16, checksum >> 8, checksum };
+        result = delta_buffer_append(out, bytes, sizeof(bytes));
+    }
+
+    return result;
+}
+
+int delta_apply(const unsigned char *base, size_t base_len,
+                const unsigned char *delta, size_t delta_len,
+                struct delta_buffer *out)
+{
+    const unsigned char *p = delta;
+    const unsigned char *end = delta + delta_len;
+    uint64_t expected_base_len, target_len;
+
+    out->len = 0;
+
+    if (delta_len < sizeof(MAGIC) + 4 || memcmp(p, MAGIC, sizeof(MAGIC)) != 0) {
+        return -1;
+    }
+    p += sizeof(MAGIC);
+    end -= 4;
+
+    if (get_varint(&p, end, &expected_base_len) != 0 ||
+        get_varint(&p, end, &target_len) != 0 ||
+        expected_base_len != base_len || delta_buffer_reserve(out, target_len) != 0) {
+        return -1;
+    }
+
+    while (p != end) {
+        unsigned char op = *p++;
+        uint64_t offset, len;
+        if (op == OP_LITERAL) {
+            if (get_varint(&p, end, &len) != 0 || len > (uint64_t)(end - p) ||
+                out->len + len > target_len) {
+                return -1;
+            }
+            delta_buffer_append(out, p, len);
+            p += len;
+        } else if (op == OP_COPY) {
+            if (get_varint(&p, end, &offset) != 0 || get_varint(&p, end, &len) != 0 ||
+                offset > base_len || len > base_len - offset ||
+                out->len + len > target_len) {
+                return -1;
+            }
+            delta_buffer_append(out, base + offset, len);
+        } else {
+            return -1;
+        }
+    }
+
+    uint32_t checksum = ((uint32_t)end[0] << 24) | (end[1] << 16) | (end[2] << 8) | end[3];
+    if (out->len != target_len || adler32(out->data, out->len) != checksum) {
+        return -1;
+    }
+
+    return 0;
+}
+
+void delta_buffer_free(struct delta_buffer *buffer)
+{
+    free(buffer->data);
+    memset(buffer, 0, sizeof(*buffer));
+}
@@ -0,0 +1,64 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013-2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef DELTA_H
+#define DELTA_H
+
+#include <stddef.h>
+
+/*
+ * Binary delta of a snapshot file against the same file in the base snapshot.
+ *
+ * Format (all integers are unsigned LEB128 varints):
+ *
+ *   "CRD1" base_length target_length
+ *   { 0x00 length literal_bytes | 0x01 base_offset length }...
+ *   adler32 of the target, 4 bytes big endian
+ *
+ * Instructions are applied in order, 0x00 appends literal bytes, 0x01 appends
+ * bytes copied from the base file.
+ */
+
+struct delta_buffer {
+    unsigned char *data;
+    size_t len;
+    size_t size;
+};
+
+/* Encodes target as a delta against base into out. Returns 0 on success. */
+int delta_encode(const unsigned char *base, size_t base_len,
+                 const unsigned char *target, size_t target_len,
+                 struct delta_buffer *out);
+
+/* Rebuilds the target from base and delta into out. Returns 0 on success,
+ * -1 when the delta is malformed or doesn't belong to base. */
+int delta_apply(const unsigned char *base, size_t base_len,
+                const unsigned char *delta, size_t delta_len,
+                struct delta_buffer *out);
+
+/* Makes room for len more bytes after buffer->len. Returns 0 on success. */
+int delta_buffer_reserve(struct delta_buffer *buffer, size_t len);
+
+int delta_buffer_append(struct delta_buffer *buffer, const void *data, size_t len);
+
+void delta_buffer_free(struct delta_buffer *buffer);
+
+#endif // DELTA_H
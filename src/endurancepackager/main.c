@@ -0,0 +1,750 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013-2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+/*
+ * endurance-packager creates an endurance rich core report from a set of
+ * endurance snapshot directories in a single pass. LZO compressed snapshot
+ * files are decompressed block by block straight into a tar stream, which is
+ * compressed with xz and wrapped into the lzop compressed .rcore.lzo report.
+ * The output is equivalent to what scripts/endurance-collect used to produce
+ * with lzop -d, tar, xz and lzop, without any intermediate files.
+ *
+ * With --delta, the first snapshot directory serves as a base and files of
+ * the later snapshots are stored as binary deltas against the same file in
+ * the base (see delta.h), unless the delta doesn't save enough. The archive
+ * ends with a "manifest" entry describing how each file was stored, so that
+ * the receiving side can rebuild the snapshots with --apply-delta.
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <stdarg.h>
+#include <libgen.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syslog.h>
+#include <time.h>
+#include <unistd.h>
+#include <lzma.h>
+#include <sys/stat.h>
+
+#include "delta.h"
+#include "lzop.h"
+
+#define TAR_BLOCK 512
+#define COPY_BUFFER_SIZE (64 * 1024)
+
+/* Decompressed file of the base snapshot, shared by all later snapshots. */
+struct base_file {
+    char path[PATH_MAX];
+    /* 0 if the file couldn't be read. */
+    int loaded;
+    struct delta_buffer data;
+};
+
+struct packager {
+    struct lzop_writer out;
+    lzma_stream xz;
+    unsigned char xz_buffer[COPY_BUFFER_SIZE];
+    unsigned char copy_buffer[COPY_BUFFER_SIZE];
+    uint64_t tar_bytes;
+    /* Files written to the archive, skipped ones aren't counted. */
+    int files;
+
+    struct delta_buffer manifest;
+    struct base_file *base_files;
+    size_t base_count;
+    size_t base_size;
+    struct delta_buffer target;
+    struct delta_buffer delta;
+    uint64_t raw_bytes;
+    uint64_t stored_bytes;
+    int deltas;
+};
+
+static void manifest_add(struct packager *p, const char *format, ...)
+{
+    char line[PATH_MAX + 128];
+    va_list args;
+
+    va_start(args, format);
+    int len = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    if (len > 0 && (size_t)len < sizeof(line)) {
+        delta_buffer_append(&p->manifest, line, len);
+    }
+}
+
+static int is_lzo_file(const char *name)
+{
+    size_t name_len = strlen(name);
+    return name_len > 4 && strcmp(name + name_len - 4, ".lzo") == 0;
+}
+
+static int xz_code(struct packager *p, const void *data, size_t len,
+                   lzma_action action)
+{
+    lzma_ret ret;
+
+    p->xz.next_in = data;
+    p->xz.avail_in = len;
+
+    do {
+        p->xz.next_out = p->xz_buffer;
+        p->xz.avail_out = sizeof(p->xz_buffer);
+
+        ret = lzma_code(&p->xz, action);
+        if (ret != LZMA_OK && ret != LZMA_STREAM_END) {
+            syslog(LOG_ERR, "xz compression failed (%d).", ret);
+            return -1;
+        }
+
+        size_t produced = sizeof(p->xz_buffer) - p->xz.avail_out;
+        if (produced > 0 && lzop_write(&p->out, p->xz_buffer, produced) != 0) {
+            syslog(LOG_ERR, "Couldn't write output: %s", strerror(errno));
+            return -1;
+        }
+    } while (p->xz.avail_in > 0 || p->xz.avail_out == 0 ||
+             (action == LZMA_FINISH && ret != LZMA_STREAM_END));
+
+    return 0;
+}
+
+static int tar_write(struct packager *p, const void *data, size_t len)
+{
+    p->tar_bytes += len;
+    return xz_code(p, data, len, LZMA_RUN);
+}
+
+static int tar_pad(struct packager *p)
+{
+    static const unsigned char zeros[TAR_BLOCK];
+    size_t remainder = p->tar_bytes % TAR_BLOCK;
+
+    return remainder ? tar_write(p, zeros, TAR_BLOCK - remainder) : 0;
+}
+
+static int tar_header(struct packager *p, const char *name, mode_t mode,
+                      uint64_t size, time_t mtime, char type)
+{
+    unsigned char header[TAR_BLOCK];
+    memset(header, 0, sizeof(header));
+
+    if (strlen(name) >= 100) {
+        syslog(LOG_ERR, "File name too long for tar: %s", name);
+        return -1;
+    }
+
+    /* ustar header, fields are NUL terminated octal numbers. */
+    strcpy((char *)header, name);
+    snprintf((char *)header + 100, 8, "%07o", (unsigned)(mode & 07777));
+    snprintf((char *)header + 108, 8, "%07o", 0);
+    snprintf((char *)header + 116, 8, "%07o", 0);
+    snprintf((char *)header + 124, 12, "%011llo", (unsigned long long)size);
+    snprintf((char *)header + 136, 12, "%011llo", (unsigned long long)mtime);
+    header[156] = type;
+    memcpy(header + 257, "ustar", 6);
+    memcpy(header + 263, "00", 2);
+    strcpy((char *)header + 265, "root");
+    strcpy((char *)header + 297, "root");
+
+    /* Checksum is calculated with the checksum field filled with spaces. */
+    memset(header + 148, ' ', 8);
+    unsigned checksum = 0;
+    size_t i;
+    for (i = 0; i != sizeof(header); ++i) {
+        checksum += header[i];
+    }
+    snprintf((char *)header + 148, 8, "%06o", checksum);
+
+    return tar_write(p, header, sizeof(header));
+}
+
+/* Streams the rest of the declared size as zeros so that the archive stays
+ * consistent even if a snapshot file turns out to be truncated. */
+static int tar_fill(struct packager *p, uint64_t missing)
+{
+    memset(p->copy_buffer, 0, sizeof(p->copy_buffer));
+    while (missing > 0) {
+        size_t chunk = missing < sizeof(p->copy_buffer) ? missing : sizeof(p->copy_buffer);
+        if (tar_write(p, p->copy_buffer, chunk) != 0) {
+            return -1;
+        }
+        missing -= chunk;
+    }
+    return 0;
+}
+
+static int add_lzo_file(struct packager *p, const char *path,
+                        const char *name, const struct stat *st)
+{
+    struct lzop_reader reader;
+    if (lzop_reader_open(&reader, path) != 0) {
+        /* Not fatal, the snapshot is just missing one file. */
+        syslog(LOG_WARNING, "Skipping %s.", path);
+        return 0;
+    }
+
+    int64_t size = lzop_uncompressed_size(&reader);
+    if (size < 0) {
+        syslog(LOG_WARNING, "Skipping corrupted %s.", path);
+        lzop_reader_close(&reader);
+        return 0;
+    }
+
+    /* lzop -d restored the original mode and mtime, do the same. */
+    mode_t mode = reader.mode ? reader.mode : st->st_mode;
+    time_t mtime = reader.mtime ? reader.mtime : st->st_mtime;
+
+    int result = tar_header(p, name, mode, size, mtime, '0');
+    uint64_t written = 0;
+    while (result == 0 && written < (uint64_t)size) {
+        ssize_t len = lzop_read(&reader, p->copy_buffer, sizeof(p->copy_buffer));
+        if (len <= 0) {
+            syslog(LOG_WARNING, "%s is truncated or corrupted.", path);
+            break;
+        }
+        result = tar_write(p, p->copy_buffer, len);
+        written += len;
+    }
+    lzop_reader_close(&reader);
+
+    if (result == 0 && written < (uint64_t)size) {
+        result = tar_fill(p, size - written);
+    }
+
+    p->raw_bytes += size;
+    p->stored_bytes += size;
+    ++p->files;
+    manifest_add(p, "%s full %lld\n", name, (long long)size);
+
+    return result == 0 ? tar_pad(p) : -1;
+}
+
+static int add_plain_file(struct packager *p, const char *path,
+                          const char *name, const struct stat *st)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        syslog(LOG_WARNING, "Skipping %s: %s", path, strerror(errno));
+        return 0;
+    }
+
+    int result = tar_header(p, name, st->st_mode, st->st_size, st->st_mtime, '0');
+    uint64_t written = 0;
+    while (result == 0 && written < (uint64_t)st->st_size) {
+        ssize_t len = read(fd, p->copy_buffer, sizeof(p->copy_buffer));
+        if (len <= 0) {
+            break;
+        }
+        if ((uint64_t)len > st->st_size - written) {
+            /* File grew after stat(), the header is already written. */
+            len = st->st_size - written;
+        }
+        result = tar_write(p, p->copy_buffer, len);
+        written += len;
+    }
+    close(fd);
+
+    if (result == 0 && written < (uint64_t)st->st_size) {
+        result = tar_fill(p, st->st_size - written);
+    }
+
+    p->raw_bytes += st->st_size;
+    p->stored_bytes += st->st_size;
+    ++p->files;
+    manifest_add(p, "%s full %lld\n", name, (long long)st->st_size);
+
+    return result == 0 ? tar_pad(p) : -1;
+}
+
+/* Reads the whole (decompressed) content of a snapshot file into buffer. */
+static int load_file(const char *path, const struct stat *st,
+                     struct delta_buffer *buffer, mode_t *mode, time_t *mtime)
+{
+    ssize_t len;
+
+    buffer->len = 0;
+    *mode = st->st_mode;
+    *mtime = st->st_mtime;
+
+    if (is_lzo_file(path)) {
+        struct lzop_reader reader;
+        if (lzop_reader_open(&reader, path) != 0) {
+            return -1;
+        }
+        if (reader.mode) {
+            *mode = reader.mode;
+        }
+        if (reader.mtime) {
+            *mtime = reader.mtime;
+        }
+        do {
+            if (delta_buffer_reserve(buffer, COPY_BUFFER_SIZE) != 0) {
+                len = -1;
+                break;
+            }
+            len = lzop_read(&reader, buffer->data + buffer->len, COPY_BUFFER_SIZE);
+            if (len > 0) {
+                buffer->len += len;
+            }
+        } while (len > 0);
+        lzop_reader_close(&reader);
+        return len == 0 ? 0 : -1;
+    }
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return -1;
+    }
+    do {
+        if (delta_buffer_reserve(buffer, COPY_BUFFER_SIZE) != 0) {
+            len = -1;
+            break;
+        }
+        len = read(fd, buffer->data + buffer->len, COPY_BUFFER_SIZE);
+        if (len > 0) {
+            buffer->len += len;
+        }
+    } while (len > 0);
+    close(fd);
+
+    return len == 0 ? 0 : -1;
+}
+
+static int add_buffer(struct packager *p, const char *name, mode_t mode,
+                      time_t mtime, const struct delta_buffer *buffer)
+{
+    if (tar_header(p, name, mode, buffer->len, mtime, '0') != 0 ||
+        tar_write(p, buffer->data, buffer->len) != 0) {
+        return -1;
+    }
+    return tar_pad(p);
+}
+
+/* Returns the content of the base snapshot file, NULL if it can't be read.
+ * Every snapshot after the base is encoded against the same files, so each
+ * of them is decompressed only once per package. */
+static const struct delta_buffer *load_base_file(struct packager *p, const char *base_path)
+{
+    size_t i;
+    for (i = 0; i != p->base_count; ++i) {
+        if (strcmp(p->base_files[i].path, base_path) == 0) {
+            return p->base_files[i].loaded ? &p->base_files[i].data : NULL;
+        }
+    }
+
+    if (p->base_count == p->base_size) {
+        size_t size = p->base_size ? p->base_size * 2 : 32;
+        struct base_file *files = realloc(p->base_files, size * sizeof(struct base_file));
+        if (!files) {
+            return NULL;
+        }
+        p->base_files = files;
+        p->base_size = size;
+    }
+
+    struct base_file *file = &p->base_files[p->base_count++];
+    memset(file, 0, sizeof(*file));
+    snprintf(file->path, sizeof(file->path), "%s", base_path);
+
+    struct stat st;
+    mode_t mode;
+    time_t mtime;
+    file->loaded = stat(base_path, &st) == 0 &&
+                   load_file(base_path, &st, &file->data, &mode, &mtime) == 0;
+    if (!file->loaded) {
+        delta_buffer_free(&file->data);
+        return NULL;
+    }
+
+    return &file->data;
+}
+
+static void free_base_files(struct packager *p)
+{
+    size_t i;
+    for (i = 0; i != p->base_count; ++i) {
+        delta_buffer_free(&p->base_files[i].data);
+    }
+    free(p->base_files);
+    p->base_files = NULL;
+    p->base_count = p->base_size = 0;
+}
+
+static int add_delta_file(struct packager *p, const char *path, const char *name,
+                          const struct stat *st, const char *base_path,
+                          const char *base_name)
+{
+    mode_t mode;
+    time_t mtime;
+
+    if (load_file(path, st, &p->target, &mode, &mtime) != 0) {
+        syslog(LOG_WARNING, "Skipping corrupted %s.", path);
+        return 0;
+    }
+
+    const struct delta_buffer *base = load_base_file(p, base_path);
+    int use_delta =
+        base &&
+        delta_encode(base->data, base->len, p->target.data, p->target.len,
+                     &p->delta) == 0 &&
+        /* Not worth it when most of the file has changed. */
+        p->delta.len < p->target.len / 4 * 3;
+
+    p->raw_bytes += p->target.len;
+    ++p->files;
+
+    if (!use_delta) {
+        p->stored_bytes += p->target.len;
+        manifest_add(p, "%s full %zu\n", name, p->target.len);
+        return add_buffer(p, name, mode, mtime, &p->target);
+    }
+
+    char delta_name[PATH_MAX];
+    snprintf(delta_name, sizeof(delta_name), "%s.delta", name);
+
+    p->stored_bytes += p->delta.len;
+    ++p->deltas;
+    manifest_add(p, "%s delta %s %zu\n", delta_name, base_name, p->target.len);
+
+    return add_buffer(p, delta_name, mode, mtime, &p->delta);
+}
+
+static int filter_entries(const struct dirent *entry)
+{
+    return entry->d_name[0] != '.';
+}
+
+/* Adds the entries of a snapshot directory, recursing into subdirectories
+ * like tar does. name is the directory in the archive, base_dir and
+ * base_name the same directory in the base snapshot, if any. */
+static int add_directory(struct packager *p, const char *dir, const char *name,
+                         const char *base_dir, const char *base_name)
+{
+    struct dirent **entries;
+    int count = scandir(dir, &entries, filter_entries, alphasort);
+    if (count < 0) {
+        syslog(LOG_WARNING, "Couldn't list %s: %s", dir, strerror(errno));
+        return 0;
+    }
+
+    int result = 0;
+    int i;
+    for (i = 0; i != count; ++i) {
+        const char *entry = entries[i]->d_name;
+        char path[PATH_MAX];
+        char file_name[PATH_MAX];
+        char base_path[PATH_MAX] = "";
+        char base_file_name[PATH_MAX] = "";
+        snprintf(path, sizeof(path), "%s/%s", dir, entry);
+        snprintf(file_name, sizeof(file_name), "%s/%s", name, entry);
+        if (base_dir) {
+            snprintf(base_path, sizeof(base_path), "%s/%s", base_dir, entry);
+            snprintf(base_file_name, sizeof(base_file_name), "%s/%s", base_name, entry);
+        }
+
+        struct stat st;
+        if (result != 0) {
+            /* Just free the remaining entries. */
+        } else if (lstat(path, &st) == 0 && S_ISDIR(st.st_mode)) {
+            char dir_name[PATH_MAX + 1];
+            snprintf(dir_name, sizeof(dir_name), "%s/", file_name);
+            result = tar_header(p, dir_name, st.st_mode, 0, st.st_mtime, '5');
+            if (result == 0) {
+                result = add_directory(p, path, file_name, base_dir ? base_path : NULL,
+                                       base_file_name);
+            }
+        } else if (stat(path, &st) == 0 && S_ISREG(st.st_mode)) {
+            int lzo = is_lzo_file(file_name);
+            if (lzo) {
+                file_name[strlen(file_name) - 4] = '\0';
+                if (base_dir) {
+                    base_file_name[strlen(base_file_name) - 4] = '\0';
+                }
+            }
+
+            if (base_dir && access(base_path, R_OK) == 0) {
+                result = add_delta_file(p, path, file_name, &st, base_path, base_file_name);
+            } else if (lzo) {
+                result = add_lzo_file(p, path, file_name, &st);
+            } else {
+                result = add_plain_file(p, path, file_name, &st);
+            }
+        } else {
+            syslog(LOG_WARNING, "Skipping %s, not a regular file or directory.", path);
+        }
+        free(entries[i]);
+    }
+    free(entries);
+
+    return result;
+}
+
+static int add_snapshot(struct packager *p, const char *dir, const char *base_dir)
+{
+    struct stat st;
+    if (stat(dir, &st) != 0 || !S_ISDIR(st.st_mode)) {
+        syslog(LOG_WARNING, "%s is not a snapshot directory.", dir);
+        return 0;
+    }
+
+    char dir_copy[PATH_MAX];
+    strncpy(dir_copy, dir, sizeof(dir_copy) - 1);
+    dir_copy[sizeof(dir_copy) - 1] = '\0';
+    const char *snapshot = basename(dir_copy);
+
+    char base_copy[PATH_MAX] = "";
+    const char *base_snapshot = "";
+    if (base_dir) {
+        strncpy(base_copy, base_dir, sizeof(base_copy) - 1);
+        base_snapshot = basename(base_copy);
+    }
+
+    char name[PATH_MAX];
+    snprintf(name, sizeof(name), "%s/", snapshot);
+    if (tar_header(p, name, st.st_mode, 0, st.st_mtime, '5') != 0) {
+        return -1;
+    }
+
+    return add_directory(p, dir, snapshot, base_dir, base_snapshot);
+}
+
+static int write_section_header(struct packager *p, const char *name)
+{
+    char header[128];
+    int len = snprintf(header, sizeof(header), "\n[---rich-core: %s---]\n", name);
+    return lzop_write(&p->out, header, len);
+}
+
+static int write_text_section(struct packager *p, const char *name,
+                              const char *content)
+{
+    if (write_section_header(p, name) != 0 ||
+        lzop_write(&p->out, content, strlen(content)) != 0 ||
+        lzop_write(&p->out, "\n", 1) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+static long elapsed_ms(const struct timespec *since)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - since->tv_sec) * 1000 +
+           (now.tv_nsec - since->tv_nsec) / 1000000;
+}
+
+static int add_manifest(struct packager *p)
+{
+    manifest_add(p, "raw-bytes %llu\nstored-bytes %llu\n",
+                 (unsigned long long)p->raw_bytes,
+                 (unsigned long long)p->stored_bytes);
+
+    return add_buffer(p, "manifest", 0100644, time(NULL), &p->manifest);
+}
+
+/* Rebuilds a snapshot file from its base and delta, for the receiving side
+ * and for testing. */
+static int apply_delta(const char *base_path, const char *delta_path,
+                       const char *output)
+{
+    struct delta_buffer base = { NULL, 0, 0 };
+    struct delta_buffer delta = { NULL, 0, 0 };
+    struct delta_buffer target = { NULL, 0, 0 };
+    struct stat st;
+    mode_t mode;
+    time_t mtime;
+    int result = -1;
+
+    if (stat(base_path, &st) == 0 && load_file(base_path, &st, &base, &mode, &mtime) == 0 &&
+        stat(delta_path, &st) == 0 && load_file(delta_path, &st, &delta, &mode, &mtime) == 0 &&
+        delta_apply(base.data, base.len, delta.data, delta.len, &target) == 0) {
+        FILE *file = fopen(output, "w");
+        if (file) {
+            if (fwrite(target.data, 1, target.len, file) == target.len) {
+                result = 0;
+            }
+            if (fclose(file) != 0) {
+                result = -1;
+            }
+        }
+    }
+
+    if (result != 0) {
+        fprintf(stderr, "Couldn't rebuild %s from %s and %s.\n", output,
+                base_path, delta_path);
+    }
+
+    delta_buffer_free(&base);
+    delta_buffer_free(&delta);
+    delta_buffer_free(&target);
+
+    return result == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static void print_usage()
+{
+    fprintf(stderr, "usage: endurance-packager --device-uid UID --boot-time TIME "
+            "--output FILE [--delta] SNAPSHOT_DIR...\n"
+            "       endurance-packager --apply-delta BASE DELTA OUTPUT\n");
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option options[] = {
+        { "device-uid", required_argument, NULL, 'u' },
+        { "boot-time", required_argument, NULL, 'b' },
+        { "output", required_argument, NULL, 'o' },
+        { "delta", no_argument, NULL, 'd' },
+        { "apply-delta", no_argument, NULL, 'a' },
+        { NULL, 0, NULL, 0 }
+    };
+
+    const char *device_uid = "";
+    const char *boot_time = "";
+    const char *output = NULL;
+    int delta = 0;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "u:b:o:da", options, NULL)) != -1) {
+        switch (opt) {
+        case 'u':
+            device_uid = optarg;
+            break;
+        case 'b':
+            boot_time = optarg;
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        case 'd':
+            delta = 1;
+            break;
+        case 'a':
+            if (argc - optind != 3) {
+                print_usage();
+                return EXIT_FAILURE;
+            }
+            return apply_delta(argv[optind], argv[optind + 1], argv[optind + 2]);
+        default:
+            print_usage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!output || optind == argc) {
+        print_usage();
+        return EXIT_FAILURE;
+    }
+
+    openlog("endurance-packager", LOG_PID, LOG_USER);
+
+    struct timespec started;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+
+    char tmp_output[PATH_MAX];
+    snprintf(tmp_output, sizeof(tmp_output), "%s.tmp", output);
+    int fd = open(tmp_output, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        syslog(LOG_ERR, "Couldn't create %s: %s", tmp_output, strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    static struct packager p;
+    lzma_stream xz_init = LZMA_STREAM_INIT;
+    p.xz = xz_init;
+
+    int result = lzop_writer_open(&p.out, fd);
+    if (result == 0 && lzma_easy_encoder(&p.xz, 0, LZMA_CHECK_CRC64) != LZMA_OK) {
+        syslog(LOG_ERR, "Couldn't initialize xz encoder.");
+        result = -1;
+    }
+
+    if (result == 0) {
+        result = write_text_section(&p, "device-uid", device_uid);
+    }
+    if (result == 0) {
+        result = write_text_section(&p, "boot-time", boot_time);
+    }
+    if (result == 0) {
+        result = write_section_header(&p, "endurance-snapshot-pack.tar.xz");
+    }
+
+    char base_copy[PATH_MAX] = "-";
+    if (delta) {
+        strncpy(base_copy, argv[optind], sizeof(base_copy) - 1);
+    }
+    manifest_add(&p, "version 1\ndelta-format CRD1\nbase %s\n",
+                 delta ? basename(base_copy) : "-");
+
+    int i;
+    for (i = optind; result == 0 && i != argc; ++i) {
+        result = add_snapshot(&p, argv[i], (delta && i != optind) ? argv[optind] : NULL);
+    }
+
+    if (result == 0) {
+        result = add_manifest(&p);
+    }
+
+    if (result == 0) {
+        /* End of archive marker. */
+        static const unsigned char zeros[2 * TAR_BLOCK];
+        result = tar_write(&p, zeros, sizeof(zeros));
+    }
+    if (result == 0) {
+        result = xz_code(&p, NULL, 0, LZMA_FINISH);
+    }
+
+    lzma_end(&p.xz);
+    delta_buffer_free(&p.manifest);
+    free_base_files(&p);
+    delta_buffer_free(&p.target);
+    delta_buffer_free(&p.delta);
+    if (lzop_writer_finish(&p.out) != 0) {
+        result = -1;
+    }
+    if (close(fd) != 0) {
+        result = -1;
+    }
+
+    if (result != 0 || rename(tmp_output, output) != 0) {
+        syslog(LOG_ERR, "Couldn't create endurance package %s.", output);
+        unlink(tmp_output);
+        return EXIT_FAILURE;
+    }
+
+    double ratio = p.out.bytes_out ? (double)p.raw_bytes / p.out.bytes_out : 0;
+    syslog(LOG_INFO, "Packed %d snapshots (%d files, %d as deltas) into %s: "
+           "%llu bytes of snapshot data, %llu bytes after delta encoding, "
+           "%llu bytes written in %ld ms. Compression ratio %.1f:1.",
+           argc - optind, p.files, p.deltas, output,
+           (unsigned long long)p.raw_bytes, (unsigned long long)p.stored_bytes,
+           (unsigned long long)p.out.bytes_out, elapsed_ms(&started), ratio);
+
+    return EXIT_SUCCESS;
+}
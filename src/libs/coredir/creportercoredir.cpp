@@ -31,10 +31,13 @@
 
 #include "creportercoredir.h"
 #include "creportercoredir_p.h"
+#include "creporterprobes.h"
 #include "creporterutils.h"
 
 using CReporter::LoggingCategory::cr;
 
+CREPORTER_PROBE_SEMAPHORE(coredir_scan);
+
 
 #define FILE_PERMISSION     0777
 
@@ -105,6 +108,9 @@ QString CReporterCoreDir::checkDirectoryForCores()
 {
     Q_D(CReporterCoreDir);
 
+    CREPORTER_PROBE_TIMER(probeTimer);
+    int scanned = 0;
+
     QFileInfo fi;
     QString coreFilePath;
 
@@ -118,6 +124,7 @@ QString CReporterCoreDir::checkDirectoryForCores()
     while (iter.hasNext()) {
         iter.next();
         fi = iter.fileInfo();
+        ++scanned;
 
         if (!d->coresAtDirectory.contains(fi.fileName()) &&
                 CReporterUtils::validateCore(fi.fileName())) {
@@ -135,6 +142,8 @@ QString CReporterCoreDir::checkDirectoryForCores()
         updateCoreList();
     }
 
+    CREPORTER_PROBE4(coredir_scan, qPrintable(d->directory), scanned,
+                     CREPORTER_PROBE_ELAPSED_US(probeTimer), int(!coreFilePath.isEmpty()));
     return coreFilePath;
 }
 
@@ -31,15 +31,22 @@
 #include <QTimer>
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSet>
 #include <QSignalMapper>
 
 #include "creportercoreregistry.h"
 #include "creportercoreregistry_p.h"
 #include "creportercoredir.h"
+#include "creporterprobes.h"
+#include "creporterstats.h"
 #include "creporterutils.h"
 
 using CReporter::LoggingCategory::cr;
 
+CREPORTER_PROBE_SEMAPHORE(registry_scan);
+
 #define NUM_ENV_MOUNTPOINTS 2
 #define NUM_STATIC_MOUNTPOINTS 1
 #define MAX_CORE_DIRS (NUM_ENV_MOUNTPOINTS + NUM_STATIC_MOUNTPOINTS + 1)
@@ -67,8 +74,12 @@ mountpoint_static[NUM_STATIC_MOUNTPOINTS][MAX_MOUNTPOINT_NAMELEN] = {
 
 const char core_dumps_suffix[] = "/core-dumps";
 
+// Smallest crash info cache that is pruned when new files are looked up.
+#define MIN_CRASH_INFO_PRUNE_LIMIT 64
+
 
 CReporterCoreRegistryPrivate::CReporterCoreRegistryPrivate()
+    : crashInfoPruneLimit(MIN_CRASH_INFO_PRUNE_LIMIT)
 {
     mapper = new QSignalMapper();
 }
@@ -78,6 +89,22 @@ CReporterCoreRegistryPrivate::~CReporterCoreRegistryPrivate()
     delete mapper;
 }
 
+void CReporterCoreRegistryPrivate::pruneCrashInfoCache(const QSet<QString> &present) const
+{
+    QHash<QString, CReporterCrashInfo>::iterator it = crashInfoCache.begin();
+    while (it != crashInfoCache.end()) {
+        if (present.contains(it.key()) || QFile::exists(it.key())) {
+            ++it;
+        } else {
+            it = crashInfoCache.erase(it);
+        }
+    }
+
+    // Prune again once the cache has doubled, that keeps lookups amortized
+    // constant while the cache stays proportional to the files present.
+    crashInfoPruneLimit = qMax(MIN_CRASH_INFO_PRUNE_LIMIT, 2 * crashInfoCache.size());
+}
+
 CReporterCoreRegistry::CReporterCoreRegistry(QObject *parent)
     : QObject(parent), d_ptr(new CReporterCoreRegistryPrivate())
 {
@@ -103,6 +130,9 @@ QStringList CReporterCoreRegistry::collectAllCoreFiles() const
 {
     Q_D(const CReporterCoreRegistry);
 
+    QElapsedTimer timer;
+    timer.start();
+
     QStringList out;
     QListIterator<CReporterCoreDir *> iter(d->coreDirs);
 
@@ -110,9 +140,38 @@ QStringList CReporterCoreRegistry::collectAllCoreFiles() const
         CReporterCoreDir *dir = (CReporterCoreDir *) iter.next();
         dir->collectAllCoreFilesAtLocation(out);
     }
+
+    qint64 elapsedUs = timer.nsecsElapsed() / 1000;
+    CReporterStats::instance()->observe("core_scan_duration_us", elapsedUs);
+    CREPORTER_PROBE3(registry_scan, d->coreDirs.size(), out.size(), elapsedUs);
+
+    // Forget files that have been deleted or uploaded meanwhile.
+    if (d->crashInfoCache.size() > out.size()) {
+        d->pruneCrashInfoCache(out.toSet());
+    }
+
     return out;
 }
 
+CReporterCrashInfo CReporterCoreRegistry::crashInfo(const QString &path) const
+{
+    Q_D(const CReporterCoreRegistry);
+
+    QHash<QString, CReporterCrashInfo>::const_iterator it =
+        d->crashInfoCache.constFind(path);
+    if (it != d->crashInfoCache.constEnd()) {
+        return it.value();
+    }
+
+    // Files are removed by the uploader, the UI and the daemon without the
+    // registry knowing, forget them before the cache grows too much.
+    if (d->crashInfoCache.size() >= d->crashInfoPruneLimit) {
+        d->pruneCrashInfoCache();
+    }
+
+    return d->crashInfoCache.insert(path, CReporterCrashInfo(path)).value();
+}
+
 QStringList CReporterCoreRegistry::getCoreLocationPaths()
 {
     Q_D(CReporterCoreRegistry);
@@ -141,6 +200,9 @@ QString CReporterCoreRegistry::checkDirectoryForCores(const QString &path)
 {
     Q_D(CReporterCoreRegistry);
 
+    QElapsedTimer timer;
+    timer.start();
+
     QString coreFilePath;
     QListIterator<CReporterCoreDir *> iter(d->coreDirs);
 
@@ -151,6 +213,8 @@ QString CReporterCoreRegistry::checkDirectoryForCores(const QString &path)
             coreFilePath = pCoreDir->checkDirectoryForCores();
         }
     }
+
+    CReporterStats::instance()->observe("directory_check_duration_us", timer.nsecsElapsed() / 1000);
     return coreFilePath;
 }
 
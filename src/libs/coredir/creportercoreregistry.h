@@ -28,6 +28,8 @@
 #include <QObject>
 #include <QStringList>
 
+#include "creportercrashinfo.h"
+
 class CReporterCoreRegistryPrivate;
 
 /*!
@@ -71,6 +73,15 @@ public:
      */
     QString checkDirectoryForCores(const QString &path);
 
+    /*!
+     * @brief Returns information parsed from the name of a rich core file.
+     *
+     * Results are cached until the file disappears from the registry.
+     *
+     * @param path Rich core file path.
+     */
+    CReporterCrashInfo crashInfo(const QString &path) const;
+
 public Q_SLOTS:
     /*!
       * @brief Parent can call this to refresh internal core file lists of
@@ -25,7 +25,11 @@
 #ifndef CREPORTERCOREREGISTRY_P_H
 #define CREPORTERCOREREGISTRY_P_H
 
+#include <QHash>
 #include <QList>
+#include <QSet>
+
+#include "creportercrashinfo.h"
 
 class CReporterCoreDir;
 class QSignalMapper;
@@ -42,11 +46,22 @@ public:
     CReporterCoreRegistryPrivate();
     virtual ~CReporterCoreRegistryPrivate();
 
+    /*!
+     * @brief Removes cached crash info of the files that don't exist anymore.
+     *
+     * @param present Paths known to exist, others are checked on disk.
+     */
+    void pruneCrashInfoCache(const QSet<QString> &present = QSet<QString>()) const;
+
 public:
     //! @arg Signal mapper to map gconf value changes.
     QSignalMapper *mapper;
     //! @arg List of CReporterCoreDir instances.
     QList<CReporterCoreDir *> coreDirs;
+    //! @arg Parsed file names of the known rich core files.
+    mutable QHash<QString, CReporterCrashInfo> crashInfoCache;
+    //! @arg Cache size at which crashInfo() prunes the cache.
+    mutable int crashInfoPruneLimit;
 };
 
 #endif // CREPORTERCOREREGISTRY_P_H
@@ -54,6 +54,12 @@ const QString PrivacyDisclaimerFile =  "/usr/share/crash-reporter-settings/priva
 //! Default log file.
 const QString DefaultLogFile = "/tmp/crash-reporter.log";
 
+//! Default log file for binary records.
+const QString DefaultBinaryLogFile = "/tmp/crash-reporter.blog";
+
+//! Log of uploaded reports, kept in the first core directory.
+const QString UploadLogFileName = "uploadlog";
+
 #ifndef CREPORTER_UNIT_TEST
 //! Daemon service name
 const QString DaemonServiceName = "com.nokia.CrashReporter.Daemon";
@@ -97,6 +103,8 @@ enum LogType {
     LogSyslog,
     //! Log to a file.
     LogFile,
+    //! Log binary records to a file.
+    LogBinary,
 };
 
 //! Prefix for message and core packages created by Quick Feedback
@@ -0,0 +1,105 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERPROBES_H
+#define CREPORTERPROBES_H
+
+/*!
+ * @file creporterprobes.h
+ * @brief Static tracepoints (USDT) in the hot paths of crash-reporter.
+ *
+ * Probes of the "crash_reporter" provider can be attached to with bpftrace,
+ * perf or SystemTap without rebuilding, e.g.
+ *
+ *   bpftrace -e 'usdt:/usr/lib/libcrashreporter.so.0:crash_reporter:coredir_scan
+ *                { @us = hist(arg2); }'
+ *
+ * Every probe has a semaphore, which the tracer increments while it's
+ * attached; bpftrace does so through the uprobe reference counters of
+ * Linux 4.20 and later, SystemTap by itself. An inactive probe costs a test
+ * of its semaphore and its arguments aren't evaluated, so they may be
+ * expensive (qPrintable(), QFileInfo::size()). Each probe needs its
+ * semaphore defined with CREPORTER_PROBE_SEMAPHORE(name) once in the
+ * binary or library that fires it, in the file that uses the probe.
+ *
+ * Arguments should be integers or C strings; durations are in
+ * microseconds. Probes are compiled in when sys/sdt.h is available,
+ * building with CONFIG+=no_usdt leaves them out altogether.
+ *
+ * Scripts showing latency histograms are in tests/usdt.
+ */
+
+#ifdef CREPORTER_USDT
+
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+
+#include <QElapsedTimer>
+
+//! Defines the semaphore of a probe, at file scope.
+#define CREPORTER_PROBE_SEMAPHORE(name) \
+    __extension__ unsigned short crash_reporter_##name##_semaphore \
+    __attribute__((section(".probes"), used, visibility("hidden"))) = 0
+
+//! True while a tracer is attached to the probe.
+#define CREPORTER_PROBE_ENABLED(name) \
+    __builtin_expect(crash_reporter_##name##_semaphore, 0)
+
+#define CREPORTER_PROBE(name) \
+    do { if (CREPORTER_PROBE_ENABLED(name)) \
+        DTRACE_PROBE(crash_reporter, name); } while (0)
+#define CREPORTER_PROBE1(name, a1) \
+    do { if (CREPORTER_PROBE_ENABLED(name)) \
+        DTRACE_PROBE1(crash_reporter, name, a1); } while (0)
+#define CREPORTER_PROBE2(name, a1, a2) \
+    do { if (CREPORTER_PROBE_ENABLED(name)) \
+        DTRACE_PROBE2(crash_reporter, name, a1, a2); } while (0)
+#define CREPORTER_PROBE3(name, a1, a2, a3) \
+    do { if (CREPORTER_PROBE_ENABLED(name)) \
+        DTRACE_PROBE3(crash_reporter, name, a1, a2, a3); } while (0)
+#define CREPORTER_PROBE4(name, a1, a2, a3, a4) \
+    do { if (CREPORTER_PROBE_ENABLED(name)) \
+        DTRACE_PROBE4(crash_reporter, name, a1, a2, a3, a4); } while (0)
+
+//! Starts measuring a duration reported by a probe.
+#define CREPORTER_PROBE_TIMER(timer) \
+    QElapsedTimer timer; timer.start()
+//! Microseconds since CREPORTER_PROBE_TIMER(timer).
+#define CREPORTER_PROBE_ELAPSED_US(timer) \
+    (timer.nsecsElapsed() / 1000)
+
+#else
+
+#define CREPORTER_PROBE_SEMAPHORE(name) struct CReporterProbeSemaphore_##name
+#define CREPORTER_PROBE_ENABLED(name) 0
+
+#define CREPORTER_PROBE(name) do {} while (0)
+#define CREPORTER_PROBE1(name, a1) do {} while (0)
+#define CREPORTER_PROBE2(name, a1, a2) do {} while (0)
+#define CREPORTER_PROBE3(name, a1, a2, a3) do {} while (0)
+#define CREPORTER_PROBE4(name, a1, a2, a3, a4) do {} while (0)
+
+#define CREPORTER_PROBE_TIMER(timer) do {} while (0)
+#define CREPORTER_PROBE_ELAPSED_US(timer) 0
+
+#endif // CREPORTER_USDT
+
+#endif // CREPORTERPROBES_H
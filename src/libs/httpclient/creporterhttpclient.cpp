@@ -32,6 +32,7 @@
 #include <QDebug>
 #include <QFile>
 #include <QFileInfo>
+#include <QDateTime>
 #include <QDir>
 #include <QSslConfiguration>
 #include <QNetworkProxy>
@@ -41,13 +42,33 @@
 #include "creporterhttpclient.h"
 #include "creporterhttpclient_p.h"
 #include "creporterapplicationsettings.h"
+#include "creporternamespace.h"
+#include "creporterprobes.h"
+#include "creporterstats.h"
 #include "creporterutils.h"
 
 using CReporter::LoggingCategory::cr;
 
+CREPORTER_PROBE_SEMAPHORE(upload_start);
+CREPORTER_PROBE_SEMAPHORE(upload_done);
+CREPORTER_PROBE_SEMAPHORE(upload_progress);
+
 static const char *clientstate_string[] = {"None", "Init", "Connecting", "Sending", "Aborting"};
 static const int CONNECTION_TIMEOUT_MS = 2 * 60 * 1000;
 
+namespace {
+
+/*! Device identification sent with every upload. It can't change while the
+ * process runs and getting the UID is a blocking D-Bus call. */
+QString deviceQuery()
+{
+    static const QString query("uuid=" + CReporterUtils::deviceUid() +
+                               "&model=" + CReporterUtils::deviceModel());
+    return query;
+}
+
+} // namespace
+
 CReporterHttpClientPrivate::CReporterHttpClientPrivate(CReporterHttpClient *parent)
     : QObject(parent),
       m_manager(0),
@@ -63,8 +84,6 @@ CReporterHttpClientPrivate::CReporterHttpClientPrivate(CReporterHttpClient *pare
 
 CReporterHttpClientPrivate::~CReporterHttpClientPrivate()
 {
-    CReporterApplicationSettings::freeSingleton();
-
     if (m_reply != 0) {
         m_reply->abort();
         m_reply = 0;
@@ -74,21 +93,31 @@ CReporterHttpClientPrivate::~CReporterHttpClientPrivate()
     m_manager = 0;
 }
 
-void CReporterHttpClientPrivate::init(bool deleteAfterSending)
+void CReporterHttpClientPrivate::init(const CReporterUploadEndpoint &endpoint,
+                                      bool deleteAfterSending)
 {
     qCDebug(cr) << "Initiating HTTP session.";
     m_deleteFileFlag = deleteAfterSending;
+    m_endpoint = endpoint;
 
-    if (CReporterApplicationSettings::instance()->useProxy()) {
-        qCDebug(cr) << "Network proxy defined.";
-
-        QNetworkProxy proxy;
+    /* Default proxy restores the initial state if the proxy has been
+     * switched off since the previous session. */
+    QNetworkProxy proxy;
+    if (m_endpoint.useProxy()) {
         proxy.setType(QNetworkProxy::HttpProxy);
-        proxy.setHostName(CReporterApplicationSettings::instance()->proxyUrl());
-        proxy.setPort(CReporterApplicationSettings::instance()->proxyPort());
+        proxy.setHostName(m_endpoint.proxyHost());
+        proxy.setPort(m_endpoint.proxyPort());
+    }
+    if (QNetworkProxy::applicationProxy() != proxy) {
+        qCDebug(cr) << "Network proxy changed, use proxy:" << m_endpoint.useProxy();
         QNetworkProxy::setApplicationProxy(proxy);
     }
 
+    if (m_endpoint.useSsl()) {
+        m_sslConfiguration = QSslConfiguration::defaultConfiguration();
+        m_sslConfiguration.setPeerVerifyMode(QSslSocket::VerifyNone);
+    }
+
     if (m_manager == 0) {
         m_manager = new QNetworkAccessManager(q_ptr);
         Q_CHECK_PTR(m_manager);
@@ -111,16 +140,9 @@ bool CReporterHttpClientPrivate::createRequest(const QString &file)
     QNetworkRequest request;
     QByteArray dataToSend;
 
-    // Set server URL and port.
-    QUrl url(CReporterApplicationSettings::instance()->serverUrl());
-
-    url.setPort(CReporterApplicationSettings::instance()->serverPort());
-
-    if (CReporterApplicationSettings::instance()->useSsl()) {
+    if (m_endpoint.useSsl()) {
         qCDebug(cr) << "SSL is enabled.";
-        QSslConfiguration ssl(QSslConfiguration::defaultConfiguration());
-        ssl.setPeerVerifyMode(QSslSocket::VerifyNone);
-        request.setSslConfiguration(ssl);
+        request.setSslConfiguration(m_sslConfiguration);
     }
 
     // Set file to be the current.
@@ -128,14 +150,8 @@ bool CReporterHttpClientPrivate::createRequest(const QString &file)
     qCDebug(cr) << "File to upload:" << m_currentFile.absoluteFilePath();
     qCDebug(cr) << "File size:" << m_currentFile.size() / 1024 << "kB's";
 
-    // For PUT, we need to append file name to the path.
-    QString serverPath = CReporterApplicationSettings::instance()->serverPath() +
-                         "/" + m_currentFile.fileName();
-
-    url.setPath(serverPath);
-
-    url.setQuery("uuid=" + CReporterUtils::deviceUid() +
-                 "&model=" + CReporterUtils::deviceModel());
+    QUrl url(m_endpoint.uploadUrl(m_currentFile.fileName()));
+    url.setQuery(deviceQuery());
 
     request.setUrl(url);
     qCDebug(cr) << "Upload URL:" << url.toString();
@@ -145,7 +161,10 @@ bool CReporterHttpClientPrivate::createRequest(const QString &file)
         return false;
     }
 
+    CREPORTER_PROBE2(upload_start, qPrintable(m_currentFile.fileName()), dataToSend.size());
+
     // Send request and connect signal/ slots.
+    m_requestTimer.start();
     m_reply = m_manager->put(request, dataToSend);
 
     if (m_reply == 0) {
@@ -188,8 +207,8 @@ void CReporterHttpClientPrivate::handleAuthenticationRequired(QNetworkReply *rep
     qCDebug(cr) << "Fill in the credentials.";
 
     // Fill in the credentials.
-    authenticator->setUser(CReporterApplicationSettings::instance()->username());
-    authenticator->setPassword(CReporterApplicationSettings::instance()->password());
+    authenticator->setUser(m_endpoint.username());
+    authenticator->setPassword(m_endpoint.password());
 }
 
 void CReporterHttpClientPrivate::handleSslErrors(const QList<QSslError> &errors)
@@ -213,6 +232,7 @@ void CReporterHttpClientPrivate::handleError(QNetworkReply::NetworkError error)
         // Finished is emitted by QNetworkReply after this, inidicating that
         // the connection is over.
         QString errorString = m_reply->errorString();
+        recordResponse(false);
         m_reply = 0;
         qCWarning(cr) << "Upload failed. Error code:" << error << "," << errorString;
         emit uploadError(m_currentFile.fileName(), errorString);
@@ -244,32 +264,79 @@ void CReporterHttpClientPrivate::parseReply()
         return;
     }
 
-    QUrl submissionUrl(CReporterApplicationSettings::instance()->serverUrl());
-    submissionUrl.setPort(CReporterApplicationSettings::instance()->serverPort());
-    submissionUrl.setPath("/");
-    submissionUrl.setFragment(QString("submissions/%1").arg(submissionId));
+    QUrl submissionUrl(m_endpoint.submissionUrl(submissionId));
 
-    QString corePath(CReporterCoreRegistry::instance()->getCoreLocationPaths().first());
-    QFile uploadlog(corePath + "/uploadlog");
+    QStringList corePaths(CReporterCoreRegistry::instance()->getCoreLocationPaths());
+    if (corePaths.isEmpty()) {
+        qCWarning(cr) << "No core location to write the uploadlog in.";
+        return;
+    }
+
+    QFile uploadlog(corePaths.first() + '/' + CReporter::UploadLogFileName);
     if (!uploadlog.open(QIODevice::WriteOnly | QIODevice::Append)) {
         qCWarning(cr) << "Couldn't open uploadlog for writing.";
         return;
     }
 
     QTextStream stream(&uploadlog);
-    stream << m_currentFile.fileName() << ' ' << submissionUrl.toString() << '\n';
+    stream << m_currentFile.fileName() << ' ' << submissionUrl.toString();
+    if (!m_trace.isEmpty()) {
+        stream << ' ' << m_trace.toString();
+    }
+    stream << '\n';
 
     uploadlog.close();
 }
 
+void CReporterHttpClientPrivate::recordResponse(bool success)
+{
+    CReporterStats *stats = CReporterStats::instance();
+
+    QVariant status(m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute));
+    stats->increment(QString("http_responses_total{status=\"%1\"}")
+                     .arg(status.isValid() ? status.toString() : QString("none")));
+
+    if (!success) {
+        stats->increment("uploads_failed_total");
+        return;
+    }
+
+    qint64 elapsedMs = qMax<qint64>(m_requestTimer.elapsed(), 1);
+    qint64 size = m_currentFile.size();
+
+    stats->increment("uploads_succeeded_total");
+    stats->increment("uploaded_bytes_total", size);
+    stats->observe("upload_duration_ms", elapsedMs);
+    stats->observe("upload_throughput_bytes_per_second", size * 1000 / elapsedMs);
+
+    // The report was written when the crash was detected.
+    qint64 latency = m_currentFile.lastModified().secsTo(QDateTime::currentDateTime());
+    stats->observe("report_upload_latency_seconds", qMax<qint64>(latency, 0));
+
+    for (int i = 0; i != CReporterTrace::StageCount; ++i) {
+        CReporterTrace::Stage stage = static_cast<CReporterTrace::Stage>(i);
+        qint64 duration = m_trace.duration(stage);
+        if (duration >= 0) {
+            stats->observe(QString("report_stage_duration_us{stage=\"%1\"}")
+                           .arg(CReporterTrace::stageName(stage)), duration);
+        }
+    }
+}
+
 void CReporterHttpClientPrivate::handleFinished()
 {
     qCDebug(cr) << "Uploading file:" << m_currentFile.fileName() << "finished.";
 
     m_connectionTimeout.stop();
 
+    CREPORTER_PROBE4(upload_done, qPrintable(m_currentFile.fileName()), m_currentFile.size(),
+                     m_requestTimer.isValid() ? m_requestTimer.nsecsElapsed() / 1000 : 0,
+                     int(m_reply != 0));
+
     if (m_reply) {
         // Upload was successful.
+        m_trace.mark(CReporterTrace::ReplyReceived);
+        recordResponse(true);
         parseReply();
 
         if (m_deleteFileFlag) {
@@ -280,6 +347,7 @@ void CReporterHttpClientPrivate::handleFinished()
 
     // QNetworkreply objects are owned by QNetworkAccessManager and deleted along with it.
     m_reply = 0;
+    m_trace = CReporterTrace();
 
     stateChange(CReporterHttpClient::Init);
     emit finished();
@@ -288,6 +356,8 @@ void CReporterHttpClientPrivate::handleFinished()
 void CReporterHttpClientPrivate::handleUploadProgress(qint64 bytesSent, qint64 bytesTotal)
 {
     qCDebug(cr) << "Sent:" << bytesSent << "Total:" << bytesTotal;
+    CREPORTER_PROBE3(upload_progress, bytesSent, bytesTotal,
+                     m_requestTimer.nsecsElapsed() / 1000);
 
     // Upload has started; stop the connection timeout.
     m_connectionTimeout.stop();
@@ -301,6 +371,10 @@ void CReporterHttpClientPrivate::handleUploadProgress(qint64 bytesSent, qint64 b
         stateChange(CReporterHttpClient::Sending);
     }
 
+    if (bytesSent > 0) {
+        m_trace.mark(CReporterTrace::FirstByteSent);
+    }
+
     if (bytesTotal != 0) {
         int done = (int)((bytesSent * 100) / bytesTotal);
         qCDebug(cr) << "Done:" << done << "%";
@@ -354,9 +428,16 @@ CReporterHttpClient::~CReporterHttpClient()
 }
 
 void CReporterHttpClient::initSession(bool deleteAfterSending)
+{
+    initSession(CReporterApplicationSettings::instance()->uploadEndpoint(),
+                deleteAfterSending);
+}
+
+void CReporterHttpClient::initSession(const CReporterUploadEndpoint &endpoint,
+                                      bool deleteAfterSending)
 {
     Q_D(CReporterHttpClient);
-    d->init(deleteAfterSending);
+    d->init(endpoint, deleteAfterSending);
 }
 
 CReporterHttpClient::State CReporterHttpClient::state() const
@@ -369,6 +450,12 @@ QString CReporterHttpClient::stateToString(CReporterHttpClient::State state) con
     return  QString(clientstate_string[state]);
 }
 
+void CReporterHttpClient::setTrace(const CReporterTrace &trace)
+{
+    Q_D(CReporterHttpClient);
+    d->m_trace = trace;
+}
+
 bool CReporterHttpClient::upload(const QString &file)
 {
     Q_D(CReporterHttpClient);
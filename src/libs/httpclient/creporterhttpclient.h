@@ -31,6 +31,8 @@
 
 class CReporterHttpClientPrivate;
 class CReporterHttpCntx;
+class CReporterTrace;
+class CReporterUploadEndpoint;
 
 /*!
   * @class CReporterHttpcClient
@@ -79,6 +81,15 @@ public:
      */
     void initSession(bool deleteAfterSending = true);
 
+    /*!
+     * @brief Initiates client session uploading to the given server.
+     *
+     * @param endpoint Server settings to use for the whole session.
+     * @param deleteAfterSending If set to true, file is deleted from the system
+     *  after it has been sent.
+     */
+    void initSession(const CReporterUploadEndpoint &endpoint, bool deleteAfterSending = true);
+
     /*!
      * @brief Returns Http client state.
      *
@@ -86,6 +97,15 @@ public:
      */
     State state() const;
 
+    /*!
+     * @brief Sets the trace of the file uploaded next.
+     *
+     * CReporterTrace::FirstByteSent and CReporterTrace::ReplyReceived are
+     * marked in it and the trace is stored in the uploadlog together with the
+     * submission URL.
+     */
+    void setTrace(const CReporterTrace &trace);
+
     /*! @brief Returns state in string format.
      *
      * @return State as string.
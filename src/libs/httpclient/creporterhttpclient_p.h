@@ -27,10 +27,14 @@
 
 #include  <QList>
 #include <QNetworkReply>
+#include <QElapsedTimer>
 #include <QFileInfo>
+#include <QSslConfiguration>
 #include <QTimer>
 
 #include "creporterhttpclient.h"
+#include "creportertrace.h"
+#include "creporteruploadendpoint.h"
 
 class CReporterCoreRegistry;
 class QNetworkAccessManager;
@@ -57,7 +61,7 @@ public:
      *
      * @param deleteAfterSending If True file is delete after sent successfully.
      */
-    void init(bool deleteAfterSending);
+    void init(const CReporterUploadEndpoint &endpoint, bool deleteAfterSending);
 
     /*!
      * @brief Creates a new request sent over the network.
@@ -160,6 +164,15 @@ private:
      */
     void parseReply();
 
+    /*!
+     * @brief Updates statistics once the server has replied.
+     *
+     * Successful uploads also add the stage durations of their trace.
+     *
+     * @param success Whether the file was uploaded.
+     */
+    void recordResponse(bool success);
+
 public:
     //! @arg QNetworkAccessManager object.
     QNetworkAccessManager *m_manager;
@@ -171,11 +184,19 @@ public:
     QFileInfo m_currentFile;
     //! @arg Client state.
     CReporterHttpClient::State m_clientState;
+    //! @arg Server settings of the session.
+    CReporterUploadEndpoint m_endpoint;
+    //! @arg SSL configuration of the session's requests.
+    QSslConfiguration m_sslConfiguration;
     /*!
      * Cancels running HTTP request if a connection isn't established within
      * a predefined period of time.
      */
     QTimer m_connectionTimeout;
+    //! @arg Time since the current request was sent.
+    QElapsedTimer m_requestTimer;
+    //! @arg Trace of the current file.
+    CReporterTrace m_trace;
 
     Q_DECLARE_PUBLIC(CReporterHttpClient)
 
@@ -27,6 +27,7 @@
 
 #include "creporteruploaditem.h"
 #include "creporterhttpclient.h"
+#include "creportertrace.h"
 #include "creporterutils.h"
 
 using CReporter::LoggingCategory::cr;
@@ -42,6 +43,7 @@ public:
     qint64 filesize;
     CReporterHttpClient *http;
     CReporterUploadItem::ItemStatus status;
+    CReporterTrace trace;
 };
 
 CReporterUploadItem::CReporterUploadItem(const QString &file)
@@ -76,6 +78,16 @@ QString CReporterUploadItem::filename() const
     return d_ptr->filename;
 }
 
+CReporterTrace CReporterUploadItem::trace() const
+{
+    return d_ptr->trace;
+}
+
+void CReporterUploadItem::setTrace(const CReporterTrace &trace)
+{
+    d_ptr->trace = trace;
+}
+
 void CReporterUploadItem::markDone()
 {
     qCDebug(cr) << "Item done.";
@@ -109,6 +121,7 @@ bool CReporterUploadItem::startUpload()
     connect(d->http, SIGNAL(updateProgress(int)), this, SIGNAL(updateProgress(int)));
 
     d->http->initSession();
+    d->http->setTrace(d->trace);
     if (d->http->upload(d->filepath)) {
         setStatus(Sending);
         return true;
@@ -29,6 +29,7 @@
 
 #include "creporterexport.h"
 
+class CReporterTrace;
 class CReporterUploadItemPrivate;
 
 /*!
@@ -81,6 +82,20 @@ public:
      */
     QString filename() const;
 
+    /*!
+     * @brief Returns the trace of the file.
+     *
+     * @return Trace, empty unless set with setTrace().
+     */
+    CReporterTrace trace() const;
+
+    /*!
+     * @brief Sets the trace of the file, continued while it's uploaded.
+     *
+     * @param trace Trace.
+     */
+    void setTrace(const CReporterTrace &trace);
+
     /*!
      * @brief Marks item as done. Causes to emit done().
      *
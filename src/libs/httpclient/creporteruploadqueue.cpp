@@ -27,12 +27,16 @@
 #include <QQueue>
 #include <QDebug>
 
+#include "creporterprobes.h"
 #include "creporteruploadqueue.h"
 #include "creporteruploaditem.h"
+#include "creportertrace.h"
 #include "creporterutils.h"
 
 using CReporter::LoggingCategory::cr;
 
+CREPORTER_PROBE_SEMAPHORE(queue_next);
+
 class CReporterUploadQueuePrivate
 {
 public:
@@ -66,6 +70,10 @@ void CReporterUploadQueue::enqueue(CReporterUploadItem *item)
     Q_ASSERT(item != 0);
     qCDebug(cr) << "Append new item to queue...";
 
+    CReporterTrace trace(item->trace());
+    trace.mark(CReporterTrace::Enqueued);
+    item->setTrace(trace);
+
     item->setParent(this);
     d_ptr->uploadQueue.append(item);
 
@@ -121,6 +129,8 @@ void CReporterUploadQueue::emitNextItem()
 {
     qCDebug(cr) << "Emit nextItem().";
     CReporterUploadItem *item = d_ptr->uploadQueue.dequeue();
+    CREPORTER_PROBE3(queue_next, d_ptr->uploadQueue.size(), d_ptr->nbrOfItems,
+                     item->filesize());
 
     emit nextItem(item);
 }
@@ -71,12 +71,21 @@ SOURCES += coredir/creportercoredir.cpp \
            httpclient/creporteruploadqueue.cpp \
            httpclient/creporteruploadengine.cpp \
            utils/creporterutils.cpp \
+           utils/creportercrashinfo.cpp \
+           utils/creporterstats.cpp \
+           utils/creporterstatsadaptor.cpp \
+           utils/creportertrace.cpp \
            logger/creporterlogger.cpp \
+           logger/creporterloggingadaptor.cpp \
+           logger/creporterlogring.cpp \
+           logger/creporterlogwriter.cpp \
+           serviceif/creportercorerecord.cpp \
            serviceif/creporterdaemonproxy.cpp \
            settings/creporterprivacysettingsmodel.cpp \
            settings/creportersavedstate.cpp \
            settings/creportersettingsbase.cpp \
            settings/creporterapplicationsettings.cpp \
+           settings/creporteruploadendpoint.cpp \
            settings/creportersettingsinit.cpp \
 
 # Public headers
@@ -88,21 +97,31 @@ PUBLIC_HEADERS += creporternamespace.h \
                   httpclient/creporteruploadqueue.h \
                   httpclient/creporteruploadengine.h \
                   utils/creporterutils.h \
+                  utils/creportercrashinfo.h \
+                  utils/creporterstats.h \
+                  utils/creporterstatsadaptor.h \
+                  utils/creportertrace.h \
                   logger/creporterlogger.h \
+                  logger/creporterloggingadaptor.h \
+                  serviceif/creportercorerecord.h \
                   serviceif/creporterdaemonproxy.h \
                   serviceif/creportermetatypes.h \
                   settings/creporterprivacysettingsmodel.h \
                   settings/creportersavedstate.h \
                   settings/creportersettingsbase.h \
                   settings/creporterapplicationsettings.h \
+                  settings/creporteruploadendpoint.h \
                   creporterexport.h \
 
 # Local headers
 HEADERS += $$PUBLIC_HEADERS \
+           creporterprobes.h \
            coredir/creportercoredir_p.h \
            coredir/creportercoreregistry_p.h \
             httpclient/creporterhttpclient_p.h \
             httpclient/creporteruploadengine_p.h \
+            logger/creporterlogring_p.h \
+            logger/creporterlogwriter_p.h \
             settings/creportersettingsbase_p.h \
             settings/creportersettingsinit_p.h \
 
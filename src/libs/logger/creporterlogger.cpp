@@ -26,49 +26,181 @@
  */
 
 #include <QDebug>
+#include <QHash>
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QThread>
 #include <QTime>
 #include <stdlib.h>
 #include <iostream>
 #include <syslog.h>
 
 #include "creporterlogger.h"
+#include "creporterlogwriter_p.h"
 
 #define CREPORTER_LOGGER_FILE       "file"
 #define CREPORTER_LOGGER_SYSLOG     "syslog"
+#define CREPORTER_LOGGER_BINARY     "binary"
+#define CREPORTER_LOGGER_NONE       "none"
 
+namespace {
+
+//! Size after which log files are rotated.
+const qint64 MaxLogFileSize = 1024 * 1024;
+//! Number of messages the writer thread can lag behind.
+const int LogQueueCapacity = 1024;
+
+struct Sampler {
+    int rate;
+    int counter;
+};
+
+QMutex samplersMutex;
+QHash<QByteArray, Sampler> samplers;
+//! Keeps the per message check to a single load while nothing is sampled.
+QAtomicInt samplingActive(0);
+
+QMutex categoryLevelsMutex;
+QHash<QString, QtMsgType> categoryLevels;
+QLoggingCategory::CategoryFilter previousFilter = 0;
+
+int severity(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg:
+        return 0;
+    case QtInfoMsg:
+        return 1;
+    case QtWarningMsg:
+        return 2;
+    case QtCriticalMsg:
+        return 3;
+    case QtFatalMsg:
+        return 4;
+    }
+    return 0;
+}
+
+void categoryFilter(QLoggingCategory *category)
+{
+    if (previousFilter) {
+        previousFilter(category);
+    }
+
+    QMutexLocker locker(&categoryLevelsMutex);
+    QHash<QString, QtMsgType>::ConstIterator it =
+            categoryLevels.constFind(QString::fromLatin1(category->categoryName()));
+    if (it == categoryLevels.constEnd()) {
+        return;
+    }
+
+    int level = severity(it.value());
+    category->setEnabled(QtDebugMsg, level <= severity(QtDebugMsg));
+    category->setEnabled(QtInfoMsg, level <= severity(QtInfoMsg));
+    category->setEnabled(QtWarningMsg, level <= severity(QtWarningMsg));
+    category->setEnabled(QtCriticalMsg, level <= severity(QtCriticalMsg));
+}
+
+//! (Re)installs the filter, which also applies it to all existing categories.
+void updateCategoryFilter()
+{
+    QLoggingCategory::CategoryFilter filter =
+            QLoggingCategory::installFilter(categoryFilter);
+    if (filter != categoryFilter) {
+        previousFilter = filter;
+    }
+}
+
+CReporter::LogType logTypeFromName(const QString &type, bool *ok = 0)
+{
+    CReporter::LogType result = CReporter::LogNone;
+    bool known = true;
+
+    if (type == CREPORTER_LOGGER_FILE) {
+        result = CReporter::LogFile;
+    } else if (type == CREPORTER_LOGGER_SYSLOG) {
+        result = CReporter::LogSyslog;
+    } else if (type == CREPORTER_LOGGER_BINARY) {
+        result = CReporter::LogBinary;
+    } else {
+        known = (type == CREPORTER_LOGGER_NONE);
+    }
+
+    if (ok) {
+        *ok = known;
+    }
+    return result;
+}
+
+//! @return @c false if a debug message of the category should be skipped.
+bool sampleMessage(const char *category)
+{
+    QMutexLocker locker(&samplersMutex);
+
+    QHash<QByteArray, Sampler>::Iterator it =
+            samplers.find(QByteArray::fromRawData(category, qstrlen(category)));
+    if (it == samplers.end()) {
+        return true;
+    }
+    return (it->counter++ % it->rate) == 0;
+}
+
+} // namespace
+
+struct CReporterLogger::Output {
+    CReporter::LogType type;
+    //! @arg Set for file outputs, owned.
+    CReporterLogWriter *writer;
+};
 
 CReporterLogger *CReporterLogger::sm_Instance = 0;
 bool CReporterLogger::sm_Syslog = false;
-CReporter::LogType CReporterLogger::sm_LogType = CReporter::LogNone;
 
 CReporterLogger::CReporterLogger(const QString type)
+    : m_retiredDropped(0), m_old_msg_handler(0), m_handlerInstalled(false)
 {
+    Output *output = new Output;
+    output->type = CReporter::LogNone;
+    output->writer = 0;
+    m_output.storeRelease(output);
+
     // save ourself in a static variable
     CReporterLogger::sm_Instance = this;
 
-    if (type == CREPORTER_LOGGER_FILE) {
-        CReporterLogger::sm_LogType = CReporter::LogFile;
-    } else if (type == CREPORTER_LOGGER_SYSLOG) {
-        CReporterLogger::sm_LogType = CReporter::LogSyslog;
-    }
+    open(logTypeFromName(type));
+}
 
-    switch (CReporterLogger::sm_LogType) {
-    // Initialize logging.
-    case CReporter::LogSyslog:
-        // Init syslog.
-        openlog(NULL, LOG_PID, LOG_USER);
-        break;
-    case CReporter::LogFile:
-        m_file.setFileName(CReporter::DefaultLogFile);
+CReporterLogger::~CReporterLogger ()
+{
+    open(CReporter::LogNone);
+
+    delete m_output.loadAcquire();
+
+    CReporterLogger::sm_Instance = 0;
+}
+
+bool CReporterLogger::open(CReporter::LogType type)
+{
+    Output *output = new Output;
+    output->type = type;
+    output->writer = 0;
+
+    // Open the new output first, the current one stays if that fails.
+    if (type == CReporter::LogFile || type == CReporter::LogBinary) {
+        bool binary = (type == CReporter::LogBinary);
+        const QString &fileName = binary ? CReporter::DefaultBinaryLogFile
+                                         : CReporter::DefaultLogFile;
+        output->writer = new CReporterLogWriter(fileName,
+                                                binary ? CReporterLogWriter::Binary : CReporterLogWriter::Text,
+                                                MaxLogFileSize, LogQueueCapacity);
         // Open file for appending.
-        if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
-            std::cerr << __PRETTY_FUNCTION__ << "Failed to open log file: " << qPrintable(CReporter::DefaultLogFile)
+        if (!output->writer->open()) {
+            std::cerr << __PRETTY_FUNCTION__ << "Failed to open log file: " << qPrintable(fileName)
                       << " for appending." << std::endl;
-            m_old_msg_handler = 0;
-            return;
+            delete output->writer;
+            delete output;
+            return false;
         }
-        // Set stream.
-        m_stream.setDevice(&m_file);
         // Set default message pattern
         qSetMessagePattern(QStringLiteral("%{time} %{appname}: ["
                                           "%{if-debug}D%{endif}"
@@ -77,68 +209,193 @@ CReporterLogger::CReporterLogger(const QString type)
                                           "%{if-critical}C%{endif}"
                                           "%{if-fatal}F%{endif}"
                                           "] %{function}:%{line} - %{message}"));
+    }
+
+    // Only this function replaces the output, no other thread changes it.
+    CReporter::LogType oldType = m_output.loadAcquire()->type;
+    if (type == CReporter::LogSyslog && oldType != CReporter::LogSyslog) {
+        // Init syslog.
+        openlog(NULL, LOG_PID, LOG_USER);
+    }
+
+    Output *oldOutput = m_output.fetchAndStoreOrdered(output);
+
+    /* Handlers that started before the swap may still use the old output,
+     * later ones see the new one. Posting never blocks, so this is short. */
+    while (m_handlers.fetchAndAddOrdered(0) > 0) {
+        QThread::yieldCurrentThread();
+    }
+
+    if (oldOutput->writer) {
+        oldOutput->writer->close();
+        m_retiredDropped += oldOutput->writer->droppedCount();
+        delete oldOutput->writer;
+    }
+    delete oldOutput;
+
+    if (oldType == CReporter::LogSyslog && type != CReporter::LogSyslog) {
+        closelog();
+    }
+
+    if (type == CReporter::LogNone) { // TODO Means rather LogDefault than LogNone
+        if (m_handlerInstalled) {
+            qInstallMessageHandler(m_old_msg_handler);
+            m_handlerInstalled = false;
+        }
+    } else if (!m_handlerInstalled) {
+        // Register ourselves as a debug message handler
+        m_old_msg_handler = qInstallMessageHandler(CReporterLogger::messageHandler);
+        m_handlerInstalled = true;
+    }
+
+    return true;
+}
+
+bool CReporterLogger::setLogType(const QString &type)
+{
+    if (!sm_Instance) {
+        return false;
+    }
+
+    bool ok;
+    CReporter::LogType logType = logTypeFromName(type, &ok);
+    return ok && sm_Instance->open(logType);
+}
+
+QString CReporterLogger::logType()
+{
+    if (!sm_Instance) {
+        return CREPORTER_LOGGER_NONE;
+    }
+
+    switch (sm_Instance->m_output.loadAcquire()->type) {
+    case CReporter::LogSyslog:
+        return CREPORTER_LOGGER_SYSLOG;
+    case CReporter::LogFile:
+        return CREPORTER_LOGGER_FILE;
+    case CReporter::LogBinary:
+        return CREPORTER_LOGGER_BINARY;
+    case CReporter::LogNone:
         break;
-    case CReporter::LogNone: // TODO Means rather LogDefault than LogNone
-        return;
     }
+    return CREPORTER_LOGGER_NONE;
+}
 
-    // Register ourselves as a debug message handler
-    m_old_msg_handler = qInstallMessageHandler(CReporterLogger::messageHandler);
+void CReporterLogger::setSampling(const QString &category, int rate)
+{
+    QMutexLocker locker(&samplersMutex);
+
+    if (rate > 1) {
+        Sampler &sampler = samplers[category.toLatin1()];
+        sampler.rate = rate;
+        sampler.counter = 0;
+    } else {
+        samplers.remove(category.toLatin1());
+    }
+    samplingActive.store(!samplers.isEmpty());
 }
 
-CReporterLogger::~CReporterLogger ()
+void CReporterLogger::setCategoryLevel(const QString &category, QtMsgType level)
 {
-    if (m_old_msg_handler) {
-        qInstallMessageHandler(m_old_msg_handler);
+    {
+        QMutexLocker locker(&categoryLevelsMutex);
+        categoryLevels.insert(category, level);
     }
-    if (m_file.isOpen()) {
-        m_file.close();
+    updateCategoryFilter();
+}
+
+void CReporterLogger::clearCategoryLevels()
+{
+    {
+        QMutexLocker locker(&categoryLevelsMutex);
+        categoryLevels.clear();
     }
+    // The previous filter restores the state set by the logging rules.
+    updateCategoryFilter();
+}
 
-    if (CReporterLogger::sm_LogType == CReporter::LogSyslog) {
-        closelog();
+int CReporterLogger::droppedMessages()
+{
+    if (!sm_Instance) {
+        return 0;
+    }
+
+    sm_Instance->m_handlers.ref();
+    int dropped = sm_Instance->m_retiredDropped;
+    CReporterLogWriter *writer = sm_Instance->m_output.loadAcquire()->writer;
+    if (writer) {
+        dropped += writer->droppedCount();
     }
+    sm_Instance->m_handlers.deref();
+    return dropped;
+}
+
+bool CReporterLogger::decodeBinaryLog(QIODevice *input, QTextStream &output)
+{
+    return CReporterLogWriter::decode(input, output);
 }
 
 void CReporterLogger::messageHandler(QtMsgType type,
                                      const QMessageLogContext &context,
                                      const QString &msg)
 {
-    Q_ASSERT(CReporterLogger::sm_LogType != CReporter::LogNone);
+    if (type == QtDebugMsg && samplingActive.load() && context.category
+            && !sampleMessage(context.category)) {
+        return;
+    }
 
-    QString logMessage = qFormatLogMessage(type, context, msg);
+    // Keeps the output alive until we are done with it, see open().
+    CReporterLogger::sm_Instance->m_handlers.ref();
+    const Output *output = CReporterLogger::sm_Instance->m_output.loadAcquire();
+    CReporterLogWriter *writer = output->writer;
 
-    // print nothing if message pattern didn't apply / was empty.
-    // (still print empty lines, e.g. because message itself was empty)
-    if (logMessage.isNull())
-        return;
+    if (writer && writer->format() == CReporterLogWriter::Binary) {
+        // Formatting is left to the decoder.
+        char record[CReporterLogRing::SlotSize];
+        int length = CReporterLogWriter::encodeRecord(record, type, context.category,
+                                                      context.function, context.line, msg);
+        writer->post(record, length);
+    } else if (output->type != CReporter::LogNone) {
+        QString logMessage = qFormatLogMessage(type, context, msg);
+
+        // print nothing if message pattern didn't apply / was empty.
+        // (still print empty lines, e.g. because message itself was empty)
+        if (!logMessage.isNull() && writer) {
+            QByteArray line(logMessage.toUtf8());
+            line.append('\n');
+            writer->post(line.constData(), line.size());
+        } else if (!logMessage.isNull() && output->type == CReporter::LogSyslog) {
+            int msgLevel = LOG_DEBUG;
 
-    if (CReporterLogger::sm_LogType == CReporter::LogSyslog) {
-        int msgLevel = LOG_DEBUG;
-
-        switch (type) {
-        case QtDebugMsg:
-            msgLevel = LOG_DEBUG;
-            break;
-        case QtInfoMsg:
-            msgLevel = LOG_INFO;
-            break;
-        case QtWarningMsg:
-            msgLevel = LOG_WARNING;
-            break;
-        case QtCriticalMsg:
-            msgLevel = LOG_CRIT;
-            break;
-        case QtFatalMsg:
-            msgLevel = LOG_EMERG;
-            break;
+            switch (type) {
+            case QtDebugMsg:
+                msgLevel = LOG_DEBUG;
+                break;
+            case QtInfoMsg:
+                msgLevel = LOG_INFO;
+                break;
+            case QtWarningMsg:
+                msgLevel = LOG_WARNING;
+                break;
+            case QtCriticalMsg:
+                msgLevel = LOG_CRIT;
+                break;
+            case QtFatalMsg:
+                msgLevel = LOG_EMERG;
+                break;
+            }
+
+            syslog(msgLevel, "%s", logMessage.toLocal8Bit().constData());
         }
+    }
 
-        syslog(msgLevel, "%s", logMessage.toLocal8Bit().constData());
-    } else if (CReporterLogger::sm_LogType == CReporter::LogFile) {
-        CReporterLogger::sm_Instance->m_stream << logMessage << endl;
+    if (type == QtFatalMsg && writer) {
+        writer->close();
     }
 
+    // Before exit(), the destructor may replace the output.
+    CReporterLogger::sm_Instance->m_handlers.deref();
+
     if (type == QtFatalMsg) {
         exit(1);
     }
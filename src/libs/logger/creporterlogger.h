@@ -28,13 +28,16 @@
 #ifndef CREPORTERLOGGER_H
 #define CREPORTERLOGGER_H
 
-#include <QFile>
-#include <QTextStream>
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QString>
 
 #include "creporterexport.h"
 #include "creporternamespace.h"
 
-class CReporterLoggerPrivate;
+class QIODevice;
+class QTextStream;
+class CReporterLogWriter;
 
 /*!
   * @class CReporterLogger
@@ -43,6 +46,12 @@ class CReporterLoggerPrivate;
   * By default Qt prints debug etc. messages to stderr output. This class takes
   * over the Qt debugging functions and forwards the messages to a file, syslog or
   * suppresses output totally (default).
+  *
+  * File output is asynchronous: messages are queued and written by a
+  * background thread, so logging never waits for the disk. If the queue
+  * fills up, messages are dropped and their count is logged instead. The
+  * "binary" type stores compact records that are decoded offline with
+  * decodeBinaryLog().
   */
 class CREPORTER_EXPORT CReporterLogger
 {
@@ -59,6 +68,52 @@ public:
 
     ~CReporterLogger();
 
+    /*!
+     * @brief Sets the lowest message type logged for a category.
+     *
+     * Takes effect immediately for all categories with the given name,
+     * overriding the logging rules.
+     *
+     * @param category Logging category name.
+     * @param level One of QtDebugMsg, QtInfoMsg, QtWarningMsg or QtCriticalMsg.
+     */
+    static void setCategoryLevel(const QString &category, QtMsgType level);
+
+    //! Removes all levels set with setCategoryLevel().
+    static void clearCategoryLevels();
+
+    /*!
+     * @brief Switches the log output at runtime.
+     *
+     * @param type One of "none", "file", "syslog" or "binary".
+     * @return @c false if @a type is unknown or its output couldn't be opened,
+     *  in which case the current output stays in use.
+     */
+    static bool setLogType(const QString &type);
+
+    //! @return Name of the log output in use.
+    static QString logType();
+
+    /*!
+     * @brief Logs only every @a rate th debug message of a category.
+     *
+     * @param category Logging category name.
+     * @param rate Sampling rate, 0 or 1 logs every message.
+     */
+    static void setSampling(const QString &category, int rate);
+
+    //! @return Number of messages dropped because the queue was full.
+    static int droppedMessages();
+
+    /*!
+     * @brief Decodes a log file written by the "binary" logger.
+     *
+     * @param input Binary log.
+     * @param output Stream the messages are written to as text.
+     * @return @c false if @a input isn't a valid binary log.
+     */
+    static bool decodeBinaryLog(QIODevice *input, QTextStream &output);
+
 protected:
     /*!
      * @brief Overrides default message handler.
@@ -72,17 +127,26 @@ protected:
                                const QString &msg);
 
 private:
+    struct Output;
+
+    bool open(CReporter::LogType type);
+
     //! @arg Instance pointer to the this class.
     static CReporterLogger *sm_Instance;
-    //! @arg The stream write to.
-    QTextStream m_stream;
-    //! @arg File to write.
-    QFile m_file;
+    /*! @arg Output in use, replaced as a whole so that message handlers see
+     * the log type and the writer change together. */
+    QAtomicPointer<Output> m_output;
+    /*! @arg Number of message handlers running. A replaced output is deleted
+     * once none of them can be using it any more. */
+    QAtomicInt m_handlers;
+    //! @arg Messages dropped by the writers already deleted.
+    int m_retiredDropped;
     //! @arg Old msg handler.
     QtMessageHandler m_old_msg_handler;
+    //! @arg Whether messageHandler() is installed.
+    bool m_handlerInstalled;
     //! @arg Use syslog for logging.
     static bool sm_Syslog;
-    static CReporter::LogType sm_LogType;
 };
 
 typedef CReporterLogger Logger;
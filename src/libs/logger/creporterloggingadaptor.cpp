@@ -0,0 +1,90 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <limits.h>
+
+#include <QLoggingCategory>
+
+#include "creporterlogger.h"
+#include "creporterloggingadaptor.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+CReporterLoggingAdaptor::CReporterLoggingAdaptor(QObject *parent)
+    : QDBusAbstractAdaptor(parent)
+{
+}
+
+CReporterLoggingAdaptor::~CReporterLoggingAdaptor()
+{
+}
+
+void CReporterLoggingAdaptor::setFilterRules(const QString &rules)
+{
+    qCDebug(cr) << "New logging rules:" << rules;
+    QString filterRules(rules);
+    QLoggingCategory::setFilterRules(filterRules.replace(';', '\n'));
+}
+
+bool CReporterLoggingAdaptor::setCategoryLevel(const QString &category, const QString &level)
+{
+    QtMsgType type;
+    if (level == "debug") {
+        type = QtDebugMsg;
+    } else if (level == "info") {
+        type = QtInfoMsg;
+    } else if (level == "warning") {
+        type = QtWarningMsg;
+    } else if (level == "critical") {
+        type = QtCriticalMsg;
+    } else {
+        return false;
+    }
+
+    CReporterLogger::setCategoryLevel(category, type);
+    return true;
+}
+
+void CReporterLoggingAdaptor::clearCategoryLevels()
+{
+    CReporterLogger::clearCategoryLevels();
+}
+
+bool CReporterLoggingAdaptor::setLoggerType(const QString &type)
+{
+    return CReporterLogger::setLogType(type);
+}
+
+QString CReporterLoggingAdaptor::loggerType()
+{
+    return CReporterLogger::logType();
+}
+
+void CReporterLoggingAdaptor::setSampling(const QString &category, uint rate)
+{
+    CReporterLogger::setSampling(category, int(qMin<uint>(rate, INT_MAX)));
+}
+
+uint CReporterLoggingAdaptor::droppedMessages()
+{
+    return CReporterLogger::droppedMessages();
+}
@@ -0,0 +1,57 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERLOGGINGADAPTOR_H
+#define CREPORTERLOGGINGADAPTOR_H
+
+#include <QtDBus/QtDBus>
+
+#include "creporterexport.h"
+
+/*!
+ * @class CReporterLoggingAdaptor
+ * @brief Exports runtime control of CReporterLogger over D-Bus.
+ *
+ * Create it as a child of an object registered on the bus, the interface is
+ * then exported together with the object's other adaptors.
+ *
+ * @sa com.nokia.CrashReporter.Logging.xml
+ */
+class CREPORTER_EXPORT CReporterLoggingAdaptor : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.nokia.CrashReporter.Logging")
+
+public:
+    CReporterLoggingAdaptor(QObject *parent);
+    ~CReporterLoggingAdaptor();
+
+public Q_SLOTS:
+    void setFilterRules(const QString &rules);
+    bool setCategoryLevel(const QString &category, const QString &level);
+    void clearCategoryLevels();
+    bool setLoggerType(const QString &type);
+    QString loggerType();
+    void setSampling(const QString &category, uint rate);
+    uint droppedMessages();
+};
+
+#endif // CREPORTERLOGGINGADAPTOR_H
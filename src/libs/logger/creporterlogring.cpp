@@ -0,0 +1,102 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <string.h>
+
+#include "creporterlogring_p.h"
+
+/* Bounded queue after Dmitry Vyukov's design: each slot carries a sequence
+ * number telling whether it is free for the producer claiming position n
+ * (sequence == n) or holds a record for the consumer (sequence == n + 1). */
+
+CReporterLogRing::CReporterLogRing(int capacity)
+    : m_head(0), m_tail(0), m_dropped(0)
+{
+    quint32 size = 2;
+    while (size < quint32(capacity)) {
+        size <<= 1;
+    }
+
+    m_slots.reset(new Slot[size]);
+    m_mask = size - 1;
+    for (quint32 i = 0; i != size; ++i) {
+        m_slots[i].sequence.store(i);
+        m_slots[i].length = 0;
+    }
+}
+
+bool CReporterLogRing::push(const char *data, int length)
+{
+    Slot *slot;
+    quint32 position = m_head.load();
+    forever {
+        slot = &m_slots[position & m_mask];
+        qint32 diff = qint32(slot->sequence.loadAcquire() - position);
+        if (diff == 0) {
+            if (m_head.testAndSetRelaxed(position, position + 1)) {
+                break;
+            }
+            position = m_head.load();
+        } else if (diff < 0) {
+            // The consumer hasn't freed the slot yet, the ring is full.
+            m_dropped.ref();
+            return false;
+        } else {
+            position = m_head.load();
+        }
+    }
+
+    slot->length = qMin(length, int(SlotSize));
+    memcpy(slot->data, data, slot->length);
+    slot->sequence.storeRelease(position + 1);
+
+    return true;
+}
+
+bool CReporterLogRing::pop(QByteArray *record)
+{
+    Slot *slot = &m_slots[m_tail & m_mask];
+    if (qint32(slot->sequence.loadAcquire() - (m_tail + 1)) < 0) {
+        return false;
+    }
+
+    *record = QByteArray(slot->data, slot->length);
+    slot->sequence.storeRelease(m_tail + m_mask + 1);
+    ++m_tail;
+
+    return true;
+}
+
+bool CReporterLogRing::isEmpty() const
+{
+    const Slot *slot = &m_slots[m_tail & m_mask];
+    return qint32(slot->sequence.loadAcquire() - (m_tail + 1)) < 0;
+}
+
+int CReporterLogRing::takeDropped()
+{
+    return m_dropped.fetchAndStoreRelaxed(0);
+}
+
+int CReporterLogRing::capacity() const
+{
+    return m_mask + 1;
+}
@@ -0,0 +1,92 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERLOGRING_P_H
+#define CREPORTERLOGRING_P_H
+
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QScopedArrayPointer>
+
+/*!
+ * @class CReporterLogRing
+ * @brief Bounded lock-free queue of log records.
+ *
+ * Any number of threads may push records, a single thread pops them. Records
+ * are copied into fixed size slots, longer ones are truncated. When the ring
+ * is full, new records are dropped and counted instead of blocking the
+ * caller.
+ */
+class CReporterLogRing
+{
+public:
+    //! Maximum size of one record in bytes.
+    static const int SlotSize = 512;
+
+    /*!
+     * @brief Creates the ring.
+     *
+     * @param capacity Number of slots, rounded up to a power of two.
+     */
+    explicit CReporterLogRing(int capacity);
+
+    /*!
+     * @brief Appends a record.
+     *
+     * @param data Record contents.
+     * @param length Length of @a data, truncated to SlotSize.
+     * @return @c false if the ring was full and the record was dropped.
+     */
+    bool push(const char *data, int length);
+
+    /*!
+     * @brief Removes the oldest record. Must be called from one thread only.
+     *
+     * @param record Set to the record contents.
+     * @return @c false if the ring was empty.
+     */
+    bool pop(QByteArray *record);
+
+    //! @return @c true if there is nothing to pop. Consumer side only.
+    bool isEmpty() const;
+
+    //! @return Number of records dropped since the last call.
+    int takeDropped();
+
+    int capacity() const;
+
+private:
+    Q_DISABLE_COPY(CReporterLogRing)
+
+    struct Slot {
+        QAtomicInteger<quint32> sequence;
+        int length;
+        char data[SlotSize];
+    };
+
+    QScopedArrayPointer<Slot> m_slots;
+    quint32 m_mask;
+    QAtomicInteger<quint32> m_head;
+    quint32 m_tail;
+    QAtomicInt m_dropped;
+};
+
+#endif // CREPORTERLOGRING_P_H
@@ -0,0 +1,354 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <QDateTime>
+#include <QTextStream>
+#include <QtEndian>
+
+#include "creporterlogwriter_p.h"
+
+namespace {
+
+/* Binary log file starts with the magic, then records follow:
+ *
+ *   u16 length of the rest of the record
+ *   u8  QtMsgType
+ *   u8  reserved
+ *   u32 pid
+ *   i64 time, milliseconds since the epoch
+ *   u32 line
+ *   u16 category length, category
+ *   u16 function length, function
+ *   message up to the end of the record
+ *
+ * Integers are little endian, strings are UTF-8 without terminator. */
+const char BinaryMagic[] = "CRBLOG1\n";
+const int BinaryMagicSize = sizeof(BinaryMagic) - 1;
+const int FixedHeaderSize = 20;
+//! Limit for the category and function names, the rest is for the message.
+const int MaxNameSize = 127;
+
+const char LoggerCategory[] = "crash-reporter.logger";
+
+char *putString(char *out, const char *str)
+{
+    quint16 length = str ? qMin<size_t>(strlen(str), MaxNameSize) : 0;
+    qToLittleEndian<quint16>(length, reinterpret_cast<uchar *>(out));
+    memcpy(out + 2, str, length);
+    return out + 2 + length;
+}
+
+bool takeString(const uchar **in, const uchar *end, QString *str)
+{
+    if (end - *in < 2) {
+        return false;
+    }
+    quint16 length = qFromLittleEndian<quint16>(*in);
+    *in += 2;
+    if (end - *in < length) {
+        return false;
+    }
+    *str = QString::fromUtf8(reinterpret_cast<const char *>(*in), length);
+    *in += length;
+    return true;
+}
+
+QChar typeLetter(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg:
+        return 'D';
+    case QtInfoMsg:
+        return 'I';
+    case QtWarningMsg:
+        return 'W';
+    case QtCriticalMsg:
+        return 'C';
+    case QtFatalMsg:
+        return 'F';
+    }
+    return '?';
+}
+
+} // namespace
+
+CReporterLogWriter::CReporterLogWriter(const QString &fileName, Format format,
+                                       qint64 maxFileSize, int capacity)
+    : m_ring(capacity), m_file(fileName), m_format(format),
+      m_maxFileSize(maxFileSize), m_eventFd(-1), m_sleeping(0), m_stopping(0),
+      m_dropped(0)
+{
+}
+
+CReporterLogWriter::~CReporterLogWriter()
+{
+    close();
+
+    if (m_eventFd >= 0) {
+        ::close(m_eventFd);
+    }
+}
+
+bool CReporterLogWriter::open()
+{
+    m_eventFd = eventfd(0, EFD_CLOEXEC);
+    if (m_eventFd < 0 || !openFile()) {
+        return false;
+    }
+
+    start();
+    return true;
+}
+
+bool CReporterLogWriter::post(const char *data, int length)
+{
+    if (!m_ring.push(data, length)) {
+        return false;
+    }
+
+    // Only pay for the syscall when the writer thread waits for records.
+    if (m_sleeping.testAndSetOrdered(1, 0)) {
+        wake();
+    }
+    return true;
+}
+
+void CReporterLogWriter::close()
+{
+    if (!isRunning()) {
+        return;
+    }
+
+    m_stopping.storeRelease(1);
+    wake();
+    wait();
+
+    m_file.close();
+}
+
+CReporterLogWriter::Format CReporterLogWriter::format() const
+{
+    return m_format;
+}
+
+int CReporterLogWriter::droppedCount() const
+{
+    return m_dropped.load();
+}
+
+int CReporterLogWriter::encodeRecord(char *buffer, QtMsgType type, const char *category,
+                                     const char *function, int line, const QString &message)
+{
+    static const quint32 pid = getpid();
+
+    char *out = putString(buffer + FixedHeaderSize, category);
+    out = putString(out, function);
+
+    QByteArray text(message.toUtf8());
+    int length = qMin<int>(text.size(), buffer + CReporterLogRing::SlotSize - out);
+    memcpy(out, text.constData(), length);
+    out += length;
+
+    uchar *header = reinterpret_cast<uchar *>(buffer);
+    qToLittleEndian<quint16>(out - buffer - 2, header);
+    header[2] = type;
+    header[3] = 0;
+    qToLittleEndian<quint32>(pid, header + 4);
+    qToLittleEndian<qint64>(QDateTime::currentMSecsSinceEpoch(), header + 8);
+    qToLittleEndian<quint32>(line, header + 16);
+
+    return out - buffer;
+}
+
+bool CReporterLogWriter::decode(QIODevice *input, QTextStream &output)
+{
+    if (input->read(BinaryMagicSize) != QByteArray(BinaryMagic, BinaryMagicSize)) {
+        return false;
+    }
+
+    forever {
+        // Two processes may have started the same file at once.
+        if (input->peek(BinaryMagicSize) == QByteArray(BinaryMagic, BinaryMagicSize)) {
+            input->read(BinaryMagicSize);
+            continue;
+        }
+
+        uchar lengthBytes[2];
+        qint64 count = input->read(reinterpret_cast<char *>(lengthBytes), 2);
+        if (count == 0) {
+            return true;
+        } else if (count != 2) {
+            return false;
+        }
+
+        quint16 length = qFromLittleEndian<quint16>(lengthBytes);
+        QByteArray record(input->read(length));
+        if (record.size() != length || length < FixedHeaderSize - 2) {
+            return false;
+        }
+
+        const uchar *in = reinterpret_cast<const uchar *>(record.constData());
+        const uchar *end = in + length;
+
+        QtMsgType type = QtMsgType(in[0]);
+        quint32 pid = qFromLittleEndian<quint32>(in + 2);
+        qint64 time = qFromLittleEndian<qint64>(in + 6);
+        quint32 line = qFromLittleEndian<quint32>(in + 14);
+        in += FixedHeaderSize - 2;
+
+        QString category;
+        QString function;
+        if (!takeString(&in, end, &category) || !takeString(&in, end, &function)) {
+            return false;
+        }
+
+        output << QDateTime::fromMSecsSinceEpoch(time).toString("yyyy-MM-dd hh:mm:ss.zzz")
+               << " [" << pid << "] [" << typeLetter(type) << "] " << category << ' '
+               << function << ':' << line << " - "
+               << QString::fromUtf8(reinterpret_cast<const char *>(in), end - in) << '\n';
+    }
+}
+
+void CReporterLogWriter::run()
+{
+    forever {
+        bool stopping = m_stopping.loadAcquire();
+        drain();
+        if (stopping) {
+            break;
+        }
+
+        /* Announce the sleep before the last check, so that a record pushed
+         * after it is guaranteed to see the flag and wake us up. */
+        m_sleeping.fetchAndStoreOrdered(1);
+        if (m_ring.isEmpty() && !m_stopping.loadAcquire()) {
+            quint64 value;
+            if (::read(m_eventFd, &value, sizeof(value)) < 0 && errno != EINTR) {
+                break;
+            }
+        }
+        m_sleeping.storeRelease(0);
+    }
+}
+
+void CReporterLogWriter::wake()
+{
+    quint64 value = 1;
+    ssize_t result = ::write(m_eventFd, &value, sizeof(value));
+    Q_UNUSED(result);
+}
+
+bool CReporterLogWriter::openFile()
+{
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return false;
+    }
+
+    if (m_format == Binary && m_file.size() == 0) {
+        m_file.write(BinaryMagic, BinaryMagicSize);
+    }
+    return true;
+}
+
+bool CReporterLogWriter::fileReplaced()
+{
+    struct stat fileStat;
+    struct stat pathStat;
+    if (fstat(m_file.handle(), &fileStat) < 0) {
+        return false;
+    }
+    if (stat(QFile::encodeName(m_file.fileName()).constData(), &pathStat) < 0) {
+        return true;
+    }
+    return fileStat.st_ino != pathStat.st_ino || fileStat.st_dev != pathStat.st_dev;
+}
+
+void CReporterLogWriter::rotate()
+{
+    QString fileName(m_file.fileName());
+
+    /* Every process appending to the file checks its size, the lock lets
+     * only one of them do the rotation. */
+    flock(m_file.handle(), LOCK_EX);
+    if (!fileReplaced()) {
+        QFile::remove(fileName + ".1");
+        QFile::rename(fileName, fileName + ".1");
+    }
+    m_file.close();
+    openFile();
+}
+
+void CReporterLogWriter::drain()
+{
+    QByteArray record;
+    bool written = false;
+    while (m_ring.pop(&record)) {
+        /* Another process may have rotated the file, records written to the
+         * old one would be lost once it gets rotated again. */
+        if (!written && fileReplaced()) {
+            m_file.close();
+            openFile();
+        }
+        m_file.write(record);
+        written = true;
+    }
+
+    int dropped = m_ring.takeDropped();
+    if (dropped > 0) {
+        m_dropped.fetchAndAddRelaxed(dropped);
+        writeDropped(dropped);
+        written = true;
+    }
+
+    if (!written) {
+        return;
+    }
+
+    m_file.flush();
+
+    if (m_file.size() >= m_maxFileSize) {
+        rotate();
+    }
+}
+
+void CReporterLogWriter::writeDropped(int count)
+{
+    QString message(QString("%1 log messages dropped, the queue was full.").arg(count));
+
+    if (m_format == Binary) {
+        char buffer[CReporterLogRing::SlotSize];
+        m_file.write(buffer, encodeRecord(buffer, QtWarningMsg, LoggerCategory,
+                                          Q_FUNC_INFO, __LINE__, message));
+    } else {
+        QMessageLogContext context(__FILE__, __LINE__, Q_FUNC_INFO, LoggerCategory);
+        QString line(qFormatLogMessage(QtWarningMsg, context, message));
+        if (!line.isNull()) {
+            m_file.write(line.append('\n').toUtf8());
+        }
+    }
+}
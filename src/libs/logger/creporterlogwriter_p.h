@@ -0,0 +1,125 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERLOGWRITER_P_H
+#define CREPORTERLOGWRITER_P_H
+
+#include <QFile>
+#include <QThread>
+
+#include "creporterlogring_p.h"
+
+class QTextStream;
+
+/*!
+ * @class CReporterLogWriter
+ * @brief Writes log records to a file from a background thread.
+ *
+ * Records are queued in a CReporterLogRing, so posting never blocks on disk
+ * I/O. The thread sleeps on an eventfd while the ring is empty. When the file
+ * grows over the size limit, it is renamed with a ".1" suffix, replacing the
+ * previous one, and a new file is started. Several processes can share the
+ * file: rotation is done under a lock and the others follow to the new file.
+ */
+class CReporterLogWriter : public QThread
+{
+public:
+    enum Format {
+        //! Records are lines of formatted text.
+        Text,
+        //! Records are binary, see encodeRecord().
+        Binary,
+    };
+
+    /*!
+     * @brief Creates the writer.
+     *
+     * @param fileName Log file to append to.
+     * @param format Format of the records.
+     * @param maxFileSize Size after which the file is rotated.
+     * @param capacity Number of records that can be queued.
+     */
+    CReporterLogWriter(const QString &fileName, Format format,
+                       qint64 maxFileSize, int capacity);
+    ~CReporterLogWriter();
+
+    /*!
+     * @brief Opens the log file and starts the writer thread.
+     *
+     * @return @c false if the file couldn't be opened.
+     */
+    bool open();
+
+    /*!
+     * @brief Queues a record for writing. Can be called from any thread.
+     *
+     * @return @c false if the queue was full and the record was dropped.
+     */
+    bool post(const char *data, int length);
+
+    Format format() const;
+
+    //! Writes out all queued records and stops the thread.
+    void close();
+
+    //! @return Total number of dropped records.
+    int droppedCount() const;
+
+    /*!
+     * @brief Encodes a binary log record.
+     *
+     * @param buffer Buffer of CReporterLogRing::SlotSize bytes. The message
+     *  is truncated to fit.
+     * @return Length of the record.
+     */
+    static int encodeRecord(char *buffer, QtMsgType type, const char *category,
+                            const char *function, int line, const QString &message);
+
+    /*!
+     * @brief Decodes a binary log file into text.
+     *
+     * @return @c false if @a input isn't a binary log or is corrupted.
+     */
+    static bool decode(QIODevice *input, QTextStream &output);
+
+protected:
+    void run();
+
+private:
+    void wake();
+    bool openFile();
+    //! @return @c true if the path no longer leads to the open file.
+    bool fileReplaced();
+    void rotate();
+    void drain();
+    void writeDropped(int count);
+
+    CReporterLogRing m_ring;
+    QFile m_file;
+    Format m_format;
+    qint64 m_maxFileSize;
+    int m_eventFd;
+    QAtomicInt m_sleeping;
+    QAtomicInt m_stopping;
+    QAtomicInt m_dropped;
+};
+
+#endif // CREPORTERLOGWRITER_P_H
@@ -0,0 +1,60 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creportercorerecord.h"
+
+#include <QDBusMetaType>
+
+CReporterCoreRecord::CReporterCoreRecord()
+    : size(0), modified(0), signal(0), pid(0), reportClass(0),
+      uploadState(UploadPending), duplicateCount(0)
+{
+}
+
+void CReporterCoreRecord::registerMetaType()
+{
+    qRegisterMetaType<CReporterCoreRecord>("CReporterCoreRecord");
+    qRegisterMetaType<CReporterCoreRecordList>("CReporterCoreRecordList");
+    qDBusRegisterMetaType<CReporterCoreRecord>();
+    qDBusRegisterMetaType<CReporterCoreRecordList>();
+}
+
+QDBusArgument &operator<<(QDBusArgument &argument,
+                          const CReporterCoreRecord &record)
+{
+    argument.beginStructure();
+    argument << record.filePath << record.size << record.modified
+             << record.applicationName << record.signal << record.pid
+             << record.reportClass << record.uploadState << record.duplicateCount;
+    argument.endStructure();
+    return argument;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &argument,
+                                CReporterCoreRecord &record)
+{
+    argument.beginStructure();
+    argument >> record.filePath >> record.size >> record.modified
+             >> record.applicationName >> record.signal >> record.pid
+             >> record.reportClass >> record.uploadState >> record.duplicateCount;
+    argument.endStructure();
+    return argument;
+}
@@ -0,0 +1,82 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERCORERECORD_H
+#define CREPORTERCORERECORD_H
+
+#include <QDBusArgument>
+#include <QList>
+#include <QMetaType>
+#include <QString>
+
+#include "creporterexport.h"
+
+/*!
+ * @struct CReporterCoreRecord
+ * @brief Description of a rich core file as kept in the daemon's report index.
+ *
+ * Lets clients list reports over D-Bus without stat'ing each file or parsing
+ * its name. Marshalled as (sxxsiiiii).
+ */
+struct CREPORTER_EXPORT CReporterCoreRecord
+{
+    //! Whether the report was handed over for uploading.
+    enum UploadState {
+        UploadPending,
+        UploadQueued,
+    };
+
+    CReporterCoreRecord();
+
+    /*!
+     * @brief Registers the record types with the Qt meta-type and D-Bus
+     * type systems. Must be called before the types are used over D-Bus.
+     */
+    static void registerMetaType();
+
+    //! @arg Absolute path to the rich core file.
+    QString filePath;
+    //! @arg File size in bytes.
+    qint64 size;
+    //! @arg Last modification time, milliseconds since the epoch.
+    qint64 modified;
+    QString applicationName;
+    int signal;
+    int pid;
+    //! @arg One of CReporterCrashInfo::ReportClass.
+    int reportClass;
+    //! @arg One of UploadState.
+    int uploadState;
+    //! @arg Similar crashes seen by the daemon's monitor.
+    int duplicateCount;
+};
+
+typedef QList<CReporterCoreRecord> CReporterCoreRecordList;
+
+Q_DECLARE_METATYPE(CReporterCoreRecord)
+Q_DECLARE_METATYPE(CReporterCoreRecordList)
+
+CREPORTER_EXPORT QDBusArgument &operator<<(QDBusArgument &argument,
+                                           const CReporterCoreRecord &record);
+CREPORTER_EXPORT const QDBusArgument &operator>>(const QDBusArgument &argument,
+                                                 CReporterCoreRecord &record);
+
+#endif // CREPORTERCORERECORD_H
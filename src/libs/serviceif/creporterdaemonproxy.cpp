@@ -42,6 +42,8 @@
 CReporterDaemonProxy::CReporterDaemonProxy(const QString &service, const QString &path, const QDBusConnection &connection, QObject *parent)
     : QDBusAbstractInterface(service, path, staticInterfaceName(), connection, parent)
 {
+    // HAND-EDIT
+    CReporterCoreRecord::registerMetaType();
 }
 
 CReporterDaemonProxy::~CReporterDaemonProxy()
@@ -46,6 +46,7 @@
 
 // HAND-EDIT
 #include "creporterexport.h"
+#include "creportercorerecord.h"
 
 /*
  * Proxy class for interface com.nokia.CrashReporter.Daemon
@@ -71,6 +72,45 @@ public Q_SLOTS: // METHODS
         return asyncCallWithArgumentList(QLatin1String("getAllCoreFiles"), argumentList);
     }
 
+    inline QDBusPendingReply<CReporterCoreRecordList, uint, qulonglong> getCoreFileRecords(uint offset, uint limit, const QVariantMap &filter)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(offset) << QVariant::fromValue(limit) << QVariant::fromValue(filter);
+        return asyncCallWithArgumentList(QLatin1String("getCoreFileRecords"), argumentList);
+    }
+    inline QDBusReply<CReporterCoreRecordList> getCoreFileRecords(uint offset, uint limit, const QVariantMap &filter, uint &total, qulonglong &generation)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(offset) << QVariant::fromValue(limit) << QVariant::fromValue(filter);
+        QDBusMessage reply = callWithArgumentList(QDBus::Block, QLatin1String("getCoreFileRecords"), argumentList);
+        if (reply.type() == QDBusMessage::ReplyMessage && reply.arguments().count() == 3) {
+            total = qdbus_cast<uint>(reply.arguments().at(1));
+            generation = qdbus_cast<qulonglong>(reply.arguments().at(2));
+        }
+        return reply;
+    }
+
+    inline QDBusPendingReply<QStringList, qulonglong> getReportSnapshot()
+    {
+        QList<QVariant> argumentList;
+        return asyncCallWithArgumentList(QLatin1String("getReportSnapshot"), argumentList);
+    }
+    inline QDBusReply<QStringList> getReportSnapshot(qulonglong &generation)
+    {
+        QList<QVariant> argumentList;
+        QDBusMessage reply = callWithArgumentList(QDBus::Block, QLatin1String("getReportSnapshot"), argumentList);
+        if (reply.type() == QDBusMessage::ReplyMessage && reply.arguments().count() == 2) {
+            generation = qdbus_cast<qulonglong>(reply.arguments().at(1));
+        }
+        return reply;
+    }
+
+    inline QDBusPendingReply<QVariantMap> getUploadTraceSummary()
+    {
+        QList<QVariant> argumentList;
+        return asyncCallWithArgumentList(QLatin1String("getUploadTraceSummary"), argumentList);
+    }
+
     inline QDBusPendingReply<> startCoreMonitoring()
     {
         QList<QVariant> argumentList;
@@ -84,6 +124,8 @@ public Q_SLOTS: // METHODS
     }
 
 Q_SIGNALS: // SIGNALS
+    void reportAdded(const QString &filePath, qulonglong generation);
+    void reportRemoved(const QString &filePath, qulonglong generation);
 };
 
 #endif
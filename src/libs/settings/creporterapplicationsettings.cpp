@@ -40,6 +40,11 @@ public:
 
     int intValue(const QString &key, const QVariant &defaultValue) const;
 
+    void invalidateEndpoint();
+
+    //! @arg Built on demand, null when settings changed since.
+    mutable CReporterUploadEndpoint endpoint;
+
 private:
     Q_DECLARE_PUBLIC(CReporterApplicationSettings)
     CReporterApplicationSettings *q_ptr;
@@ -60,6 +65,11 @@ int CReporterApplicationSettingsPrivate::intValue(const QString &key, const QVar
     return ok ? result : defaultValue.toInt();
 }
 
+void CReporterApplicationSettingsPrivate::invalidateEndpoint()
+{
+    endpoint = CReporterUploadEndpoint();
+}
+
 CReporterApplicationSettings *CReporterApplicationSettings::instance()
 {
     if (sm_Instance == 0) {
@@ -197,8 +207,57 @@ void CReporterApplicationSettings::setLoggerType(const QString &type)
         emit loggerTypeChanged();
 }
 
+QString CReporterApplicationSettings::prometheusTextfileDir() const
+{
+    return value(Stats::ValuePrometheusTextfileDir, QString()).toString();
+}
+
+void CReporterApplicationSettings::setPrometheusTextfileDir(const QString &dir)
+{
+    if (setValue(Stats::ValuePrometheusTextfileDir, dir))
+        emit prometheusTextfileDirChanged();
+}
+
+int CReporterApplicationSettings::idleTimeout() const
+{
+    const Q_D(CReporterApplicationSettings);
+
+    return d->intValue(Daemon::ValueIdleTimeout, 30);
+}
+
+void CReporterApplicationSettings::setIdleTimeout(int seconds)
+{
+    if (setValue(Daemon::ValueIdleTimeout, seconds))
+        emit idleTimeoutChanged();
+}
+
+CReporterUploadEndpoint CReporterApplicationSettings::uploadEndpoint() const
+{
+    const Q_D(CReporterApplicationSettings);
+
+    // The settings application writes the file from another process.
+    if (reloadIfChanged()) {
+        d->endpoint = CReporterUploadEndpoint();
+    }
+
+    if (d->endpoint.isNull()) {
+        CReporterUploadEndpoint endpoint(serverUrl(), serverPort(), serverPath(),
+                                         useSsl(), username(), password());
+        if (useProxy()) {
+            endpoint.setProxy(proxyUrl(), proxyPort());
+        }
+        d->endpoint = endpoint;
+    }
+
+    return d->endpoint;
+}
+
 CReporterApplicationSettings::CReporterApplicationSettings()
     : CReporterSettingsBase("crash-reporter-settings", "crash-reporter"),
       d_ptr(new CReporterApplicationSettingsPrivate(this))
 {
+    connect(this, SIGNAL(valueChanged(QString, QVariant)),
+            this, SLOT(invalidateEndpoint()));
 }
+
+#include "moc_creporterapplicationsettings.cpp"
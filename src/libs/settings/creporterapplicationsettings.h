@@ -29,6 +29,7 @@
 #define CREPORTERAPPLICATIONSETTINGS_H
 
 #include "creportersettingsbase.h"
+#include "creporteruploadendpoint.h"
 
 class CReporterApplicationSettingsPrivate;
 
@@ -66,6 +67,24 @@ namespace Logging {
 const QString ValueLoggerType = "Logging/logger_type";
 }
 
+/*!
+  * @namespace Stats
+  * @brief Key/ value pairs for statistics related settings.
+  *
+  */
+namespace Stats {
+const QString ValuePrometheusTextfileDir = "Stats/prometheus_textfile_dir";
+}
+
+/*!
+  * @namespace Daemon
+  * @brief Key/ value pairs for daemon related settings.
+  *
+  */
+namespace Daemon {
+const QString ValueIdleTimeout = "Daemon/idle_timeout";
+}
+
 /*!
   * @class CReporterApplicationSettings
   * @brief This a singleton class for reading and writing crash-reporter application settings.
@@ -85,6 +104,8 @@ class CReporterApplicationSettings : public CReporterSettingsBase
     Q_PROPERTY(QString proxyUrl READ proxyUrl WRITE setProxyUrl NOTIFY proxyUrlChanged)
     Q_PROPERTY(int proxyPort READ proxyPort WRITE setProxyPort NOTIFY proxyPortChanged)
     Q_PROPERTY(QString loggerType READ loggerType WRITE setLoggerType NOTIFY loggerTypeChanged)
+    Q_PROPERTY(QString prometheusTextfileDir READ prometheusTextfileDir WRITE setPrometheusTextfileDir NOTIFY prometheusTextfileDirChanged)
+    Q_PROPERTY(int idleTimeout READ idleTimeout WRITE setIdleTimeout NOTIFY idleTimeoutChanged)
 
 public:
     /*!
@@ -132,6 +153,31 @@ public:
     QString loggerType() const;
     void setLoggerType(const QString &type);
 
+    /*!
+     * @brief Returns the directory statistics are exported to.
+     *
+     * Each process writes a <application name>.prom file there. Empty if
+     * the export is disabled.
+     */
+    QString prometheusTextfileDir() const;
+    void setPrometheusTextfileDir(const QString &dir);
+
+    /*!
+     * @brief Returns how many seconds an on-demand daemon stays idle
+     * before it exits.
+     */
+    int idleTimeout() const;
+    void setIdleTimeout(int seconds);
+
+    /*!
+     * @brief Returns the server and proxy settings used for uploading.
+     *
+     * The endpoint is built on the first call and replaced as a whole once
+     * any setting changes, also when another process rewrites the settings
+     * file.
+     */
+    CReporterUploadEndpoint uploadEndpoint() const;
+
 signals:
     void serverUrlChanged();
     void serverPortChanged();
@@ -143,6 +189,8 @@ signals:
     void proxyUrlChanged();
     void proxyPortChanged();
     void loggerTypeChanged();
+    void prometheusTextfileDirChanged();
+    void idleTimeoutChanged();
 
 protected:
     /*!
@@ -157,6 +205,8 @@ private:
     CReporterApplicationSettingsPrivate *d_ptr;
     //! @arg Static class reference.
     static CReporterApplicationSettings *sm_Instance;
+
+    Q_PRIVATE_SLOT(d_func(), void invalidateEndpoint())
 };
 
 #endif // CREPORTERAPPLICATIONSETTINGS_H
@@ -166,7 +166,8 @@ public:
     /*!
      * @brief Reads setting for including stack trace into crash report.
      *
-     * @note This setting is used by rich-core-dumper.
+     * @note This setting is used by rich-core-dumper and crash-reporter-dumper,
+     * which unwinds the core on the device.
      * @return true if stack trace should be included; otherwise false.
      */
     bool includeStackTrace() const;
@@ -174,7 +175,8 @@ public:
     /*!
      * @brief Reads setting for automatic download of debug symbols.
      *
-     * @note This setting is used by rich-core-dumper.
+     * @note This setting is used by rich-core-dumper and crash-reporter-dumper,
+     * which then unwinds with debuginfo from crash-reporter-debuginfo's cache.
      * @return true if debug symbols should be downloaded; otherwise false.
      */
     bool downloadDebuginfo() const;
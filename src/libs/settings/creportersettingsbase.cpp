@@ -22,22 +22,88 @@
  *
  */
 
+#include <QCoreApplication>
 #include <QSettings>
 #include <QFile>
 
+#include <sys/stat.h>
 
 #include "creportersettingsbase_p.h"
 #include "creportersettingsbase.h"
 #include "creportersettingsinit_p.h"
 #include "creporternamespace.h"
 
+namespace {
+//! Time to collect changes before they are written to the file.
+const int FlushDelay = 2000;
+}
+
 CReporterSettingsBasePrivate::CReporterSettingsBasePrivate()
-    : m_settings(0)
+    : m_settings(0), m_flushCount(0), m_fileInode(0), m_fileModified(0)
 {
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(FlushDelay);
+    connect(&m_flushTimer, SIGNAL(timeout()), this, SLOT(flush()));
 }
 
 CReporterSettingsBasePrivate::~CReporterSettingsBasePrivate()
 {
+    flush();
+}
+
+void CReporterSettingsBasePrivate::scheduleFlush()
+{
+    if (m_flushTimer.isActive()) {
+        return;
+    }
+    m_flushTimer.start();
+
+    /* Singletons may be created before the application object, so connect
+     * only once there is something to write. */
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), SIGNAL(aboutToQuit()),
+                this, SLOT(flush()), Qt::UniqueConnection);
+    }
+}
+
+bool CReporterSettingsBasePrivate::updateFileStamp()
+{
+    quint64 inode = 0;
+    qint64 modified = 0;
+
+    struct stat st;
+    if (m_settings && stat(QFile::encodeName(m_settings->fileName()).constData(), &st) == 0) {
+        inode = st.st_ino;
+        modified = qint64(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    }
+
+    bool changed = inode != m_fileInode || modified != m_fileModified;
+    m_fileInode = inode;
+    m_fileModified = modified;
+    return changed;
+}
+
+void CReporterSettingsBasePrivate::flush()
+{
+    m_flushTimer.stop();
+
+    if (m_pending.isEmpty() || !m_settings) {
+        return;
+    }
+
+    /* QSettings would sync on its own after every setValue() call that
+     * reaches the event loop. Handing it all changes right before sync()
+     * writes them at once, replacing the file through a temporary one. */
+    for (QVariantHash::const_iterator it = m_pending.constBegin();
+         it != m_pending.constEnd(); ++it) {
+        m_settings->setValue(it.key(), it.value());
+    }
+    m_pending.clear();
+
+    m_settings->sync();
+    ++m_flushCount;
+    // Our own write isn't a change made by someone else.
+    updateFileStamp();
 }
 
 CReporterSettingsBase::CReporterSettingsBase(const QString &organization,
@@ -49,11 +115,13 @@ CReporterSettingsBase::CReporterSettingsBase(const QString &organization,
     creporterSettingsInit(CReporter::SystemSettingsLocation);
     d_ptr->m_settings = new QSettings(QSettings::NativeFormat, QSettings::UserScope,
                                       organization, application, this);
-
+    d_ptr->updateFileStamp();
 }
 
 CReporterSettingsBase::~CReporterSettingsBase()
 {
+    d_ptr->flush();
+
     delete d_ptr;
     d_ptr = 0;
 }
@@ -62,7 +130,14 @@ void CReporterSettingsBase::writeSettings()
 {
     Q_D(CReporterSettingsBase);
     // Write any unsaved changes to permanent storage.
-    d->m_settings->sync();
+    d->flush();
+}
+
+int CReporterSettingsBase::flushCount() const
+{
+    Q_D(const CReporterSettingsBase);
+
+    return d->m_flushCount;
 }
 
 QString CReporterSettingsBase::settingsFile() const
@@ -92,21 +167,44 @@ bool CReporterSettingsBase::setValue(const QString &key, const QVariant &value)
 {
     Q_D(CReporterSettingsBase);
 
-    QVariant oldValue = d->m_settings->value(key);
-    // Set value for the setting.
-    d->m_settings->setValue(key, value);
-
-    if (oldValue != value) {
-        // Notify change, if setting value was changed.
-        emit valueChanged(key, value);
-        return true;
+    if (this->value(key) == value) {
+        return false;
     }
 
-    return false;
+    // Keep the value in memory, it gets written together with other changes.
+    d->m_pending.insert(key, value);
+    d->scheduleFlush();
+
+    // Notify change, if setting value was changed.
+    emit valueChanged(key, value);
+    return true;
 }
 
 QVariant CReporterSettingsBase::value(const QString &key, const QVariant &defaultValue) const
 {
+    Q_D(const CReporterSettingsBase);
+
+    QVariantHash::const_iterator it = d->m_pending.constFind(key);
+    if (it != d->m_pending.constEnd()) {
+        return it.value();
+    }
+
     // Find and return value.
-    return d_ptr->m_settings->value(key, defaultValue);
+    return d->m_settings->value(key, defaultValue);
+}
+
+bool CReporterSettingsBase::reloadIfChanged() const
+{
+    // Re-reading doesn't change any value set through this object.
+    CReporterSettingsBasePrivate *d = d_ptr;
+
+    if (!d->updateFileStamp()) {
+        return false;
+    }
+
+    // Pending changes are merged in, sync() re-reads the rest from the file.
+    d->flush();
+    d->m_settings->sync();
+    d->updateFileStamp();
+    return true;
 }
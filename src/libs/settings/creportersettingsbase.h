@@ -57,9 +57,18 @@ public:
     /*!
      * @brief Saves any unsaved settings in the permanent storage.
      *
+     * Changed values are otherwise kept in memory and written together a
+     * short while after the first change, at application exit, or when the
+     * object is destroyed. Call this only when the file has to be up to date
+     * immediately.
      */
     void writeSettings();
 
+    /*!
+     * @brief Returns how many times changes were written to the settings file.
+     */
+    int flushCount() const;
+
     /*!
      * @brief Return path to settings file.
      *
@@ -105,6 +114,13 @@ protected:
      */
     QVariant value(const QString &key, const QVariant &defaultValue = QVariant()) const;
 
+    /*!
+     * @brief Re-reads the settings file if another process has replaced it.
+     *
+     * @return true if the file changed since it was last read or written.
+     */
+    bool reloadIfChanged() const;
+
 private:
     Q_DECLARE_PRIVATE(CReporterSettingsBase)
 
@@ -26,6 +26,8 @@
 #define CREPORTERSETTINGSBASE_P_H
 
 #include <QObject>
+#include <QTimer>
+#include <QVariantHash>
 
 #include "creportersettingsbase.h"
 
@@ -45,9 +47,38 @@ public:
     CReporterSettingsBasePrivate();
     virtual ~CReporterSettingsBasePrivate();
 
+    /*!
+     * @brief Starts the delay after which pending changes are written, and
+     * makes sure they are written when the application quits.
+     */
+    void scheduleFlush();
+
+    /*!
+     * @brief Stats the settings file and remembers its identity.
+     *
+     * @return true if the file differs from the one seen previously.
+     */
+    bool updateFileStamp();
+
+public Q_SLOTS:
+    /*!
+     * @brief Writes pending changes to the settings file.
+     */
+    void flush();
+
 public:
     //! @arg Settings read from file.
     QSettings *m_settings;
+    //! @arg Changed values not yet handed to m_settings.
+    QVariantHash m_pending;
+    //! @arg Delays writing of the changes to coalesce them.
+    QTimer m_flushTimer;
+    //! @arg Number of times changes were written to the file.
+    int m_flushCount;
+    //! @arg Inode of the settings file, QSettings replaces it on every write.
+    quint64 m_fileInode;
+    //! @arg Modification time of the settings file in nanoseconds.
+    qint64 m_fileModified;
 
 private:
     Q_DECLARE_PUBLIC(CReporterSettingsBase)
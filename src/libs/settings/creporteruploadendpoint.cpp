@@ -0,0 +1,144 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creporteruploadendpoint.h"
+
+#include <QSharedData>
+
+class CReporterUploadEndpointData: public QSharedData
+{
+public:
+    CReporterUploadEndpointData() : useSsl(false), useProxy(false), proxyPort(0) {}
+
+    QUrl serverUrl;
+    QString serverPath;
+    bool useSsl;
+    QString username;
+    QString password;
+    bool useProxy;
+    QString proxyHost;
+    int proxyPort;
+};
+
+CReporterUploadEndpoint::CReporterUploadEndpoint()
+{
+}
+
+CReporterUploadEndpoint::CReporterUploadEndpoint(const QString &serverUrl, int serverPort,
+        const QString &serverPath, bool useSsl, const QString &username,
+        const QString &password)
+    : d(new CReporterUploadEndpointData)
+{
+    d->serverUrl.setUrl(serverUrl);
+    d->serverUrl.setPort(serverPort);
+    d->serverPath = serverPath;
+    d->useSsl = useSsl;
+    d->username = username;
+    d->password = password;
+}
+
+CReporterUploadEndpoint::CReporterUploadEndpoint(const CReporterUploadEndpoint &other)
+    : d(other.d)
+{
+}
+
+CReporterUploadEndpoint &CReporterUploadEndpoint::operator=(const CReporterUploadEndpoint &other)
+{
+    d = other.d;
+    return *this;
+}
+
+CReporterUploadEndpoint::~CReporterUploadEndpoint()
+{
+}
+
+void CReporterUploadEndpoint::setProxy(const QString &host, int port)
+{
+    Q_ASSERT(d && d->ref.load() == 1);
+
+    d->useProxy = true;
+    d->proxyHost = host;
+    d->proxyPort = port;
+}
+
+bool CReporterUploadEndpoint::isNull() const
+{
+    return !d;
+}
+
+QUrl CReporterUploadEndpoint::serverUrl() const
+{
+    return d ? d->serverUrl : QUrl();
+}
+
+QUrl CReporterUploadEndpoint::uploadUrl(const QString &fileName) const
+{
+    if (!d) {
+        return QUrl();
+    }
+
+    // For PUT, the file name is appended to the path.
+    QUrl url(d->serverUrl);
+    url.setPath(d->serverPath + "/" + fileName);
+    return url;
+}
+
+QUrl CReporterUploadEndpoint::submissionUrl(int submissionId) const
+{
+    if (!d) {
+        return QUrl();
+    }
+
+    QUrl url(d->serverUrl);
+    url.setPath("/");
+    url.setFragment(QString("submissions/%1").arg(submissionId));
+    return url;
+}
+
+bool CReporterUploadEndpoint::useSsl() const
+{
+    return d && d->useSsl;
+}
+
+QString CReporterUploadEndpoint::username() const
+{
+    return d ? d->username : QString();
+}
+
+QString CReporterUploadEndpoint::password() const
+{
+    return d ? d->password : QString();
+}
+
+bool CReporterUploadEndpoint::useProxy() const
+{
+    return d && d->useProxy;
+}
+
+QString CReporterUploadEndpoint::proxyHost() const
+{
+    return d ? d->proxyHost : QString();
+}
+
+int CReporterUploadEndpoint::proxyPort() const
+{
+    return d ? d->proxyPort : 0;
+}
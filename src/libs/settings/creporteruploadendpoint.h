@@ -0,0 +1,104 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERUPLOADENDPOINT_H
+#define CREPORTERUPLOADENDPOINT_H
+
+#include <QExplicitlySharedDataPointer>
+#include <QString>
+#include <QUrl>
+
+#include "creporterexport.h"
+
+class CReporterUploadEndpointData;
+
+/*!
+ * @class CReporterUploadEndpoint
+ * @brief Immutable snapshot of the settings describing the upload server.
+ *
+ * Built once from CReporterApplicationSettings and shared by copies, so
+ * that uploads don't look the values up in the settings for every request.
+ *
+ * @sa CReporterApplicationSettings::uploadEndpoint()
+ */
+class CREPORTER_EXPORT CReporterUploadEndpoint
+{
+public:
+    //! Creates a null endpoint.
+    CReporterUploadEndpoint();
+
+    /*!
+     * @brief Creates an endpoint.
+     *
+     * @param serverUrl Server address, its port is replaced by @a serverPort.
+     * @param serverPort Server port.
+     * @param serverPath Path reports are uploaded under.
+     * @param useSsl Whether to use SSL.
+     * @param username User name for server authentication.
+     * @param password Password for server authentication.
+     */
+    CReporterUploadEndpoint(const QString &serverUrl, int serverPort,
+                            const QString &serverPath, bool useSsl,
+                            const QString &username, const QString &password);
+
+    CReporterUploadEndpoint(const CReporterUploadEndpoint &other);
+    CReporterUploadEndpoint &operator=(const CReporterUploadEndpoint &other);
+    ~CReporterUploadEndpoint();
+
+    /*!
+     * @brief Sets the HTTP proxy to connect through.
+     *
+     * Only meant to be used while building the endpoint.
+     */
+    void setProxy(const QString &host, int port);
+
+    bool isNull() const;
+
+    //! @return Server URL with scheme, host and port.
+    QUrl serverUrl() const;
+
+    /*!
+     * @brief Returns the URL a file is uploaded to with PUT.
+     *
+     * @param fileName Name of the uploaded file.
+     */
+    QUrl uploadUrl(const QString &fileName) const;
+
+    /*!
+     * @brief Returns the URL of a submission on the server web page.
+     *
+     * @param submissionId Identifier returned by the server for an upload.
+     */
+    QUrl submissionUrl(int submissionId) const;
+
+    bool useSsl() const;
+    QString username() const;
+    QString password() const;
+
+    bool useProxy() const;
+    QString proxyHost() const;
+    int proxyPort() const;
+
+private:
+    QExplicitlySharedDataPointer<CReporterUploadEndpointData> d;
+};
+
+#endif // CREPORTERUPLOADENDPOINT_H
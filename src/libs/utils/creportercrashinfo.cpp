@@ -0,0 +1,171 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <limits.h>
+
+#include "creportercrashinfo.h"
+
+#include "creporternamespace.h"
+
+namespace {
+
+// Returns 0 for anything but a number that fits in an int.
+int parseNumber(const QChar *begin, const QChar *end)
+{
+    qint64 result = 0;
+    for (; begin != end; ++begin) {
+        ushort c = begin->unicode();
+        if (c < '0' || c > '9') {
+            return 0;
+        }
+        result = result * 10 + (c - '0');
+        if (result > INT_MAX) {
+            return 0;
+        }
+    }
+    return result;
+}
+
+CReporterCrashInfo::ReportClass classFromFileName(const QStringRef &fileName)
+{
+    static const struct {
+        const QString *prefix;
+        CReporterCrashInfo::ReportClass reportClass;
+    } prefixes[] = {
+        { &CReporter::QuickFeedbackPrefix, CReporterCrashInfo::QuickFeedback },
+        { &CReporter::EndurancePackagePrefix, CReporterCrashInfo::EndurancePackage },
+        { &CReporter::PowerExcessPrefix, CReporterCrashInfo::PowerExcess },
+        { &CReporter::OneshotFailurePrefix, CReporterCrashInfo::OneshotFailure },
+        { &CReporter::HWrebootPrefix, CReporterCrashInfo::HWReboot },
+        { &CReporter::HWSMPLPrefix, CReporterCrashInfo::HWSMPL },
+        { &CReporter::OverheatShutdownPrefix, CReporterCrashInfo::OverheatShutdown },
+        { &CReporter::JournalSpyPrefix, CReporterCrashInfo::JournalSpy },
+    };
+
+    for (size_t i = 0; i != sizeof(prefixes) / sizeof(prefixes[0]); ++i) {
+        if (fileName.contains(*prefixes[i].prefix)) {
+            return prefixes[i].reportClass;
+        }
+    }
+    return CReporterCrashInfo::ApplicationCrash;
+}
+
+} // namespace
+
+CReporterCrashInfo::CReporterCrashInfo()
+    : m_nameStart(0), m_nameLength(0), m_hwidStart(0), m_hwidLength(0),
+      m_signalStart(0), m_signalLength(0), m_pidStart(0), m_pidLength(0),
+      m_signal(0), m_pid(0), m_reportClass(ApplicationCrash)
+{
+}
+
+CReporterCrashInfo::CReporterCrashInfo(const QString &filePath)
+    : m_filePath(filePath), m_nameStart(0), m_nameLength(0), m_hwidStart(0),
+      m_hwidLength(0), m_signalStart(0), m_signalLength(0), m_pidStart(0),
+      m_pidLength(0), m_signal(0), m_pid(0), m_reportClass(ApplicationCrash)
+{
+    const QChar *data = m_filePath.constData();
+
+    /* Walk from the end, the application name may contain dashes. The first
+     * dot after the last dash starts the file suffix. */
+    int end = m_filePath.size();
+    int dashes[3];
+    int dashCount = 0;
+    int i = m_filePath.size() - 1;
+    for (; i >= 0; --i) {
+        ushort c = data[i].unicode();
+        if (c == '/') {
+            break;
+        } else if (c == '.' && dashCount == 0) {
+            end = i;
+        } else if (c == '-' && dashCount < 3) {
+            dashes[dashCount++] = i;
+        }
+    }
+
+    m_nameStart = i + 1;
+    m_reportClass = classFromFileName(m_filePath.midRef(m_nameStart));
+
+    if (dashCount < 3) {
+        m_nameLength = end - m_nameStart;
+        return;
+    }
+
+    m_nameLength = dashes[2] - m_nameStart;
+    m_hwidStart = dashes[2] + 1;
+    m_hwidLength = dashes[1] - m_hwidStart;
+    m_signalStart = dashes[1] + 1;
+    m_signalLength = dashes[0] - m_signalStart;
+    m_pidStart = dashes[0] + 1;
+    m_pidLength = end - m_pidStart;
+    m_signal = parseNumber(data + m_signalStart, data + dashes[0]);
+    m_pid = parseNumber(data + m_pidStart, data + end);
+}
+
+bool CReporterCrashInfo::isValid() const
+{
+    return m_hwidStart > 0;
+}
+
+QString CReporterCrashInfo::filePath() const
+{
+    return m_filePath;
+}
+
+QStringRef CReporterCrashInfo::applicationName() const
+{
+    return QStringRef(&m_filePath, m_nameStart, m_nameLength);
+}
+
+QStringRef CReporterCrashInfo::hwid() const
+{
+    return QStringRef(&m_filePath, m_hwidStart, m_hwidLength);
+}
+
+int CReporterCrashInfo::signal() const
+{
+    return m_signal;
+}
+
+pid_t CReporterCrashInfo::pid() const
+{
+    return m_pid;
+}
+
+QStringRef CReporterCrashInfo::signalText() const
+{
+    return QStringRef(&m_filePath, m_signalStart, m_signalLength);
+}
+
+QStringRef CReporterCrashInfo::pidText() const
+{
+    return QStringRef(&m_filePath, m_pidStart, m_pidLength);
+}
+
+CReporterCrashInfo::ReportClass CReporterCrashInfo::reportClass() const
+{
+    return m_reportClass;
+}
+
+bool CReporterCrashInfo::includesCrash() const
+{
+    return m_reportClass == ApplicationCrash;
+}
@@ -0,0 +1,118 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERCRASHINFO_H
+#define CREPORTERCRASHINFO_H
+
+#include <sys/types.h>
+
+#include <QString>
+#include <QStringRef>
+
+#include "creporterexport.h"
+
+/*!
+ * @class CReporterCrashInfo
+ * @brief Information encoded in a rich core file name.
+ *
+ * Rich core files are named application-hwid-signal-pid.rcore.lzo. The name
+ * is parsed in a single pass from its end, since the application name may
+ * contain dashes. Textual fields are views into the file path, so parsing
+ * doesn't allocate.
+ *
+ * The report class is found like CReporterUtils::reportIncludesCrash()
+ * does, by looking for the class prefixes anywhere in the file name, but
+ * not in the directories of the path.
+ */
+class CREPORTER_EXPORT CReporterCrashInfo
+{
+public:
+    //! Kind of the report, derived from the application name prefix.
+    enum ReportClass {
+        ApplicationCrash,
+        QuickFeedback,
+        EndurancePackage,
+        PowerExcess,
+        OneshotFailure,
+        HWReboot,
+        HWSMPL,
+        OverheatShutdown,
+        JournalSpy,
+    };
+
+    CReporterCrashInfo();
+
+    /*!
+     * Parses the components of rich core file name.
+     *
+     * @param filePath Path to rich core file.
+     */
+    explicit CReporterCrashInfo(const QString &filePath);
+
+    /*!
+     * @return @c true if the file name had all the expected components.
+     */
+    bool isValid() const;
+
+    QString filePath() const;
+
+    /*!
+     * Textual fields refer to the file path stored in this object and are
+     * valid only as long as it exists.
+     */
+    QStringRef applicationName() const;
+    QStringRef hwid() const;
+
+    //! @return Signal number, 0 if it isn't a number, like QString::toInt().
+    int signal() const;
+    //! @return Process ID, 0 if it isn't a number, like QString::toInt().
+    pid_t pid() const;
+
+    //! @return Signal field as it is in the file name.
+    QStringRef signalText() const;
+    //! @return Process ID field as it is in the file name.
+    QStringRef pidText() const;
+    ReportClass reportClass() const;
+
+    /*!
+     * @return @c false if the report is a quickie, an endurance pack or some
+     * other log package, @c true if it contains a core dump.
+     */
+    bool includesCrash() const;
+
+private:
+    QString m_filePath;
+    int m_nameStart;
+    int m_nameLength;
+    int m_hwidStart;
+    int m_hwidLength;
+    int m_signalStart;
+    int m_signalLength;
+    int m_pidStart;
+    int m_pidLength;
+    int m_signal;
+    pid_t m_pid;
+    ReportClass m_reportClass;
+};
+
+Q_DECLARE_TYPEINFO(CReporterCrashInfo, Q_MOVABLE_TYPE);
+
+#endif // CREPORTERCRASHINFO_H
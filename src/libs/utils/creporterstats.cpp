@@ -0,0 +1,305 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QCoreApplication>
+#include <QHash>
+#include <QMutex>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QTimer>
+#include <QVector>
+
+#include "creporterstats.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+
+//! Delay for coalescing changes into one textfile write.
+const int TextfileWriteDelayMs = 10 * 1000;
+
+const char MetricPrefix[] = "crash_reporter_";
+
+int bucketIndex(quint64 value)
+{
+    if (value <= 1) {
+        return 0;
+    }
+    // Bits needed for value - 1 is the exponent of the smallest 2^i >= value.
+    return qMin<int>(64 - __builtin_clzll(value - 1), CReporterStats::BucketCount - 1);
+}
+
+QString baseName(const QString &name)
+{
+    int brace = name.indexOf('{');
+    return brace < 0 ? name : name.left(brace);
+}
+
+} // namespace
+
+struct CReporterStatsHistogram {
+    CReporterStatsHistogram() : buckets(CReporterStats::BucketCount, 0), count(0), sum(0) {}
+
+    QVector<quint64> buckets;
+    quint64 count;
+    quint64 sum;
+};
+
+class CReporterStatsPrivate
+{
+public:
+    explicit CReporterStatsPrivate(CReporterStats *q) : q_ptr(q) {}
+
+    void scheduleWrite();
+    void writeTextfile();
+
+    mutable QMutex mutex;
+    QHash<QString, quint64> counters;
+    QHash<QString, CReporterStatsHistogram> histograms;
+    QString textfilePath;
+    QTimer writeTimer;
+
+private:
+    Q_DECLARE_PUBLIC(CReporterStats)
+    CReporterStats *q_ptr;
+};
+
+void CReporterStatsPrivate::scheduleWrite()
+{
+    // The timer belongs to the main thread.
+    if (!textfilePath.isEmpty() && !writeTimer.isActive()) {
+        QMetaObject::invokeMethod(&writeTimer, "start", Qt::QueuedConnection);
+    }
+}
+
+void CReporterStatsPrivate::writeTextfile()
+{
+    Q_Q(CReporterStats);
+
+    QString path;
+    {
+        QMutexLocker locker(&mutex);
+        path = textfilePath;
+    }
+    if (path.isEmpty()) {
+        return;
+    }
+    QString text(q->prometheusText());
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(cr) << "Couldn't open" << path << "for writing statistics.";
+        return;
+    }
+    file.write(text.toUtf8());
+    if (!file.commit()) {
+        qCWarning(cr) << "Couldn't write statistics to" << path;
+    }
+}
+
+CReporterStats *CReporterStats::instance()
+{
+    static CReporterStats *instance = 0;
+    if (!instance) {
+        instance = new CReporterStats(qApp);
+    }
+
+    return instance;
+}
+
+CReporterStats::CReporterStats(QObject *parent)
+    : QObject(parent), d_ptr(new CReporterStatsPrivate(this))
+{
+    Q_D(CReporterStats);
+
+    d->writeTimer.setSingleShot(true);
+    d->writeTimer.setInterval(TextfileWriteDelayMs);
+    connect(&d->writeTimer, SIGNAL(timeout()), this, SLOT(writeTextfile()));
+}
+
+CReporterStats::~CReporterStats()
+{
+    Q_D(CReporterStats);
+
+    if (d->writeTimer.isActive()) {
+        d->writeTextfile();
+    }
+
+    delete d_ptr;
+    d_ptr = 0;
+}
+
+void CReporterStats::increment(const QString &counter, quint64 delta)
+{
+    Q_D(CReporterStats);
+
+    QMutexLocker locker(&d->mutex);
+    d->counters[counter] += delta;
+    d->scheduleWrite();
+}
+
+void CReporterStats::observe(const QString &histogram, quint64 value)
+{
+    Q_D(CReporterStats);
+
+    QMutexLocker locker(&d->mutex);
+    CReporterStatsHistogram &h = d->histograms[histogram];
+    ++h.buckets[bucketIndex(value)];
+    ++h.count;
+    h.sum += value;
+    d->scheduleWrite();
+}
+
+quint64 CReporterStats::counter(const QString &name) const
+{
+    Q_D(const CReporterStats);
+
+    QMutexLocker locker(&d->mutex);
+    return d->counters.value(name);
+}
+
+QVariantMap CReporterStats::counters() const
+{
+    Q_D(const CReporterStats);
+
+    QMutexLocker locker(&d->mutex);
+    QVariantMap result;
+    for (QHash<QString, quint64>::ConstIterator it = d->counters.constBegin();
+            it != d->counters.constEnd(); ++it) {
+        result.insert(it.key(), qulonglong(it.value()));
+    }
+    return result;
+}
+
+QStringList CReporterStats::histograms() const
+{
+    Q_D(const CReporterStats);
+
+    QMutexLocker locker(&d->mutex);
+    QStringList names(d->histograms.keys());
+    names.sort();
+    return names;
+}
+
+QVariantMap CReporterStats::histogram(const QString &name) const
+{
+    Q_D(const CReporterStats);
+
+    QMutexLocker locker(&d->mutex);
+    QVariantMap result;
+    QHash<QString, CReporterStatsHistogram>::ConstIterator it = d->histograms.constFind(name);
+    if (it == d->histograms.constEnd()) {
+        return result;
+    }
+
+    QVariantList buckets;
+    foreach (quint64 bucket, it->buckets) {
+        buckets << qulonglong(bucket);
+    }
+    result.insert("buckets", buckets);
+    result.insert("count", qulonglong(it->count));
+    result.insert("sum", qulonglong(it->sum));
+    return result;
+}
+
+QString CReporterStats::prometheusText() const
+{
+    Q_D(const CReporterStats);
+
+    QMutexLocker locker(&d->mutex);
+    QString text;
+    QTextStream out(&text);
+
+    QStringList names(d->counters.keys());
+    names.sort();
+    QString previousBase;
+    foreach (const QString &name, names) {
+        QString base(baseName(name));
+        if (base != previousBase) {
+            out << "# TYPE " << MetricPrefix << base << " counter\n";
+            previousBase = base;
+        }
+        out << MetricPrefix << name << ' ' << d->counters.value(name) << '\n';
+    }
+
+    names = d->histograms.keys();
+    names.sort();
+    previousBase.clear();
+    foreach (const QString &name, names) {
+        const CReporterStatsHistogram &h = d->histograms[name];
+        QString base(baseName(name));
+        if (base != previousBase) {
+            out << "# TYPE " << MetricPrefix << base << " histogram\n";
+            previousBase = base;
+        }
+        // Labels of the histogram go before le in the bucket labels.
+        QString labels(name.mid(base.size()));
+        QString bucketLabels(labels.isEmpty() ? QString() : labels.mid(1, labels.size() - 2) + ',');
+
+        // Skip the empty tail, the +Inf bucket covers it.
+        int last = BucketCount - 1;
+        while (last > 0 && h.buckets.at(last) == 0) {
+            --last;
+        }
+        quint64 cumulative = 0;
+        for (int i = 0; i <= last; ++i) {
+            cumulative += h.buckets.at(i);
+            out << MetricPrefix << base << "_bucket{" << bucketLabels
+                << "le=\"" << (quint64(1) << i) << "\"} " << cumulative << '\n';
+        }
+        out << MetricPrefix << base << "_bucket{" << bucketLabels << "le=\"+Inf\"} "
+            << h.count << '\n';
+        out << MetricPrefix << base << "_sum" << labels << ' ' << h.sum << '\n';
+        out << MetricPrefix << base << "_count" << labels << ' ' << h.count << '\n';
+    }
+
+    out.flush();
+    return text;
+}
+
+void CReporterStats::setTextfilePath(const QString &path)
+{
+    Q_D(CReporterStats);
+
+    {
+        QMutexLocker locker(&d->mutex);
+        d->textfilePath = path;
+    }
+
+    if (path.isEmpty()) {
+        d->writeTimer.stop();
+    } else {
+        d->writeTextfile();
+    }
+}
+
+void CReporterStats::reset()
+{
+    Q_D(CReporterStats);
+
+    QMutexLocker locker(&d->mutex);
+    d->counters.clear();
+    d->histograms.clear();
+    d->scheduleWrite();
+}
+
+#include "moc_creporterstats.cpp"
@@ -0,0 +1,107 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERSTATS_H
+#define CREPORTERSTATS_H
+
+#include <QObject>
+#include <QStringList>
+#include <QVariantMap>
+
+#include "creporterexport.h"
+
+class CReporterStatsPrivate;
+
+/*!
+ * @class CReporterStats
+ * @brief Counters and histograms describing how the crash report pipeline
+ * performs in this process.
+ *
+ * Counter and histogram names may carry Prometheus style labels, e.g.
+ * cores_detected_total{class="crash"}. Histograms have power of two buckets,
+ * a value v is counted in the smallest bucket with upper bound 2^i >= v.
+ *
+ * When a textfile path is set, the statistics are periodically written there
+ * in the Prometheus text exposition format, for node_exporter's textfile
+ * collector.
+ */
+class CREPORTER_EXPORT CReporterStats : public QObject
+{
+    Q_OBJECT
+
+public:
+    //! Number of histogram buckets.
+    static const int BucketCount = 64;
+
+    static CReporterStats *instance();
+
+    ~CReporterStats();
+
+    //! Adds @a delta to a counter.
+    void increment(const QString &counter, quint64 delta = 1);
+
+    //! Records a value in a histogram.
+    void observe(const QString &histogram, quint64 value);
+
+    //! @return Value of a counter, 0 if it was never incremented.
+    quint64 counter(const QString &name) const;
+
+    //! @return All counters, values are qulonglong.
+    QVariantMap counters() const;
+
+    //! @return Names of all histograms.
+    QStringList histograms() const;
+
+    /*!
+     * @brief Returns a histogram.
+     *
+     * @return Map with "count" and "sum" of the observed values and
+     *  "buckets", a list of BucketCount non-cumulative bucket counts. Empty if
+     *  nothing was observed.
+     */
+    QVariantMap histogram(const QString &name) const;
+
+    //! @return Statistics in the Prometheus text exposition format.
+    QString prometheusText() const;
+
+    /*!
+     * @brief Sets the file statistics are exported to.
+     *
+     * The file is replaced atomically a few seconds after a change and when
+     * the process exits.
+     *
+     * @param path File path, empty disables the export.
+     */
+    void setTextfilePath(const QString &path);
+
+    //! Clears all statistics.
+    void reset();
+
+private:
+    CReporterStats(QObject *parent);
+
+    Q_DECLARE_PRIVATE(CReporterStats)
+    CReporterStatsPrivate *d_ptr;
+
+    Q_PRIVATE_SLOT(d_func(), void writeTextfile())
+};
+
+#endif // CREPORTERSTATS_H
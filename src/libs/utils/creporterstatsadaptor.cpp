@@ -0,0 +1,57 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creporterstats.h"
+#include "creporterstatsadaptor.h"
+
+CReporterStatsAdaptor::CReporterStatsAdaptor(QObject *parent)
+    : QDBusAbstractAdaptor(parent)
+{
+}
+
+CReporterStatsAdaptor::~CReporterStatsAdaptor()
+{
+}
+
+QVariantMap CReporterStatsAdaptor::counters()
+{
+    return CReporterStats::instance()->counters();
+}
+
+QStringList CReporterStatsAdaptor::histograms()
+{
+    return CReporterStats::instance()->histograms();
+}
+
+QVariantMap CReporterStatsAdaptor::histogram(const QString &name)
+{
+    return CReporterStats::instance()->histogram(name);
+}
+
+QString CReporterStatsAdaptor::prometheusText()
+{
+    return CReporterStats::instance()->prometheusText();
+}
+
+void CReporterStatsAdaptor::reset()
+{
+    CReporterStats::instance()->reset();
+}
@@ -0,0 +1,231 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <time.h>
+
+#include <algorithm>
+
+#include <QDateTime>
+#include <QFile>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+
+#include "creportertrace.h"
+
+namespace {
+
+const char *const StageNames[CReporterTrace::StageCount] = {
+    "appeared",
+    "directory_changed",
+    "duplicate_checked",
+    "notified",
+    "uploader_notified",
+    "enqueued",
+    "first_byte_sent",
+    "reply_received",
+};
+
+//! Nearest-rank percentile of sorted @a values.
+qint64 percentile(const QVector<qint64> &values, int p)
+{
+    int rank = (values.size() * p + 99) / 100;
+    return values.at(qMax(rank, 1) - 1);
+}
+
+QVariantMap summarise(QVector<qint64> &values)
+{
+    std::sort(values.begin(), values.end());
+
+    QVariantMap result;
+    result.insert("count", values.size());
+    result.insert("p50", percentile(values, 50));
+    result.insert("p90", percentile(values, 90));
+    result.insert("p99", percentile(values, 99));
+    result.insert("max", values.last());
+    return result;
+}
+
+} // namespace
+
+CReporterTrace::CReporterTrace()
+{
+    std::fill(m_timestamps, m_timestamps + StageCount, 0);
+}
+
+qint64 CReporterTrace::now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    return qint64(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+qint64 CReporterTrace::fromDateTime(const QDateTime &time)
+{
+    qint64 result = now() - time.msecsTo(QDateTime::currentDateTimeUtc()) * 1000;
+    return qMax<qint64>(result, 0);
+}
+
+QString CReporterTrace::stageName(Stage stage)
+{
+    return QString::fromLatin1(StageNames[stage]);
+}
+
+void CReporterTrace::mark(Stage stage)
+{
+    if (m_timestamps[stage] == 0) {
+        m_timestamps[stage] = now();
+    }
+}
+
+void CReporterTrace::setTimestamp(Stage stage, qint64 timestamp)
+{
+    m_timestamps[stage] = timestamp;
+}
+
+qint64 CReporterTrace::timestamp(Stage stage) const
+{
+    return m_timestamps[stage];
+}
+
+bool CReporterTrace::isEmpty() const
+{
+    for (int i = 0; i != StageCount; ++i) {
+        if (m_timestamps[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+qint64 CReporterTrace::duration(Stage stage) const
+{
+    if (m_timestamps[stage] == 0) {
+        return -1;
+    }
+    for (int i = stage - 1; i >= 0; --i) {
+        if (m_timestamps[i] != 0) {
+            // The file time comes from another clock and may be off a bit.
+            return qMax<qint64>(m_timestamps[stage] - m_timestamps[i], 0);
+        }
+    }
+    return -1;
+}
+
+qint64 CReporterTrace::totalDuration() const
+{
+    qint64 first = 0;
+    qint64 last = 0;
+    for (int i = 0; i != StageCount; ++i) {
+        if (m_timestamps[i] != 0) {
+            if (first == 0) {
+                first = m_timestamps[i];
+            }
+            last = m_timestamps[i];
+        }
+    }
+    return qMax<qint64>(last - first, 0);
+}
+
+QString CReporterTrace::toString() const
+{
+    QString result;
+    for (int i = 0; i != StageCount; ++i) {
+        if (m_timestamps[i] != 0) {
+            if (!result.isEmpty()) {
+                result += ',';
+            }
+            result += QString("%1:%2").arg(StageNames[i]).arg(m_timestamps[i]);
+        }
+    }
+    return result;
+}
+
+CReporterTrace CReporterTrace::fromString(const QString &text)
+{
+    CReporterTrace trace;
+    foreach (const QString &entry, text.split(',', QString::SkipEmptyParts)) {
+        int colon = entry.indexOf(':');
+        if (colon < 0) {
+            continue;
+        }
+        QStringRef name(entry.leftRef(colon));
+        for (int i = 0; i != StageCount; ++i) {
+            if (name == QLatin1String(StageNames[i])) {
+                trace.m_timestamps[i] = entry.midRef(colon + 1).toLongLong();
+                break;
+            }
+        }
+    }
+    return trace;
+}
+
+QList<CReporterTrace> CReporterTrace::readUploadLog(const QString &path)
+{
+    QList<CReporterTrace> result;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return result;
+    }
+
+    // Lines are "<file name> <submission URL>[ <trace>]".
+    QTextStream stream(&file);
+    while (!stream.atEnd()) {
+        QStringList fields(stream.readLine().split(' ', QString::SkipEmptyParts));
+        if (fields.size() < 3) {
+            continue;
+        }
+        CReporterTrace trace(fromString(fields.at(2)));
+        if (!trace.isEmpty()) {
+            result << trace;
+        }
+    }
+
+    return result;
+}
+
+QVariantMap CReporterTrace::summary(const QList<CReporterTrace> &traces)
+{
+    QVector<qint64> durations[StageCount];
+    QVector<qint64> totals;
+
+    foreach (const CReporterTrace &trace, traces) {
+        for (int i = 0; i != StageCount; ++i) {
+            qint64 d = trace.duration(static_cast<Stage>(i));
+            if (d >= 0) {
+                durations[i] << d;
+            }
+        }
+        totals << trace.totalDuration();
+    }
+
+    QVariantMap result;
+    for (int i = 0; i != StageCount; ++i) {
+        if (!durations[i].isEmpty()) {
+            result.insert(StageNames[i], summarise(durations[i]));
+        }
+    }
+    if (!totals.isEmpty()) {
+        result.insert("total", summarise(totals));
+    }
+    return result;
+}
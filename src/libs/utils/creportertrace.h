@@ -0,0 +1,130 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERTRACE_H
+#define CREPORTERTRACE_H
+
+#include <QList>
+#include <QString>
+#include <QVariantMap>
+
+#include "creporterexport.h"
+
+class QDateTime;
+
+/*!
+ * @class CReporterTrace
+ * @brief Timestamps of the stages a report passes from its creation to the
+ * server's reply.
+ *
+ * Timestamps are in microseconds of CLOCK_BOOTTIME, which is monotonic,
+ * shared by all processes and keeps running while the device is suspended.
+ * This allows the trace to be started in the daemon and completed in the
+ * auto uploader.
+ *
+ * The text form, e.g. "appeared:12,directory_changed:40,enqueued:97", is
+ * passed over D-Bus and stored in the uploadlog.
+ */
+class CREPORTER_EXPORT CReporterTrace
+{
+public:
+    //! Stages in the order a report passes them.
+    enum Stage {
+        //! The report file was written.
+        FileAppeared,
+        //! The daemon noticed the report in a core directory.
+        DirectoryChanged,
+        //! Duplicate check of the report completed.
+        DuplicateChecked,
+        //! User was notified of the report.
+        Notified,
+        //! The daemon asked the auto uploader to upload the report.
+        UploaderNotified,
+        //! The report was added to the upload queue.
+        Enqueued,
+        //! First bytes of the report were sent to the server.
+        FirstByteSent,
+        //! The server replied to the upload.
+        ReplyReceived,
+        StageCount
+    };
+
+    CReporterTrace();
+
+    //! @return Current time in the clock of the trace.
+    static qint64 now();
+
+    //! @return @a time converted to the clock of the trace, 0 if it precedes boot.
+    static qint64 fromDateTime(const QDateTime &time);
+
+    //! @return Name of @a stage used in the text form.
+    static QString stageName(Stage stage);
+
+    //! Records the current time for @a stage, unless it was already recorded.
+    void mark(Stage stage);
+
+    //! Sets the time of @a stage, 0 clears it.
+    void setTimestamp(Stage stage, qint64 timestamp);
+
+    //! @return Time of @a stage, 0 if it wasn't recorded.
+    qint64 timestamp(Stage stage) const;
+
+    //! @return @c true if no stage was recorded.
+    bool isEmpty() const;
+
+    /*!
+     * @return Time from the previous recorded stage to @a stage in
+     *  microseconds, -1 if @a stage wasn't recorded or is the first one.
+     */
+    qint64 duration(Stage stage) const;
+
+    //! @return Time from the first to the last recorded stage in microseconds.
+    qint64 totalDuration() const;
+
+    QString toString() const;
+
+    //! Parses the text form, unknown stages are ignored.
+    static CReporterTrace fromString(const QString &text);
+
+    /*!
+     * @brief Reads the traces stored in an uploadlog.
+     *
+     * @param path Path of the uploadlog.
+     * @return Traces of the uploads that had one.
+     */
+    static QList<CReporterTrace> readUploadLog(const QString &path);
+
+    /*!
+     * @brief Summarises stage durations of @a traces.
+     *
+     * @return Map from stage name and "total" to a map with "count", "p50",
+     *  "p90", "p99" and "max" durations in microseconds. Stages without
+     *  durations are left out.
+     */
+    static QVariantMap summary(const QList<CReporterTrace> &traces);
+
+private:
+    qint64 m_timestamps[StageCount];
+};
+
+Q_DECLARE_TYPEINFO(CReporterTrace, Q_MOVABLE_TYPE);
+
+#endif // CREPORTERTRACE_H
@@ -27,6 +27,12 @@
 
 #include <sys/types.h> // for stat()
 #include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
 
 #ifndef CREPORTER_UNIT_TEST
 #include <ssudeviceinfo.h>
@@ -41,6 +47,8 @@
 #include <notification.h>
 
 #include "creporterutils.h"
+#include "creportercrashinfo.h"
+#include "creportertrace.h"
 
 #include "creporternamespace.h"
 #include "../autouploader_interface.h" // generated
@@ -57,6 +65,11 @@ using CReporter::LoggingCategory::cr;
 const QString richCoreTmpNoteFile = "/tmp/rich-core-note.txt";
 const QString coreSuffixRcore = "rcore";
 const QString coreSuffixRcoreLzo = "rcore.lzo";
+#ifndef CREPORTER_UNIT_TEST
+const char richCoreBrokerSocket[] = "/run/crash-reporter/rich-core-broker.sock";
+#else
+const char richCoreBrokerSocket[] = "/tmp/crash-reporter-tests/rich-core-broker.sock";
+#endif
 
 CReporterUtils::CReporterUtils() {}
 
@@ -101,51 +114,11 @@ bool CReporterUtils::removeFile(const QString &path)
 
 QStringList CReporterUtils::parseCrashInfoFromFilename(const QString &filePath)
 {
-    qCDebug(cr) << "Parse:" << filePath;
-
-    QFileInfo fi(filePath);
-    // Remove path and file suffix. i.e. /media/mmc1/application-hwid-11-2029.rcore.lzo =>
-    // application-hwid-11-2029
-    QString baseName = fi.baseName();
-
-    /*
-     * The basename format is: application_name-hwid-11-2029
-     *
-     * Parsing from start until dash '-', because it may appear as part of executable name.
-     * Instead, walk from end to beginning.
-     */
-
-    // Find the last dash. Start from the last character.
-    int searchIndex = baseName.lastIndexOf("-");
-    // Extracts PID substring.
-    QString pid = baseName.right(baseName.size() - (searchIndex + 1));
-    qCDebug(cr) << "PID:" << pid;
-
-    // Remove dash and PID from the original basename.
-    baseName = baseName.remove(searchIndex, pid.size() + 1);
+    CReporterCrashInfo info(filePath);
 
-    // Repeat above for SIGNUM, HWID and IMEI. Finally, string what is left in the basename,
-    // is the application name.
-
-    // Extract SIGNUM.
-    searchIndex = baseName.lastIndexOf("-");
-    QString signum = baseName.right(baseName.size() - (searchIndex + 1));
-    qCDebug(cr) << "SIGNUM:" << signum;
-
-    baseName = baseName.remove(searchIndex, signum.size() + 1);
-
-    // Extract HWID.
-    searchIndex = baseName.lastIndexOf("-");
-    QString hwid = baseName.right(baseName.size() - (searchIndex + 1));
-    qCDebug(cr) << "HWID:" << hwid;
-
-    baseName = baseName.remove(searchIndex, hwid.size() + 1);
-
-    qCDebug(cr) << "Application name:" << baseName;
-
-    // Append results to list. Index 0 = Application name ....
     QStringList result;
-    result << baseName << hwid << signum << pid;
+    result << info.applicationName().toString() << info.hwid().toString()
+           << info.signalText().toString() << info.pidText().toString();
 
     return result;
 }
@@ -240,6 +213,39 @@ bool CReporterUtils::notifyAutoUploader(const QStringList &filesToUpload,
     return true;
 }
 
+bool CReporterUtils::notifyAutoUploader(const QStringList &filesToUpload,
+                                        const QHash<QString, CReporterTrace> &traces,
+                                        bool obeyNetworkRestrictions)
+{
+    qCDebug(cr) << "Requesting crash-reporter-autouploader to upload"
+                << filesToUpload.size() << "files," << traces.size() << "traced.";
+
+    // Files without a trace get an empty string.
+    QStringList traceStrings;
+    foreach (const QString &file, filesToUpload) {
+        CReporterTrace trace(traces.value(file));
+        if (!trace.isEmpty()) {
+            trace.mark(CReporterTrace::UploaderNotified);
+        }
+        traceStrings << trace.toString();
+    }
+
+    ComNokiaCrashReporterAutoUploaderInterface proxy(CReporter::AutoUploaderServiceName,
+            CReporter::AutoUploaderObjectPath, QDBusConnection::sessionBus());
+
+    QDBusPendingReply <bool>reply =
+        proxy.uploadFilesWithTraces(filesToUpload, traceStrings, obeyNetworkRestrictions);
+    // This blocks.
+    reply.waitForFinished();
+
+    if (reply.isError()) {
+        qCWarning(cr) << "D-Bus error occurred:" << reply.error().name() << reply.error().message();
+
+        return false;
+    }
+    return true;
+}
+
 QProcess *CReporterUtils::invokeLogCollection(const QString &label)
 {
     QScopedPointer<QProcess> richCoreHelper(new QProcess(qApp));
@@ -258,6 +264,55 @@ QProcess *CReporterUtils::invokeLogCollection(const QString &label)
     return richCoreHelper.take();
 }
 
+bool CReporterUtils::requestLogCollection(const QString &label)
+{
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        qCWarning(cr) << "Couldn't create socket:" << strerror(errno);
+        return invokeLogCollection(label) != 0;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, richCoreBrokerSocket, sizeof(addr.sun_path) - 1);
+
+    if (::connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == -1) {
+        qCDebug(cr) << "rich-core-broker not available, invoking rich-core-helper.";
+        close(fd);
+        return invokeLogCollection(label) != 0;
+    }
+
+    // The broker answers right away, the timeout only guards against a hung
+    // broker blocking the caller's event loop.
+    struct timeval timeout = { 2, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    QByteArray request("COLLECT ");
+    request.append(label.toLatin1());
+
+    char reply[128];
+    ssize_t len = -1;
+    if (send(fd, request.constData(), request.size(), MSG_NOSIGNAL) == request.size()) {
+        len = recv(fd, reply, sizeof(reply) - 1, 0);
+    }
+    close(fd);
+
+    if (len <= 0) {
+        qCWarning(cr) << "No reply from rich-core-broker.";
+        return false;
+    }
+    reply[len] = '\0';
+
+    if (qstrncmp(reply, "QUEUED", 6) == 0 || qstrcmp(reply, "DUPLICATE") == 0) {
+        qCDebug(cr) << "Log collection" << label << "requested:" << reply;
+        return true;
+    }
+
+    qCWarning(cr) << "rich-core-broker refused log collection" << label << ":" << reply;
+    return false;
+}
+
 static void runServiceHelper(const QString &service, bool run)
 {
     QProcess::execute("/usr/libexec/crashreporter-servicehelper", QStringList() << service << (run ? "start" : "stop"));
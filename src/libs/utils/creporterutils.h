@@ -26,10 +26,12 @@
 #define CREPORTERUTILS_H
 
 #include <QFileInfo>
+#include <QHash>
 #include <QLoggingCategory>
 
 #include "creporterexport.h"
 
+class CReporterTrace;
 class Notification;
 class QProcess;
 
@@ -90,6 +92,8 @@ public:
      * indexes of the returned QStringList (0 = Application name, 1 = HWID,
      * 2 = SIGNUM and 3 = PID).
      *
+     * @deprecated Use CReporterCrashInfo, which doesn't allocate the pieces.
+     *
      * @param Absolute file path to rich core file.
      * @return Data extracted to string list.
      */
@@ -138,6 +142,21 @@ public:
     Q_INVOKABLE static bool notifyAutoUploader(const QStringList &filesToUpload,
             bool obeyNetworkRestrictions = true);
 
+    /*!
+     * Sends a request for auto uploader daemon to add files into upload queue,
+     * passing along the traces of the files.
+     *
+     * @param filesToUpload A list of files we want to upload to the server.
+     * @param traces Traces of some of the files, by file path.
+     *               CReporterTrace::UploaderNotified is marked in them.
+     * @param obeyNetworkRestrictions @c false if the files should be uploaded
+     *                                regardless of the network connection type.
+     * @return @c true if files were successfully added, otherwise @c false.
+     */
+    static bool notifyAutoUploader(const QStringList &filesToUpload,
+                                   const QHash<QString, CReporterTrace> &traces,
+                                   bool obeyNetworkRestrictions = true);
+
     /*!
      * Runs rich-core-dumper that subsequently collects system logs and creates
      * a rich core report (in *.rcore.lzo format).
@@ -152,6 +171,20 @@ public:
      */
     static QProcess *invokeLogCollection(const QString &label);
 
+    /*!
+     * Asks rich-core-broker to collect system logs into a rich core report.
+     *
+     * The broker queues the request and coalesces it with an identical one
+     * that is already pending, so it is cheap to call this repeatedly. When
+     * the broker isn't reachable, falls back to invokeLogCollection().
+     *
+     * @param label A string that should be used in the rich core filename
+     *              at the place of application name.
+     * @return @c true if the collection was queued or is already pending,
+     * @c false on error or when the broker's queue is full.
+     */
+    static bool requestLogCollection(const QString &label);
+
     Q_INVOKABLE static void setEnduranceServiceState(bool run);
     Q_INVOKABLE static void setJournalSpyServiceState(bool run);
 
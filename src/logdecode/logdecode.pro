@@ -1,6 +1,6 @@
 # This file is a part of crash-reporter.
 #
-# Copyright (C) 2014 Jolla Ltd.
+# Copyright (C) 2013 Jolla Ltd.
 # Contact: Jakub Adam <jakub.adam@jollamobile.com>
 #
 # This program is free software; you can redistribute it and/or
@@ -20,30 +20,20 @@
 include(../../crash-reporter-conf.pri)
 
 TEMPLATE = app
-TARGET = crash-reporter-journalspy
+TARGET = crash-reporter-logdecode
 
 QT = core
-CONFIG += link_pkgconfig
 
 INCLUDEPATH += \
 	../libs \
 	../libs/logger \
-	../libs/settings \
-	../libs/utils \
-
-HEADERS = \
-	journalspy.h
 
 SOURCES = \
 	main.cpp \
-	journalspy.cpp \
 
 LIBS += \
 	../../lib/libcrashreporter.so \
 
-PKGCONFIG += \
-	libsystemd \
-
-target.path = $$CREPORTER_SYSTEM_LIBEXEC
+target.path = $$CREPORTER_SYSTEM_BIN
 
 INSTALLS = target
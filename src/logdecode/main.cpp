@@ -1,7 +1,7 @@
 /*
  * This file is a part of crash-reporter.
  *
- * Copyright (C) 2014 Jolla Ltd.
+ * Copyright (C) 2013 Jolla Ltd.
  * Contact: Jakub Adam <jakub.adam@jollamobile.com>
  *
  * This program is free software; you can redistribute it and/or
@@ -19,41 +19,36 @@
  * 02110-1301 USA
  */
 
-#include <signal.h>
+#include <stdio.h>
 
-#include <QCoreApplication>
-#include <QDebug>
-#include <QFileInfo>
+#include <QFile>
+#include <QTextStream>
 
-#include "journalspy.h"
-#include "creporterapplicationsettings.h"
 #include "creporterlogger.h"
-#include "creporterutils.h"
-
-using CReporter::LoggingCategory::cr;
-
-void signalHandler(int signal)
-{
-    Q_UNUSED(signal)
-
-    QCoreApplication::exit(0);
-}
 
+/* Prints a log written by the "binary" logger type as text. */
 int main(int argc, char **argv)
 {
-    signal(SIGINT, &signalHandler);
-    signal(SIGTERM, &signalHandler);
-
-    QCoreApplication app(argc, argv);
-
-    qCDebug(cr) << qPrintable(QFileInfo(argv[0]).fileName()) << CREPORTERVERSION
-                << "[" << app.applicationPid() << "] started.";
-
-    JournalSpy journalSpy;
-
-    int result = app.exec();
-
-    qCDebug(cr) << "Shutting down the journal spy process.";
-
-    return result;
+    QFile input;
+    if (argc > 2) {
+        fprintf(stderr, "Usage: %s [binary log file]\n", argv[0]);
+        return 1;
+    } else if (argc == 2) {
+        input.setFileName(QString::fromLocal8Bit(argv[1]));
+        if (!input.open(QIODevice::ReadOnly)) {
+            fprintf(stderr, "Can't open %s\n", argv[1]);
+            return 1;
+        }
+    } else if (!input.open(stdin, QIODevice::ReadOnly)) {
+        return 1;
+    }
+
+    QTextStream output(stdout);
+    if (!CReporterLogger::decodeBinaryLog(&input, output)) {
+        output.flush();
+        fprintf(stderr, "Not a binary crash-reporter log or truncated record.\n");
+        return 1;
+    }
+
+    return 0;
 }
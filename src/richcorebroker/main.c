@@ -0,0 +1,453 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+/*
+ * rich-core-broker is a long running privileged service that triggers
+ * rich-core-dumper on behalf of the unprivileged crash-reporter components.
+ *
+ * Clients connect to a SOCK_SEQPACKET socket and send one request per
+ * connection:
+ *
+ *   COLLECT <label>   queue log collection, label is used as application name
+ *   STATUS            report the number of running, queued and finished jobs
+ *
+ * The broker answers with a single packet: QUEUED <position>, DUPLICATE
+ * (the same label is already queued or being collected), BUSY (queue full),
+ * STATUS ... or ERR <reason>.
+ *
+ * Unlike rich-core-helper, which forks a setuid shell for every request,
+ * the broker coalesces repeated requests, runs at most a configured number
+ * of rich-core-dumper instances at once and runs them with idle I/O priority
+ * so that a burst of triggers doesn't compete with the foreground.
+ */
+
+#define _GNU_SOURCE /* for struct ucred and accept4() */
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syslog.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <systemd/sd-daemon.h>
+
+#define DEFAULT_SOCKET_PATH "/run/crash-reporter/rich-core-broker.sock"
+#define RICH_CORE_DUMPER "/usr/sbin/rich-core-dumper"
+
+#define MAX_LABEL_LEN 64
+#define MAX_QUEUED 16
+#define MAX_CLIENTS 16
+#define MAX_JOBS 4
+
+/* From linux/ioprio.h, which isn't exported to userspace on all targets. */
+#define IOPRIO_CLASS_IDLE 3
+#define IOPRIO_CLASS_SHIFT 13
+#define IOPRIO_WHO_PROCESS 1
+
+struct job {
+    char label[MAX_LABEL_LEN + 1];
+    pid_t pid;
+    struct timespec started;
+};
+
+static struct job queue[MAX_QUEUED];
+static int queued = 0;
+
+static struct job running[MAX_JOBS];
+static int max_running = 1;
+
+static unsigned long finished_count = 0;
+static unsigned long duplicate_count = 0;
+static unsigned long rejected_count = 0;
+
+static const char *dumper_path = RICH_CORE_DUMPER;
+/* Signal mask before the broker blocked the signals it reads from a
+ * signalfd; dumpers must not inherit those blocked. */
+static sigset_t original_sigmask;
+
+static int validate_label(const char *label)
+{
+    size_t label_len = strlen(label);
+    if (label_len == 0 || label_len > MAX_LABEL_LEN) {
+        return 0;
+    }
+
+    /* Label is going to be passed to rich-core-dumper running as root so make
+     * sure its content is sane. Only alphanumeric chars, underscore and hyphen
+     * are allowed, no spaces. */
+    size_t i;
+    for (i = 0; i != label_len; ++i) {
+        if (!isalnum((unsigned char)label[i]) && label[i] != '_' && label[i] != '-') {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static int running_count()
+{
+    int i, count = 0;
+    for (i = 0; i != max_running; ++i) {
+        if (running[i].pid != 0) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+static int is_pending(const char *label)
+{
+    int i;
+    for (i = 0; i != max_running; ++i) {
+        if (running[i].pid != 0 && strcmp(running[i].label, label) == 0) {
+            return 1;
+        }
+    }
+    for (i = 0; i != queued; ++i) {
+        if (strcmp(queue[i].label, label) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static long elapsed_ms(const struct timespec *since)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - since->tv_sec) * 1000 +
+           (now.tv_nsec - since->tv_nsec) / 1000000;
+}
+
+static void exec_dumper(const char *label)
+{
+    char name_arg[MAX_LABEL_LEN + sizeof("--name=")];
+    char signal_arg[32];
+    char *args[] = { (char *)dumper_path, name_arg, signal_arg, NULL };
+    char *env[] = { "PATH=/usr/sbin:/usr/bin:/sbin:/bin", NULL };
+
+    /* Collection is never urgent; don't let it compete for I/O or CPU with
+     * whatever the user is doing at the moment. */
+    if (syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0,
+                IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT) == -1) {
+        syslog(LOG_WARNING, "Couldn't set idle I/O priority: %s", strerror(errno));
+    }
+    setpriority(PRIO_PROCESS, 0, 10);
+
+    snprintf(name_arg, sizeof(name_arg), "--name=%s", label);
+    snprintf(signal_arg, sizeof(signal_arg), "--signal=%d", rand());
+
+    sigprocmask(SIG_SETMASK, &original_sigmask, NULL);
+    execve(args[0], args, env);
+    syslog(LOG_CRIT, "Couldn't invoke %s: %s", args[0], strerror(errno));
+    _exit(EXIT_FAILURE);
+}
+
+static void start_queued_jobs()
+{
+    int slot;
+    for (slot = 0; slot != max_running && queued > 0; ++slot) {
+        if (running[slot].pid != 0) {
+            continue;
+        }
+
+        struct job *job = &running[slot];
+        *job = queue[0];
+        --queued;
+        memmove(queue, queue + 1, queued * sizeof(struct job));
+
+        pid_t pid = fork();
+        if (pid == -1) {
+            syslog(LOG_ERR, "Error on fork(): %s", strerror(errno));
+            job->pid = 0;
+            continue;
+        } else if (pid == 0) {
+            exec_dumper(job->label);
+        }
+
+        job->pid = pid;
+        clock_gettime(CLOCK_MONOTONIC, &job->started);
+        syslog(LOG_DEBUG, "Collecting logs for %s (pid %d).", job->label, pid);
+    }
+}
+
+static void reap_children()
+{
+    pid_t pid;
+    int status;
+    while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+        int i;
+        for (i = 0; i != max_running; ++i) {
+            if (running[i].pid == pid) {
+                syslog(LOG_DEBUG, "Log collection for %s finished in %ld ms, "
+                        "status %d.", running[i].label,
+                        elapsed_ms(&running[i].started), status);
+                running[i].pid = 0;
+                ++finished_count;
+                break;
+            }
+        }
+    }
+
+    start_queued_jobs();
+}
+
+static void reply(int fd, const char *message)
+{
+    if (send(fd, message, strlen(message), MSG_NOSIGNAL) == -1) {
+        syslog(LOG_WARNING, "Couldn't send reply: %s", strerror(errno));
+    }
+}
+
+static void handle_request(int fd)
+{
+    char buf[MAX_LABEL_LEN + 16];
+    char answer[128];
+
+    ssize_t len = recv(fd, buf, sizeof(buf) - 1, MSG_DONTWAIT | MSG_TRUNC);
+    if (len <= 0) {
+        return;
+    } else if ((size_t)len >= sizeof(buf)) {
+        reply(fd, "ERR request too long");
+        return;
+    }
+    buf[len] = '\0';
+    if (buf[len - 1] == '\n') {
+        buf[len - 1] = '\0';
+    }
+
+    if (strcmp(buf, "STATUS") == 0) {
+        snprintf(answer, sizeof(answer),
+                "STATUS running=%d queued=%d finished=%lu duplicates=%lu "
+                "rejected=%lu", running_count(), queued, finished_count,
+                duplicate_count, rejected_count);
+        reply(fd, answer);
+        return;
+    }
+
+    if (strncmp(buf, "COLLECT ", 8) != 0) {
+        reply(fd, "ERR unknown request");
+        return;
+    }
+
+    const char *label = buf + 8;
+    if (!validate_label(label)) {
+        syslog(LOG_WARNING, "Invalid crash report label: %s", label);
+        reply(fd, "ERR invalid label");
+        return;
+    }
+
+    struct ucred cred;
+    socklen_t cred_len = sizeof(cred);
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &cred_len) == 0) {
+        syslog(LOG_INFO, "Log collection %s requested by pid %d, uid %d.",
+                label, cred.pid, cred.uid);
+    }
+
+    if (is_pending(label)) {
+        ++duplicate_count;
+        reply(fd, "DUPLICATE");
+        return;
+    }
+
+    if (queued == MAX_QUEUED) {
+        ++rejected_count;
+        reply(fd, "BUSY");
+        return;
+    }
+
+    strcpy(queue[queued].label, label);
+    queue[queued].pid = 0;
+    ++queued;
+
+    snprintf(answer, sizeof(answer), "QUEUED %d", queued);
+    start_queued_jobs();
+    reply(fd, answer);
+}
+
+static int open_socket(const char *path)
+{
+    if (sd_listen_fds(0) == 1) {
+        /* Sockets passed by systemd don't have FD_CLOEXEC set, dumpers
+         * shouldn't inherit it. */
+        fcntl(SD_LISTEN_FDS_START, F_SETFD, FD_CLOEXEC);
+        return SD_LISTEN_FDS_START;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        syslog(LOG_CRIT, "Couldn't create socket: %s", strerror(errno));
+        return -1;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1 ||
+        listen(fd, MAX_CLIENTS) == -1) {
+        syslog(LOG_CRIT, "Couldn't listen on %s: %s", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    /* Requests are validated and only ever trigger rich-core-dumper, which
+     * rich-core-helper already allows to anyone. */
+    chmod(path, 0666);
+
+    return fd;
+}
+
+static void print_usage()
+{
+    fprintf(stderr, "usage: rich-core-broker [-j max_jobs] [-s socket_path] "
+            "[-d dumper]\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *socket_path = DEFAULT_SOCKET_PATH;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "j:s:d:")) != -1) {
+        switch (opt) {
+        case 'j':
+            max_running = atoi(optarg);
+            if (max_running < 1 || max_running > MAX_JOBS) {
+                print_usage();
+                return EXIT_FAILURE;
+            }
+            break;
+        case 's':
+            socket_path = optarg;
+            break;
+        case 'd':
+            /* Allows benchmarks to substitute a stub dumper. */
+            dumper_path = optarg;
+            break;
+        default:
+            print_usage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    openlog("rich-core-broker", LOG_PID, LOG_USER);
+    syslog(LOG_NOTICE, "Starting, at most %d concurrent collections.",
+            max_running);
+
+    srand(time(NULL));
+
+    int listenfd = open_socket(socket_path);
+    if (listenfd == -1) {
+        return EXIT_FAILURE;
+    }
+
+    sigset_t sigset;
+    sigemptyset(&sigset);
+    sigaddset(&sigset, SIGTERM);
+    sigaddset(&sigset, SIGINT);
+    sigaddset(&sigset, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &sigset, &original_sigmask);
+    int sigfd = signalfd(-1, &sigset, SFD_NONBLOCK | SFD_CLOEXEC);
+
+    struct pollfd fds[2 + MAX_CLIENTS];
+    int clients = 0;
+    int result = EXIT_SUCCESS;
+
+    fds[0].fd = listenfd;
+    fds[0].events = POLLIN;
+    fds[1].fd = sigfd;
+    fds[1].events = POLLIN;
+
+    while (1) {
+        if (poll(fds, 2 + clients, -1) == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            syslog(LOG_CRIT, "Error on poll(): %s", strerror(errno));
+            result = EXIT_FAILURE;
+            break;
+        }
+
+        if (fds[1].revents & POLLIN) {
+            struct signalfd_siginfo info;
+            int terminate = 0;
+            while (read(sigfd, &info, sizeof(info)) == sizeof(info)) {
+                if (info.ssi_signo == SIGCHLD) {
+                    reap_children();
+                } else {
+                    terminate = 1;
+                }
+            }
+            if (terminate) {
+                syslog(LOG_NOTICE, "Exiting.");
+                break;
+            }
+        }
+
+        /* Serve clients before accepting new ones so that the array can be
+         * compacted in place. */
+        int i;
+        for (i = 2; i < 2 + clients;) {
+            if (fds[i].revents) {
+                if (fds[i].revents & POLLIN) {
+                    handle_request(fds[i].fd);
+                }
+                close(fds[i].fd);
+                fds[i] = fds[1 + clients];
+                --clients;
+            } else {
+                ++i;
+            }
+        }
+
+        if (fds[0].revents & POLLIN) {
+            int clientfd = accept4(listenfd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (clientfd == -1) {
+                syslog(LOG_WARNING, "Error on accept(): %s", strerror(errno));
+            } else if (clients == MAX_CLIENTS) {
+                reply(clientfd, "BUSY");
+                close(clientfd);
+            } else {
+                fds[2 + clients].fd = clientfd;
+                fds[2 + clients].events = POLLIN;
+                fds[2 + clients].revents = 0;
+                ++clients;
+            }
+        }
+    }
+
+    return result;
+}
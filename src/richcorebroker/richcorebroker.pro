@@ -1,4 +1,4 @@
-# This file is part of crash-reporter
+# This file is a part of crash-reporter.
 #
 # Copyright (C) 2013 Jolla Ltd.
 # Contact: Jakub Adam <jakub.adam@jollamobile.com>
@@ -20,18 +20,14 @@
 include(../../crash-reporter-conf.pri)
 
 TEMPLATE = app
-TARGET = endurance-collect-daemon
+TARGET = rich-core-broker
 
 CONFIG -= qt
 CONFIG += link_pkgconfig
 
 SOURCES = main.c
 
-PKGCONFIG += \
-    dbus-1 \
-    libiphb
-
-LIBS += -lrt
+PKGCONFIG += libsystemd
 
 # qmake uses C++ linker by default, unnecessarily pulling in libstdc++
 QMAKE_LINK = $$QMAKE_LINK_C
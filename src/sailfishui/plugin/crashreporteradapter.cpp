@@ -21,12 +21,21 @@
 
 #include "crashreporteradapter.h"
 
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusServiceWatcher>
 #include <QFileSystemWatcher>
 
 #include "creportercoreregistry.h"
+#include "creporterdaemonproxy.h"
+#include "creporternamespace.h"
 #include "creporterutils.h"
 #include "pendinguploadsmodel.h"
 
+using CReporter::LoggingCategory::cr;
+
 class CrashReporterAdapterPrivate
 {
 public:
@@ -37,39 +46,167 @@ public:
 
 private:
     void updateCoreDirectoryModels();
-
+    void updateReportsToUpload();
+
+    void watchCoreDirectories();
+    void requestSnapshot();
+    void daemonUnregistered();
+    void snapshotReceived(QDBusPendingCallWatcher *call);
+    void reportAdded(const QString &filePath, qulonglong newGeneration);
+    void reportRemoved(const QString &filePath, qulonglong newGeneration);
+    //! @return @c true if the change directly follows the mirrored state.
+    bool acceptGeneration(qulonglong newGeneration);
+
+    /* While the daemon is running, the models mirror its report index.
+     * Otherwise the core directories are watched and scanned here. */
+    CReporterDaemonProxy daemon;
+    QDBusServiceWatcher daemonWatcher;
     QFileSystemWatcher watcher;
+    //! Generation of the daemon's index the models correspond to.
+    qulonglong generation;
+    bool snapshotPending;
 
     Q_DECLARE_PUBLIC(CrashReporterAdapter)
     CrashReporterAdapter *q_ptr;
 };
 
 CrashReporterAdapterPrivate::CrashReporterAdapterPrivate(CrashReporterAdapter *qq)
-    : reportsToUpload(0), q_ptr(qq)
+    : reportsToUpload(0),
+      daemon(CReporter::DaemonServiceName, CReporter::DaemonObjectPath,
+             QDBusConnection::sessionBus()),
+      daemonWatcher(CReporter::DaemonServiceName, QDBusConnection::sessionBus()),
+      generation(0), snapshotPending(false), q_ptr(qq)
 {
     Q_Q(CrashReporterAdapter);
 
-    updateCoreDirectoryModels();
+    QObject::connect(&daemon, SIGNAL(reportAdded(QString, qulonglong)),
+                     q, SLOT(reportAdded(QString, qulonglong)));
+    QObject::connect(&daemon, SIGNAL(reportRemoved(QString, qulonglong)),
+                     q, SLOT(reportRemoved(QString, qulonglong)));
+
+    QObject::connect(&daemonWatcher, SIGNAL(serviceRegistered(QString)),
+                     q, SLOT(requestSnapshot()));
+    QObject::connect(&daemonWatcher, SIGNAL(serviceUnregistered(QString)),
+                     q, SLOT(daemonUnregistered()));
+
     // Recalculate the models when directory contents change.
     QObject::connect(&watcher, SIGNAL(directoryChanged(const QString &)),
                      q, SLOT(updateCoreDirectoryModels()));
 
-    watcher.addPaths(CReporterCoreRegistry::instance()->getCoreLocationPaths());
+    QDBusConnectionInterface *bus = QDBusConnection::sessionBus().interface();
+    // Don't activate the daemon just to list the reports.
+    if (bus && bus->isServiceRegistered(CReporter::DaemonServiceName)) {
+        requestSnapshot();
+    } else {
+        watchCoreDirectories();
+    }
 }
 
 void CrashReporterAdapterPrivate::updateCoreDirectoryModels()
 {
-    Q_Q(CrashReporterAdapter);
+    pendingUploadsModel.setData(CReporterCoreRegistry::instance()->collectAllCoreFiles());
+    updateReportsToUpload();
+}
 
-    QStringList coreFiles(CReporterCoreRegistry::instance()->collectAllCoreFiles());
+void CrashReporterAdapterPrivate::updateReportsToUpload()
+{
+    Q_Q(CrashReporterAdapter);
 
-    int newCoresToUpload = coreFiles.count();
+    int newCoresToUpload = pendingUploadsModel.reportCount();
     if (newCoresToUpload != reportsToUpload) {
         reportsToUpload = newCoresToUpload;
         emit q->reportsToUploadChanged();
     }
+}
+
+void CrashReporterAdapterPrivate::watchCoreDirectories()
+{
+    updateCoreDirectoryModels();
+    watcher.addPaths(CReporterCoreRegistry::instance()->getCoreLocationPaths());
+}
+
+void CrashReporterAdapterPrivate::requestSnapshot()
+{
+    Q_Q(CrashReporterAdapter);
+
+    if (snapshotPending) {
+        return;
+    }
+    snapshotPending = true;
+
+    QDBusPendingCallWatcher *call =
+        new QDBusPendingCallWatcher(daemon.getCoreFileRecords(0, 0, QVariantMap()), q);
+    QObject::connect(call, SIGNAL(finished(QDBusPendingCallWatcher *)),
+                     q, SLOT(snapshotReceived(QDBusPendingCallWatcher *)));
+}
+
+void CrashReporterAdapterPrivate::daemonUnregistered()
+{
+    if (watcher.directories().isEmpty()) {
+        watchCoreDirectories();
+    }
+}
+
+void CrashReporterAdapterPrivate::snapshotReceived(QDBusPendingCallWatcher *call)
+{
+    QDBusPendingReply<CReporterCoreRecordList, uint, qulonglong> reply = *call;
+    call->deleteLater();
+    snapshotPending = false;
+
+    if (reply.isError()) {
+        qCWarning(cr)
+                << "Couldn't get reports from the daemon:" << reply.error().message();
+        if (watcher.directories().isEmpty()) {
+            watchCoreDirectories();
+        }
+        return;
+    }
+
+    // The daemon keeps the index from now on.
+    if (!watcher.directories().isEmpty()) {
+        watcher.removePaths(watcher.directories());
+    }
+
+    generation = reply.argumentAt<2>();
+    pendingUploadsModel.setRecords(reply.argumentAt<0>());
+    updateReportsToUpload();
+}
+
+bool CrashReporterAdapterPrivate::acceptGeneration(qulonglong newGeneration)
+{
+    // Changes made before the snapshot was taken are already in it.
+    if (snapshotPending || newGeneration <= generation) {
+        return false;
+    }
+
+    if (newGeneration != generation + 1) {
+        qCDebug(cr)
+                << "Missed report index changes" << generation + 1
+                << "to" << newGeneration - 1 << ", resynchronizing.";
+        requestSnapshot();
+        return false;
+    }
+
+    generation = newGeneration;
+    return true;
+}
+
+void CrashReporterAdapterPrivate::reportAdded(const QString &filePath,
+                                              qulonglong newGeneration)
+{
+    if (acceptGeneration(newGeneration)) {
+        pendingUploadsModel.addReport(filePath);
+        updateReportsToUpload();
+    }
+}
 
-    pendingUploadsModel.setData(coreFiles);
+void CrashReporterAdapterPrivate::reportRemoved(const QString &filePath,
+                                                qulonglong newGeneration)
+{
+    if (acceptGeneration(newGeneration)) {
+        pendingUploadsModel.removeReport(filePath);
+        updateReportsToUpload();
+    }
 }
 
 CrashReporterAdapter::CrashReporterAdapter(QObject *parent)
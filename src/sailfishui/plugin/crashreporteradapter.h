@@ -26,6 +26,7 @@
 
 class CrashReporterAdapterPrivate;
 class QAbstractListModel;
+class QDBusPendingCallWatcher;
 
 class CrashReporterAdapter: public QObject
 {
@@ -54,6 +55,11 @@ private:
     QScopedPointer<CrashReporterAdapterPrivate> d_ptr;
 
     Q_PRIVATE_SLOT(d_func(), void updateCoreDirectoryModels())
+    Q_PRIVATE_SLOT(d_func(), void requestSnapshot())
+    Q_PRIVATE_SLOT(d_func(), void daemonUnregistered())
+    Q_PRIVATE_SLOT(d_func(), void snapshotReceived(QDBusPendingCallWatcher *))
+    Q_PRIVATE_SLOT(d_func(), void reportAdded(const QString &, qulonglong))
+    Q_PRIVATE_SLOT(d_func(), void reportRemoved(const QString &, qulonglong))
 };
 
 #endif // CRASHREPORTERADAPTER_H
@@ -21,25 +21,110 @@
 
 #include "pendinguploadsmodel.h"
 
-#include <QStringList>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+
 #include <QDateTime>
+#include <QFile>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
 
-#include "creporterutils.h"
+#include "creportercoreregistry.h"
+#include "creportercrashinfo.h"
+
+namespace {
+//! Number of rows handed to views at once.
+const int FetchBatchSize = 100;
+}
 
 class PendingUploadsModelPrivate
 {
 public:
     struct Item {
-        QString applicationName;
-        pid_t pid;
-        QString signal;
+        Item() : created(0), hasMetadata(false), pid(0) {}
+
         QString filePath;
-        QDateTime dateCreated;
+        //! Sort key, modification time in milliseconds since the epoch, the
+        //! same as CReporterCoreRecord::modified from the report index.
+        qint64 created;
+
+        // Filled only when the row is displayed for the first time.
+        mutable bool hasMetadata;
+        mutable QString applicationName;
+        mutable pid_t pid;
+        mutable QString signal;
     };
 
-    QList<Item> contents;
+    PendingUploadsModelPrivate() : visibleCount(0) {}
+
+    static Item createItem(const QString &filePath);
+    static Item createItem(const CReporterCoreRecord &record);
+    static bool newerThan(const Item &a, const Item &b);
+
+    const Item &itemWithMetadata(int row) const;
+
+    //! All reports, newest first.
+    QVector<Item> contents;
+    //! Paths in contents, for identity checks.
+    QSet<QString> filePaths;
+    //! Number of leading rows of contents known to views.
+    int visibleCount;
+    //! New reports waiting to be merged into contents.
+    QVector<Item> added;
 };
 
+PendingUploadsModelPrivate::Item PendingUploadsModelPrivate::createItem(const QString &filePath)
+{
+    Item item;
+    item.filePath = filePath;
+
+    struct stat st;
+    if (stat(QFile::encodeName(filePath).constData(), &st) == 0) {
+        item.created = qint64(st.st_mtim.tv_sec) * 1000 + st.st_mtim.tv_nsec / 1000000;
+    }
+
+    return item;
+}
+
+PendingUploadsModelPrivate::Item PendingUploadsModelPrivate::createItem(const CReporterCoreRecord &record)
+{
+    Item item;
+    item.filePath = record.filePath;
+    item.created = record.modified;
+    item.applicationName = record.applicationName;
+    item.pid = record.pid;
+    item.signal = strsignal(record.signal);
+    item.hasMetadata = true;
+
+    return item;
+}
+
+bool PendingUploadsModelPrivate::newerThan(const Item &a, const Item &b)
+{
+    if (a.created != b.created) {
+        return a.created > b.created;
+    }
+    return a.filePath < b.filePath;
+}
+
+const PendingUploadsModelPrivate::Item &PendingUploadsModelPrivate::itemWithMetadata(int row) const
+{
+    const Item &item = contents.at(row);
+
+    if (!item.hasMetadata) {
+        CReporterCrashInfo info(CReporterCoreRegistry::instance()->crashInfo(item.filePath));
+        item.applicationName = info.applicationName().toString();
+        item.pid = info.pid();
+        item.signal = strsignal(info.signal());
+        item.hasMetadata = true;
+    }
+
+    return item;
+}
+
 PendingUploadsModel::PendingUploadsModel(QObject *parent)
     : QAbstractListModel(parent), d_ptr(new PendingUploadsModelPrivate)
 {
@@ -53,7 +138,16 @@ int PendingUploadsModel::rowCount(const QModelIndex &parent) const
 {
     Q_D(const PendingUploadsModel);
 
-    Q_UNUSED(parent);
+    if (parent.isValid()) {
+        return 0;
+    }
+
+    return d->visibleCount;
+}
+
+int PendingUploadsModel::reportCount() const
+{
+    Q_D(const PendingUploadsModel);
 
     return d->contents.size();
 }
@@ -62,21 +156,21 @@ QVariant PendingUploadsModel::data(const QModelIndex &index, int role) const
 {
     Q_D(const PendingUploadsModel);
 
-    Q_ASSERT(index.row() < d->contents.size());
+    Q_ASSERT(index.row() < d->visibleCount);
 
     const PendingUploadsModelPrivate::Item &item = d->contents.at(index.row());
 
     switch (role) {
     case Application:
-        return item.applicationName;
+        return d->itemWithMetadata(index.row()).applicationName;
     case PID:
-        return item.pid;
+        return d->itemWithMetadata(index.row()).pid;
     case Signal:
-        return item.signal;
+        return d->itemWithMetadata(index.row()).signal;
     case FilePath:
         return item.filePath;
     case DateCreated:
-        return item.dateCreated;
+        return item.created ? QDateTime::fromMSecsSinceEpoch(item.created) : QDateTime();
     default:
         return QVariant();
     }
@@ -94,47 +188,186 @@ QHash<int, QByteArray> PendingUploadsModel::roleNames() const
     return result;
 }
 
+bool PendingUploadsModel::canFetchMore(const QModelIndex &parent) const
+{
+    Q_D(const PendingUploadsModel);
+
+    return !parent.isValid() && d->visibleCount < d->contents.size();
+}
+
+void PendingUploadsModel::fetchMore(const QModelIndex &parent)
+{
+    Q_D(PendingUploadsModel);
+
+    int count = qMin(FetchBatchSize, d->contents.size() - d->visibleCount);
+    if (parent.isValid() || count <= 0) {
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), d->visibleCount, d->visibleCount + count - 1);
+    d->visibleCount += count;
+    endInsertRows();
+}
+
 void PendingUploadsModel::setData(const QStringList &data)
 {
     Q_D(PendingUploadsModel);
 
-    QStringList newData(data);
+    removeReportsNotIn(data.toSet());
 
-    for (int i = 0; i != d->contents.size(); ++i) {
-        int index = newData.indexOf(d->contents.at(i).filePath);
-        if (index == -1) {
-            beginRemoveRows(QModelIndex(), i, i);
-            d->contents.removeAt(i--);
-            endRemoveRows();
-        } else {
-            // We already have that item.
-            newData.removeAt(index);
+    foreach (const QString &filePath, data) {
+        if (!d->filePaths.contains(filePath)) {
+            d->filePaths.insert(filePath);
+            d->added.append(PendingUploadsModelPrivate::createItem(filePath));
         }
     }
+    mergeAdded();
+}
 
-    if (newData.isEmpty()) {
+void PendingUploadsModel::setRecords(const CReporterCoreRecordList &records)
+{
+    Q_D(PendingUploadsModel);
+
+    QSet<QString> newPaths;
+    foreach (const CReporterCoreRecord &record, records) {
+        newPaths.insert(record.filePath);
+    }
+    removeReportsNotIn(newPaths);
+
+    foreach (const CReporterCoreRecord &record, records) {
+        if (!d->filePaths.contains(record.filePath)) {
+            d->filePaths.insert(record.filePath);
+            d->added.append(PendingUploadsModelPrivate::createItem(record));
+        }
+    }
+    mergeAdded();
+}
+
+void PendingUploadsModel::addReport(const QString &filePath)
+{
+    Q_D(PendingUploadsModel);
+
+    if (!d->filePaths.contains(filePath)) {
+        d->filePaths.insert(filePath);
+        d->added.append(PendingUploadsModelPrivate::createItem(filePath));
+        mergeAdded();
+    }
+}
+
+void PendingUploadsModel::removeReport(const QString &filePath)
+{
+    Q_D(PendingUploadsModel);
+
+    if (!d->filePaths.remove(filePath)) {
         return;
     }
 
-    // Append new items.
-    foreach (const QString &filePath, newData) {
-        QStringList info(CReporterUtils::parseCrashInfoFromFilename(filePath));
+    int row = 0;
+    while (d->contents.at(row).filePath != filePath) {
+        ++row;
+    }
+
+    if (row < d->visibleCount) {
+        beginRemoveRows(QModelIndex(), row, row);
+        d->contents.remove(row);
+        --d->visibleCount;
+        endRemoveRows();
+    } else {
+        d->contents.remove(row);
+    }
+
+    showFirstPage();
+}
+
+void PendingUploadsModel::removeReportsNotIn(const QSet<QString> &newPaths)
+{
+    Q_D(PendingUploadsModel);
+
+    /* Remove rows of the files that are gone, each contiguous range at once.
+     * Walking backwards keeps the indexes of the rows yet to check valid.
+     * Views don't know about rows past visibleCount, those go silently. */
+    int last = d->contents.size() - 1;
+    while (last >= 0) {
+        if (newPaths.contains(d->contents.at(last).filePath)) {
+            --last;
+            continue;
+        }
+
+        int first = last;
+        while (first > 0 && !newPaths.contains(d->contents.at(first - 1).filePath)) {
+            --first;
+        }
+
+        for (int i = first; i <= last; ++i) {
+            d->filePaths.remove(d->contents.at(i).filePath);
+        }
+
+        int count = last - first + 1;
+        if (first < d->visibleCount) {
+            int visibleLast = qMin(last, d->visibleCount - 1);
+            beginRemoveRows(QModelIndex(), first, visibleLast);
+            d->contents.remove(first, count);
+            d->visibleCount -= visibleLast - first + 1;
+            endRemoveRows();
+        } else {
+            d->contents.remove(first, count);
+        }
+
+        last = first - 1;
+    }
+}
+
+void PendingUploadsModel::mergeAdded()
+{
+    Q_D(PendingUploadsModel);
 
-        PendingUploadsModelPrivate::Item item;
-        item.applicationName = info[0];
-        item.pid = info[3].toInt();
-        item.signal = strsignal(info[2].toInt());
-        item.filePath = filePath;
-        item.dateCreated = QFileInfo(filePath).created();
+    std::sort(d->added.begin(), d->added.end(), PendingUploadsModelPrivate::newerThan);
 
-        int i = 0;
-        for (; i < d->contents.count(); ++i) {
-            if (item.dateCreated > d->contents.at(i).dateCreated) {
-                break;
-            }
+    /* Both lists are sorted; merge the new items in as runs of rows that
+     * belong between the same two existing rows. */
+    int row = 0;
+    int i = 0;
+    while (i < d->added.size()) {
+        while (row < d->contents.size() &&
+               PendingUploadsModelPrivate::newerThan(d->contents.at(row), d->added.at(i))) {
+            ++row;
         }
-        beginInsertRows(QModelIndex(), i, i);
-        d->contents.insert(i, item);
+
+        int end = i + 1;
+        while (end < d->added.size() && (row == d->contents.size() ||
+               PendingUploadsModelPrivate::newerThan(d->added.at(end), d->contents.at(row)))) {
+            ++end;
+        }
+
+        int count = end - i;
+        bool visible = row < d->visibleCount;
+        if (visible) {
+            beginInsertRows(QModelIndex(), row, row + count - 1);
+        }
+        d->contents.insert(row, count, PendingUploadsModelPrivate::Item());
+        std::copy(d->added.constBegin() + i, d->added.constBegin() + end, d->contents.begin() + row);
+        if (visible) {
+            d->visibleCount += count;
+            endInsertRows();
+        }
+
+        row += count;
+        i = end;
+    }
+
+    d->added.clear();
+
+    showFirstPage();
+}
+
+void PendingUploadsModel::showFirstPage()
+{
+    Q_D(PendingUploadsModel);
+
+    int firstPage = qMin(FetchBatchSize, d->contents.size());
+    if (d->visibleCount < firstPage) {
+        beginInsertRows(QModelIndex(), d->visibleCount, firstPage - 1);
+        d->visibleCount = firstPage;
         endInsertRows();
     }
 }
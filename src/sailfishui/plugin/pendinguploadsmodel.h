@@ -23,6 +23,9 @@
 #define PENDINGUPLOADSMODEL_H
 
 #include <QAbstractListModel>
+#include <QSet>
+
+#include "creportercorerecord.h"
 
 class PendingUploadsModelPrivate;
 
@@ -43,12 +46,45 @@ public:
 
     int rowCount(const QModelIndex &parent) const;
 
+    //! @return Number of all reports, including rows not fetched yet.
+    int reportCount() const;
+
     QVariant data(const QModelIndex &index, int role) const;
     QHash<int, QByteArray> roleNames() const;
 
+    /*!
+     * Rows are exposed to views in pages, the rest of the reports is
+     * fetched as the view scrolls.
+     */
+    bool canFetchMore(const QModelIndex &parent) const;
+    void fetchMore(const QModelIndex &parent);
+
+    /*!
+     * Updates the model to contain the given report files, newest first.
+     * Only the difference against the current contents is applied, in as few
+     * row insertions and removals as possible.
+     */
     void setData(const QStringList &data);
 
+    /*!
+     * Same as setData(), but takes the metadata from the records instead of
+     * reading it from the files.
+     */
+    void setRecords(const CReporterCoreRecordList &records);
+
+    //! Adds a single report unless the model already contains it.
+    void addReport(const QString &filePath);
+    //! Removes a single report if the model contains it.
+    void removeReport(const QString &filePath);
+
 private:
+    //! Removes the reports whose paths aren't in the set.
+    void removeReportsNotIn(const QSet<QString> &newPaths);
+    //! Merges the reports collected in the private added list into the model.
+    void mergeAdded();
+    //! Makes sure the first page is always shown.
+    void showFirstPage();
+
     Q_DECLARE_PRIVATE(PendingUploadsModel)
     QScopedPointer<PendingUploadsModelPrivate> d_ptr;
 };
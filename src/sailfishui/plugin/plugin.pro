@@ -15,6 +15,7 @@ target.path = $$TARGETPATH
 INCLUDEPATH += \
 	../../libs \
 	../../libs/coredir \
+	../../libs/serviceif \
 	../../libs/settings \
 	../../libs/utils \
 
@@ -2,7 +2,6 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
-#include <stdbool.h>
 
 static void printUsage()
 {
@@ -16,25 +15,18 @@ int main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
-    char *serviceName;
-    if (strcmp(argv[1], "journalspy") == 0) {
-        serviceName = "crash-reporter-journalspy.service";
-    } else if (strcmp(argv[1], "endurance") == 0) {
-        serviceName = "crash-reporter-endurance.service";
-    } else {
+    /* Both sources run in the collector host, which re-reads the enable
+     * marks on reload. */
+    if (strcmp(argv[1], "journalspy") != 0 && strcmp(argv[1], "endurance") != 0) {
         printUsage();
         return EXIT_FAILURE;
     }
 
-    bool start;
-    if (strcmp(argv[2], "start") == 0) {
-        start = true;
-    } else if (strcmp(argv[2], "stop") == 0) {
-        start = false;
-    } else {
+    if (strcmp(argv[2], "start") != 0 && strcmp(argv[2], "stop") != 0) {
         printUsage();
         return EXIT_FAILURE;
     }
 
-    return execlp("systemctl", "systemctl", (start ? "start" : "stop"), serviceName, NULL);
+    return execlp("systemctl", "systemctl", "reload-or-restart",
+                  "crash-reporter-collector.service", NULL);
 }
@@ -7,7 +7,11 @@ SUBDIRS += \
     daemon \
     autouploader \
     sailfishui \
-    endurancecollect \
+    collector \
+    endurancepackager \
+    dumper \
+    debuginfo \
     richcorehelper \
-    journalspy \
+    richcorebroker \
     servicehelper \
+    logdecode \
@@ -0,0 +1,23 @@
+TEMPLATE = subdirs
+
+SUBDIRS = bm_logcollection \
+	bm_coreregistry \
+	bm_crashinfo \
+	bm_daemonmonitor \
+	bm_pendinguploadsmodel \
+	bm_journalspy \
+	bm_httpupload \
+	bm_crashstorm \
+	bm_daemonstartup \
+	bm_coldstart \
+	bm_corereducer \
+	bm_debuginfocache \
+
+runbenchmarks.path = /usr/share/crash-reporter-tests/benchmarks
+runbenchmarks.files = \
+	run_benchmarks.sh \
+	compare_benchmarks.sh \
+	endurance-packager-benchmark.sh \
+	dumper-benchmark.sh
+
+INSTALLS += runbenchmarks
@@ -0,0 +1,277 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDBusServiceWatcher>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QSettings>
+#include <QSignalSpy>
+
+#include "bm_coldstart.h"
+#include "creporternamespace.h"
+#include "fakeautouploader.h"
+
+namespace {
+
+const int StartTimeoutMs = 10000;
+// Long enough for the daemon not to exit while being measured.
+const int LongIdleTimeout = 60;
+const int LatencyRuns = 5;
+
+bool serviceRegistered(const QString &service)
+{
+    return QDBusConnection::sessionBus().interface()->isServiceRegistered(service);
+}
+
+} // namespace
+
+void Bm_ColdStart::initTestCase()
+{
+    uploader = 0;
+    daemon = 0;
+
+    coreDir = qgetenv("CREPORTER_STORM_DIR");
+    if (coreDir.isEmpty()) {
+        coreDir = "/var/cache/core-dumps";
+    }
+    daemonBinary = qgetenv("CREPORTER_DAEMON");
+    if (daemonBinary.isEmpty()) {
+        daemonBinary = CREPORTER_DAEMON_BINARY;
+    }
+
+    if (!QFileInfo(daemonBinary).isExecutable()) {
+        QSKIP("crash-reporter-daemon isn't installed.");
+    }
+    if (!QFileInfo(coreDir).isWritable()) {
+        QSKIP("The core-dumps directory isn't writable.");
+    }
+    if (serviceRegistered(CReporter::DaemonServiceName)) {
+        QSKIP("crash-reporter-daemon is already running.");
+    }
+    QVERIFY(home.isValid());
+
+    uploader = new FakeAutoUploader(this);
+    QDBusConnection bus(QDBusConnection::sessionBus());
+    QVERIFY(bus.registerObject(CReporter::AutoUploaderObjectPath, uploader,
+                               QDBusConnection::ExportScriptableSlots));
+    QVERIFY(bus.registerService(CReporter::AutoUploaderServiceName));
+
+    daemon = new QProcess(this);
+    daemon->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    daemon->setStandardOutputFile(QProcess::nullDevice());
+}
+
+void Bm_ColdStart::startup_data()
+{
+    QTest::addColumn<int>("reports");
+    QTest::addColumn<bool>("snapshot");
+
+    QTest::newRow("empty, scan") << 0 << false;
+    QTest::newRow("empty, snapshot") << 0 << true;
+    QTest::newRow("100 reports, scan") << 100 << false;
+    QTest::newRow("100 reports, snapshot") << 100 << true;
+    QTest::newRow("1000 reports, scan") << 1000 << false;
+    QTest::newRow("1000 reports, snapshot") << 1000 << true;
+}
+
+void Bm_ColdStart::startup()
+{
+    QFETCH(int, reports);
+    QFETCH(bool, snapshot);
+
+    removeReports();
+    writeSettings(LongIdleTimeout);
+    for (int i = 0; i != reports; ++i) {
+        QVERIFY(!writeReport(i).isEmpty());
+    }
+
+    QString snapshotPath(home.path() + "/.config/crash-reporter-settings/daemon-snapshot");
+    QFile::remove(snapshotPath);
+    if (snapshot) {
+        // Directories modified within the last second aren't snapshotted.
+        QTest::qWait(1100);
+        QVERIFY(startDaemon());
+        stopDaemon();
+        QVERIFY(QFile::exists(snapshotPath));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(startDaemon());
+    qint64 startupUs = timer.nsecsElapsed() / 1000;
+
+    stopDaemon();
+    removeReports();
+
+    QTest::setBenchmarkResult(startupUs / 1000.0, QTest::WalltimeMilliseconds);
+}
+
+void Bm_ColdStart::reportLatency()
+{
+    QList<qint64> latenciesUs;
+
+    for (int run = 0; run != LatencyRuns; ++run) {
+        removeReports();
+        writeSettings(LongIdleTimeout);
+
+        // The snapshot tells the daemon which reports it has already seen.
+        QTest::qWait(1100);
+        QVERIFY(startDaemon());
+        stopDaemon();
+        uploader->reset();
+
+        // Written while the daemon isn't running; the path unit starts it.
+        qint64 writtenUs = CReporterTrace::now();
+        QString path(writeReport(run));
+        QVERIFY(!path.isEmpty());
+        QVERIFY(startDaemon());
+
+        QElapsedTimer timeout;
+        timeout.start();
+        while (!uploader->traces.contains(path)) {
+            QVERIFY2(timeout.elapsed() < StartTimeoutMs, "The report wasn't uploaded.");
+            QTest::qWait(5);
+        }
+        latenciesUs << uploader->traces.value(path).timestamp(CReporterTrace::UploaderNotified)
+                    - writtenUs;
+
+        stopDaemon();
+    }
+    removeReports();
+
+    qSort(latenciesUs);
+    qint64 medianUs = latenciesUs.at(latenciesUs.size() / 2);
+    qDebug("latency min %.1f ms, median %.1f ms, max %.1f ms",
+           latenciesUs.first() / 1000.0, medianUs / 1000.0, latenciesUs.last() / 1000.0);
+
+    QTest::setBenchmarkResult(medianUs / 1000.0, QTest::WalltimeMilliseconds);
+}
+
+void Bm_ColdStart::idleExit()
+{
+    const int idleTimeout = 1;
+
+    removeReports();
+    writeSettings(idleTimeout);
+
+    QVERIFY(startDaemon());
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY2(daemon->waitForFinished(idleTimeout * 1000 + StartTimeoutMs),
+             "The daemon didn't exit when idle.");
+    qint64 lingerMs = timer.elapsed() - idleTimeout * 1000;
+
+    QCOMPARE(daemon->exitStatus(), QProcess::NormalExit);
+    QCOMPARE(daemon->exitCode(), 0);
+    QVERIFY(!serviceRegistered(CReporter::DaemonServiceName));
+
+    QTest::setBenchmarkResult(lingerMs, QTest::WalltimeMilliseconds);
+}
+
+void Bm_ColdStart::cleanupTestCase()
+{
+    if (daemon) {
+        stopDaemon();
+    }
+    if (!coreDir.isEmpty()) {
+        removeReports();
+    }
+}
+
+void Bm_ColdStart::writeSettings(int idleTimeout)
+{
+    QString settingsDir(home.path() + "/.config/crash-reporter-settings");
+    QDir().mkpath(settingsDir);
+    QFile::remove(settingsDir + "/crash-reporter-privacy.conf");
+    QFile::remove(settingsDir + "/crash-reporter.conf");
+
+    QSettings privacy(settingsDir + "/crash-reporter-privacy.conf", QSettings::IniFormat);
+    privacy.setValue("Settings/coredumping", true);
+    privacy.setValue("Settings/notifications", false);
+    privacy.setValue("Settings/automaticsending", true);
+    privacy.setValue("Settings/privacy-notice-accepted", true);
+    privacy.setValue("Settings/allow-mobile-data", true);
+    privacy.sync();
+
+    QSettings application(settingsDir + "/crash-reporter.conf", QSettings::IniFormat);
+    application.setValue("Daemon/idle_timeout", idleTimeout);
+    application.sync();
+}
+
+QString Bm_ColdStart::writeReport(int index)
+{
+    QString path(QString("%1/coldstart%2-0123456789abcdef-11-%3.rcore.lzo")
+                 .arg(coreDir).arg(index).arg(10000 + index));
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write("rcore") != 5) {
+        return QString();
+    }
+    return path;
+}
+
+bool Bm_ColdStart::startDaemon()
+{
+    QDBusServiceWatcher watcher(CReporter::DaemonServiceName, QDBusConnection::sessionBus(),
+                                QDBusServiceWatcher::WatchForRegistration);
+    QSignalSpy registered(&watcher, SIGNAL(serviceRegistered(QString)));
+
+    QProcessEnvironment environment(QProcessEnvironment::systemEnvironment());
+    environment.insert("HOME", home.path());
+    daemon->setProcessEnvironment(environment);
+    daemon->start(daemonBinary, QStringList() << "--on-demand");
+    if (!daemon->waitForStarted()) {
+        return false;
+    }
+
+    return registered.wait(StartTimeoutMs) && daemon->state() == QProcess::Running;
+}
+
+void Bm_ColdStart::stopDaemon()
+{
+    if (daemon->state() == QProcess::NotRunning) {
+        return;
+    }
+    // The daemon saves its snapshot on the way out.
+    daemon->terminate();
+    if (!daemon->waitForFinished(5000)) {
+        daemon->kill();
+        daemon->waitForFinished();
+    }
+}
+
+void Bm_ColdStart::removeReports()
+{
+    // Only reports written by this benchmark carry its hwid.
+    QDir dir(coreDir);
+    foreach (const QString &name, dir.entryList(QStringList() << "*-0123456789abcdef-*",
+                                                QDir::Files | QDir::Hidden)) {
+        dir.remove(name);
+    }
+}
+
+QTEST_MAIN(Bm_ColdStart)
@@ -0,0 +1,77 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef BM_COLDSTART_H
+#define BM_COLDSTART_H
+
+#include <QTemporaryDir>
+#include <QTest>
+
+class FakeAutoUploader;
+class QProcess;
+
+/*!
+ * Measures the installed crash-reporter-daemon when it runs on demand
+ * instead of staying resident.
+ *
+ * startup() reports the time from starting the daemon to its D-Bus service
+ * being registered, with and without a snapshot of the report index.
+ * reportLatency() writes a report while the daemon isn't running and starts
+ * it the way the path unit does, reporting the time until the autouploader
+ * is called. idleExit() reports how long the daemon lingers past its idle
+ * timeout.
+ *
+ * The daemon uses its usual core-dumps directory, so the running
+ * crash-reporter service must be stopped first. It runs with a temporary
+ * HOME holding its settings and snapshot.
+ */
+class Bm_ColdStart : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void startup_data();
+    void startup();
+
+    void reportLatency();
+
+    void idleExit();
+
+    void cleanupTestCase();
+
+private:
+    void writeSettings(int idleTimeout);
+    QString writeReport(int index);
+    bool startDaemon();
+    void stopDaemon();
+    void removeReports();
+
+    QString coreDir;
+    QString daemonBinary;
+    QTemporaryDir home;
+    FakeAutoUploader *uploader;
+    QProcess *daemon;
+};
+
+#endif // BM_COLDSTART_H
@@ -0,0 +1,24 @@
+include(../bm_common_top.pri)
+
+TARGET = bm_coldstart
+
+# Talks to the installed daemon under the real D-Bus names.
+DEFINES -= CREPORTER_UNIT_TEST
+DEFINES += CREPORTER_DAEMON_BINARY=\\\"$$CREPORTER_SYSTEM_BIN/crash-reporter-daemon\\\"
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               ../bm_crashstorm \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+HEADERS += \
+	../bm_crashstorm/fakeautouploader.h \
+	bm_coldstart.h \
+
+SOURCES += \
+	../bm_crashstorm/fakeautouploader.cpp \
+	bm_coldstart.cpp \
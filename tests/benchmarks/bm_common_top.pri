@@ -0,0 +1,20 @@
+DEFINES += CREPORTER_UNIT_TEST
+include(../../crash-reporter-conf.pri)
+
+TEMPLATE = app
+QT += testlib dbus
+CONFIG += release
+
+CREPORTER_SRC_DIR = ../../../src
+CREPORTER_TESTLIB_DIR = ../../qtest/testlib
+
+include(../qtest/testlib/testlib.pri)
+
+INCLUDEPATH += . \
+               $${CREPORTER_TESTLIB_DIR} \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+target.path = $$CREPORTER_TESTS_INSTALL_LIBS/benchmarks
+
+INSTALLS += target \
@@ -0,0 +1,175 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryFile>
+
+#include "bm_corereducer.h"
+
+extern "C" {
+#include "corereducer.h"
+#include "lzop.h"
+#include "stacktrace.h"
+}
+
+namespace {
+
+const QByteArray CoreSection("\n[---rich-core: coredump---]\n");
+
+int countBytes(void *context, const void *data, size_t len)
+{
+    Q_UNUSED(data)
+
+    *static_cast<quint64 *>(context) += len;
+    return 0;
+}
+
+int appendBytes(void *context, const void *data, size_t len)
+{
+    static_cast<QByteArray *>(context)->append(static_cast<const char *>(data), len);
+    return 0;
+}
+
+//! @return The coredump section of a rich core, which is its last section.
+QByteArray extractCore(const QString &path)
+{
+    struct lzop_reader reader;
+    if (lzop_reader_open(&reader, QFile::encodeName(path).constData()) != 0) {
+        return QByteArray();
+    }
+
+    QByteArray data;
+    char buf[64 * 1024];
+    ssize_t len;
+    while ((len = lzop_read(&reader, buf, sizeof(buf))) > 0) {
+        data.append(buf, len);
+    }
+    lzop_reader_close(&reader);
+
+    int start = data.indexOf(CoreSection);
+    return start == -1 ? QByteArray() : data.mid(start + CoreSection.size());
+}
+
+} // namespace
+
+void Bm_CoreReducer::initTestCase()
+{
+    QDir testData(CREPORTER_TESTDATA_DIR);
+    foreach (const QString &fileName, testData.entryList(QStringList() << "*.rcore.lzo")) {
+        QByteArray core(extractCore(testData.absoluteFilePath(fileName)));
+        if (!core.isEmpty()) {
+            cores.insert(fileName, core);
+        }
+    }
+
+    QByteArray corePath(qgetenv("CREPORTER_CORE_FILE"));
+    if (!corePath.isEmpty()) {
+        QFile file(QString::fromLocal8Bit(corePath));
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        cores.insert(file.fileName(), file.readAll());
+    }
+
+    QVERIFY(!cores.isEmpty());
+}
+
+void Bm_CoreReducer::reduce_data()
+{
+    QTest::addColumn<QString>("name");
+
+    foreach (const QString &name, cores.keys()) {
+        QTest::newRow(qPrintable(name)) << name;
+    }
+}
+
+void Bm_CoreReducer::reduce()
+{
+    QFETCH(QString, name);
+
+    // The reducer reads from a file descriptor, like from the core pipe.
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(cores.value(name)), qint64(cores.value(name).size()));
+    QVERIFY(file.flush());
+
+    struct core_reducer_stats stats;
+    quint64 output = 0;
+    int result = -1;
+    QBENCHMARK {
+        lseek(file.handle(), 0, SEEK_SET);
+        output = 0;
+        result = core_reduce(file.handle(), countBytes, &output, &stats);
+    }
+
+    QCOMPARE(result, 0);
+    QCOMPARE(quint64(stats.output_size), output);
+    QVERIFY(stats.output_size < stats.input_size);
+
+    qDebug() << name << stats.input_size << "->" << stats.output_size << "bytes,"
+             << stats.threads << "threads," << stats.segments << "segments";
+}
+
+void Bm_CoreReducer::unwind_data()
+{
+    reduce_data();
+}
+
+void Bm_CoreReducer::unwind()
+{
+    QFETCH(QString, name);
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(cores.value(name)), qint64(cores.value(name).size()));
+    QVERIFY(file.flush());
+    lseek(file.handle(), 0, SEEK_SET);
+
+    QByteArray reduced;
+    struct core_reducer_stats stats;
+    QCOMPARE(core_reduce(file.handle(), appendBytes, &reduced, &stats), 0);
+
+    struct stack_trace trace;
+    int result = -1;
+    QBENCHMARK {
+        // The unwinder takes over the core.
+        char *core = static_cast<char *>(malloc(reduced.size()));
+        memcpy(core, reduced.constData(), reduced.size());
+        result = stack_trace_collect(core, reduced.size(), 10000, NULL, &trace);
+        if (result == 0) {
+            stack_trace_free(&trace);
+        }
+    }
+
+    QCOMPARE(result, 0);
+    QVERIFY(!trace.truncated);
+    QCOMPARE(trace.threads, stats.threads);
+
+    qDebug() << name << trace.threads << "threads," << trace.frames << "frames,"
+             << "fingerprint" << QByteArray::number(trace.fingerprint, 16);
+}
+
+QTEST_MAIN(Bm_CoreReducer)
@@ -0,0 +1,54 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef BM_COREREDUCER_H
+#define BM_COREREDUCER_H
+
+#include <QMap>
+#include <QTest>
+
+/*!
+ * Measures core reduction, the size of the reduced cores and how long it
+ * takes to unwind them.
+ *
+ * Cores are taken from the coredump sections of the rich cores in the test
+ * data. A core file given in CREPORTER_CORE_FILE, e.g. one of a large
+ * multithreaded application, is measured too.
+ */
+class Bm_CoreReducer : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void reduce_data();
+    void reduce();
+
+    void unwind_data();
+    void unwind();
+
+private:
+    QMap<QString, QByteArray> cores;
+};
+
+#endif // BM_COREREDUCER_H
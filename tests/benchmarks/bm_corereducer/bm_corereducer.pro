@@ -0,0 +1,27 @@
+include(../bm_common_top.pri)
+
+TARGET = bm_corereducer
+
+DEFINES += CREPORTER_TESTDATA_DIR=\\\"$$CREPORTER_TESTS_TESTDATA_INSTALL_LIBS\\\"
+
+INCLUDEPATH += . \
+               $$CREPORTER_SRC_DIR/dumper \
+               $$CREPORTER_SRC_DIR/common \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+HEADERS += \
+	$${CREPORTER_SRC_DIR}/dumper/corereducer.h \
+	$${CREPORTER_SRC_DIR}/dumper/stacktrace.h \
+	$${CREPORTER_SRC_DIR}/common/debuginfocache.h \
+	$${CREPORTER_SRC_DIR}/common/lzop.h \
+	bm_corereducer.h \
+
+SOURCES += \
+	$${CREPORTER_SRC_DIR}/dumper/corereducer.c \
+	$${CREPORTER_SRC_DIR}/dumper/stacktrace.c \
+	$${CREPORTER_SRC_DIR}/common/debuginfocache.c \
+	$${CREPORTER_SRC_DIR}/common/lzop.c \
+	bm_corereducer.cpp \
+
+LIBS += -llzo2 -ldw -lelf -lpthread
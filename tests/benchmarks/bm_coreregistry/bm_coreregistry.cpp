@@ -0,0 +1,130 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QDir>
+#include <QFile>
+
+#include "bm_coreregistry.h"
+#include "creportercoreregistry.h"
+#include "creportertestutils.h"
+
+void Bm_CoreRegistry::initTestCase()
+{
+    CReporterTestUtils::createTestMountpoints();
+
+    // Creates the core-dumps directory under the test mount point.
+    coreDir = CReporterCoreRegistry::instance()->getCoreLocationPaths().value(0);
+    if (coreDir.isEmpty()) {
+        coreDir = QDir::homePath() + "/crash-reporter-tests/home/user/MyDocs/core-dumps";
+        QVERIFY(QDir().mkpath(coreDir));
+    }
+    createdCount = 0;
+}
+
+void Bm_CoreRegistry::createReports(int count)
+{
+    // Reports are only added, rows with more files reuse the earlier ones.
+    for (; createdCount < count; ++createdCount) {
+        QFile file(QString("%1/application%2-0123456789abcdef-11-%3.rcore.lzo")
+                   .arg(coreDir).arg(createdCount % 50).arg(1000 + createdCount));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+    CReporterCoreRegistry::instance()->refreshRegistry();
+}
+
+void Bm_CoreRegistry::collectAllCoreFiles_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+}
+
+void Bm_CoreRegistry::collectAllCoreFiles()
+{
+    QFETCH(int, count);
+
+    createReports(count);
+
+    CReporterCoreRegistry *registry = CReporterCoreRegistry::instance();
+    QStringList files;
+    QBENCHMARK {
+        files = registry->collectAllCoreFiles();
+    }
+
+    QCOMPARE(files.size(), count);
+}
+
+void Bm_CoreRegistry::checkDirectoryForCores_data()
+{
+    collectAllCoreFiles_data();
+}
+
+void Bm_CoreRegistry::checkDirectoryForCores()
+{
+    QFETCH(int, count);
+
+    createReports(count);
+
+    /* Nothing new in the directory, the whole listing is compared against the
+     * known files and then re-read. This is what every deletion costs. */
+    CReporterCoreRegistry *registry = CReporterCoreRegistry::instance();
+    QString found;
+    QBENCHMARK {
+        found = registry->checkDirectoryForCores(coreDir);
+    }
+
+    QVERIFY(found.isEmpty());
+}
+
+void Bm_CoreRegistry::collectAllCoreFilesMemory_data()
+{
+    collectAllCoreFiles_data();
+}
+
+void Bm_CoreRegistry::collectAllCoreFilesMemory()
+{
+    QFETCH(int, count);
+
+    createReports(count);
+
+    CReporterCoreRegistry *registry = CReporterCoreRegistry::instance();
+    qint64 baseline = CReporterTestUtils::currentMemory();
+    CReporterTestUtils::resetPeakMemory();
+
+    QStringList files(registry->collectAllCoreFiles());
+    foreach (const QString &file, files) {
+        registry->crashInfo(file);
+    }
+
+    QTest::setBenchmarkResult(CReporterTestUtils::peakMemory() - baseline,
+                              QTest::BytesAllocated);
+    QCOMPARE(files.size(), count);
+}
+
+void Bm_CoreRegistry::cleanupTestCase()
+{
+    CReporterTestUtils::removeTestMountpoints();
+}
+
+QTEST_MAIN(Bm_CoreRegistry)
@@ -0,0 +1,25 @@
+include(../bm_common_top.pri)
+
+TARGET = bm_coreregistry
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               $$CREPORTER_SRC_DIR/libs/coredir \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+# Compiled in for the test mount points.
+HEADERS += \
+	$${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.h \
+	$${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir_p.h \
+	$${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.h \
+	$${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry_p.h \
+	bm_coreregistry.h \
+
+SOURCES += \
+	$${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.cpp \
+	$${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.cpp \
+	bm_coreregistry.cpp \
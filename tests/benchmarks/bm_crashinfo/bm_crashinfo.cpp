@@ -0,0 +1,101 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QStringList>
+#include <QVector>
+
+#include "bm_crashinfo.h"
+#include "creportercrashinfo.h"
+#include "creportertestutils.h"
+
+static const int DirectorySize = 10000;
+
+static QStringList directoryListing()
+{
+    QStringList files;
+    for (int i = 0; i < DirectorySize; ++i) {
+        files << QString("/var/cache/core-dumps/application%1-0123456789abcdef-11-%2.rcore.lzo")
+                 .arg(i % 50).arg(1000 + i);
+    }
+    return files;
+}
+
+void Bm_CrashInfo::parse_data()
+{
+    QTest::addColumn<QString>("path");
+
+    QTest::newRow("crash")
+            << "/var/cache/core-dumps/jolla-settings-0123456789abcdef-11-4321.rcore.lzo";
+    QTest::newRow("long name")
+            << "/var/cache/core-dumps/org.example.some-long-application-name-with-dashes-"
+               "0123456789abcdef-6-123456.rcore.lzo";
+    QTest::newRow("endurance")
+            << "/var/cache/core-dumps/Endurance-0123456789abcdef-1392000000-1391990000.rcore.lzo";
+    QTest::newRow("invalid")
+            << "/var/cache/core-dumps/garbage-11.rcore.lzo";
+}
+
+void Bm_CrashInfo::parse()
+{
+    QFETCH(QString, path);
+
+    int signal = 0;
+    QBENCHMARK {
+        CReporterCrashInfo info(path);
+        signal += info.signal();
+    }
+
+    QVERIFY(signal >= 0);
+}
+
+void Bm_CrashInfo::parseDirectory()
+{
+    QStringList files(directoryListing());
+
+    QBENCHMARK {
+        QVector<CReporterCrashInfo> infos;
+        infos.reserve(files.size());
+        foreach (const QString &file, files) {
+            infos.append(CReporterCrashInfo(file));
+        }
+    }
+}
+
+void Bm_CrashInfo::parseDirectoryMemory()
+{
+    QStringList files(directoryListing());
+
+    qint64 baseline = CReporterTestUtils::currentMemory();
+    CReporterTestUtils::resetPeakMemory();
+
+    QVector<CReporterCrashInfo> infos;
+    infos.reserve(files.size());
+    foreach (const QString &file, files) {
+        infos.append(CReporterCrashInfo(file));
+    }
+
+    QTest::setBenchmarkResult(CReporterTestUtils::peakMemory() - baseline,
+                              QTest::BytesAllocated);
+    QCOMPARE(infos.size(), files.size());
+}
+
+QTEST_MAIN(Bm_CrashInfo)
@@ -0,0 +1,17 @@
+include(../bm_common_top.pri)
+
+TARGET = bm_crashinfo
+
+INCLUDEPATH += . \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+HEADERS += \
+	$${CREPORTER_SRC_DIR}/libs/utils/creportercrashinfo.h \
+	bm_crashinfo.h \
+
+SOURCES += \
+	$${CREPORTER_SRC_DIR}/libs/utils/creportercrashinfo.cpp \
+	bm_crashinfo.cpp \
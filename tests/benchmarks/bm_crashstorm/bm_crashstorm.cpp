@@ -0,0 +1,434 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <unistd.h>
+
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QSettings>
+#include <QTextStream>
+
+#include "bm_crashstorm.h"
+#include "creportercrashinfo.h"
+#include "creporternamespace.h"
+#include "creportertestutils.h"
+
+namespace {
+
+// Time without autouploader calls after which a storm counts as handled.
+const int QuietPeriodMs = 2000;
+const int StormTimeoutMs = 120000;
+
+qint64 processCpuTicks(qint64 pid)
+{
+    QFile file(QString("/proc/%1/stat").arg(pid));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+
+    // Fields after the parenthesised command name, starting from state.
+    QByteArray stat(file.readAll());
+    QList<QByteArray> fields(stat.mid(stat.lastIndexOf(')') + 2).split(' '));
+    if (fields.size() < 13) {
+        return -1;
+    }
+    return fields.at(11).toLongLong() + fields.at(12).toLongLong();
+}
+
+qint64 processPeakRss(qint64 pid)
+{
+    QFile file(QString("/proc/%1/status").arg(pid));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+
+    QByteArray line;
+    while (!(line = file.readLine()).isEmpty()) {
+        if (line.startsWith("VmHWM:")) {
+            return line.mid(6).trimmed().split(' ').first().toLongLong() * 1024;
+        }
+    }
+    return -1;
+}
+
+bool serviceRegistered(const QString &service)
+{
+    return QDBusConnection::sessionBus().interface()->isServiceRegistered(service);
+}
+
+qint64 percentile(QList<qint64> values, int percent)
+{
+    if (values.isEmpty()) {
+        return 0;
+    }
+    qSort(values);
+    return values.at((values.size() - 1) * percent / 100);
+}
+
+void addStorms()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("rate");
+    QTest::addColumn<int>("applications");
+    QTest::addColumn<int>("duplicates");
+    QTest::addColumn<int>("nonCrash");
+    QTest::addColumn<int>("maxSimilarCores");
+
+    QTest::newRow("100 at 10/s") << 100 << 10 << 20 << 0 << 0 << 5;
+    QTest::newRow("100 burst") << 100 << 0 << 20 << 0 << 0 << 5;
+    QTest::newRow("500 at 50/s, 50% duplicates") << 500 << 50 << 10 << 50 << 0 << 5;
+    QTest::newRow("500 burst, 50% duplicates") << 500 << 0 << 10 << 50 << 0 << 5;
+    QTest::newRow("200 at 20/s, 25% non-crash") << 200 << 20 << 10 << 25 << 25 << 5;
+}
+
+} // namespace
+
+void Bm_CrashStorm::initTestCase()
+{
+    uploader = 0;
+    daemon = 0;
+
+    coreDir = qgetenv("CREPORTER_STORM_DIR");
+    if (coreDir.isEmpty()) {
+        coreDir = "/var/cache/core-dumps";
+    }
+    daemonBinary = qgetenv("CREPORTER_DAEMON");
+    if (daemonBinary.isEmpty()) {
+        daemonBinary = CREPORTER_DAEMON_BINARY;
+    }
+    stormBinary = qgetenv("CREPORTER_CRASHSTORM");
+    if (stormBinary.isEmpty()) {
+        stormBinary = CREPORTER_CRASHSTORM_BINARY;
+    }
+
+    if (!QFileInfo(daemonBinary).isExecutable()) {
+        QSKIP("crash-reporter-daemon isn't installed.");
+    }
+    if (!QFileInfo(stormBinary).isExecutable()) {
+        QSKIP("crashstorm isn't installed.");
+    }
+    if (!QFileInfo(coreDir).isWritable()) {
+        QSKIP("The core-dumps directory isn't writable.");
+    }
+    if (serviceRegistered(CReporter::DaemonServiceName)) {
+        QSKIP("crash-reporter-daemon is already running.");
+    }
+    QVERIFY(home.isValid());
+
+    uploader = new FakeAutoUploader(this);
+    QDBusConnection bus(QDBusConnection::sessionBus());
+    QVERIFY(bus.registerObject(CReporter::AutoUploaderObjectPath, uploader,
+                               QDBusConnection::ExportScriptableSlots));
+    QVERIFY(bus.registerService(CReporter::AutoUploaderServiceName));
+
+    daemon = new QProcess(this);
+    daemon->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    daemon->setStandardOutputFile(QProcess::nullDevice());
+}
+
+void Bm_CrashStorm::storm_data()
+{
+    addStorms();
+}
+
+void Bm_CrashStorm::storm()
+{
+    QFETCH(int, count);
+    QFETCH(int, rate);
+    QFETCH(int, applications);
+    QFETCH(int, duplicates);
+    QFETCH(int, nonCrash);
+    QFETCH(int, maxSimilarCores);
+
+    removeReports();
+    uploader->reset();
+    QVERIFY(startDaemon(maxSimilarCores));
+    qint64 startTicks = processCpuTicks(daemon->processId());
+
+    QString manifest(home.path() + "/manifest");
+    QStringList arguments;
+    arguments << "--directory" << coreDir
+              << "--count" << QString::number(count)
+              << "--rate" << QString::number(rate)
+              << "--applications" << QString::number(applications)
+              << "--duplicates" << QString::number(duplicates)
+              << "--non-crash" << QString::number(nonCrash)
+              << "--manifest" << manifest;
+
+    QProcess generator;
+    generator.setProcessChannelMode(QProcess::ForwardedChannels);
+    generator.start(stormBinary, arguments);
+    QVERIFY(generator.waitForStarted());
+
+    qint64 stormStartUs = CReporterTrace::now();
+    QElapsedTimer timeout;
+    timeout.start();
+    while (generator.state() != QProcess::NotRunning) {
+        QTest::qWait(10);
+    }
+    QCOMPARE(generator.exitCode(), 0);
+
+    // Wait until the daemon stops calling the autouploader.
+    qint64 stormEndUs = CReporterTrace::now();
+    forever {
+        qint64 lastActivityUs = qMax(stormEndUs, uploader->lastCallUs);
+        if (CReporterTrace::now() - lastActivityUs > QuietPeriodMs * 1000) {
+            break;
+        }
+        QVERIFY2(timeout.elapsed() < StormTimeoutMs, "The daemon didn't settle.");
+        QTest::qWait(50);
+    }
+
+    Result result(analyze(manifest, maxSimilarCores));
+    result.drainMs = (qMax(stormEndUs, uploader->lastCallUs) - stormStartUs) / 1000;
+    result.cpuTicks = processCpuTicks(daemon->processId()) - startTicks;
+    result.peakRss = processPeakRss(daemon->processId());
+    result.uploaderCalls = uploader->calls;
+
+    stopDaemon();
+    removeReports();
+
+    results.insert(QTest::currentDataTag(), result);
+
+    qDebug("%d reports, latency p50 %.1f ms, p90 %.1f ms, max %.1f ms, "
+           "%lld CPU ticks, %lld kB peak RSS, %d duplicate errors, %d missed",
+           count, percentile(result.latenciesUs, 50) / 1000.0,
+           percentile(result.latenciesUs, 90) / 1000.0,
+           percentile(result.latenciesUs, 100) / 1000.0,
+           result.cpuTicks, result.peakRss / 1024,
+           result.duplicateErrors, result.missedReports);
+
+    QTest::setBenchmarkResult(result.drainMs, QTest::WalltimeMilliseconds);
+}
+
+void Bm_CrashStorm::detectionLatency_data()
+{
+    addStorms();
+}
+
+void Bm_CrashStorm::detectionLatency()
+{
+    const Result *result = currentResult();
+    if (!result) {
+        QSKIP("The storm didn't run.");
+    }
+    QTest::setBenchmarkResult(percentile(result->latenciesUs, 90) / 1000.0,
+                              QTest::WalltimeMilliseconds);
+}
+
+void Bm_CrashStorm::cpuTicks_data()
+{
+    addStorms();
+}
+
+void Bm_CrashStorm::cpuTicks()
+{
+    const Result *result = currentResult();
+    if (!result) {
+        QSKIP("The storm didn't run.");
+    }
+    QTest::setBenchmarkResult(result->cpuTicks, QTest::CPUTicks);
+}
+
+void Bm_CrashStorm::peakMemory_data()
+{
+    addStorms();
+}
+
+void Bm_CrashStorm::peakMemory()
+{
+    const Result *result = currentResult();
+    if (!result) {
+        QSKIP("The storm didn't run.");
+    }
+    QTest::setBenchmarkResult(result->peakRss, QTest::BytesAllocated);
+}
+
+void Bm_CrashStorm::duplicateErrors_data()
+{
+    addStorms();
+}
+
+void Bm_CrashStorm::duplicateErrors()
+{
+    const Result *result = currentResult();
+    if (!result) {
+        QSKIP("The storm didn't run.");
+    }
+    QTest::setBenchmarkResult(result->duplicateErrors, QTest::Events);
+}
+
+void Bm_CrashStorm::uploaderCalls_data()
+{
+    addStorms();
+}
+
+void Bm_CrashStorm::uploaderCalls()
+{
+    const Result *result = currentResult();
+    if (!result) {
+        QSKIP("The storm didn't run.");
+    }
+    QTest::setBenchmarkResult(result->uploaderCalls, QTest::Events);
+}
+
+void Bm_CrashStorm::missedReports_data()
+{
+    addStorms();
+}
+
+void Bm_CrashStorm::missedReports()
+{
+    const Result *result = currentResult();
+    if (!result) {
+        QSKIP("The storm didn't run.");
+    }
+    QTest::setBenchmarkResult(result->missedReports, QTest::Events);
+}
+
+void Bm_CrashStorm::cleanupTestCase()
+{
+    if (daemon) {
+        stopDaemon();
+    }
+    if (!coreDir.isEmpty()) {
+        removeReports();
+    }
+}
+
+bool Bm_CrashStorm::startDaemon(int maxSimilarCores)
+{
+    QString settingsDir(home.path() + "/.config/crash-reporter-settings");
+    QDir().mkpath(settingsDir);
+    QFile::remove(settingsDir + "/crash-reporter-privacy.conf");
+
+    QSettings privacy(settingsDir + "/crash-reporter-privacy.conf", QSettings::IniFormat);
+    privacy.setValue("Settings/coredumping", true);
+    privacy.setValue("Settings/notifications", false);
+    privacy.setValue("Settings/avoid-dups", true);
+    privacy.setValue("Settings/maxsimilarcores", maxSimilarCores);
+    privacy.setValue("Settings/automaticsending", true);
+    privacy.setValue("Settings/privacy-notice-accepted", true);
+    privacy.setValue("Settings/allow-mobile-data", true);
+    privacy.sync();
+
+    QProcessEnvironment environment(QProcessEnvironment::systemEnvironment());
+    environment.insert("HOME", home.path());
+    daemon->setProcessEnvironment(environment);
+    daemon->start(daemonBinary);
+    if (!daemon->waitForStarted()) {
+        return false;
+    }
+
+    QElapsedTimer timeout;
+    timeout.start();
+    while (!serviceRegistered(CReporter::DaemonServiceName)) {
+        if (timeout.elapsed() > 10000 || daemon->state() != QProcess::Running) {
+            return false;
+        }
+        QTest::qWait(50);
+    }
+    return true;
+}
+
+void Bm_CrashStorm::stopDaemon()
+{
+    if (daemon->state() == QProcess::NotRunning) {
+        return;
+    }
+    daemon->terminate();
+    if (!daemon->waitForFinished(5000)) {
+        daemon->kill();
+        daemon->waitForFinished();
+    }
+}
+
+void Bm_CrashStorm::removeReports()
+{
+    // Only reports written by crashstorm carry its hwid.
+    QDir dir(coreDir);
+    foreach (const QString &name, dir.entryList(QStringList() << "*-0123456789abcdef-*",
+                                                QDir::Files | QDir::Hidden)) {
+        dir.remove(name);
+    }
+}
+
+Bm_CrashStorm::Result Bm_CrashStorm::analyze(const QString &manifestPath, int maxSimilarCores)
+{
+    Result result;
+    result.duplicateErrors = 0;
+    result.missedReports = 0;
+
+    QFile file(manifestPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning("Can't read the manifest.");
+        return result;
+    }
+
+    QHash<QString, int> similar;
+    QTextStream manifest(&file);
+    while (!manifest.atEnd()) {
+        QStringList fields(manifest.readLine().split(' '));
+        if (fields.size() != 3) {
+            continue;
+        }
+        qint64 writtenUs = fields.at(0).toLongLong();
+        const QString &path = fields.at(2);
+
+        /* The daemon keeps maxSimilarCores reports with the same application
+         * and signal. Reports without a crash are never duplicates. */
+        CReporterCrashInfo info(path);
+        bool kept = true;
+        if (info.includesCrash()) {
+            QString key(info.applicationName().toString() + '-'
+                        + QString::number(info.signal()));
+            kept = ++similar[key] <= maxSimilarCores;
+        }
+        if (QFile::exists(path) != kept) {
+            ++result.duplicateErrors;
+        }
+
+        if (!kept) {
+            continue;
+        }
+        QHash<QString, CReporterTrace>::const_iterator trace(uploader->traces.constFind(path));
+        if (trace == uploader->traces.constEnd()) {
+            ++result.missedReports;
+            continue;
+        }
+        result.latenciesUs << trace->timestamp(CReporterTrace::UploaderNotified) - writtenUs;
+    }
+    return result;
+}
+
+const Bm_CrashStorm::Result *Bm_CrashStorm::currentResult()
+{
+    QHash<QString, Result>::const_iterator result(results.constFind(QTest::currentDataTag()));
+    return result != results.constEnd() ? &*result : 0;
+}
+
+QTEST_MAIN(Bm_CrashStorm)
@@ -0,0 +1,107 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef BM_CRASHSTORM_H
+#define BM_CRASHSTORM_H
+
+#include <QHash>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "fakeautouploader.h"
+
+class QProcess;
+
+/*!
+ * Drives the installed crash-reporter-daemon with crash storms written by
+ * the crashstorm tool and measures how it copes.
+ *
+ * The daemon watches its usual core-dumps directory, so the running
+ * crash-reporter service must be stopped first. It runs with a temporary
+ * HOME holding privacy settings that enable automatic sending and duplicate
+ * deletion. Generated reports are removed afterwards.
+ *
+ * storm() runs each storm and reports the time until the daemon goes quiet.
+ * The following functions report further results of the same rows:
+ * detection latency (90th percentile from a report appearing to the
+ * autouploader being called), CPU ticks and peak RSS of the daemon, reports
+ * kept or deleted contrary to the duplicate limit, autouploader calls and
+ * reports the autouploader was never told about.
+ */
+class Bm_CrashStorm : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void storm_data();
+    void storm();
+
+    void detectionLatency_data();
+    void detectionLatency();
+
+    void cpuTicks_data();
+    void cpuTicks();
+
+    void peakMemory_data();
+    void peakMemory();
+
+    void duplicateErrors_data();
+    void duplicateErrors();
+
+    void uploaderCalls_data();
+    void uploaderCalls();
+
+    void missedReports_data();
+    void missedReports();
+
+    void cleanupTestCase();
+
+private:
+    struct Result {
+        qint64 drainMs;
+        QList<qint64> latenciesUs;
+        qint64 cpuTicks;
+        qint64 peakRss;
+        int duplicateErrors;
+        int uploaderCalls;
+        int missedReports;
+    };
+
+    bool startDaemon(int maxSimilarCores);
+    void stopDaemon();
+    void removeReports();
+    Result analyze(const QString &manifestPath, int maxSimilarCores);
+    const Result *currentResult();
+
+    QString coreDir;
+    QString daemonBinary;
+    QString stormBinary;
+    QTemporaryDir home;
+    FakeAutoUploader *uploader;
+    QProcess *daemon;
+    QHash<QString, Result> results;
+};
+
+#endif // BM_CRASHSTORM_H
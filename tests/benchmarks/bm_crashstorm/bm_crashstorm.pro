@@ -0,0 +1,24 @@
+include(../bm_common_top.pri)
+
+TARGET = bm_crashstorm
+
+# Talks to the installed daemon under the real D-Bus names.
+DEFINES -= CREPORTER_UNIT_TEST
+DEFINES += CREPORTER_DAEMON_BINARY=\\\"$$CREPORTER_SYSTEM_BIN/crash-reporter-daemon\\\" \
+           CREPORTER_CRASHSTORM_BINARY=\\\"$$CREPORTER_TESTS_TESTDATA_INSTALL_LIBS/crashstorm\\\"
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+HEADERS += \
+	bm_crashstorm.h \
+	fakeautouploader.h \
+
+SOURCES += \
+	bm_crashstorm.cpp \
+	fakeautouploader.cpp \
@@ -0,0 +1,64 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include "fakeautouploader.h"
+
+FakeAutoUploader::FakeAutoUploader(QObject *parent)
+    : QObject(parent), calls(0), lastCallUs(0)
+{
+}
+
+void FakeAutoUploader::reset()
+{
+    calls = 0;
+    traces.clear();
+    lastCallUs = 0;
+}
+
+bool FakeAutoUploader::uploadFiles(const QStringList &fileList, bool obeyNetworkRestrictions)
+{
+    return uploadFilesWithTraces(fileList, QStringList(), obeyNetworkRestrictions);
+}
+
+bool FakeAutoUploader::uploadFilesWithTraces(const QStringList &fileList,
+                                             const QStringList &traceList,
+                                             bool obeyNetworkRestrictions)
+{
+    Q_UNUSED(obeyNetworkRestrictions)
+
+    ++calls;
+    lastCallUs = CReporterTrace::now();
+    for (int i = 0; i != fileList.size(); ++i) {
+        CReporterTrace trace;
+        if (i < traceList.size()) {
+            trace = CReporterTrace::fromString(traceList.at(i));
+        }
+        // Older daemons don't pass traces, take the time of the call.
+        trace.mark(CReporterTrace::UploaderNotified);
+        traces.insert(fileList.at(i), trace);
+    }
+    return true;
+}
+
+void FakeAutoUploader::quit()
+{
+}
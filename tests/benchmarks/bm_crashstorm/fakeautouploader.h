@@ -0,0 +1,60 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef FAKEAUTOUPLOADER_H
+#define FAKEAUTOUPLOADER_H
+
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+
+#include "creportertrace.h"
+
+/*!
+ * Stands in for crash-reporter-autouploader on the session bus and records
+ * the upload requests of the daemon.
+ */
+class FakeAutoUploader : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.nokia.CrashReporter.AutoUploader")
+
+public:
+    FakeAutoUploader(QObject *parent = 0);
+
+    void reset();
+
+    int calls;
+    //! Trace of every report the daemon passed one for.
+    QHash<QString, CReporterTrace> traces;
+    //! CLOCK_BOOTTIME of the last call in microseconds.
+    qint64 lastCallUs;
+
+public Q_SLOTS:
+    Q_SCRIPTABLE bool uploadFiles(const QStringList &fileList, bool obeyNetworkRestrictions);
+    Q_SCRIPTABLE bool uploadFilesWithTraces(const QStringList &fileList,
+                                            const QStringList &traces,
+                                            bool obeyNetworkRestrictions);
+    Q_SCRIPTABLE void quit();
+};
+
+#endif // FAKEAUTOUPLOADER_H
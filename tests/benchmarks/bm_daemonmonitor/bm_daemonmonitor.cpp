@@ -0,0 +1,97 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include "bm_daemonmonitor.h"
+#include "creporterdaemonmonitor.h"
+#include "creporterdaemonmonitor_p.h"
+#include "creportertestutils.h"
+
+static QString reportPath(int application, int pid)
+{
+    return QString("/var/cache/core-dumps/application%1-0123456789abcdef-11-%2.rcore.lzo")
+           .arg(application).arg(pid);
+}
+
+void Bm_DaemonMonitor::init()
+{
+    monitor = new CReporterDaemonMonitor(this);
+    // High enough for nothing to be reported as duplicate.
+    monitor->setAutoDeleteMaxSimilarCores(1000000);
+}
+
+void Bm_DaemonMonitor::handleCrashes(int applications)
+{
+    for (int i = 0; i < applications; ++i) {
+        monitor->d_ptr->checkForDuplicates(reportPath(i, 1000 + i));
+    }
+}
+
+void Bm_DaemonMonitor::checkForDuplicates_data()
+{
+    QTest::addColumn<int>("applications");
+
+    QTest::newRow("10") << 10;
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+}
+
+void Bm_DaemonMonitor::checkForDuplicates()
+{
+    QFETCH(int, applications);
+
+    handleCrashes(applications);
+
+    // The last handled application, the whole list is compared.
+    int pid = 0;
+    QBENCHMARK {
+        monitor->d_ptr->checkForDuplicates(reportPath(applications - 1, ++pid));
+    }
+
+    QVERIFY(monitor->duplicateCount("application" + QString::number(applications - 1), 11) > 1);
+}
+
+void Bm_DaemonMonitor::checkForDuplicatesMemory_data()
+{
+    checkForDuplicates_data();
+}
+
+void Bm_DaemonMonitor::checkForDuplicatesMemory()
+{
+    QFETCH(int, applications);
+
+    qint64 baseline = CReporterTestUtils::currentMemory();
+    CReporterTestUtils::resetPeakMemory();
+
+    handleCrashes(applications);
+
+    QTest::setBenchmarkResult(CReporterTestUtils::peakMemory() - baseline,
+                              QTest::BytesAllocated);
+    QCOMPARE(monitor->d_ptr->handledRichCores.size(), applications);
+}
+
+void Bm_DaemonMonitor::cleanup()
+{
+    delete monitor;
+    monitor = 0;
+}
+
+QTEST_MAIN(Bm_DaemonMonitor)
@@ -0,0 +1,55 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef BM_DAEMONMONITOR_H
+#define BM_DAEMONMONITOR_H
+
+#include <QTest>
+
+class CReporterDaemonMonitor;
+
+/*!
+ * Measures duplicate checking of new crash reports against the crashes the
+ * daemon has already handled.
+ */
+class Bm_DaemonMonitor : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+
+    void checkForDuplicates_data();
+    void checkForDuplicates();
+
+    void checkForDuplicatesMemory_data();
+    void checkForDuplicatesMemory();
+
+    void cleanup();
+
+private:
+    void handleCrashes(int applications);
+
+    CReporterDaemonMonitor *monitor;
+};
+
+#endif // BM_DAEMONMONITOR_H
@@ -0,0 +1,31 @@
+include(../bm_common_top.pri)
+
+DAEMON_SRC_DIR = $${CREPORTER_SRC_DIR}/daemon
+
+TARGET = bm_daemonmonitor
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               $${DAEMON_SRC_DIR} \
+               $$CREPORTER_SRC_DIR/libs/coredir \
+               $$CREPORTER_SRC_DIR/libs/httpclient \
+               $$CREPORTER_SRC_DIR/libs/serviceif \
+               $$CREPORTER_SRC_DIR/libs/settings \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+CONFIG += link_pkgconfig
+PKGCONFIG += nemonotifications-qt5
+
+HEADERS += \
+	$${DAEMON_SRC_DIR}/creporterdaemonmonitor.h \
+	$${DAEMON_SRC_DIR}/creporterdaemonmonitor_p.h \
+	$${DAEMON_SRC_DIR}/creporterdaemonsnapshot.h \
+	bm_daemonmonitor.h \
+
+SOURCES += \
+	$${DAEMON_SRC_DIR}/creporterdaemonmonitor.cpp \
+	bm_daemonmonitor.cpp \
@@ -0,0 +1,145 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QDir>
+#include <QFile>
+
+#include "bm_daemonstartup.h"
+#include "creportercoreregistry.h"
+#include "creporterdaemonsnapshot.h"
+#include "creporterreportindex.h"
+#include "creportertestutils.h"
+
+void Bm_DaemonStartup::initTestCase()
+{
+    CReporterTestUtils::createTestMountpoints();
+
+    // Creates the core-dumps directory under the test mount point.
+    coreDir = CReporterCoreRegistry::instance()->getCoreLocationPaths().value(0);
+    if (coreDir.isEmpty()) {
+        coreDir = QDir::homePath() + "/crash-reporter-tests/home/user/MyDocs/core-dumps";
+        QVERIFY(QDir().mkpath(coreDir));
+    }
+    snapshotPath = QDir::homePath() + "/crash-reporter-tests/daemon-snapshot";
+    createdCount = 0;
+}
+
+void Bm_DaemonStartup::createReports(int count)
+{
+    // Reports are only added, rows with more files reuse the earlier ones.
+    for (; createdCount < count; ++createdCount) {
+        QFile file(QString("%1/application%2-0123456789abcdef-11-%3.rcore.lzo")
+                   .arg(coreDir).arg(createdCount % 50).arg(1000 + createdCount));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+    CReporterCoreRegistry::instance()->refreshRegistry();
+
+    // Snapshots aren't trusted for directories modified in the last second.
+    QVERIFY(CReporterTestUtils::setFileAge(coreDir, 60));
+}
+
+void Bm_DaemonStartup::scanIndex_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+}
+
+void Bm_DaemonStartup::scanIndex()
+{
+    QFETCH(int, count);
+
+    createReports(count);
+
+    int indexed = 0;
+    QBENCHMARK {
+        CReporterReportIndex index;
+        indexed = index.reports().size();
+    }
+
+    QCOMPARE(indexed, count);
+}
+
+void Bm_DaemonStartup::restoreIndex_data()
+{
+    scanIndex_data();
+}
+
+void Bm_DaemonStartup::restoreIndex()
+{
+    QFETCH(int, count);
+
+    createReports(count);
+
+    QStringList corePaths(CReporterCoreRegistry::instance()->getCoreLocationPaths());
+    {
+        CReporterReportIndex index;
+        CReporterDaemonSnapshot snapshot;
+        snapshot.setDirectories(corePaths);
+        snapshot.setRecords(index.records());
+        QVERIFY(snapshot.save(snapshotPath));
+    }
+
+    int indexed = 0;
+    QBENCHMARK {
+        CReporterDaemonSnapshot snapshot;
+        QVERIFY(snapshot.load(snapshotPath));
+        QVERIFY(snapshot.isCurrent(corePaths));
+        CReporterReportIndex index(snapshot.records());
+        indexed = index.reports().size();
+    }
+
+    QCOMPARE(indexed, count);
+}
+
+void Bm_DaemonStartup::saveSnapshot_data()
+{
+    scanIndex_data();
+}
+
+void Bm_DaemonStartup::saveSnapshot()
+{
+    QFETCH(int, count);
+
+    createReports(count);
+
+    // What the daemon does on exit, refreshing the index included.
+    QStringList corePaths(CReporterCoreRegistry::instance()->getCoreLocationPaths());
+    CReporterReportIndex index;
+    QBENCHMARK {
+        CReporterDaemonSnapshot snapshot;
+        snapshot.setDirectories(corePaths);
+        index.refresh();
+        snapshot.setRecords(index.records());
+        QVERIFY(snapshot.save(snapshotPath));
+    }
+}
+
+void Bm_DaemonStartup::cleanupTestCase()
+{
+    QFile::remove(snapshotPath);
+    CReporterTestUtils::removeTestMountpoints();
+}
+
+QTEST_MAIN(Bm_DaemonStartup)
@@ -0,0 +1,59 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef BM_DAEMONSTARTUP_H
+#define BM_DAEMONSTARTUP_H
+
+#include <QTest>
+
+/*!
+ * Measures how long the daemon takes to build its report index at startup
+ * with 100, 1000 and 10000 reports, scanning the core-dumps directories as
+ * on the first start versus restoring the snapshot saved by the previous run.
+ */
+class Bm_DaemonStartup : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void scanIndex_data();
+    void scanIndex();
+
+    void restoreIndex_data();
+    void restoreIndex();
+
+    void saveSnapshot_data();
+    void saveSnapshot();
+
+    void cleanupTestCase();
+
+private:
+    void createReports(int count);
+
+    QString coreDir;
+    QString snapshotPath;
+    int createdCount;
+};
+
+#endif // BM_DAEMONSTARTUP_H
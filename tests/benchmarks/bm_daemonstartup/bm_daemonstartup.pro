@@ -0,0 +1,33 @@
+include(../bm_common_top.pri)
+
+DAEMON_SRC_DIR = $${CREPORTER_SRC_DIR}/daemon
+
+TARGET = bm_daemonstartup
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               $${DAEMON_SRC_DIR} \
+               $$CREPORTER_SRC_DIR/libs/coredir \
+               $$CREPORTER_SRC_DIR/libs/serviceif \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+# Compiled in for the test mount points.
+HEADERS += \
+	$${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.h \
+	$${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir_p.h \
+	$${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.h \
+	$${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry_p.h \
+	$${DAEMON_SRC_DIR}/creporterdaemonsnapshot.h \
+	$${DAEMON_SRC_DIR}/creporterreportindex.h \
+	bm_daemonstartup.h \
+
+SOURCES += \
+	$${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.cpp \
+	$${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.cpp \
+	$${DAEMON_SRC_DIR}/creporterdaemonsnapshot.cpp \
+	$${DAEMON_SRC_DIR}/creporterreportindex.cpp \
+	bm_daemonstartup.cpp \
@@ -0,0 +1,168 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <unistd.h>
+
+#include <QByteArray>
+#include <QFile>
+#include <QVector>
+
+#include "bm_debuginfocache.h"
+
+extern "C" {
+#include "debuginfocache.h"
+}
+
+namespace {
+
+const int FileCount = 3000;
+const int FileSize = 4096;
+const int BuildIdSize = 20;
+
+QByteArray buildId(int i)
+{
+    QByteArray id(BuildIdSize, '\0');
+    for (int b = 0; b != BuildIdSize; ++b) {
+        id[b] = char((i * 2654435761u) >> (b % 4 * 8)) ^ char(b);
+    }
+    return id;
+}
+
+const unsigned char *bytes(const QByteArray &data)
+{
+    return reinterpret_cast<const unsigned char *>(data.constData());
+}
+
+//! Adds files with the build-ids of first..first + count - 1 to the cache.
+int addFiles(const QString &cacheDir, const QString &sourcePath, int first, int count,
+             uint64_t maxSize)
+{
+    QVector<QByteArray> ids;
+    QVector<debuginfo_file> files;
+    QByteArray path(QFile::encodeName(sourcePath));
+    for (int i = first; i != first + count; ++i) {
+        ids.append(buildId(i));
+    }
+    for (int i = 0; i != count; ++i) {
+        debuginfo_file file = { bytes(ids.at(i)), size_t(ids.at(i).size()), path.constData() };
+        files.append(file);
+    }
+
+    struct debuginfo_cache cache;
+    if (debuginfo_cache_open(&cache, QFile::encodeName(cacheDir).constData(), 1) != 0) {
+        return -1;
+    }
+    int result = debuginfo_cache_add(&cache, files.constData(), files.size(), maxSize);
+    debuginfo_cache_close(&cache);
+    return result;
+}
+
+bool contains(struct debuginfo_cache *cache, int i)
+{
+    QByteArray id(buildId(i));
+    int fd = debuginfo_cache_lookup(cache, bytes(id), id.size(), NULL);
+    if (fd == -1) {
+        return false;
+    }
+    close(fd);
+    return true;
+}
+
+} // namespace
+
+void Bm_DebuginfoCache::initTestCase()
+{
+    QVERIFY(dir.isValid());
+
+    sourcePath = dir.path() + "/source.debug";
+    QFile source(sourcePath);
+    QVERIFY(source.open(QIODevice::WriteOnly));
+    QCOMPARE(source.write(QByteArray(FileSize, 'x')), qint64(FileSize));
+    source.close();
+
+    QCOMPARE(addFiles(dir.path() + "/cache", sourcePath, 0, FileCount, 0), FileCount);
+}
+
+void Bm_DebuginfoCache::open()
+{
+    QByteArray cacheDir(QFile::encodeName(dir.path() + "/cache"));
+    size_t count = 0;
+
+    QBENCHMARK {
+        struct debuginfo_cache cache;
+        QCOMPARE(debuginfo_cache_open(&cache, cacheDir.constData(), 1), 0);
+        count = debuginfo_cache_count(&cache);
+        debuginfo_cache_close(&cache);
+    }
+
+    QCOMPARE(count, size_t(FileCount));
+}
+
+void Bm_DebuginfoCache::lookup()
+{
+    struct debuginfo_cache cache;
+    QCOMPARE(debuginfo_cache_open(&cache, QFile::encodeName(dir.path() + "/cache").constData(),
+                                  1), 0);
+
+    int i = 0;
+    int found = 0;
+    QBENCHMARK {
+        // Every other lookup misses.
+        found += contains(&cache, i % (2 * FileCount));
+        ++i;
+    }
+    debuginfo_cache_close(&cache);
+
+    QVERIFY(found > 0);
+}
+
+void Bm_DebuginfoCache::eviction()
+{
+    QString cacheDir(dir.path() + "/eviction");
+    const uint64_t maxSize = 10 * FileSize;
+
+    QCOMPARE(addFiles(cacheDir, sourcePath, 0, 10, maxSize), 10);
+    QTest::qWait(10);
+
+    struct debuginfo_cache cache;
+    QCOMPARE(debuginfo_cache_open(&cache, QFile::encodeName(cacheDir).constData(), 1), 0);
+    for (int i = 0; i != 3; ++i) {
+        QVERIFY(contains(&cache, i));
+    }
+    debuginfo_cache_close(&cache);
+
+    // Files used or added last stay, the size limit is remembered.
+    QCOMPARE(addFiles(cacheDir, sourcePath, 10, 3, 0), 3);
+
+    QCOMPARE(debuginfo_cache_open(&cache, QFile::encodeName(cacheDir).constData(), 0), 0);
+    QCOMPARE(debuginfo_cache_count(&cache), size_t(10));
+    QCOMPARE(debuginfo_cache_total_size(&cache), maxSize);
+    for (int i = 0; i != 3; ++i) {
+        QVERIFY(contains(&cache, i));
+    }
+    for (int i = 10; i != 13; ++i) {
+        QVERIFY(contains(&cache, i));
+    }
+    debuginfo_cache_close(&cache);
+}
+
+QTEST_MAIN(Bm_DebuginfoCache)
@@ -0,0 +1,50 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2014 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef BM_DEBUGINFOCACHE_H
+#define BM_DEBUGINFOCACHE_H
+
+#include <QTemporaryDir>
+#include <QTest>
+
+/*!
+ * Measures opening the debuginfo cache and looking up files in it, with
+ * as many files as debuginfo of a whole device has, and checks the order
+ * of eviction.
+ */
+class Bm_DebuginfoCache : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void open();
+    void lookup();
+    void eviction();
+
+private:
+    QTemporaryDir dir;
+    QString sourcePath;
+};
+
+#endif // BM_DEBUGINFOCACHE_H
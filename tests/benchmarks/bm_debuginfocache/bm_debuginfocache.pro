@@ -0,0 +1,16 @@
+include(../bm_common_top.pri)
+
+TARGET = bm_debuginfocache
+
+INCLUDEPATH += . \
+               $$CREPORTER_SRC_DIR/common \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+HEADERS += \
+	$${CREPORTER_SRC_DIR}/common/debuginfocache.h \
+	bm_debuginfocache.h \
+
+SOURCES += \
+	$${CREPORTER_SRC_DIR}/common/debuginfocache.c \
+	bm_debuginfocache.cpp \
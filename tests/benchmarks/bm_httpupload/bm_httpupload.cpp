@@ -0,0 +1,157 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSignalSpy>
+
+#include "bm_httpupload.h"
+#include "creporterhttpclient.h"
+#include "creporteringestserver.h"
+#include "creportertestutils.h"
+#include "creporteruploadendpoint.h"
+
+static const int UploadTimeoutMs = 60 * 1000;
+
+void Bm_HttpUpload::initTestCase()
+{
+    QVERIFY(reportDir.isValid());
+
+    server = new CReporterIngestServer(this);
+    QVERIFY(server->start());
+}
+
+QString Bm_HttpUpload::createReport(int size)
+{
+    QString path(QString("%1/application-0123456789abcdef-11-%2.rcore.lzo")
+                 .arg(reportDir.path()).arg(size));
+
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly)) {
+        QByteArray chunk(64 * 1024, 'x');
+        for (int written = 0; written < size; written += chunk.size()) {
+            file.write(chunk.constData(), qMin(chunk.size(), size - written));
+        }
+    }
+    return path;
+}
+
+bool Bm_HttpUpload::uploadAndWait(CReporterHttpClient *client, const QString &file)
+{
+    QSignalSpy errorSpy(client, SIGNAL(uploadError(QString, QString)));
+    QSignalSpy finishedSpy(client, SIGNAL(finished()));
+
+    if (!client->upload(file)) {
+        return false;
+    }
+
+    if (finishedSpy.isEmpty() && !finishedSpy.wait(UploadTimeoutMs)) {
+        return false;
+    }
+
+    return errorSpy.isEmpty();
+}
+
+void Bm_HttpUpload::upload_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<int>("bytesPerSecond");
+    QTest::addColumn<int>("latencyMs");
+
+    QTest::newRow("64 KiB") << 64 * 1024 << 0 << 0;
+    QTest::newRow("1 MiB") << 1024 * 1024 << 0 << 0;
+    QTest::newRow("16 MiB") << 16 * 1024 * 1024 << 0 << 0;
+    QTest::newRow("1 MiB, 1 MiB/s") << 1024 * 1024 << 1024 * 1024 << 0;
+    QTest::newRow("1 MiB, 500 ms reply") << 1024 * 1024 << 0 << 500;
+}
+
+void Bm_HttpUpload::upload()
+{
+    QFETCH(int, size);
+    QFETCH(int, bytesPerSecond);
+    QFETCH(int, latencyMs);
+
+    QString file(createReport(size));
+
+    CReporterIngestServer::Behavior behavior;
+    behavior.bytesPerSecond = bytesPerSecond;
+    behavior.latencyMs = latencyMs;
+    server->setDefaultBehavior(behavior);
+
+    CReporterHttpClient client;
+    client.initSession(CReporterUploadEndpoint(server->serverUrl(), server->serverPort(),
+                                               server->serverPath(), false, QString(), QString()),
+                       false);
+
+    qint64 receivedBefore = server->bytesReceived();
+    int uploads = 0;
+    QElapsedTimer timer;
+    timer.start();
+
+    QBENCHMARK {
+        QVERIFY(uploadAndWait(&client, file));
+        ++uploads;
+    }
+
+    qint64 elapsedMs = qMax<qint64>(timer.elapsed(), 1);
+    QCOMPARE(server->bytesReceived() - receivedBefore, qint64(size) * uploads);
+    qDebug() << "Throughput:" << qint64(size) * uploads * 1000 / elapsedMs / 1024 << "KiB/s";
+}
+
+void Bm_HttpUpload::uploadMemory_data()
+{
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("64 KiB") << 64 * 1024;
+    QTest::newRow("1 MiB") << 1024 * 1024;
+    QTest::newRow("16 MiB") << 16 * 1024 * 1024;
+}
+
+void Bm_HttpUpload::uploadMemory()
+{
+    QFETCH(int, size);
+
+    QString file(createReport(size));
+
+    server->setDefaultBehavior(CReporterIngestServer::Behavior());
+
+    CReporterHttpClient client;
+    client.initSession(CReporterUploadEndpoint(server->serverUrl(), server->serverPort(),
+                                               server->serverPath(), false, QString(), QString()),
+                       false);
+
+    qint64 baseline = CReporterTestUtils::currentMemory();
+    CReporterTestUtils::resetPeakMemory();
+
+    QVERIFY(uploadAndWait(&client, file));
+
+    QTest::setBenchmarkResult(CReporterTestUtils::peakMemory() - baseline,
+                              QTest::BytesAllocated);
+}
+
+void Bm_HttpUpload::cleanupTestCase()
+{
+    server->close();
+}
+
+QTEST_MAIN(Bm_HttpUpload)
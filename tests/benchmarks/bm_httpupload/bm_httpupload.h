@@ -0,0 +1,59 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef BM_HTTPUPLOAD_H
+#define BM_HTTPUPLOAD_H
+
+#include <QTemporaryDir>
+#include <QTest>
+
+class CReporterHttpClient;
+class CReporterIngestServer;
+
+/*!
+ * Measures uploading reports of different sizes with CReporterHttpClient
+ * to a loopback server, also over a throttled and a slow to reply link.
+ */
+class Bm_HttpUpload : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void upload_data();
+    void upload();
+
+    void uploadMemory_data();
+    void uploadMemory();
+
+    void cleanupTestCase();
+
+private:
+    QString createReport(int size);
+    bool uploadAndWait(CReporterHttpClient *client, const QString &file);
+
+    CReporterIngestServer *server;
+    QTemporaryDir reportDir;
+};
+
+#endif // BM_HTTPUPLOAD_H
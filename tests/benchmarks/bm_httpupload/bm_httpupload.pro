@@ -0,0 +1,20 @@
+include(../bm_common_top.pri)
+include(../../qtest/testlib/ingestserver.pri)
+
+TARGET = bm_httpupload
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               $$CREPORTER_SRC_DIR/libs/httpclient \
+               $$CREPORTER_SRC_DIR/libs/settings \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+HEADERS += \
+	bm_httpupload.h \
+
+SOURCES += \
+	bm_httpupload.cpp \
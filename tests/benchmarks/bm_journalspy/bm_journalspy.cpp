@@ -0,0 +1,200 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QBuffer>
+#include <QDebug>
+#include <QFile>
+#include <QtEndian>
+
+#include "bm_journalspy.h"
+#include "journalspyexpression.h"
+
+static const int SyntheticEntries = 10000;
+
+static const char DefaultExpressions[] =
+    ";wlan\n"
+    "SYSLOG_IDENTIFIER=kernel\n"
+    "MESSAGE=wlan:\n"
+    ";request-suspend\n"
+    "MESSAGE=request_suspend_state: sleep \\(\\d->\\d\\)\n"
+    ";jolla-settings-model\n"
+    "_COMM=jolla-settings\n"
+    "MESSAGE=\\[D\\] SettingsModel::SettingsModel.* Created SettingsModel instance\n"
+    "CODE_FUNC=SettingsModel::SettingsModel\\(QObject\\*\\)\n";
+
+namespace {
+
+class ReplayedEntry : public JournalSpyExpression::Entry
+{
+public:
+    ReplayedEntry(const QHash<QByteArray, QByteArray> &fields)
+        : fields(fields)
+    {
+    }
+
+    bool field(const QByteArray &name, const char **value, size_t *length) const
+    {
+        QHash<QByteArray, QByteArray>::const_iterator it = fields.constFind(name);
+        if (it == fields.constEnd()) {
+            return false;
+        }
+        *value = it.value().constData();
+        *length = it.value().size();
+        return true;
+    }
+
+private:
+    const QHash<QByteArray, QByteArray> &fields;
+};
+
+QByteArray syntheticExport()
+{
+    static const char *comms[] = { "kernel", "lipstick", "jolla-settings", "ofonod", "mce" };
+
+    QByteArray data;
+    for (int i = 0; i < SyntheticEntries; ++i) {
+        const char *comm = comms[i % 5];
+        data += "__REALTIME_TIMESTAMP=" + QByteArray::number(1400000000000000LL + i) + '\n';
+        data += "PRIORITY=6\n";
+        data += QByteArray("_COMM=") + comm + '\n';
+        data += QByteArray("SYSLOG_IDENTIFIER=") + comm + '\n';
+        if (i % 100 == 0) {
+            data += "MESSAGE=wlan: connection lost, reason " + QByteArray::number(i) + '\n';
+        } else {
+            data += "MESSAGE=Some ordinary log message number " + QByteArray::number(i) + '\n';
+        }
+        data += "\n";
+    }
+    return data;
+}
+
+} // namespace
+
+QList<Bm_JournalSpy::JournalEntry> Bm_JournalSpy::readExport(const QByteArray &data)
+{
+    QList<JournalEntry> result;
+    JournalEntry entry;
+
+    int pos = 0;
+    while (pos < data.size()) {
+        int end = data.indexOf('\n', pos);
+        if (end == -1) {
+            end = data.size();
+        }
+
+        if (end == pos) {
+            // Empty line ends the entry.
+            if (!entry.isEmpty()) {
+                result << entry;
+                entry.clear();
+            }
+            pos = end + 1;
+            continue;
+        }
+
+        int separator = data.indexOf('=', pos);
+        if (separator != -1 && separator < end) {
+            entry.insert(data.mid(pos, separator - pos),
+                         data.mid(separator + 1, end - separator - 1));
+            pos = end + 1;
+        } else {
+            // Binary field: name, little endian 64-bit size, data, newline.
+            QByteArray name(data.mid(pos, end - pos));
+            pos = end + 1;
+            if (pos + 8 > data.size()) {
+                break;
+            }
+            quint64 size = qFromLittleEndian<quint64>(
+                               reinterpret_cast<const uchar *>(data.constData() + pos));
+            pos += 8;
+            entry.insert(name, data.mid(pos, size));
+            pos += size + 1;
+        }
+    }
+
+    if (!entry.isEmpty()) {
+        result << entry;
+    }
+    return result;
+}
+
+void Bm_JournalSpy::initTestCase()
+{
+    QByteArray exportPath(qgetenv("CREPORTER_JOURNAL_EXPORT"));
+    if (exportPath.isEmpty()) {
+        exportData = syntheticExport();
+    } else {
+        QFile file(QString::fromLocal8Bit(exportPath));
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        exportData = file.readAll();
+    }
+
+    entries = readExport(exportData);
+    QVERIFY(!entries.isEmpty());
+}
+
+void Bm_JournalSpy::parseExport()
+{
+    int count = 0;
+    QBENCHMARK {
+        count = readExport(exportData).size();
+    }
+
+    QCOMPARE(count, entries.size());
+}
+
+void Bm_JournalSpy::match()
+{
+    QList<JournalSpyExpression> expressions;
+
+    QByteArray expressionsPath(qgetenv("CREPORTER_JOURNALSPY_EXPRESSIONS"));
+    if (expressionsPath.isEmpty()) {
+        QByteArray config(DefaultExpressions);
+        QBuffer buffer(&config);
+        buffer.open(QIODevice::ReadOnly);
+        expressions = JournalSpyExpression::parse(buffer);
+    } else {
+        QFile file(QString::fromLocal8Bit(expressionsPath));
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        expressions = JournalSpyExpression::parse(file);
+    }
+    QVERIFY(!expressions.isEmpty());
+
+    // Same loop as JournalSpyPrivate::handleJournalEntries().
+    int matches = 0;
+    QBENCHMARK {
+        matches = 0;
+        foreach (const JournalEntry &fields, entries) {
+            ReplayedEntry entry(fields);
+            foreach (const JournalSpyExpression &expression, expressions) {
+                if (expression.matches(entry)) {
+                    ++matches;
+                    break;
+                }
+            }
+        }
+    }
+
+    qDebug() << entries.size() << "entries," << matches << "matches";
+}
+
+QTEST_MAIN(Bm_JournalSpy)
@@ -0,0 +1,57 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef BM_JOURNALSPY_H
+#define BM_JOURNALSPY_H
+
+#include <QHash>
+#include <QList>
+#include <QTest>
+
+/*!
+ * Measures matching of JournalSpy expressions against journal entries.
+ *
+ * The entries are replayed from a journal export, 'journalctl -o export',
+ * given in CREPORTER_JOURNAL_EXPORT. Without it a synthetic journal is used.
+ * Expressions are read from CREPORTER_JOURNALSPY_EXPRESSIONS, or built-in
+ * ones resembling the examples in journalspy-expressions.conf are used.
+ */
+class Bm_JournalSpy : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void parseExport();
+    void match();
+
+private:
+    typedef QHash<QByteArray, QByteArray> JournalEntry;
+
+    static QList<JournalEntry> readExport(const QByteArray &data);
+
+    QByteArray exportData;
+    QList<JournalEntry> entries;
+};
+
+#endif // BM_JOURNALSPY_H
@@ -0,0 +1,22 @@
+include(../bm_common_top.pri)
+
+JOURNALSPY_SRC_DIR = $${CREPORTER_SRC_DIR}/collector/journalspy
+
+TARGET = bm_journalspy
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               $${JOURNALSPY_SRC_DIR} \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+HEADERS += \
+	$${JOURNALSPY_SRC_DIR}/journalspyexpression.h \
+	bm_journalspy.h \
+
+SOURCES += \
+	$${JOURNALSPY_SRC_DIR}/journalspyexpression.cpp \
+	bm_journalspy.cpp \
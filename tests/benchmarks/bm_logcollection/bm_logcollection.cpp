@@ -0,0 +1,197 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <QDir>
+#include <QFile>
+#include <QProcess>
+
+#include "bm_logcollection.h"
+#include "creporterutils.h"
+
+static const char *BrokerBinary = "/usr/libexec/rich-core-broker";
+static const char *BrokerSocket = "/tmp/crash-reporter-tests/rich-core-broker.sock";
+static const int ThroughputRequests = 50;
+
+// Same command chain rich-core-helper executes, minus the setuid.
+static QStringList spawnArguments()
+{
+    return QStringList() << "-i" << "/bin/bash" << "-c" << "/bin/true";
+}
+
+void Bm_LogCollection::initTestCase()
+{
+    broker = 0;
+    labelCounter = 0;
+
+    if (!QFile::exists(BrokerBinary)) {
+        QSKIP("rich-core-broker is not installed");
+    }
+    QDir().mkpath(QFileInfo(BrokerSocket).path());
+}
+
+bool Bm_LogCollection::startBroker(int maxJobs)
+{
+    stopBroker();
+
+    broker = new QProcess(this);
+    broker->start(BrokerBinary, QStringList()
+                  << "-j" << QString::number(maxJobs)
+                  << "-s" << BrokerSocket
+                  << "-d" << "/bin/true");
+    if (!broker->waitForStarted()) {
+        return false;
+    }
+
+    for (int i = 0; i < 100 && !QFile::exists(BrokerSocket); ++i) {
+        QTest::qWait(10);
+    }
+    return QFile::exists(BrokerSocket);
+}
+
+void Bm_LogCollection::stopBroker()
+{
+    if (broker) {
+        broker->terminate();
+        broker->waitForFinished();
+        delete broker;
+        broker = 0;
+    }
+}
+
+int Bm_LogCollection::brokerFinishedCount()
+{
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, BrokerSocket, sizeof(addr.sun_path) - 1);
+
+    char reply[128] = { 0 };
+    if (::connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == 0 &&
+        send(fd, "STATUS", 6, 0) == 6) {
+        recv(fd, reply, sizeof(reply) - 1, 0);
+    }
+    close(fd);
+
+    const char *finished = strstr(reply, "finished=");
+    return finished ? atoi(finished + 9) : -1;
+}
+
+void Bm_LogCollection::triggerLatency_data()
+{
+    QTest::addColumn<bool>("useBroker");
+
+    QTest::newRow("broker") << true;
+    QTest::newRow("spawn") << false;
+}
+
+void Bm_LogCollection::triggerLatency()
+{
+    QFETCH(bool, useBroker);
+
+    QList<QProcess *> spawned;
+
+    if (useBroker) {
+        QVERIFY(startBroker(1));
+        QBENCHMARK {
+            // Distinct labels so that the broker doesn't coalesce requests.
+            CReporterUtils::requestLogCollection(
+                    QString("Benchmark-%1").arg(labelCounter++));
+        }
+        stopBroker();
+    } else {
+        QBENCHMARK {
+            QProcess *process = new QProcess(this);
+            process->start("/bin/env", spawnArguments());
+            process->waitForStarted();
+            spawned << process;
+        }
+    }
+
+    foreach (QProcess *process, spawned) {
+        process->waitForFinished();
+        delete process;
+    }
+}
+
+void Bm_LogCollection::throughput_data()
+{
+    QTest::addColumn<bool>("useBroker");
+    QTest::addColumn<int>("maxJobs");
+
+    QTest::newRow("broker, 1 job") << true << 1;
+    QTest::newRow("broker, 4 jobs") << true << 4;
+    QTest::newRow("spawn") << false << 0;
+}
+
+void Bm_LogCollection::throughput()
+{
+    QFETCH(bool, useBroker);
+    QFETCH(int, maxJobs);
+
+    if (useBroker) {
+        QVERIFY(startBroker(maxJobs));
+        QBENCHMARK_ONCE {
+            int requested = 0;
+            while (requested < ThroughputRequests) {
+                // Broker queue is bounded, back off while it's full.
+                if (CReporterUtils::requestLogCollection(
+                        QString("Benchmark-%1").arg(labelCounter++))) {
+                    ++requested;
+                } else {
+                    QTest::qWait(1);
+                }
+            }
+            while (brokerFinishedCount() < ThroughputRequests) {
+                QTest::qWait(1);
+            }
+        }
+        stopBroker();
+    } else {
+        QBENCHMARK_ONCE {
+            QList<QProcess *> spawned;
+            for (int i = 0; i < ThroughputRequests; ++i) {
+                QProcess *process = new QProcess(this);
+                process->start("/bin/env", spawnArguments());
+                process->waitForStarted();
+                spawned << process;
+            }
+            foreach (QProcess *process, spawned) {
+                process->waitForFinished();
+                delete process;
+            }
+        }
+    }
+}
+
+void Bm_LogCollection::cleanupTestCase()
+{
+    stopBroker();
+}
+
+QTEST_MAIN(Bm_LogCollection)
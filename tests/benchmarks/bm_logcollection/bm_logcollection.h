@@ -0,0 +1,59 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef BM_LOGCOLLECTION_H
+#define BM_LOGCOLLECTION_H
+
+#include <QTest>
+
+class QProcess;
+
+/*!
+ * Compares triggering log collection through rich-core-broker with the
+ * rich-core-helper spawn path. Both run a no-op in place of rich-core-dumper
+ * so that only the cost of the trigger mechanism is measured.
+ */
+class Bm_LogCollection : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void triggerLatency_data();
+    void triggerLatency();
+
+    void throughput_data();
+    void throughput();
+
+    void cleanupTestCase();
+
+private:
+    bool startBroker(int maxJobs);
+    void stopBroker();
+    int brokerFinishedCount();
+
+    QProcess *broker;
+    int labelCounter;
+};
+
+#endif // BM_LOGCOLLECTION_H
@@ -0,0 +1,27 @@
+include(../bm_common_top.pri)
+
+TARGET = bm_logcollection
+
+INCLUDEPATH += . \
+               $$CREPORTER_SRC_DIR/libs/serviceif \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+CONFIG += link_pkgconfig
+PKGCONFIG += nemonotifications-qt5
+
+HEADERS += \
+	$${CREPORTER_SRC_DIR}/libs/autouploader_interface.h \
+	$${CREPORTER_SRC_DIR}/libs/ssu_interface.h \
+	$${CREPORTER_SRC_DIR}/libs/utils/creporterutils.h \
+	$${CREPORTER_SRC_DIR}/libs/utils/creportercrashinfo.h \
+	bm_logcollection.h \
+
+SOURCES += \
+	$${CREPORTER_SRC_DIR}/libs/utils/creporterutils.cpp \
+	$${CREPORTER_SRC_DIR}/libs/utils/creportercrashinfo.cpp \
+	$${CREPORTER_SRC_DIR}/libs/autouploader_interface.cpp \
+	$${CREPORTER_SRC_DIR}/libs/ssu_interface.cpp \
+	bm_logcollection.cpp \
@@ -0,0 +1,120 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QStringList>
+
+#include "bm_pendinguploadsmodel.h"
+#include "creportertestutils.h"
+#include "pendinguploadsmodel.h"
+
+static QString reportPath(int index)
+{
+    return QString("/var/cache/core-dumps/application%1-0123456789abcdef-11-%2.rcore.lzo")
+           .arg(index % 50).arg(100000 + index);
+}
+
+static QStringList reports(int first, int count)
+{
+    QStringList result;
+    for (int i = first; i < first + count; ++i) {
+        result << reportPath(i);
+    }
+    return result;
+}
+
+static void addCountRows()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+}
+
+void Bm_PendingUploadsModel::setData_data()
+{
+    addCountRows();
+}
+
+void Bm_PendingUploadsModel::setData()
+{
+    QFETCH(int, count);
+
+    QStringList files(reports(0, count));
+
+    QBENCHMARK {
+        PendingUploadsModel model;
+        model.setData(files);
+    }
+}
+
+void Bm_PendingUploadsModel::setDataChurn_data()
+{
+    addCountRows();
+}
+
+void Bm_PendingUploadsModel::setDataChurn()
+{
+    QFETCH(int, count);
+
+    QStringList initial(reports(0, count));
+    PendingUploadsModel model;
+    model.setData(initial);
+
+    /* Every update the oldest report got uploaded and a new one appeared,
+     * like the daemon refreshing the model while the uploader works. */
+    QList<QStringList> updates;
+    for (int i = 1; i <= 100; ++i) {
+        updates << reports(i, count);
+    }
+
+    QBENCHMARK {
+        foreach (const QStringList &update, updates) {
+            model.setData(update);
+        }
+        model.setData(initial);
+    }
+}
+
+void Bm_PendingUploadsModel::setDataMemory_data()
+{
+    addCountRows();
+}
+
+void Bm_PendingUploadsModel::setDataMemory()
+{
+    QFETCH(int, count);
+
+    QStringList files(reports(0, count));
+
+    qint64 baseline = CReporterTestUtils::currentMemory();
+    CReporterTestUtils::resetPeakMemory();
+
+    PendingUploadsModel model;
+    model.setData(files);
+    model.setData(reports(1, count));
+
+    QTest::setBenchmarkResult(CReporterTestUtils::peakMemory() - baseline,
+                              QTest::BytesAllocated);
+}
+
+QTEST_MAIN(Bm_PendingUploadsModel)
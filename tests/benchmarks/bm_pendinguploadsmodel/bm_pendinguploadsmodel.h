@@ -0,0 +1,47 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef BM_PENDINGUPLOADSMODEL_H
+#define BM_PENDINGUPLOADSMODEL_H
+
+#include <QTest>
+
+/*!
+ * Measures updating the list of pending uploads shown in the settings UI
+ * as reports are created and uploaded.
+ */
+class Bm_PendingUploadsModel : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void setData_data();
+    void setData();
+
+    void setDataChurn_data();
+    void setDataChurn();
+
+    void setDataMemory_data();
+    void setDataMemory();
+};
+
+#endif // BM_PENDINGUPLOADSMODEL_H
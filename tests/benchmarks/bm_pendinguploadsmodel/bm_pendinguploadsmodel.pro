@@ -0,0 +1,24 @@
+include(../bm_common_top.pri)
+
+PLUGIN_SRC_DIR = $${CREPORTER_SRC_DIR}/sailfishui/plugin
+
+TARGET = bm_pendinguploadsmodel
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               $${PLUGIN_SRC_DIR} \
+               $$CREPORTER_SRC_DIR/libs/coredir \
+               $$CREPORTER_SRC_DIR/libs/serviceif \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+HEADERS += \
+	$${PLUGIN_SRC_DIR}/pendinguploadsmodel.h \
+	bm_pendinguploadsmodel.h \
+
+SOURCES += \
+	$${PLUGIN_SRC_DIR}/pendinguploadsmodel.cpp \
+	bm_pendinguploadsmodel.cpp \
@@ -0,0 +1,60 @@
+#!/bin/sh
+#
+# Compares two result directories written by run_benchmarks.sh, e.g. those
+# of two releases. Prints every benchmark result with the relative change,
+# results that grew by more than the threshold are marked.
+
+if [ $# -lt 2 ]; then
+    echo "Usage: $0 BASELINE_DIR RESULT_DIR [THRESHOLD_PERCENT]"
+    exit 1
+fi
+
+BASELINE_DIR=$1
+RESULT_DIR=$2
+THRESHOLD=${3:-10}
+
+# Prints "benchmark/function/tag/metric value" for every result in the
+# QTestLib XML output files of a directory.
+extract_results() {
+    for FILE in $1/bm_*.xml; do
+        [ -f "$FILE" ] || continue
+        awk -v bm=`basename $FILE .xml` '
+            function attr(name,    s) {
+                if (match($0, name "=\"[^\"]*\"")) {
+                    s = substr($0, RSTART + length(name) + 2, RLENGTH - length(name) - 3)
+                    gsub(/ /, "_", s)
+                    return s
+                }
+                return ""
+            }
+            /<TestFunction / { fn = attr("name") }
+            /<BenchmarkResult / {
+                tag = attr("tag")
+                print bm "/" fn "/" (tag == "" ? "-" : tag) "/" attr("metric"), attr("value")
+            }' "$FILE"
+    done
+}
+
+extract_results $BASELINE_DIR | LC_ALL=C sort > /tmp/compare_benchmarks.$$.old
+extract_results $RESULT_DIR | LC_ALL=C sort > /tmp/compare_benchmarks.$$.new
+
+LC_ALL=C join -a 2 -e "-" -o 0,1.2,2.2 /tmp/compare_benchmarks.$$.old /tmp/compare_benchmarks.$$.new |
+awk -v threshold=$THRESHOLD '
+    BEGIN { printf "%-70s %14s %14s %9s\n", "benchmark", "baseline", "result", "change" }
+    {
+        if ($2 == "-" || $2 == 0) {
+            printf "%-70s %14s %14s %9s\n", $1, $2, $3, "new"
+            next
+        }
+        change = ($3 - $2) * 100 / $2
+        printf "%-70s %14s %14s %+8.1f%%%s\n", $1, $2, $3, change,
+               (change > threshold ? " REGRESSION" : "")
+        if (change > threshold) {
+            regressions++
+        }
+    }
+    END { exit regressions > 0 }'
+STATUS=$?
+
+rm -f /tmp/compare_benchmarks.$$.old /tmp/compare_benchmarks.$$.new
+exit $STATUS
@@ -0,0 +1,79 @@
+#!/bin/sh
+#
+# Compares rich-core-dumper with crash-reporter-dumper the way the kernel
+# runs them: a core is piped to stdin while the "crashed" process is still
+# around. Reports the wall time from the first byte of the core to the
+# finished report, and the report size, for CORE_MB megabytes of core.
+#
+# usage: dumper-benchmark.sh [core_file]
+#
+# When core_file isn't given, a core of a running process is taken with
+# gcore, or a synthetic one half made of zeros is used if gcore is missing.
+
+CORE_MB=${CORE_MB:-64}
+LEGACY=${LEGACY:-/usr/sbin/rich-core-dumper}
+DUMPER=${DUMPER:-/usr/libexec/crash-reporter-dumper}
+BENCH_DIR=${BENCH_DIR:-/var/tmp/dumper-benchmark}
+CORE=$1
+
+# Runs $1 with the target's PID and prints wall time in ms and report size.
+_measure()
+{
+  rm -rf "$BENCH_DIR/out"
+  mkdir "$BENCH_DIR/out"
+  sync
+  echo 3 > /proc/sys/vm/drop_caches 2>/dev/null
+
+  start=$(date +%s%N)
+  $2 < "$CORE"
+  end=$(date +%s%N)
+
+  report=$(ls "$BENCH_DIR"/out/*.rcore.lzo 2>/dev/null | head -n1)
+  if [ -z "$report" ]; then
+    # rich-core-dumper writes to the configured core directory.
+    report=$(ls -t /var/cache/core-dumps/benchmark-*.rcore.lzo 2>/dev/null | head -n1)
+  fi
+
+  size=n/a
+  if [ -n "$report" ]; then
+    size="$(stat -c %s "$report") bytes"
+    case "$report" in
+      "$BENCH_DIR"/*) ;;
+      *) rm -f "$report" ;;
+    esac
+  fi
+
+  echo "$1: wall $(( (end - start) / 1000000 )) ms, report $size"
+}
+
+mkdir -p "$BENCH_DIR"
+
+sleep 600 &
+TARGET=$!
+
+if [ -z "$CORE" ]; then
+  CORE=$BENCH_DIR/core
+  if command -v gcore > /dev/null && gcore -o "$BENCH_DIR/gcore" $TARGET > /dev/null 2>&1; then
+    mv "$BENCH_DIR/gcore.$TARGET" "$CORE"
+  else
+    (
+      head -c $((CORE_MB * 512 * 1024)) /dev/urandom
+      head -c $((CORE_MB * 512 * 1024)) /dev/zero
+    ) > "$CORE"
+  fi
+fi
+
+echo "Dumping a $(( $(stat -c %s "$CORE") / 1024 )) kB core"
+
+ARGS="--pid=$TARGET --uid=$(id -u) --signal=11 --name=benchmark"
+
+if [ -x "$LEGACY" ]; then
+  _measure rich-core-dumper "$LEGACY $ARGS"
+fi
+_measure "crash-reporter-dumper, 1 thread" \
+  "$DUMPER $ARGS --output-dir=$BENCH_DIR/out --threads=0"
+_measure "crash-reporter-dumper" \
+  "$DUMPER $ARGS --output-dir=$BENCH_DIR/out"
+
+kill $TARGET
+rm -rf "$BENCH_DIR"
@@ -0,0 +1,105 @@
+#!/bin/sh
+#
+# Compares the legacy lzop -d | tar | xz | lzop endurance packaging pipeline
+# with endurance-packager, with and without delta encoding. Reports wall
+# time, bytes written to storage and peak RSS for packing SNAPSHOTS endurance
+# snapshots.
+#
+# usage: endurance-packager-benchmark.sh [snapshot_source_dir]
+#
+# When snapshot_source_dir isn't given, fresh snapshots are taken with
+# endurance-snapshot. Needs GNU time for the peak memory figure.
+
+SNAPSHOTS=${SNAPSHOTS:-12}
+PACKAGER=${PACKAGER:-/usr/libexec/endurance-packager}
+BENCH_DIR=${BENCH_DIR:-/var/tmp/endurance-packager-benchmark}
+SOURCE_DIR=$1
+
+_legacy_package()
+{
+  (
+    cd "$1"
+    printf '\n[---rich-core: %s---]\n' device-uid
+    echo benchmark
+    printf '\n[---rich-core: %s---]\n' boot-time
+    echo 0
+    printf '\n[---rich-core: %s---]\n' endurance-snapshot-pack.tar.xz
+    for snapshot in ???; do
+      for lzofile in $(ls $snapshot/*.lzo 2>/dev/null); do
+        lzop -d $lzofile
+        rm -f $lzofile
+      done
+    done
+    tar c ??? | xz -0 --stdout
+  ) | lzop > "$2"
+}
+
+_native_package()
+{
+  $PACKAGER --device-uid benchmark --boot-time 0 --output "$2" "$1"/???
+}
+
+_delta_package()
+{
+  $PACKAGER --device-uid benchmark --boot-time 0 --output "$2" --delta "$1"/???
+}
+
+# Runs $1 in a child shell and prints wall time in ms, write_bytes and peak
+# RSS. The shell's /proc/<pid>/io includes the counters of all reaped children.
+_measure()
+{
+  rm -rf "$BENCH_DIR/work" "$BENCH_DIR/out.rcore.lzo"
+  cp -a "$BENCH_DIR/source" "$BENCH_DIR/work"
+  sync
+  echo 3 > /proc/sys/vm/drop_caches 2>/dev/null
+
+  TIME=""
+  if [ -x /usr/bin/time ]; then
+    TIME="/usr/bin/time -f %M -o $BENCH_DIR/rss"
+  fi
+
+  start=$(date +%s%N)
+  $TIME sh "$0" --run $1 "$BENCH_DIR/work" "$BENCH_DIR/out.rcore.lzo" > "$BENCH_DIR/io"
+  end=$(date +%s%N)
+
+  rss=n/a
+  if [ -f "$BENCH_DIR/rss" ]; then
+    rss="$(tail -n1 $BENCH_DIR/rss) kB"
+    rm -f "$BENCH_DIR/rss"
+  fi
+
+  echo "$1: wall $(( (end - start) / 1000000 )) ms," \
+    "written $(cat $BENCH_DIR/io) bytes," \
+    "package $(stat -c %s $BENCH_DIR/out.rcore.lzo) bytes," \
+    "peak RSS $rss"
+}
+
+if [ "$1" = "--run" ]; then
+  $2 "$3" "$4"
+  sync
+  grep '^write_bytes' /proc/$$/io | cut -d' ' -f2
+  exit
+fi
+
+mkdir -p "$BENCH_DIR"
+rm -rf "$BENCH_DIR/source"
+
+if [ -n "$SOURCE_DIR" ]; then
+  cp -a "$SOURCE_DIR" "$BENCH_DIR/source"
+else
+  mkdir "$BENCH_DIR/source"
+  i=0
+  while [ $i -lt $SNAPSHOTS ]; do
+    /usr/bin/endurance-snapshot "$BENCH_DIR/source" > /dev/null
+    i=$(($i + 1))
+  done
+fi
+
+echo "Packing $(ls -d $BENCH_DIR/source/??? | wc -l) snapshots" \
+  "($(du -sk $BENCH_DIR/source | cut -f1) kB compressed)"
+
+_measure _legacy_package
+_measure _native_package
+_measure _delta_package
+
+rm -rf "$BENCH_DIR"
@@ -0,0 +1,25 @@
+#!/bin/sh
+
+PACKAGE=crash-reporter-tests
+BENCHMARK_BIN_DIR=/usr/lib/$PACKAGE/benchmarks
+RESULT_DIR=${1:-/tmp/crash-reporter-benchmarks}
+
+mkdir -p $RESULT_DIR
+
+# Identify the build, so that result directories can be compared later
+# with compare_benchmarks.sh.
+{
+    echo "date: `date -u +%Y-%m-%dT%H:%M:%SZ`"
+    echo "kernel: `uname -r`"
+    echo "package: `rpm -q crash-reporter 2>/dev/null`"
+} > $RESULT_DIR/environment.txt
+
+echo "Starting to run benchmarks..."
+
+for BENCHMARK in `ls $BENCHMARK_BIN_DIR/bm_*`; do
+    NAME=`basename $BENCHMARK`
+    echo "Running" $NAME
+    $BENCHMARK -o $RESULT_DIR/$NAME.xml,xml -o $RESULT_DIR/$NAME.csv,csv -o -,txt
+done
+
+echo "Benchmark run finished. Results written in:" $RESULT_DIR
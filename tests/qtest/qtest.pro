@@ -3,16 +3,23 @@ TEMPLATE = subdirs
 SUBDIRS =  ut_creporterdaemonmonitor \
           ut_creporterdaemon \
           ut_creporterdaemonproxy \
+          ut_creporterdaemonsnapshot \
           ut_creportercoreregistry \
           ut_creportersettingsobserver \
           ut_creportercoredir \
           ut_creporterutils \
+          ut_creportercrashinfo \
+          ut_creporterlogger \
+          ut_creporterstats \
+          ut_creportertrace \
           ut_creporternwsessionmgr \
           ut_creporteruploaditem \
           ut_creporteruploadqueue \
           ut_creporteruploadengine \
+          ut_creporterhttpupload \
           ut_creporterapplicationsettings \
           ut_creporterprivacysettingsmodel \
+          ut_pendinguploadsmodel \
 
 testsxml.target = $$OUT_PWD/tests.xml
 testsxml.commands = $$PWD/generate_tests_xml.sh $$PWD > $$testsxml.target
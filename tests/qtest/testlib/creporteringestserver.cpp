@@ -0,0 +1,413 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QTcpSocket>
+#include <QTimer>
+
+#include "creporteringestserver.h"
+
+namespace {
+
+// Throttled uploads are read in slices of this period.
+const int ThrottleIntervalMs = 10;
+
+// Bytes read per slice; at least one so that rates below 100 B/s still
+// make progress.
+qint64 throttleSlice(qint64 bytesPerSecond)
+{
+    return qMax<qint64>(bytesPerSecond * ThrottleIntervalMs / 1000, 1);
+}
+
+QByteArray reasonPhrase(int statusCode)
+{
+    switch (statusCode) {
+    case 200:
+        return "OK";
+    case 400:
+        return "Bad Request";
+    case 401:
+        return "Unauthorized";
+    case 403:
+        return "Forbidden";
+    case 404:
+        return "Not Found";
+    case 405:
+        return "Method Not Allowed";
+    case 413:
+        return "Payload Too Large";
+    case 500:
+        return "Internal Server Error";
+    case 503:
+        return "Service Unavailable";
+    default:
+        return "Unknown";
+    }
+}
+
+} // namespace
+
+struct CReporterIngestServer::Connection {
+    //! Index of the current request in the records, -1 between requests.
+    int request;
+    Behavior behavior;
+    QByteArray header;
+    bool headerReceived;
+    bool authorized;
+    //! Status code to reply once the latency has passed.
+    int replyStatus;
+    QTimer *throttleTimer;
+    QTimer *replyTimer;
+
+    Connection() : request(-1), headerReceived(false), authorized(false),
+        replyStatus(0), throttleTimer(0), replyTimer(0) {}
+};
+
+CReporterIngestServer::Behavior::Behavior()
+    : statusCode(200), latencyMs(0), bytesPerSecond(0), resetAfterBytes(-1),
+      requireAuthentication(false)
+{
+}
+
+CReporterIngestServer::Request::Request()
+    : contentLength(-1), bytesReceived(0), statusCode(0), submissionId(0),
+      startedMs(-1), firstByteMs(-1), finishedMs(-1)
+{
+}
+
+CReporterIngestServer::CReporterIngestServer(QObject *parent)
+    : QTcpServer(parent), path("/post"), totalReceived(0), lastSubmissionId(0)
+{
+    connect(this, SIGNAL(newConnection()), this, SLOT(handleNewConnection()));
+}
+
+CReporterIngestServer::~CReporterIngestServer()
+{
+    qDeleteAll(connections);
+}
+
+bool CReporterIngestServer::start()
+{
+    clock.start();
+    return listen(QHostAddress::LocalHost);
+}
+
+QString CReporterIngestServer::serverUrl() const
+{
+    return "http://127.0.0.1";
+}
+
+void CReporterIngestServer::setServerPath(const QString &serverPath)
+{
+    path = serverPath;
+}
+
+QString CReporterIngestServer::serverPath() const
+{
+    return path;
+}
+
+void CReporterIngestServer::setCredentials(const QString &username, const QString &password)
+{
+    authorization = "Basic " + QString(username + ':' + password).toUtf8().toBase64();
+}
+
+void CReporterIngestServer::setDefaultBehavior(const Behavior &behavior)
+{
+    defaultBehavior = behavior;
+}
+
+void CReporterIngestServer::scheduleBehavior(const Behavior &behavior)
+{
+    scheduled.enqueue(behavior);
+}
+
+QList<CReporterIngestServer::Request> CReporterIngestServer::requests() const
+{
+    return records;
+}
+
+qint64 CReporterIngestServer::bytesReceived() const
+{
+    return totalReceived;
+}
+
+void CReporterIngestServer::reset()
+{
+    foreach (Connection *connection, connections) {
+        connection->request = -1;
+    }
+    records.clear();
+    scheduled.clear();
+    totalReceived = 0;
+}
+
+void CReporterIngestServer::handleNewConnection()
+{
+    while (QTcpSocket *socket = nextPendingConnection()) {
+        Connection *connection = new Connection;
+
+        connection->throttleTimer = new QTimer(socket);
+        connection->throttleTimer->setInterval(ThrottleIntervalMs);
+        connect(connection->throttleTimer, SIGNAL(timeout()),
+                this, SLOT(handleThrottleTimeout()));
+
+        connection->replyTimer = new QTimer(socket);
+        connection->replyTimer->setSingleShot(true);
+        connect(connection->replyTimer, SIGNAL(timeout()),
+                this, SLOT(handleReplyTimeout()));
+
+        connections.insert(socket, connection);
+        connect(socket, SIGNAL(readyRead()), this, SLOT(handleReadyRead()));
+        connect(socket, SIGNAL(disconnected()), this, SLOT(handleDisconnected()));
+    }
+}
+
+void CReporterIngestServer::handleReadyRead()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    Connection *connection = connections.value(socket);
+
+    // Throttled bodies are read from the timer.
+    if (connection && !connection->throttleTimer->isActive()) {
+        readRequest(socket, -1);
+    }
+}
+
+void CReporterIngestServer::handleThrottleTimeout()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender()->parent());
+    Connection *connection = connections.value(socket);
+    if (connection && connection->request >= 0) {
+        readRequest(socket, throttleSlice(connection->behavior.bytesPerSecond));
+    }
+}
+
+void CReporterIngestServer::handleReplyTimeout()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender()->parent());
+    sendReply(socket);
+
+    // Serve the next request on the connection, if any was sent meanwhile.
+    readRequest(socket, -1);
+}
+
+void CReporterIngestServer::handleDisconnected()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    Connection *connection = connections.take(socket);
+
+    if (connection) {
+        finishRequest(*connection);
+        delete connection;
+    }
+    socket->deleteLater();
+}
+
+void CReporterIngestServer::readRequest(QTcpSocket *socket, qint64 maxBytes)
+{
+    if (!connections.contains(socket)) {
+        return;
+    }
+
+    Connection &connection = *connections.value(socket);
+    char buffer[64 * 1024];
+
+    // Stops while a reply is delayed, the next request is read after it.
+    while (!connection.replyTimer->isActive()) {
+        if (connection.request < 0) {
+            if (socket->bytesAvailable() <= 0) {
+                return;
+            }
+            connection.behavior = scheduled.isEmpty() ? defaultBehavior : scheduled.dequeue();
+            connection.header.clear();
+            connection.headerReceived = false;
+            connection.authorized = false;
+
+            Request request;
+            request.startedMs = clock.elapsed();
+            records << request;
+            connection.request = records.size() - 1;
+        }
+
+        if (!connection.headerReceived) {
+            if (!socket->canReadLine()) {
+                return;
+            }
+            QByteArray line(socket->readLine());
+            connection.header += line;
+            if (line == "\r\n" || line == "\n") {
+                connection.headerReceived = true;
+                if (!parseHeader(connection, connection.header)) {
+                    socket->abort();
+                    return;
+                }
+                if (connection.behavior.bytesPerSecond > 0 && maxBytes < 0) {
+                    socket->setReadBufferSize(qMax<qint64>(
+                        throttleSlice(connection.behavior.bytesPerSecond), 1024));
+                    connection.throttleTimer->start();
+                    return;
+                }
+            }
+            continue;
+        }
+
+        Request &request = records[connection.request];
+        if (request.bytesReceived >= request.contentLength) {
+            requestReceived(socket);
+            continue;
+        }
+
+        qint64 wanted = request.contentLength - request.bytesReceived;
+        if (connection.behavior.resetAfterBytes >= 0) {
+            if (request.bytesReceived >= connection.behavior.resetAfterBytes) {
+                socket->abort();
+                return;
+            }
+            wanted = qMin(wanted, connection.behavior.resetAfterBytes - request.bytesReceived);
+        }
+        if (maxBytes >= 0) {
+            wanted = qMin(wanted, maxBytes);
+        }
+
+        qint64 read = wanted > 0 ? socket->read(buffer, qMin<qint64>(wanted, sizeof(buffer))) : 0;
+        if (read <= 0) {
+            return;
+        }
+        if (request.firstByteMs < 0) {
+            request.firstByteMs = clock.elapsed();
+        }
+        request.bytesReceived += read;
+        totalReceived += read;
+        if (maxBytes >= 0) {
+            maxBytes -= read;
+        }
+    }
+}
+
+bool CReporterIngestServer::parseHeader(Connection &connection, const QByteArray &header)
+{
+    Request &request = records[connection.request];
+    QList<QByteArray> lines(header.split('\n'));
+
+    QList<QByteArray> requestLine(lines.takeFirst().trimmed().split(' '));
+    if (requestLine.size() != 3) {
+        return false;
+    }
+    request.method = requestLine.at(0);
+    QByteArray target(requestLine.at(1));
+    int queryStart = target.indexOf('?');
+    request.path = target.left(queryStart);
+    if (queryStart != -1) {
+        request.query = target.mid(queryStart + 1);
+    }
+
+    request.contentLength = 0;
+    foreach (const QByteArray &line, lines) {
+        int separator = line.indexOf(':');
+        if (separator == -1) {
+            continue;
+        }
+        QByteArray name(line.left(separator).trimmed().toLower());
+        QByteArray value(line.mid(separator + 1).trimmed());
+        if (name == "content-length") {
+            request.contentLength = value.toLongLong();
+        } else if (name == "authorization") {
+            connection.authorized = !authorization.isEmpty() && value == authorization;
+        }
+    }
+
+    return true;
+}
+
+void CReporterIngestServer::requestReceived(QTcpSocket *socket)
+{
+    Connection &connection = *connections.value(socket);
+    const Request &request = records.at(connection.request);
+
+    connection.throttleTimer->stop();
+    socket->setReadBufferSize(0);
+
+    // For PUT the file name is appended to the server path.
+    QByteArray serverPath(path.toUtf8());
+    bool underServerPath = request.path == serverPath ||
+                           request.path.startsWith(serverPath + '/');
+
+    if (request.method != "PUT") {
+        connection.replyStatus = 405;
+    } else if (!underServerPath) {
+        connection.replyStatus = 404;
+    } else if (connection.behavior.requireAuthentication && !connection.authorized) {
+        connection.replyStatus = 401;
+    } else {
+        connection.replyStatus = connection.behavior.statusCode;
+    }
+
+    if (connection.behavior.latencyMs > 0) {
+        connection.replyTimer->start(connection.behavior.latencyMs);
+    } else {
+        sendReply(socket);
+    }
+}
+
+void CReporterIngestServer::sendReply(QTcpSocket *socket)
+{
+    Connection *connection = connections.value(socket);
+    if (!connection || connection->request < 0) {
+        return;
+    }
+
+    Request &request = records[connection->request];
+    request.statusCode = connection->replyStatus;
+
+    QByteArray headers;
+    QByteArray body;
+    if (request.statusCode == 200) {
+        request.submissionId = ++lastSubmissionId;
+        headers += "Content-Type: application/json\r\n";
+        body = "{\"submission_id\": " + QByteArray::number(request.submissionId) + "}";
+    } else if (request.statusCode == 401) {
+        headers += "WWW-Authenticate: Basic realm=\"crash-reporter\"\r\n";
+    }
+
+    socket->write("HTTP/1.1 " + QByteArray::number(request.statusCode) + ' ' +
+                  reasonPhrase(request.statusCode) + "\r\n" + headers +
+                  "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                  "\r\n" + body);
+
+    finishRequest(*connection);
+}
+
+void CReporterIngestServer::finishRequest(Connection &connection)
+{
+    if (connection.request < 0) {
+        return;
+    }
+
+    int index = connection.request;
+    records[index].finishedMs = clock.elapsed();
+
+    connection.request = -1;
+    connection.replyStatus = 0;
+    connection.throttleTimer->stop();
+    connection.replyTimer->stop();
+
+    emit requestFinished(index);
+}
@@ -0,0 +1,150 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERINGESTSERVER_H
+#define CREPORTERINGESTSERVER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QQueue>
+#include <QTcpServer>
+
+class QTcpSocket;
+class QTimer;
+
+/*!
+ * @class CReporterIngestServer
+ * @brief Fake crash report server on the loopback interface.
+ *
+ * Accepts PUT requests under the server path like the real server and
+ * replies with a JSON submission ID. Every request is answered according
+ * to a CReporterIngestServer::Behavior; behaviors queued with
+ * scheduleBehavior() are used for the following requests in order, after
+ * them the default behavior applies.
+ */
+class CReporterIngestServer : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    //! How a request is answered.
+    struct Behavior {
+        //! HTTP status code of the reply, 200 replies with a submission ID.
+        int statusCode;
+        //! Delay of the reply after the whole request was received.
+        int latencyMs;
+        //! Upload bandwidth cap in bytes per second, 0 if unlimited.
+        qint64 bytesPerSecond;
+        //! Connection is reset after this many body bytes, -1 never.
+        qint64 resetAfterBytes;
+        //! Request is challenged with 401 until it has the credentials.
+        bool requireAuthentication;
+
+        Behavior();
+    };
+
+    //! Record of a single request.
+    struct Request {
+        QByteArray method;
+        //! Path of the request, without the query.
+        QByteArray path;
+        QByteArray query;
+        qint64 contentLength;
+        qint64 bytesReceived;
+        //! Status code replied, 0 if the connection was reset.
+        int statusCode;
+        //! Submission ID replied, 0 if none.
+        int submissionId;
+        //! Milliseconds since the server was started.
+        qint64 startedMs;
+        qint64 firstByteMs;
+        qint64 finishedMs;
+
+        Request();
+    };
+
+    CReporterIngestServer(QObject *parent = 0);
+    ~CReporterIngestServer();
+
+    /*!
+     * Starts listening on a free port of the loopback interface.
+     *
+     * @return @c false on error.
+     */
+    bool start();
+
+    //! @return Server URL to pass to CReporterUploadEndpoint, without the port.
+    QString serverUrl() const;
+
+    //! Sets the path the uploads are accepted under, "/post" by default.
+    void setServerPath(const QString &path);
+    QString serverPath() const;
+
+    //! Sets the credentials required by Behavior::requireAuthentication.
+    void setCredentials(const QString &username, const QString &password);
+
+    void setDefaultBehavior(const Behavior &behavior);
+
+    //! Uses @a behavior for the next request that doesn't have one yet.
+    void scheduleBehavior(const Behavior &behavior);
+
+    //! @return Requests received so far, including unfinished ones.
+    QList<Request> requests() const;
+
+    //! @return Number of request body bytes received in total.
+    qint64 bytesReceived() const;
+
+    //! Forgets the recorded requests and scheduled behaviors.
+    void reset();
+
+Q_SIGNALS:
+    //! Emitted when a request was replied to or its connection was reset.
+    void requestFinished(int index);
+
+private Q_SLOTS:
+    void handleNewConnection();
+    void handleReadyRead();
+    void handleDisconnected();
+    void handleThrottleTimeout();
+    void handleReplyTimeout();
+
+private:
+    struct Connection;
+
+    void readRequest(QTcpSocket *socket, qint64 maxBytes);
+    bool parseHeader(Connection &connection, const QByteArray &header);
+    void requestReceived(QTcpSocket *socket);
+    void sendReply(QTcpSocket *socket);
+    void finishRequest(Connection &connection);
+
+    QHash<QTcpSocket *, Connection *> connections;
+    QList<Request> records;
+    QQueue<Behavior> scheduled;
+    Behavior defaultBehavior;
+    QString path;
+    QByteArray authorization;
+    QElapsedTimer clock;
+    qint64 totalReceived;
+    int lastSubmissionId;
+};
+
+#endif // CREPORTERINGESTSERVER_H
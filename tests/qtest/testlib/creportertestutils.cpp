@@ -22,6 +22,8 @@
  *
  */
 
+#include <sys/time.h>
+
 #include <QDir>
 #include <QFile>
 #include <QDirIterator>
@@ -184,3 +186,50 @@ QStringList *CReporterTestUtils::getCoreDumpPaths()
 
     return paths;
 }
+
+static qint64 statusValue( const QByteArray &name )
+{
+    // Values in /proc/self/status are in kB.
+    QFile status( "/proc/self/status" );
+    if ( !status.open( QIODevice::ReadOnly ) ) {
+        return -1;
+    }
+
+    foreach ( const QByteArray &line, status.readAll().split('\n') ) {
+        if ( line.startsWith( name ) && line.size() > name.size() &&
+             line.at( name.size() ) == ':' ) {
+            QByteArray value( line.mid( name.size() + 1 ).trimmed() );
+            return value.left( value.indexOf(' ') ).toLongLong() * 1024;
+        }
+    }
+
+    return -1;
+}
+
+bool CReporterTestUtils::setFileAge( const QString &path, int seconds )
+{
+    struct timeval times[2];
+    gettimeofday( &times[0], 0 );
+    times[0].tv_sec -= seconds;
+    times[1] = times[0];
+
+    return utimes( QFile::encodeName( path ).constData(), times ) == 0;
+}
+
+void CReporterTestUtils::resetPeakMemory()
+{
+    QFile clearRefs( "/proc/self/clear_refs" );
+    if ( clearRefs.open( QIODevice::WriteOnly ) ) {
+        clearRefs.write( "5" );
+    }
+}
+
+qint64 CReporterTestUtils::currentMemory()
+{
+    return statusValue( "VmRSS" );
+}
+
+qint64 CReporterTestUtils::peakMemory()
+{
+    return statusValue( "VmHWM" );
+}
@@ -22,6 +22,8 @@
  *
  */
 
+#include <QStringList>
+
 class CReporterTestUtils
 {
 public:
@@ -37,6 +39,19 @@ public:
 #endif // CREPORTER_UNIT_TEST
 
     static QStringList *getCoreDumpPaths();
+
+    //! Sets the access and modification times of @a path @a seconds back.
+    static bool setFileAge( const QString &path, int seconds );
+
+    /*!
+     * Resets the peak resident set size of the process to the current one.
+     * Needs Linux 4.0 or later, otherwise the peak since start is kept.
+     */
+    static void resetPeakMemory();
+    //! @return Resident set size of the process in bytes, VmRSS.
+    static qint64 currentMemory();
+    //! @return Peak resident set size of the process in bytes, VmHWM.
+    static qint64 peakMemory();
 };
 
 #define UNUSED_RESULT(x) if(x){}
@@ -0,0 +1,7 @@
+# CReporterIngestServer, needs QtNetwork which some unit tests stub out.
+
+QT += network
+
+HEADERS += $${PWD}/creporteringestserver.h
+
+SOURCES += $${PWD}/creporteringestserver.cpp
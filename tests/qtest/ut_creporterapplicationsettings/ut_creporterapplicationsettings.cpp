@@ -83,6 +83,51 @@ void Ut_CReporterApplicationSettings::testReadNotFoundSettings()
     QVERIFY(settings->serverPath() == DefaultApplicationSettings::ValueServerPathDefault);
 }
 
+void Ut_CReporterApplicationSettings::testUploadEndpoint()
+{
+    CReporterApplicationSettings *settings = CReporterApplicationSettings::instance();
+    settings->setServerPath("/crash");
+    settings->setUseProxy(false);
+
+    CReporterUploadEndpoint endpoint(settings->uploadEndpoint());
+    QVERIFY(!endpoint.isNull());
+    QCOMPARE(endpoint.uploadUrl("core.rcore.lzo").path(), QString("/crash/core.rcore.lzo"));
+    QVERIFY(!endpoint.useProxy());
+
+    // The snapshot is rebuilt when a setting changes.
+    settings->setServerPath("/upload");
+    settings->setUseProxy(true);
+    CReporterUploadEndpoint changed(settings->uploadEndpoint());
+    QCOMPARE(changed.uploadUrl("core.rcore.lzo").path(), QString("/upload/core.rcore.lzo"));
+    QVERIFY(changed.useProxy());
+    QCOMPARE(changed.proxyHost(), QString("127.0.0.2"));
+    QCOMPARE(changed.proxyPort(), 1234);
+
+    // Copies taken earlier are not affected.
+    QCOMPARE(endpoint.uploadUrl("core.rcore.lzo").path(), QString("/crash/core.rcore.lzo"));
+    QVERIFY(!endpoint.useProxy());
+}
+
+void Ut_CReporterApplicationSettings::testUploadEndpointChangedElsewhere()
+{
+    CReporterApplicationSettings *settings = CReporterApplicationSettings::instance();
+    settings->setServerPath("/crash");
+    settings->setUseProxy(true);
+    settings->writeSettings();
+    QVERIFY(settings->uploadEndpoint().useProxy());
+
+    // Settings application writes the file without going through the singleton.
+    QSettings userSettings(QSettings::NativeFormat, QSettings::UserScope, "crash-reporter-settings",
+                           "crash-reporter");
+    userSettings.setValue(Server::ValueServerPath, "/elsewhere");
+    userSettings.setValue(Server::ValueUseProxy, false);
+    userSettings.sync();
+
+    CReporterUploadEndpoint changed(settings->uploadEndpoint());
+    QCOMPARE(changed.uploadUrl("core.rcore.lzo").path(), QString("/elsewhere/core.rcore.lzo"));
+    QVERIFY(!changed.useProxy());
+}
+
 void Ut_CReporterApplicationSettings::cleanupTestCase()
 {
     CReporterApplicationSettings::instance()->freeSingleton();
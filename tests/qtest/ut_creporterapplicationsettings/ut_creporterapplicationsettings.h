@@ -38,6 +38,8 @@ private slots:
 
     void testReadSettings();
     void testReadNotFoundSettings();
+    void testUploadEndpoint();
+    void testUploadEndpointChangedElsewhere();
 
     void cleanupTestCase();
     void cleanup();
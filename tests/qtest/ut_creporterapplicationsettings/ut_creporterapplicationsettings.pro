@@ -13,8 +13,10 @@ DEPENDPATH += $$INCLUDEPATH \
 
 TEST_SOURCES += $${SETTINGS_SRC_DIR}/creporterapplicationsettings.cpp \
                 $${SETTINGS_SRC_DIR}/creportersettingsinit.cpp \
+                $${SETTINGS_SRC_DIR}/creporteruploadendpoint.cpp \
 
 HEADERS += $${SETTINGS_SRC_DIR}/creporterapplicationsettings.h \
+           $${SETTINGS_SRC_DIR}/creporteruploadendpoint.h \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase.h \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase_p.h \
             $${SETTINGS_SRC_DIR}/creportersettingsinit_p.h \
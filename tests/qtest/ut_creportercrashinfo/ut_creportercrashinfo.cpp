@@ -0,0 +1,176 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creportercrashinfo.h"
+#include "ut_creportercrashinfo.h"
+
+Q_DECLARE_METATYPE(CReporterCrashInfo::ReportClass)
+
+void Ut_CReporterCrashInfo::testParse_data()
+{
+    QTest::addColumn<QString>("path");
+    QTest::addColumn<QString>("application");
+    QTest::addColumn<QString>("hwid");
+    QTest::addColumn<int>("signal");
+    QTest::addColumn<int>("pid");
+
+    QTest::newRow("simple")
+            << "/media/mmc1/core-dumps/application-somehwid-11-4321.rcore.lzo"
+            << "application" << "somehwid" << 11 << 4321;
+    QTest::newRow("dashes in name")
+            << "/var/cache/core-dumps/jolla-settings-hw-id-6-12.rcore.lzo"
+            << "jolla-settings-hw" << "id" << 6 << 12;
+    QTest::newRow("dot in name")
+            << "/var/cache/core-dumps/test.launch-1234-11-4321.rcore.lzo"
+            << "test.launch" << "1234" << 11 << 4321;
+    QTest::newRow("dot in directory")
+            << "/home/user.name/core-dumps/app-hwid-3-99.rcore"
+            << "app" << "hwid" << 3 << 99;
+    QTest::newRow("no directory")
+            << "app-hwid-3-99.rcore.lzo"
+            << "app" << "hwid" << 3 << 99;
+    QTest::newRow("no suffix")
+            << "/tmp/app-hwid-3-99"
+            << "app" << "hwid" << 3 << 99;
+    QTest::newRow("non-numeric signal")
+            << "/tmp/app-hwid-x-99.rcore.lzo"
+            << "app" << "hwid" << 0 << 99;
+    QTest::newRow("pid out of range")
+            << "/tmp/app-hwid-6-99999999999.rcore.lzo"
+            << "app" << "hwid" << 6 << 0;
+}
+
+void Ut_CReporterCrashInfo::testParse()
+{
+    QFETCH(QString, path);
+    QFETCH(QString, application);
+    QFETCH(QString, hwid);
+    QFETCH(int, signal);
+    QFETCH(int, pid);
+
+    CReporterCrashInfo info(path);
+
+    QVERIFY(info.isValid());
+    QCOMPARE(info.filePath(), path);
+    QCOMPARE(info.applicationName().toString(), application);
+    QCOMPARE(info.hwid().toString(), hwid);
+    QCOMPARE(info.signal(), signal);
+    QCOMPARE(int(info.pid()), pid);
+}
+
+void Ut_CReporterCrashInfo::testNumericFieldText()
+{
+    // The numeric fields are also available as they are in the name, which
+    // CReporterUtils::parseCrashInfoFromFilename() has always returned.
+    CReporterCrashInfo info(QString("/tmp/app-hwid-x-007.rcore.lzo"));
+
+    QCOMPARE(info.signal(), 0);
+    QCOMPARE(info.signalText().toString(), QString("x"));
+    QCOMPARE(int(info.pid()), 7);
+    QCOMPARE(info.pidText().toString(), QString("007"));
+}
+
+void Ut_CReporterCrashInfo::testInvalidName()
+{
+    CReporterCrashInfo info("/var/cache/core-dumps/garbage-11.rcore.lzo");
+
+    QVERIFY(!info.isValid());
+    QCOMPARE(info.applicationName().toString(), QString("garbage-11"));
+    QVERIFY(info.hwid().isEmpty());
+    QCOMPARE(info.signal(), 0);
+    QCOMPARE(int(info.pid()), 0);
+
+    QVERIFY(!CReporterCrashInfo().isValid());
+    QVERIFY(!CReporterCrashInfo(QString()).isValid());
+}
+
+void Ut_CReporterCrashInfo::testReportClass_data()
+{
+    QTest::addColumn<QString>("path");
+    QTest::addColumn<CReporterCrashInfo::ReportClass>("reportClass");
+
+    QTest::newRow("crash")
+            << "/tmp/application-hwid-11-4321.rcore.lzo"
+            << CReporterCrashInfo::ApplicationCrash;
+    QTest::newRow("quickie")
+            << "/tmp/Quickie-hwid-1-4321.rcore.lzo"
+            << CReporterCrashInfo::QuickFeedback;
+    QTest::newRow("endurance")
+            << "/tmp/Endurance-hwid-1392000000-1391990000.rcore.lzo"
+            << CReporterCrashInfo::EndurancePackage;
+    QTest::newRow("power excess")
+            << "/tmp/PowerExcess-hwid-5-4321.rcore.lzo"
+            << CReporterCrashInfo::PowerExcess;
+    QTest::newRow("journal spy")
+            << "/tmp/JournalSpy-hwid-5-4321.rcore.lzo"
+            << CReporterCrashInfo::JournalSpy;
+    // Like CReporterUtils::reportIncludesCrash(), prefixes match anywhere
+    // in the file name...
+    QTest::newRow("prefix inside name")
+            << "/tmp/MyQuickie-hwid-1-4321.rcore.lzo"
+            << CReporterCrashInfo::QuickFeedback;
+    QTest::newRow("prefix in invalid name")
+            << "/tmp/Endurance.rcore.lzo"
+            << CReporterCrashInfo::EndurancePackage;
+    // ...but unlike it, not in the directories.
+    QTest::newRow("prefix in directory only")
+            << "/tmp/Quickie/application-hwid-11-4321.rcore.lzo"
+            << CReporterCrashInfo::ApplicationCrash;
+}
+
+void Ut_CReporterCrashInfo::testReportClass()
+{
+    QFETCH(QString, path);
+    QFETCH(CReporterCrashInfo::ReportClass, reportClass);
+
+    CReporterCrashInfo info(path);
+
+    QCOMPARE(info.reportClass(), reportClass);
+    QCOMPARE(info.includesCrash(), reportClass == CReporterCrashInfo::ApplicationCrash);
+}
+
+void Ut_CReporterCrashInfo::testCopy()
+{
+    CReporterCrashInfo copy;
+    {
+        CReporterCrashInfo info(QString("/tmp/app-hwid-3-99.rcore.lzo"));
+        copy = info;
+    }
+
+    QCOMPARE(copy.applicationName().toString(), QString("app"));
+    QCOMPARE(copy.hwid().toString(), QString("hwid"));
+    QCOMPARE(copy.signal(), 3);
+}
+
+void Ut_CReporterCrashInfo::benchmarkParse()
+{
+    QString path("/var/cache/core-dumps/jolla-settings-0123456789abcdef-11-4321.rcore.lzo");
+    int signal = 0;
+
+    QBENCHMARK {
+        CReporterCrashInfo info(path);
+        signal += info.signal();
+    }
+
+    QVERIFY(signal > 0);
+}
+
+QTEST_MAIN(Ut_CReporterCrashInfo)
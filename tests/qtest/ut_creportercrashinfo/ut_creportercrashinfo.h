@@ -0,0 +1,42 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef UT_CREPORTERCRASHINFO_H
+#define UT_CREPORTERCRASHINFO_H
+
+#include <QTest>
+
+class Ut_CReporterCrashInfo : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testParse_data();
+    void testParse();
+    void testNumericFieldText();
+    void testInvalidName();
+    void testReportClass_data();
+    void testReportClass();
+    void testCopy();
+    void benchmarkParse();
+};
+
+#endif // UT_CREPORTERCRASHINFO_H
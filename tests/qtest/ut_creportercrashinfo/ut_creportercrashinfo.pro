@@ -0,0 +1,22 @@
+include(../ut_common_top.pri)
+
+TARGET = ut_creportercrashinfo
+
+INCLUDEPATH += . \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+# sources to be tested
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/utils/creportercrashinfo.cpp \
+
+HEADERS += \
+	$${CREPORTER_SRC_DIR}/libs/utils/creportercrashinfo.h \
+	ut_creportercrashinfo.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+	ut_creportercrashinfo.cpp \
+
+include(../ut_coverage.pri)
@@ -228,35 +228,6 @@ void Ut_CReporterDaemon::testInitiateDaemon()
 
 }
 
-void Ut_CReporterDaemon::testDelayedStartup()
-{
-    // Check that daemon is initiated successfully after delay. UI is not launched, since no
-    // cores are found.
-    daemon = new CReporterDaemon;
-    daemon->setDelayedStartup(5000);
-    QVERIFY(daemon->d_ptr->timerId != 0);
-
-    QTest::qWait(6000);
-
-    QProcess dbusSend;
-    dbusSend.start(QString("dbus-send --session --print-reply --dest=%1 %2 %3 string:%4")
-                   .arg("org.freedesktop.DBus").arg("/").arg("org.freedesktop.DBus.GetConnectionUnixProcessID")
-                   .arg(CReporter::DaemonServiceName));
-
-    dbusSend.waitForFinished();
-    QVERIFY(dbusSend.exitCode() == 0);
-
-    daemon->stopService();
-
-    dbusSend.start(QString("dbus-send --session --print-reply --dest=%1 %2 %3 string:%4")
-                   .arg("org.freedesktop.DBus").arg("/").arg("org.freedesktop.DBus.GetConnectionUnixProcessID")
-                   .arg(CReporter::DaemonServiceName));
-
-    dbusSend.waitForFinished();
-    QVERIFY(dbusSend.exitCode() != 0);
-    QVERIFY(testDialogServer->callReceivedCalled == false);
-}
-
 void Ut_CReporterDaemon::testCollectAllCoreFiles()
 {
     QStringList compareFiles;
@@ -65,7 +65,6 @@ private slots:
     void initTestCase();
     void init();
     void testInitiateDaemon();
-    void testDelayedStartup();
     void testCollectAllCoreFiles();
     void testCollectAllCoreFilesNotValidFiles();
     void testMonitoringEnabledFromSettings();
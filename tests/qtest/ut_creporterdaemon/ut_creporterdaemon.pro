@@ -4,6 +4,7 @@ TARGET = ut_creporterdaemon
 INCLUDEPATH += . \
     $${CREPORTER_SRC_DIR}/libs/coredir \
     $${CREPORTER_SRC_DIR}/libs/httpclient \
+    $${CREPORTER_SRC_DIR}/libs/logger \
     $${CREPORTER_SRC_DIR}/libs/serviceif \
     $${CREPORTER_SRC_DIR}/libs/settings \
     $${DAEMON_SRC_DIR} \
@@ -28,6 +29,8 @@ HEADERS += $${CREPORTER_STUBS_DIR}/mgconfitem_stub.h \
     $${DAEMON_SRC_DIR}/creporterdaemonadaptor.h \
     $${DAEMON_SRC_DIR}/creporterdaemonmonitor.h \
     $${DAEMON_SRC_DIR}/creporterdaemonmonitor_p.h \
+    $${DAEMON_SRC_DIR}/creporterdaemonsnapshot.h \
+    $${DAEMON_SRC_DIR}/creporterreportindex.h \
     $${CREPORTER_SRC_DIR}/dialogserver/creporterdialogserverdbusadaptor.h \
     $${CREPORTER_SRC_DIR}/libs/autouploader_interface.h \
     $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.h \
@@ -35,6 +38,10 @@ HEADERS += $${CREPORTER_STUBS_DIR}/mgconfitem_stub.h \
     $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.h \
     $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry_p.h \
     $${CREPORTER_SRC_DIR}/libs/httpclient/creporternwsessionmgr.h \
+    $${CREPORTER_SRC_DIR}/libs/logger/creporterlogger.h \
+    $${CREPORTER_SRC_DIR}/libs/logger/creporterloggingadaptor.h \
+    $${CREPORTER_SRC_DIR}/libs/logger/creporterlogring_p.h \
+    $${CREPORTER_SRC_DIR}/libs/logger/creporterlogwriter_p.h \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersavedstate.h \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase.h \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase_p.h \
@@ -43,6 +50,11 @@ HEADERS += $${CREPORTER_STUBS_DIR}/mgconfitem_stub.h \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsobserver.h \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsobserver_p.h \
     $${CREPORTER_SRC_DIR}/libs/utils/creporterutils.h \
+    $${CREPORTER_SRC_DIR}/libs/utils/creportercrashinfo.h \
+    $${CREPORTER_SRC_DIR}/libs/utils/creportertrace.h \
+    $${CREPORTER_SRC_DIR}/libs/utils/creporterstats.h \
+    $${CREPORTER_SRC_DIR}/libs/utils/creporterstatsadaptor.h \
+    $${CREPORTER_SRC_DIR}/libs/serviceif/creportercorerecord.h \
     $${CREPORTER_SRC_DIR}/libs/notification/creporternotification.h \
     ut_creporterdaemon.h
 
@@ -51,16 +63,27 @@ SOURCES += $$TEST_SOURCES \
     $$TEST_STUBS \
     $${DAEMON_SRC_DIR}/creporterdaemonadaptor.cpp \
     $${DAEMON_SRC_DIR}/creporterdaemonmonitor.cpp \
+    $${DAEMON_SRC_DIR}/creporterdaemonsnapshot.cpp \
+    $${DAEMON_SRC_DIR}/creporterreportindex.cpp \
     $${CREPORTER_SRC_DIR}/dialogserver/creporterdialogserverdbusadaptor.cpp \
     $${CREPORTER_SRC_DIR}/libs/autouploader_interface.cpp \
     $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.cpp \
     $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.cpp \
     $${CREPORTER_SRC_DIR}/libs/httpclient/creporternwsessionmgr.cpp \
+    $${CREPORTER_SRC_DIR}/libs/logger/creporterlogger.cpp \
+    $${CREPORTER_SRC_DIR}/libs/logger/creporterloggingadaptor.cpp \
+    $${CREPORTER_SRC_DIR}/libs/logger/creporterlogring.cpp \
+    $${CREPORTER_SRC_DIR}/libs/logger/creporterlogwriter.cpp \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersavedstate.cpp \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsinit.cpp \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase.cpp \
     $${CREPORTER_SRC_DIR}/libs/settings/creporterprivacysettingsmodel.cpp \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsobserver.cpp \
     $${CREPORTER_SRC_DIR}/libs/utils/creporterutils.cpp \
+    $${CREPORTER_SRC_DIR}/libs/utils/creportercrashinfo.cpp \
+    $${CREPORTER_SRC_DIR}/libs/utils/creportertrace.cpp \
+    $${CREPORTER_SRC_DIR}/libs/utils/creporterstats.cpp \
+    $${CREPORTER_SRC_DIR}/libs/utils/creporterstatsadaptor.cpp \
+    $${CREPORTER_SRC_DIR}/libs/serviceif/creportercorerecord.cpp \
     ut_creporterdaemon.cpp
 include(../ut_coverage.pri)
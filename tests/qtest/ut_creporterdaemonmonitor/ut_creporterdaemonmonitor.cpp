@@ -300,6 +300,28 @@ void Ut_CReporterDaemonMonitor::testUIFailedToLaunch()
     QVERIFY(notificationCreated == true);
 }
 
+void Ut_CReporterDaemonMonitor::testProcessReports()
+{
+    // Reports written while the daemon wasn't running are handled on request.
+    QString filePath(paths.at(0));
+    filePath.append("/test-1234-11-4321.rcore.lzo");
+
+    QFile file(filePath);
+    file.open(QIODevice::ReadWrite);
+    file.close();
+
+    monitor = new CReporterDaemonMonitor(this);
+
+    QSignalSpy richCoreNotifySpy(monitor, SIGNAL(richCoreNotify(QString)));
+
+    // Missing reports are skipped.
+    monitor->processReports(QStringList() << filePath
+                            << paths.at(0) + "/gone-1234-11-4322.rcore.lzo");
+
+    QCOMPARE(richCoreNotifySpy.count(), 1);
+    QCOMPARE(richCoreNotifySpy.at(0).at(0).toString(), filePath);
+}
+
 void Ut_CReporterDaemonMonitor::cleanupTestCase()
 {
     CReporterTestUtils::removeTestMountpoints();
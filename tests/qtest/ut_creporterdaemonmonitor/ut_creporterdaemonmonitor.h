@@ -71,6 +71,7 @@ private slots:
     void testDirectoryDeletedNotNotified();
     void testAutoDeleteDublicateCores();
     void testUIFailedToLaunch();
+    void testProcessReports();
 
     void cleanupTestCase();
     void cleanup();
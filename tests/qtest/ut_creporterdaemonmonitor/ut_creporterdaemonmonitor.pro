@@ -30,6 +30,7 @@ HEADERS += $${CREPORTER_STUBS_DIR}/mgconfitem_stub.h \
            $${CREPORTER_STUBS_DIR}/qnetworksession.h \
            $${DAEMON_SRC_DIR}/creporterdaemonmonitor.h \
            $${DAEMON_SRC_DIR}/creporterdaemonmonitor_p.h \
+           $${DAEMON_SRC_DIR}/creporterdaemonsnapshot.h \
            $${CREPORTER_SRC_DIR}/dialogserver/creporterdialogserverdbusadaptor.h \
     $${CREPORTER_SRC_DIR}/libs/autouploader_interface.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.h \
@@ -38,6 +39,9 @@ HEADERS += $${CREPORTER_STUBS_DIR}/mgconfitem_stub.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry_p.h \
            $${CREPORTER_SRC_DIR}/libs/httpclient/creporternwsessionmgr.h \
            $${CREPORTER_SRC_DIR}/libs/utils/creporterutils.h \
+           $${CREPORTER_SRC_DIR}/libs/utils/creportercrashinfo.h \
+           $${CREPORTER_SRC_DIR}/libs/utils/creportertrace.h \
+           $${CREPORTER_SRC_DIR}/libs/utils/creporterstats.h \
            $${CREPORTER_SRC_DIR}/libs/notification/creporternotification.h \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersavedstate.h \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase.h \
@@ -57,6 +61,9 @@ SOURCES += $$TEST_SOURCES \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.cpp \
            $${CREPORTER_SRC_DIR}/libs/httpclient/creporternwsessionmgr.cpp \
            $${CREPORTER_SRC_DIR}/libs/utils/creporterutils.cpp \
+           $${CREPORTER_SRC_DIR}/libs/utils/creportercrashinfo.cpp \
+           $${CREPORTER_SRC_DIR}/libs/utils/creportertrace.cpp \
+           $${CREPORTER_SRC_DIR}/libs/utils/creporterstats.cpp \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersavedstate.cpp \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsinit.cpp \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase.cpp \
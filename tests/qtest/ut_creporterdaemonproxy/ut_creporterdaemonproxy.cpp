@@ -25,8 +25,13 @@
 #include "stdlib.h"
 
 #include <QDBusConnection>
+#include <QDBusInterface>
 #include <QSignalSpy>
 #include <QDBusPendingReply>
+#include <QDBusReply>
+#include <QFile>
+#include <QFileInfo>
+#include <QLoggingCategory>
 
 #include "ut_creporterdaemonproxy.h"
 #include "creportercoreregistry.h"
@@ -34,6 +39,7 @@
 #include "creporterdaemon.h"
 #include "creporterdaemon_p.h"
 #include "creporterdaemonproxy.h"
+#include "creportercrashinfo.h"
 #include "creporterprivacysettingsmodel.h"
 #include "creporternamespace.h"
 #include "creportersettingsinit_p.h"
@@ -47,6 +53,12 @@ static const char *test_files1[] = {
     "test_5678_core.rcore.lzo",
 };
 
+static const char *test_files2[] = {
+    "testapp-hwid-11-1234.rcore.lzo",
+    "otherapp-hwid-6-5678.rcore.lzo",
+    "Quickie-hwid-1-91011.rcore.lzo",
+};
+
 // CReporterNotification mock object.
 CReporterNotification::CReporterNotification(const QString &eventType,
         const QString &summary, const QString &body,
@@ -139,6 +151,154 @@ void Ut_CReporterDaemonProxy::testProxyCollectAllCoreFiles()
 
 }
 
+void Ut_CReporterDaemonProxy::testProxyReportIndex()
+{
+    QStringList compareFiles;
+
+    daemon = new CReporterDaemon;
+
+    QStringList paths(CReporterCoreRegistry::instance()->getCoreLocationPaths());
+    CReporterTestUtils::createTestDataFiles(paths, compareFiles, test_files1);
+
+    QVERIFY(daemon->initiateDaemon() == true);
+
+    proxy = new CReporterDaemonProxy(CReporter::DaemonServiceName,
+                                     CReporter::DaemonObjectPath,
+                                     QDBusConnection::sessionBus());
+
+    QSignalSpy addedSpy(proxy, SIGNAL(reportAdded(QString, qulonglong)));
+    QSignalSpy removedSpy(proxy, SIGNAL(reportRemoved(QString, qulonglong)));
+
+    QDBusPendingReply<QStringList, qulonglong> reply = proxy->getReportSnapshot();
+    reply.waitForFinished();
+    QCOMPARE(reply.isError(), false);
+
+    QStringList files(reply.argumentAt<0>());
+    files.sort();
+    compareFiles.sort();
+    QCOMPARE(files, compareFiles);
+    QCOMPARE(reply.argumentAt<1>(), qulonglong(0));
+
+    QString newFile(paths.first() + "/test_new.rcore.lzo");
+    QFile file(newFile);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.close();
+
+    QTRY_COMPARE(addedSpy.count(), 1);
+    QCOMPARE(addedSpy.at(0).at(0).toString(), newFile);
+    QCOMPARE(addedSpy.at(0).at(1).toULongLong(), qulonglong(1));
+
+    QVERIFY(file.remove());
+
+    QTRY_COMPARE(removedSpy.count(), 1);
+    QCOMPARE(removedSpy.at(0).at(0).toString(), newFile);
+    QCOMPARE(removedSpy.at(0).at(1).toULongLong(), qulonglong(2));
+
+    qulonglong generation = 0;
+    QDBusReply<QStringList> syncReply = proxy->getReportSnapshot(generation);
+    QCOMPARE(syncReply.isValid(), true);
+    QCOMPARE(syncReply.value().count(), compareFiles.count());
+    QCOMPARE(generation, qulonglong(2));
+}
+
+void Ut_CReporterDaemonProxy::testProxyCoreFileRecords()
+{
+    QStringList compareFiles;
+
+    daemon = new CReporterDaemon;
+
+    QString corePath(CReporterCoreRegistry::instance()->getCoreLocationPaths().first());
+    QDir().mkpath(corePath);
+    for (size_t i = 0; i != sizeof(test_files2) / sizeof(test_files2[0]); ++i) {
+        QFile file(corePath + "/" + test_files2[i]);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(QByteArray(int(i + 1) * 100, 'x'));
+        compareFiles << file.fileName();
+    }
+
+    QVERIFY(daemon->initiateDaemon() == true);
+
+    proxy = new CReporterDaemonProxy(CReporter::DaemonServiceName,
+                                     CReporter::DaemonObjectPath,
+                                     QDBusConnection::sessionBus());
+
+    QDBusPendingReply<CReporterCoreRecordList, uint, qulonglong> reply =
+        proxy->getCoreFileRecords(0, 0, QVariantMap());
+    reply.waitForFinished();
+    QCOMPARE(reply.isError(), false);
+
+    CReporterCoreRecordList records(reply.argumentAt<0>());
+    QCOMPARE(int(reply.argumentAt<1>()), compareFiles.count());
+    QCOMPARE(records.count(), compareFiles.count());
+
+    QStringList files;
+    foreach (const CReporterCoreRecord &record, records) {
+        files << record.filePath;
+        QCOMPARE(record.size, QFileInfo(record.filePath).size());
+        QCOMPARE(record.uploadState, int(CReporterCoreRecord::UploadPending));
+    }
+    files.sort();
+    compareFiles.sort();
+    QCOMPARE(files, compareFiles);
+
+    // Paging.
+    reply = proxy->getCoreFileRecords(1, 1, QVariantMap());
+    reply.waitForFinished();
+    QCOMPARE(reply.argumentAt<0>().count(), 1);
+    QCOMPARE(reply.argumentAt<0>().first().filePath, records.at(1).filePath);
+    QCOMPARE(int(reply.argumentAt<1>()), compareFiles.count());
+
+    // Filtering by class and application.
+    QVariantMap filter;
+    filter.insert("reportClass", int(CReporterCrashInfo::ApplicationCrash));
+    reply = proxy->getCoreFileRecords(0, 0, filter);
+    reply.waitForFinished();
+    QCOMPARE(int(reply.argumentAt<1>()), 2);
+
+    filter.insert("application", QString("testapp"));
+    reply = proxy->getCoreFileRecords(0, 0, filter);
+    reply.waitForFinished();
+    QCOMPARE(int(reply.argumentAt<1>()), 1);
+    CReporterCoreRecord record(reply.argumentAt<0>().first());
+    QCOMPARE(record.applicationName, QString("testapp"));
+    QCOMPARE(record.signal, 11);
+    QCOMPARE(record.pid, 1234);
+    QCOMPARE(record.reportClass, int(CReporterCrashInfo::ApplicationCrash));
+}
+
+void Ut_CReporterDaemonProxy::testLoggingInterface()
+{
+    daemon = new CReporterDaemon;
+    QVERIFY(daemon->initiateDaemon() == true);
+
+    QDBusInterface logging(CReporter::DaemonServiceName, CReporter::DaemonObjectPath,
+                           "com.nokia.CrashReporter.Logging", QDBusConnection::sessionBus());
+    QVERIFY(logging.isValid());
+
+    QLoggingCategory category("crash-reporter.proxytest");
+    QVERIFY(category.isWarningEnabled());
+
+    QDBusReply<bool> level = logging.call("setCategoryLevel",
+                                          QString("crash-reporter.proxytest"),
+                                          QString("critical"));
+    QVERIFY(level.isValid());
+    QVERIFY(level.value());
+    QVERIFY(!category.isWarningEnabled());
+    QVERIFY(category.isCriticalEnabled());
+
+    level = logging.call("setCategoryLevel", QString("crash-reporter.proxytest"),
+                         QString("verbose"));
+    QVERIFY(level.isValid());
+    QVERIFY(!level.value());
+
+    QVERIFY(logging.call("clearCategoryLevels").type() == QDBusMessage::ReplyMessage);
+    QVERIFY(category.isWarningEnabled());
+
+    QDBusReply<QString> type = logging.call("loggerType");
+    QVERIFY(type.isValid());
+    QCOMPARE(type.value(), QString("none"));
+}
+
 void Ut_CReporterDaemonProxy::cleanupTestCase()
 {
     CReporterTestUtils::removeTestMountpoints();
@@ -42,6 +42,9 @@ private slots:
     void init();
 
     void testProxyCollectAllCoreFiles();
+    void testProxyReportIndex();
+    void testProxyCoreFileRecords();
+    void testLoggingInterface();
 
     void cleanupTestCase();
     void cleanup();
@@ -9,6 +9,7 @@ LIBS += ../../../lib/libcrashreporter.so
 INCLUDEPATH += . \
                $${CREPORTER_SRC_DIR}/libs/coredir \
                $${CREPORTER_SRC_DIR}/libs/httpclient \
+               $${CREPORTER_SRC_DIR}/libs/logger \
                $${CREPORTER_SRC_DIR}/libs/serviceif \
                $${CREPORTER_SRC_DIR}/libs/settings \
 			   $${DAEMON_SRC_DIR} \
@@ -29,6 +30,8 @@ HEADERS += $${CREPORTER_STUBS_DIR}/mgconfitem_stub.h \
            $${DAEMON_SRC_DIR}/creporterdaemonadaptor.h \
            $${DAEMON_SRC_DIR}/creporterdaemonmonitor.h \
            $${DAEMON_SRC_DIR}/creporterdaemonmonitor_p.h \
+           $${DAEMON_SRC_DIR}/creporterdaemonsnapshot.h \
+           $${DAEMON_SRC_DIR}/creporterreportindex.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir_p.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry_p.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.h \
@@ -42,6 +45,8 @@ SOURCES += $$TEST_SOURCES \
            $$TEST_STUBS \
            $${DAEMON_SRC_DIR}/creporterdaemon.cpp \
            $${DAEMON_SRC_DIR}/creporterdaemonmonitor.cpp \
+           $${DAEMON_SRC_DIR}/creporterdaemonsnapshot.cpp \
+           $${DAEMON_SRC_DIR}/creporterreportindex.cpp \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.cpp \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.cpp \
            ut_creporterdaemonproxy.cpp \
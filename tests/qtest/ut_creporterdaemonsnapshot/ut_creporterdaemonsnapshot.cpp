@@ -0,0 +1,232 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "creporterdaemonsnapshot.h"
+#include "creportertestutils.h"
+#include "ut_creporterdaemonsnapshot.h"
+
+namespace {
+
+void touch(const QString &path)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+}
+
+/* Snapshots leave out directories modified within the last second, move the
+ * modification time to the past instead of waiting. */
+void ageDirectory(const QString &path)
+{
+    QVERIFY(CReporterTestUtils::setFileAge(path, 60));
+}
+
+CReporterCoreRecord record(const QString &filePath, int uploadState)
+{
+    CReporterCoreRecord result;
+    result.filePath = filePath;
+    result.size = 1234;
+    result.modified = 1392000000000LL;
+    result.applicationName = "app";
+    result.signal = 11;
+    result.pid = 4321;
+    result.reportClass = 0;
+    result.uploadState = uploadState;
+    return result;
+}
+
+} // namespace
+
+void Ut_CReporterDaemonSnapshot::testRoundTrip()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    ageDirectory(dir.path());
+
+    CReporterDuplicateRecord duplicate;
+    duplicate.applicationName = "app";
+    duplicate.signal = 6;
+    duplicate.count = 3;
+    duplicate.lastCountReset = QDateTime::fromMSecsSinceEpoch(1392000000000LL, Qt::UTC);
+
+    CReporterDaemonSnapshot snapshot;
+    snapshot.setDirectories(QStringList() << dir.path());
+    snapshot.setRecords(CReporterCoreRecordList()
+                        << record("/var/cache/core-dumps/app-hwid-11-4321.rcore.lzo",
+                                  CReporterCoreRecord::UploadPending)
+                        << record("/var/cache/core-dumps/app-hwid-11-4322.rcore.lzo",
+                                  CReporterCoreRecord::UploadQueued));
+    snapshot.setDuplicates(CReporterDuplicateRecordList() << duplicate);
+
+    QString path(dir.path() + "/snapshot");
+    QVERIFY(snapshot.save(path));
+
+    CReporterDaemonSnapshot loaded;
+    QVERIFY(loaded.load(path));
+
+    CReporterCoreRecordList records(loaded.records());
+    QCOMPARE(records.size(), 2);
+    QCOMPARE(records.at(0).filePath, QString("/var/cache/core-dumps/app-hwid-11-4321.rcore.lzo"));
+    QCOMPARE(records.at(0).size, qint64(1234));
+    QCOMPARE(records.at(0).modified, qint64(1392000000000LL));
+    QCOMPARE(records.at(0).applicationName, QString("app"));
+    QCOMPARE(records.at(0).signal, 11);
+    QCOMPARE(records.at(0).pid, 4321);
+    QCOMPARE(records.at(0).uploadState, int(CReporterCoreRecord::UploadPending));
+    QCOMPARE(records.at(1).uploadState, int(CReporterCoreRecord::UploadQueued));
+
+    CReporterDuplicateRecordList duplicates(loaded.duplicates());
+    QCOMPARE(duplicates.size(), 1);
+    QCOMPARE(duplicates.at(0).applicationName, QString("app"));
+    QCOMPARE(duplicates.at(0).signal, 6);
+    QCOMPARE(duplicates.at(0).count, 3);
+    QCOMPARE(duplicates.at(0).lastCountReset, duplicate.lastCountReset);
+}
+
+void Ut_CReporterDaemonSnapshot::testCurrent()
+{
+    QTemporaryDir snapshotDir;
+    QTemporaryDir coreDir;
+    QVERIFY(snapshotDir.isValid() && coreDir.isValid());
+    touch(coreDir.path() + "/app-hwid-11-4321.rcore.lzo");
+    ageDirectory(coreDir.path());
+
+    CReporterDaemonSnapshot snapshot;
+    snapshot.setDirectories(QStringList() << coreDir.path());
+    QVERIFY(snapshot.isCurrent(QStringList() << coreDir.path()));
+
+    QString path(snapshotDir.path() + "/snapshot");
+    QVERIFY(snapshot.save(path));
+
+    CReporterDaemonSnapshot loaded;
+    QVERIFY(loaded.load(path));
+    QVERIFY(loaded.isCurrent(QStringList() << coreDir.path()));
+}
+
+void Ut_CReporterDaemonSnapshot::testChangedDirectory()
+{
+    QTemporaryDir coreDir;
+    QVERIFY(coreDir.isValid());
+    ageDirectory(coreDir.path());
+
+    CReporterDaemonSnapshot snapshot;
+    snapshot.setDirectories(QStringList() << coreDir.path());
+    QVERIFY(snapshot.isCurrent(QStringList() << coreDir.path()));
+
+    // A new report.
+    touch(coreDir.path() + "/app-hwid-11-4321.rcore.lzo");
+    QVERIFY(!snapshot.isCurrent(QStringList() << coreDir.path()));
+
+    // A removed report.
+    ageDirectory(coreDir.path());
+    snapshot.setDirectories(QStringList() << coreDir.path());
+    QVERIFY(QFile::remove(coreDir.path() + "/app-hwid-11-4321.rcore.lzo"));
+    QVERIFY(!snapshot.isCurrent(QStringList() << coreDir.path()));
+
+    // A recreated directory.
+    QTemporaryDir parent;
+    QString path(parent.path() + "/core-dumps");
+    QVERIFY(QDir().mkpath(path));
+    ageDirectory(path);
+    snapshot.setDirectories(QStringList() << path);
+    QVERIFY(QDir().rmdir(path));
+    QVERIFY(QDir().mkpath(path));
+    ageDirectory(path);
+    QVERIFY(!snapshot.isCurrent(QStringList() << path));
+}
+
+void Ut_CReporterDaemonSnapshot::testRecentlyModified()
+{
+    QTemporaryDir coreDir;
+    QVERIFY(coreDir.isValid());
+    touch(coreDir.path() + "/app-hwid-11-4321.rcore.lzo");
+
+    CReporterDaemonSnapshot snapshot;
+    snapshot.setDirectories(QStringList() << coreDir.path());
+    QVERIFY(!snapshot.isCurrent(QStringList() << coreDir.path()));
+}
+
+void Ut_CReporterDaemonSnapshot::testOtherDirectories()
+{
+    QTemporaryDir first;
+    QTemporaryDir second;
+    QVERIFY(first.isValid() && second.isValid());
+    ageDirectory(first.path());
+    ageDirectory(second.path());
+
+    CReporterDaemonSnapshot snapshot;
+    snapshot.setDirectories(QStringList() << first.path());
+
+    QVERIFY(!snapshot.isCurrent(QStringList() << second.path()));
+    QVERIFY(!snapshot.isCurrent(QStringList() << first.path() << second.path()));
+    QVERIFY(!snapshot.isCurrent(QStringList()));
+
+    // A directory that doesn't exist is never current.
+    snapshot.setDirectories(QStringList() << first.path() + "/missing");
+    QVERIFY(!snapshot.isCurrent(QStringList() << first.path() + "/missing"));
+}
+
+void Ut_CReporterDaemonSnapshot::testInvalidFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path(dir.path() + "/snapshot");
+
+    CReporterDaemonSnapshot snapshot;
+    QVERIFY(!snapshot.load(path));
+
+    CReporterDuplicateRecord duplicate;
+    duplicate.applicationName = "app";
+    duplicate.signal = 6;
+    duplicate.count = 1;
+    snapshot.setRecords(CReporterCoreRecordList() << record("/tmp/app-hwid-11-1.rcore", 0));
+    snapshot.setDuplicates(CReporterDuplicateRecordList() << duplicate);
+    QVERIFY(snapshot.save(path));
+
+    // Truncated.
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QByteArray content(file.readAll());
+    QVERIFY(file.resize(content.size() - 4));
+    file.close();
+
+    QVERIFY(!snapshot.load(path));
+    QVERIFY(snapshot.records().isEmpty());
+    QVERIFY(snapshot.duplicates().isEmpty());
+
+    // Other version.
+    content[7] = char(content.at(7) + 1);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(content);
+    file.close();
+    QVERIFY(!snapshot.load(path));
+
+    // Garbage.
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write("not a snapshot");
+    file.close();
+    QVERIFY(!snapshot.load(path));
+}
+
+QTEST_MAIN(Ut_CReporterDaemonSnapshot)
@@ -19,27 +19,22 @@
  * 02110-1301 USA
  */
 
-#ifndef POWEREXCESSWATCH_H
-#define POWEREXCESSWATCH_H
+#ifndef UT_CREPORTERDAEMONSNAPSHOT_H
+#define UT_CREPORTERDAEMONSNAPSHOT_H
 
-#include <QObject>
+#include <QTest>
 
-class PowerExcessHandlerPrivate;
-
-class PowerExcessHandler: public QObject
+class Ut_CReporterDaemonSnapshot : public QObject
 {
     Q_OBJECT
 
-public:
-    PowerExcessHandler(QObject *parent = 0);
-    ~PowerExcessHandler();
-
-private:
-    Q_DISABLE_COPY(PowerExcessHandler)
-    Q_DECLARE_PRIVATE(PowerExcessHandler)
-    QScopedPointer<PowerExcessHandlerPrivate> d_ptr;
-
-    Q_PRIVATE_SLOT(d_func(), void handleUdevNotification())
+private Q_SLOTS:
+    void testRoundTrip();
+    void testCurrent();
+    void testChangedDirectory();
+    void testRecentlyModified();
+    void testOtherDirectories();
+    void testInvalidFile();
 };
 
-#endif // POWEREXCESSWATCH_H
+#endif // UT_CREPORTERDAEMONSNAPSHOT_H
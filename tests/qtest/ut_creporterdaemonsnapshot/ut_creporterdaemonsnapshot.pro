@@ -0,0 +1,28 @@
+include(../ut_common_top.pri)
+
+DAEMON_SRC_DIR = $${CREPORTER_SRC_DIR}/daemon
+
+TARGET = ut_creporterdaemonsnapshot
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               $${DAEMON_SRC_DIR} \
+               $$CREPORTER_SRC_DIR/libs/serviceif \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+# sources to be tested
+TEST_SOURCES += $${DAEMON_SRC_DIR}/creporterdaemonsnapshot.cpp \
+
+HEADERS += \
+	$${DAEMON_SRC_DIR}/creporterdaemonsnapshot.h \
+	ut_creporterdaemonsnapshot.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+	ut_creporterdaemonsnapshot.cpp \
+
+include(../ut_coverage.pri)
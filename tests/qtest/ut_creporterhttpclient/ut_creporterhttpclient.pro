@@ -25,7 +25,11 @@ TEST_SOURCES += $${CLIENT_SRC_DIR}/creporterhttpclient.cpp \
 HEADERS +=  $${CLIENT_SRC_DIR}/creporterhttpclient.h \
             $${CLIENT_SRC_DIR}/creporterhttpclient_p.h \
             $${CREPORTER_SRC_DIR}/libs/utils/creporterutils.h \
+            $${CREPORTER_SRC_DIR}/libs/utils/creportercrashinfo.h \
+            $${CREPORTER_SRC_DIR}/libs/utils/creportertrace.h \
+            $${CREPORTER_SRC_DIR}/libs/utils/creporterstats.h \
             $${CREPORTER_SRC_DIR}/libs/settings/creporterapplicationsettings.h \
+            $${CREPORTER_SRC_DIR}/libs/settings/creporteruploadendpoint.h \
             $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsinit_p.h \
             $${CREPORTER_STUBS_DIR}/qnetworkaccessmanager.h \
             $${CREPORTER_STUBS_DIR}/qnetworkreply.h \
@@ -35,8 +39,12 @@ HEADERS +=  $${CLIENT_SRC_DIR}/creporterhttpclient.h \
 SOURCES += $$TEST_SOURCES \
            $$TEST_STUBS \
            $${CREPORTER_SRC_DIR}/libs/settings/creporterapplicationsettings.cpp \
+           $${CREPORTER_SRC_DIR}/libs/settings/creporteruploadendpoint.cpp \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsinit.cpp \
            $${CREPORTER_SRC_DIR}/libs/utils/creporterutils.cpp \
+           $${CREPORTER_SRC_DIR}/libs/utils/creportercrashinfo.cpp \
+           $${CREPORTER_SRC_DIR}/libs/utils/creportertrace.cpp \
+           $${CREPORTER_SRC_DIR}/libs/utils/creporterstats.cpp \
            ut_creporterhttpclient.cpp \
 
 include(../ut_coverage.pri)
@@ -0,0 +1,289 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSignalSpy>
+
+#include "creportercoreregistry.h"
+#include "creporterhttpclient.h"
+#include "creporteringestserver.h"
+#include "creporternamespace.h"
+#include "creportertestutils.h"
+#include "creporteruploadendpoint.h"
+#include "ut_creporterhttpupload.h"
+
+static const int ReportSize = 64 * 1024;
+static const int UploadTimeoutMs = 10 * 1000;
+
+void Ut_CReporterHttpUpload::initTestCase()
+{
+    CReporterTestUtils::createTestMountpoints();
+    QVERIFY(!CReporterCoreRegistry::instance()->getCoreLocationPaths().isEmpty());
+
+    QVERIFY(reportDir.isValid());
+    report = reportDir.path() + "/application-0123456789abcdef-11-4321.rcore.lzo";
+    QFile file(report);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(QByteArray(ReportSize, 'x'));
+    file.close();
+
+    server = new CReporterIngestServer(this);
+    QVERIFY(server->start());
+}
+
+void Ut_CReporterHttpUpload::init()
+{
+    client = 0;
+    server->reset();
+    server->setDefaultBehavior(CReporterIngestServer::Behavior());
+    server->setCredentials(QString(), QString());
+}
+
+void Ut_CReporterHttpUpload::startClient(const QString &username, const QString &password)
+{
+    client = new CReporterHttpClient(this);
+    client->initSession(CReporterUploadEndpoint(server->serverUrl(), server->serverPort(),
+                                                server->serverPath(), false,
+                                                username, password),
+                        false);
+}
+
+bool Ut_CReporterHttpUpload::upload(bool *succeeded)
+{
+    QSignalSpy errorSpy(client, SIGNAL(uploadError(QString, QString)));
+    QSignalSpy finishedSpy(client, SIGNAL(finished()));
+
+    if (!client->upload(report)) {
+        return false;
+    }
+    if (finishedSpy.isEmpty() && !finishedSpy.wait(UploadTimeoutMs)) {
+        return false;
+    }
+
+    *succeeded = errorSpy.isEmpty();
+    return true;
+}
+
+void Ut_CReporterHttpUpload::testUpload()
+{
+    startClient();
+
+    bool succeeded = false;
+    QVERIFY(upload(&succeeded));
+    QVERIFY(succeeded);
+
+    QList<CReporterIngestServer::Request> requests(server->requests());
+    QCOMPARE(requests.size(), 1);
+    QCOMPARE(requests.at(0).method, QByteArray("PUT"));
+    QCOMPARE(requests.at(0).path,
+             QByteArray("/post/application-0123456789abcdef-11-4321.rcore.lzo"));
+    QVERIFY(requests.at(0).query.startsWith("uuid="));
+    QCOMPARE(requests.at(0).contentLength, qint64(ReportSize));
+    QCOMPARE(requests.at(0).bytesReceived, qint64(ReportSize));
+    QCOMPARE(requests.at(0).statusCode, 200);
+    QVERIFY(requests.at(0).firstByteMs >= requests.at(0).startedMs);
+    QVERIFY(requests.at(0).finishedMs >= requests.at(0).firstByteMs);
+
+    // The submission ID from the reply ends up in the uploadlog.
+    QString corePath(CReporterCoreRegistry::instance()->getCoreLocationPaths().first());
+    QFile uploadlog(corePath + '/' + CReporter::UploadLogFileName);
+    QVERIFY(uploadlog.open(QIODevice::ReadOnly));
+    QList<QByteArray> lines(uploadlog.readAll().trimmed().split('\n'));
+    QVERIFY(lines.last().startsWith("application-0123456789abcdef-11-4321.rcore.lzo "));
+    QVERIFY(lines.last().contains(
+                "#submissions/" + QByteArray::number(requests.at(0).submissionId)));
+
+    // Not deleted, the session was started with deleteAfterSending false.
+    QVERIFY(QFile::exists(report));
+}
+
+void Ut_CReporterHttpUpload::testAuthenticationChallenge()
+{
+    CReporterIngestServer::Behavior behavior;
+    behavior.requireAuthentication = true;
+    server->setDefaultBehavior(behavior);
+    server->setCredentials("user", "secret");
+
+    startClient("user", "secret");
+
+    bool succeeded = false;
+    QVERIFY(upload(&succeeded));
+    QVERIFY(succeeded);
+
+    QList<CReporterIngestServer::Request> requests(server->requests());
+    QCOMPARE(requests.size(), 2);
+    QCOMPARE(requests.at(0).statusCode, 401);
+    QCOMPARE(requests.at(1).statusCode, 200);
+    QCOMPARE(requests.at(1).bytesReceived, qint64(ReportSize));
+}
+
+void Ut_CReporterHttpUpload::testAuthenticationFailure()
+{
+    CReporterIngestServer::Behavior behavior;
+    behavior.requireAuthentication = true;
+    server->setDefaultBehavior(behavior);
+    server->setCredentials("user", "secret");
+
+    startClient("user", "wrong");
+
+    bool succeeded = true;
+    QVERIFY(upload(&succeeded));
+    QVERIFY(!succeeded);
+
+    foreach (const CReporterIngestServer::Request &request, server->requests()) {
+        QCOMPARE(request.statusCode, 401);
+    }
+}
+
+void Ut_CReporterHttpUpload::testServerError_data()
+{
+    QTest::addColumn<int>("statusCode");
+
+    QTest::newRow("internal error") << 500;
+    QTest::newRow("unavailable") << 503;
+    QTest::newRow("too large") << 413;
+}
+
+void Ut_CReporterHttpUpload::testServerError()
+{
+    QFETCH(int, statusCode);
+
+    CReporterIngestServer::Behavior behavior;
+    behavior.statusCode = statusCode;
+    server->setDefaultBehavior(behavior);
+
+    startClient();
+
+    bool succeeded = true;
+    QVERIFY(upload(&succeeded));
+    QVERIFY(!succeeded);
+    QCOMPARE(server->requests().last().statusCode, statusCode);
+}
+
+void Ut_CReporterHttpUpload::testConnectionReset()
+{
+    CReporterIngestServer::Behavior behavior;
+    behavior.resetAfterBytes = ReportSize / 4;
+    server->setDefaultBehavior(behavior);
+
+    startClient();
+
+    bool succeeded = true;
+    QVERIFY(upload(&succeeded));
+    QVERIFY(!succeeded);
+
+    // Possibly retried by QNetworkAccessManager, every attempt is cut short.
+    foreach (const CReporterIngestServer::Request &request, server->requests()) {
+        QCOMPARE(request.statusCode, 0);
+        QVERIFY(request.bytesReceived <= ReportSize / 4);
+    }
+}
+
+void Ut_CReporterHttpUpload::testReplyLatency()
+{
+    CReporterIngestServer::Behavior behavior;
+    behavior.latencyMs = 300;
+    server->setDefaultBehavior(behavior);
+
+    startClient();
+
+    QElapsedTimer timer;
+    timer.start();
+    bool succeeded = false;
+    QVERIFY(upload(&succeeded));
+    QVERIFY(succeeded);
+    QVERIFY(timer.elapsed() >= 300);
+
+    CReporterIngestServer::Request request(server->requests().first());
+    QVERIFY(request.finishedMs - request.startedMs >= 300);
+}
+
+void Ut_CReporterHttpUpload::testThrottledUpload()
+{
+    CReporterIngestServer::Behavior behavior;
+    // At least a quarter of a second for the report.
+    behavior.bytesPerSecond = ReportSize * 4;
+    server->setDefaultBehavior(behavior);
+
+    startClient();
+
+    QElapsedTimer timer;
+    timer.start();
+    bool succeeded = false;
+    QVERIFY(upload(&succeeded));
+    QVERIFY(succeeded);
+    // Some slack for the socket buffers filled before the cap applies.
+    QVERIFY(timer.elapsed() >= 150);
+    QCOMPARE(server->requests().first().bytesReceived, qint64(ReportSize));
+}
+
+void Ut_CReporterHttpUpload::testScheduledBehaviors()
+{
+    CReporterIngestServer::Behavior failure;
+    failure.statusCode = 503;
+    server->scheduleBehavior(failure);
+
+    startClient();
+
+    bool succeeded = true;
+    QVERIFY(upload(&succeeded));
+    QVERIFY(!succeeded);
+
+    // The schedule is used up, the default behavior applies again.
+    QVERIFY(upload(&succeeded));
+    QVERIFY(succeeded);
+
+    QList<CReporterIngestServer::Request> requests(server->requests());
+    QCOMPARE(requests.size(), 2);
+    QCOMPARE(requests.at(0).statusCode, 503);
+    QCOMPARE(requests.at(1).statusCode, 200);
+    QCOMPARE(server->bytesReceived(), qint64(2 * ReportSize));
+}
+
+void Ut_CReporterHttpUpload::testUploadWithoutCoreLocation()
+{
+    // Last test, the core locations aren't created again.
+    CReporterTestUtils::removeTestMountpoints();
+    QVERIFY(CReporterCoreRegistry::instance()->getCoreLocationPaths().isEmpty());
+
+    startClient();
+
+    // Only the uploadlog entry is skipped.
+    bool succeeded = false;
+    QVERIFY(upload(&succeeded));
+    QVERIFY(succeeded);
+    QCOMPARE(server->requests().size(), 1);
+    QCOMPARE(server->requests().first().statusCode, 200);
+}
+
+void Ut_CReporterHttpUpload::cleanup()
+{
+    delete client;
+    client = 0;
+}
+
+void Ut_CReporterHttpUpload::cleanupTestCase()
+{
+    CReporterTestUtils::removeTestMountpoints();
+}
+
+QTEST_MAIN(Ut_CReporterHttpUpload)
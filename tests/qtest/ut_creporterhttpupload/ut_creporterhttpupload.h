@@ -0,0 +1,67 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef UT_CREPORTERHTTPUPLOAD_H
+#define UT_CREPORTERHTTPUPLOAD_H
+
+#include <QTemporaryDir>
+#include <QTest>
+
+class CReporterHttpClient;
+class CReporterIngestServer;
+
+/*!
+ * Uploads with CReporterHttpClient over real sockets to
+ * CReporterIngestServer.
+ */
+class Ut_CReporterHttpUpload : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void cleanupTestCase();
+
+    void testUpload();
+    void testAuthenticationChallenge();
+    void testAuthenticationFailure();
+    void testServerError_data();
+    void testServerError();
+    void testConnectionReset();
+    void testReplyLatency();
+    void testThrottledUpload();
+    void testScheduledBehaviors();
+    void testUploadWithoutCoreLocation();
+
+private:
+    void startClient(const QString &username = QString(),
+                     const QString &password = QString());
+    bool upload(bool *succeeded);
+
+    CReporterIngestServer *server;
+    CReporterHttpClient *client;
+    QTemporaryDir reportDir;
+    QString report;
+};
+
+#endif // UT_CREPORTERHTTPUPLOAD_H
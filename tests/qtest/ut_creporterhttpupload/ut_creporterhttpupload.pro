@@ -0,0 +1,36 @@
+include(../ut_common_top.pri)
+include(../testlib/ingestserver.pri)
+
+CLIENT_SRC_DIR = $${CREPORTER_SRC_DIR}/libs/httpclient
+
+TARGET = ut_creporterhttpupload
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               $${CLIENT_SRC_DIR} \
+               $$CREPORTER_SRC_DIR/libs/coredir \
+               $$CREPORTER_SRC_DIR/libs/settings \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+# Compiled in for the test mount points, the uploadlog is written there.
+TEST_SOURCES += $${CLIENT_SRC_DIR}/creporterhttpclient.cpp \
+
+HEADERS += $${CLIENT_SRC_DIR}/creporterhttpclient.h \
+           $${CLIENT_SRC_DIR}/creporterhttpclient_p.h \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.h \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir_p.h \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.h \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry_p.h \
+           ut_creporterhttpupload.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.cpp \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.cpp \
+           ut_creporterhttpupload.cpp \
+
+include(../ut_coverage.pri)
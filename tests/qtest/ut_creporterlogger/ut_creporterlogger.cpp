@@ -0,0 +1,333 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QBuffer>
+#include <QLoggingCategory>
+#include <QTextStream>
+#include <QThread>
+
+#include "creporterlogger.h"
+#include "creporterlogring_p.h"
+#include "creporterlogwriter_p.h"
+#include "ut_creporterlogger.h"
+
+namespace {
+
+const int ProducerCount = 4;
+const int RecordsPerProducer = 2000;
+
+class Producer : public QThread
+{
+public:
+    Producer(CReporterLogRing *ring, int id) : m_ring(ring), m_id(id) {}
+
+protected:
+    void run()
+    {
+        for (int i = 0; i != RecordsPerProducer;) {
+            QByteArray record(QByteArray::number(m_id) + ':' + QByteArray::number(i));
+            if (m_ring->push(record.constData(), record.size())) {
+                ++i;
+            } else {
+                yieldCurrentThread();
+            }
+        }
+    }
+
+private:
+    CReporterLogRing *m_ring;
+    int m_id;
+};
+
+class MessageProducer : public QThread
+{
+public:
+    MessageProducer() : m_stop(0) {}
+
+    void stop()
+    {
+        m_stop.storeRelease(1);
+        wait();
+    }
+
+protected:
+    void run()
+    {
+        for (int i = 0; !m_stop.loadAcquire(); ++i) {
+            qDebug() << "message" << i;
+        }
+    }
+
+private:
+    QAtomicInt m_stop;
+};
+
+QByteArray readFile(const QString &fileName)
+{
+    QFile file(fileName);
+    file.open(QIODevice::ReadOnly);
+    return file.readAll();
+}
+
+} // namespace
+
+void Ut_CReporterLogger::testRingOrder()
+{
+    CReporterLogRing ring(4);
+    QVERIFY(ring.isEmpty());
+
+    QVERIFY(ring.push("one", 3));
+    QVERIFY(ring.push("two", 3));
+    QVERIFY(!ring.isEmpty());
+
+    QByteArray record;
+    QVERIFY(ring.pop(&record));
+    QCOMPARE(record, QByteArray("one"));
+    QVERIFY(ring.pop(&record));
+    QCOMPARE(record, QByteArray("two"));
+    QVERIFY(!ring.pop(&record));
+    QVERIFY(ring.isEmpty());
+
+    // Wrap around a few times.
+    for (int i = 0; i != 10; ++i) {
+        QByteArray data(QByteArray::number(i));
+        QVERIFY(ring.push(data.constData(), data.size()));
+        QVERIFY(ring.pop(&record));
+        QCOMPARE(record, data);
+    }
+}
+
+void Ut_CReporterLogger::testRingFull()
+{
+    CReporterLogRing ring(3);
+    QCOMPARE(ring.capacity(), 4);
+
+    for (int i = 0; i != 4; ++i) {
+        QVERIFY(ring.push("x", 1));
+    }
+    QVERIFY(!ring.push("y", 1));
+    QVERIFY(!ring.push("y", 1));
+    QCOMPARE(ring.takeDropped(), 2);
+    QCOMPARE(ring.takeDropped(), 0);
+
+    QByteArray record;
+    QVERIFY(ring.pop(&record));
+    QVERIFY(ring.push("z", 1));
+}
+
+void Ut_CReporterLogger::testRingTruncates()
+{
+    CReporterLogRing ring(2);
+    QByteArray data(CReporterLogRing::SlotSize + 100, 'a');
+    QVERIFY(ring.push(data.constData(), data.size()));
+
+    QByteArray record;
+    QVERIFY(ring.pop(&record));
+    QCOMPARE(record.size(), int(CReporterLogRing::SlotSize));
+}
+
+void Ut_CReporterLogger::testRingConcurrentProducers()
+{
+    CReporterLogRing ring(64);
+
+    QList<Producer *> producers;
+    for (int i = 0; i != ProducerCount; ++i) {
+        producers << new Producer(&ring, i);
+        producers.last()->start();
+    }
+
+    // Records of each producer must arrive complete and in order.
+    QVector<int> next(ProducerCount, 0);
+    int received = 0;
+    QByteArray record;
+    while (received != ProducerCount * RecordsPerProducer) {
+        if (!ring.pop(&record)) {
+            QThread::yieldCurrentThread();
+            continue;
+        }
+        QList<QByteArray> fields(record.split(':'));
+        QCOMPARE(fields.size(), 2);
+        int id = fields.at(0).toInt();
+        QCOMPARE(fields.at(1).toInt(), next[id]);
+        ++next[id];
+        ++received;
+    }
+
+    foreach (Producer *producer, producers) {
+        producer->wait();
+    }
+    qDeleteAll(producers);
+
+    QVERIFY(ring.isEmpty());
+}
+
+void Ut_CReporterLogger::testBinaryRoundTrip()
+{
+    QString fileName(m_dir.path() + "/roundtrip.blog");
+    {
+        CReporterLogWriter writer(fileName, CReporterLogWriter::Binary, 1024 * 1024, 16);
+        QVERIFY(writer.open());
+
+        char record[CReporterLogRing::SlotSize];
+        int length = CReporterLogWriter::encodeRecord(record, QtWarningMsg, "test.category",
+                                                      "void f()", 42, "first message");
+        QVERIFY(writer.post(record, length));
+
+        // Too long for a slot, the message gets truncated.
+        length = CReporterLogWriter::encodeRecord(record, QtDebugMsg, "test.category",
+                                                  "void g()", 7, QString(1000, 'x'));
+        QCOMPARE(length, int(CReporterLogRing::SlotSize));
+        QVERIFY(writer.post(record, length));
+    }
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QString text;
+    QTextStream output(&text);
+    QVERIFY(CReporterLogger::decodeBinaryLog(&file, output));
+    output.flush();
+
+    QStringList lines(text.split('\n', QString::SkipEmptyParts));
+    QCOMPARE(lines.size(), 2);
+    QVERIFY(lines.at(0).contains("[W] test.category void f():42 - first message"));
+    QVERIFY(lines.at(1).contains("[D] test.category void g():7 - xxx"));
+
+    // Not a binary log.
+    QBuffer garbage;
+    garbage.setData("plain text\n");
+    garbage.open(QIODevice::ReadOnly);
+    QVERIFY(!CReporterLogger::decodeBinaryLog(&garbage, output));
+}
+
+void Ut_CReporterLogger::testRotation()
+{
+    QString fileName(m_dir.path() + "/rotation.log");
+    {
+        CReporterLogWriter writer(fileName, CReporterLogWriter::Text, 100, 16);
+        QVERIFY(writer.open());
+
+        QByteArray line(59, 'a');
+        line.append('\n');
+        for (int i = 0; i != 4; ++i) {
+            QVERIFY(writer.post(line.constData(), line.size()));
+        }
+    }
+
+    QVERIFY(QFile::exists(fileName + ".1"));
+    QByteArray contents(readFile(fileName + ".1") + readFile(fileName));
+    QVERIFY(readFile(fileName + ".1").size() >= 100);
+    QVERIFY(contents.endsWith(QByteArray(59, 'a') + '\n'));
+}
+
+void Ut_CReporterLogger::testSharedRotation()
+{
+    QString fileName(m_dir.path() + "/shared.log");
+
+    // Stands for another process appending to the same file.
+    CReporterLogWriter other(fileName, CReporterLogWriter::Text, 100, 16);
+    QVERIFY(other.open());
+
+    {
+        CReporterLogWriter writer(fileName, CReporterLogWriter::Text, 100, 16);
+        QVERIFY(writer.open());
+
+        QByteArray line(59, 'a');
+        line.append('\n');
+        for (int i = 0; i != 2; ++i) {
+            QVERIFY(writer.post(line.constData(), line.size()));
+        }
+    }
+    QVERIFY(QFile::exists(fileName + ".1"));
+
+    QByteArray line("b\n");
+    QVERIFY(other.post(line.constData(), line.size()));
+    other.close();
+
+    // The record follows to the new file instead of the rotated one.
+    QCOMPARE(readFile(fileName), line);
+    QVERIFY(!readFile(fileName + ".1").contains(line));
+}
+
+void Ut_CReporterLogger::testSwitchWhileLogging()
+{
+    CReporterLogger logger("none");
+
+    QList<MessageProducer *> producers;
+    for (int i = 0; i != ProducerCount; ++i) {
+        producers << new MessageProducer;
+        producers.last()->start();
+    }
+
+    // Replaced outputs are deleted while the producers keep logging.
+    const char *const types[] = { "file", "binary", "syslog", "none" };
+    for (int i = 0; i != 40; ++i) {
+        const char *type = types[i % 4];
+        QVERIFY(CReporterLogger::setLogType(type));
+        QCOMPARE(CReporterLogger::logType(), QString(type));
+    }
+
+    foreach (MessageProducer *producer, producers) {
+        producer->stop();
+    }
+    qDeleteAll(producers);
+
+    QVERIFY(CReporterLogger::droppedMessages() >= 0);
+}
+
+void Ut_CReporterLogger::testCategoryLevel()
+{
+    QLoggingCategory category("crash-reporter.test");
+    QVERIFY(category.isDebugEnabled());
+
+    CReporterLogger::setCategoryLevel("crash-reporter.test", QtWarningMsg);
+    QVERIFY(!category.isDebugEnabled());
+    QVERIFY(!category.isInfoEnabled());
+    QVERIFY(category.isWarningEnabled());
+    QVERIFY(category.isCriticalEnabled());
+
+    // Applies to categories created later too.
+    QLoggingCategory another("crash-reporter.test");
+    QVERIFY(!another.isDebugEnabled());
+
+    CReporterLogger::setCategoryLevel("crash-reporter.test", QtCriticalMsg);
+    QVERIFY(!category.isWarningEnabled());
+
+    CReporterLogger::clearCategoryLevels();
+    QVERIFY(category.isDebugEnabled());
+    QVERIFY(category.isWarningEnabled());
+}
+
+void Ut_CReporterLogger::benchmarkPost()
+{
+    CReporterLogWriter writer("/dev/null", CReporterLogWriter::Binary, 1024 * 1024 * 1024, 1024);
+    QVERIFY(writer.open());
+
+    QString message("Uploading file /var/cache/core-dumps/app-hwid-11-1234.rcore.lzo");
+
+    QBENCHMARK {
+        char record[CReporterLogRing::SlotSize];
+        int length = CReporterLogWriter::encodeRecord(record, QtDebugMsg, "crash-reporter",
+                                                      Q_FUNC_INFO, __LINE__, message);
+        writer.post(record, length);
+    }
+}
+
+QTEST_MAIN(Ut_CReporterLogger)
@@ -0,0 +1,26 @@
+include(../ut_common_top.pri)
+
+TARGET = ut_creporterlogger
+
+INCLUDEPATH += . \
+               $$CREPORTER_SRC_DIR/libs/logger \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+# sources to be tested
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/logger/creporterlogger.cpp \
+                $${CREPORTER_SRC_DIR}/libs/logger/creporterlogring.cpp \
+                $${CREPORTER_SRC_DIR}/libs/logger/creporterlogwriter.cpp \
+
+HEADERS += \
+	$${CREPORTER_SRC_DIR}/libs/logger/creporterlogger.h \
+	$${CREPORTER_SRC_DIR}/libs/logger/creporterlogring_p.h \
+	$${CREPORTER_SRC_DIR}/libs/logger/creporterlogwriter_p.h \
+	ut_creporterlogger.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+	ut_creporterlogger.cpp \
+
+include(../ut_coverage.pri)
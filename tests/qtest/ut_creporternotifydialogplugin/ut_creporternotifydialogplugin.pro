@@ -30,6 +30,7 @@ HEADERS += $${PLUGIN_SRC_DIR}/creporternotifydialogplugin.h \
            $${CREPORTER_SRC_DIR}/libs/dialoginterface/creporterdialogserverinterface.h \
            $${CREPORTER_STUBS_DIR}/creporterdialogserver_stub.h \
            $${CREPORTER_SRC_DIR}/libs/settings/creporterapplicationsettings.h \
+           $${CREPORTER_SRC_DIR}/libs/settings/creporteruploadendpoint.h \
            $${CREPORTER_SRC_DIR}/libs/settings/creporterprivacysettingsmodel.h \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsinit_p.h \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase.h \
@@ -42,6 +43,7 @@ HEADERS += $${PLUGIN_SRC_DIR}/creporternotifydialogplugin.h \
 SOURCES += $$TEST_SOURCES \
            $$TEST_STUBS \
            $${CREPORTER_SRC_DIR}/libs/settings/creporterapplicationsettings.cpp \
+           $${CREPORTER_SRC_DIR}/libs/settings/creporteruploadendpoint.cpp \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsinit.cpp \
            $${CREPORTER_SRC_DIR}/libs/settings/creporterprivacysettingsmodel.cpp \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase.cpp \
@@ -120,6 +120,33 @@ void Ut_CReporterPrivacySettingsModel::testWriteSettings()
     QVERIFY(m_settings->value(Privacy::ValueIncludePkgList).toBool() == false);
 }
 
+void Ut_CReporterPrivacySettingsModel::testWriteBehind()
+{
+    CReporterPrivacySettingsModel *model = CReporterPrivacySettingsModel::instance();
+    int flushCount = model->flushCount();
+
+    model->setIncludeCore(false);
+    model->setIncludeSystemLog(true);
+    // Setting the same value again is not a change.
+    model->setIncludeSystemLog(true);
+
+    // New values are visible right away, but not written yet.
+    QVERIFY(model->includeCore() == false);
+    QVERIFY(model->includeSystemLog() == true);
+    QCOMPARE(model->flushCount(), flushCount);
+    QVERIFY(m_settings->value(Privacy::ValueIncludeCore).toBool() == true);
+    QVERIFY(m_settings->value(Privacy::ValueIncludeSysLog).toBool() == false);
+
+    // Both changes are written at once.
+    QTRY_COMPARE(model->flushCount(), flushCount + 1);
+    QVERIFY(m_settings->value(Privacy::ValueIncludeCore).toBool() == false);
+    QVERIFY(m_settings->value(Privacy::ValueIncludeSysLog).toBool() == true);
+
+    // Nothing left to write.
+    model->writeSettings();
+    QCOMPARE(model->flushCount(), flushCount + 1);
+}
+
 void Ut_CReporterPrivacySettingsModel::cleanupTestCase()
 {
 }
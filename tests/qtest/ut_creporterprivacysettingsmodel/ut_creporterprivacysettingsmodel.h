@@ -40,6 +40,7 @@ private slots:
 
     void testReadSettings();
     void testWriteSettings();
+    void testWriteBehind();
 
     void cleanupTestCase();
     void cleanup();
@@ -24,6 +24,9 @@ HEADERS += $${SETTINGS_SRC_DIR}/creporterprivacysettingsmodel.h \
            $$CREPORTER_SRC_DIR/libs/coredir/creportercoredir.h \
            $$CREPORTER_SRC_DIR/libs/coredir/creportercoreregistry.h \
            $$CREPORTER_SRC_DIR/libs/utils/creporterutils.h \
+           $$CREPORTER_SRC_DIR/libs/utils/creportercrashinfo.h \
+           $$CREPORTER_SRC_DIR/libs/utils/creportertrace.h \
+           $$CREPORTER_SRC_DIR/libs/utils/creporterstats.h \
             ut_creporterprivacysettingsmodel.h \
 
 SOURCES += \
@@ -33,5 +36,8 @@ SOURCES += \
 	$$CREPORTER_SRC_DIR/libs/coredir/creportercoredir.cpp \
 	$$CREPORTER_SRC_DIR/libs/coredir/creportercoreregistry.cpp \
 	$$CREPORTER_SRC_DIR/libs/utils/creporterutils.cpp \
+	$$CREPORTER_SRC_DIR/libs/utils/creportercrashinfo.cpp \
+	$$CREPORTER_SRC_DIR/libs/utils/creportertrace.cpp \
+	$$CREPORTER_SRC_DIR/libs/utils/creporterstats.cpp \
 
 include(../ut_coverage.pri)
@@ -24,6 +24,7 @@ HEADERS += $${PLUGIN_SRC_DIR}/creportersendselecteddialogplugin.h \
            $${CREPORTER_SRC_DIR}/libs/dialoginterface/creporterdialogserverinterface.h \
            $${CREPORTER_STUBS_DIR}/creporterdialogserver_stub.h \
            $${CREPORTER_SRC_DIR}/libs/settings/creporterapplicationsettings.h \
+           $${CREPORTER_SRC_DIR}/libs/settings/creporteruploadendpoint.h \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsinit_p.h \
            $${CREPORTER_SRC_DIR}/libs/notification/creporternotification.h \
            ut_creportersendselecteddialogplugin.h \
@@ -32,6 +33,7 @@ HEADERS += $${PLUGIN_SRC_DIR}/creportersendselecteddialogplugin.h \
 SOURCES += $$TEST_SOURCES \
            $$TEST_STUBS \
            $${CREPORTER_SRC_DIR}/libs/settings/creporterapplicationsettings.cpp \
+           $${CREPORTER_SRC_DIR}/libs/settings/creporteruploadendpoint.cpp \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsinit.cpp \
            ut_creportersendselecteddialogplugin.cpp \
 
@@ -0,0 +1,149 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "creporterstats.h"
+#include "ut_creporterstats.h"
+
+void Ut_CReporterStats::init()
+{
+    CReporterStats::instance()->setTextfilePath(QString());
+    CReporterStats::instance()->reset();
+}
+
+void Ut_CReporterStats::testCounters()
+{
+    CReporterStats *stats = CReporterStats::instance();
+
+    QCOMPARE(stats->counter("uploads_total"), quint64(0));
+    stats->increment("uploads_total");
+    stats->increment("uploads_total", 4);
+    stats->increment("cores_detected_total{class=\"crash\"}");
+
+    QCOMPARE(stats->counter("uploads_total"), quint64(5));
+
+    QVariantMap counters(stats->counters());
+    QCOMPARE(counters.size(), 2);
+    QCOMPARE(counters.value("uploads_total").toULongLong(), qulonglong(5));
+    QCOMPARE(counters.value("cores_detected_total{class=\"crash\"}").toULongLong(), qulonglong(1));
+
+    stats->reset();
+    QVERIFY(stats->counters().isEmpty());
+}
+
+void Ut_CReporterStats::testHistogramBuckets()
+{
+    CReporterStats *stats = CReporterStats::instance();
+
+    QVERIFY(stats->histogram("duration").isEmpty());
+
+    QList<quint64> values;
+    values << 0 << 1 << 2 << 3 << 4 << 5 << 1000 << Q_UINT64_C(0xffffffffffffffff);
+    foreach (quint64 value, values) {
+        stats->observe("duration", value);
+    }
+
+    QCOMPARE(stats->histograms(), QStringList() << "duration");
+
+    QVariantMap histogram(stats->histogram("duration"));
+    QCOMPARE(histogram.value("count").toULongLong(), qulonglong(values.size()));
+
+    QVariantList buckets(histogram.value("buckets").toList());
+    QCOMPARE(buckets.size(), int(CReporterStats::BucketCount));
+    QCOMPARE(buckets.at(0).toULongLong(), qulonglong(2));  // 0, 1
+    QCOMPARE(buckets.at(1).toULongLong(), qulonglong(1));  // 2
+    QCOMPARE(buckets.at(2).toULongLong(), qulonglong(2));  // 3, 4
+    QCOMPARE(buckets.at(3).toULongLong(), qulonglong(1));  // 5
+    QCOMPARE(buckets.at(10).toULongLong(), qulonglong(1)); // 1000
+    QCOMPARE(buckets.at(63).toULongLong(), qulonglong(1)); // overflow
+}
+
+void Ut_CReporterStats::testPrometheusText()
+{
+    CReporterStats *stats = CReporterStats::instance();
+
+    stats->increment("cores_detected_total{class=\"crash\"}", 2);
+    stats->increment("cores_detected_total{class=\"quickie\"}");
+    stats->observe("upload_duration_ms", 3);
+    stats->observe("upload_duration_ms", 100);
+
+    QStringList lines(stats->prometheusText().split('\n', QString::SkipEmptyParts));
+
+    QCOMPARE(lines.count("# TYPE crash_reporter_cores_detected_total counter"), 1);
+    QVERIFY(lines.contains("crash_reporter_cores_detected_total{class=\"crash\"} 2"));
+    QVERIFY(lines.contains("crash_reporter_cores_detected_total{class=\"quickie\"} 1"));
+
+    QVERIFY(lines.contains("# TYPE crash_reporter_upload_duration_ms histogram"));
+    QVERIFY(lines.contains("crash_reporter_upload_duration_ms_bucket{le=\"2\"} 0"));
+    QVERIFY(lines.contains("crash_reporter_upload_duration_ms_bucket{le=\"4\"} 1"));
+    QVERIFY(lines.contains("crash_reporter_upload_duration_ms_bucket{le=\"128\"} 2"));
+    QVERIFY(!lines.contains("crash_reporter_upload_duration_ms_bucket{le=\"256\"} 2"));
+    QVERIFY(lines.contains("crash_reporter_upload_duration_ms_bucket{le=\"+Inf\"} 2"));
+    QVERIFY(lines.contains("crash_reporter_upload_duration_ms_sum 103"));
+    QVERIFY(lines.contains("crash_reporter_upload_duration_ms_count 2"));
+}
+
+void Ut_CReporterStats::testLabelledHistogram()
+{
+    CReporterStats *stats = CReporterStats::instance();
+
+    stats->observe("report_stage_duration_us{stage=\"enqueued\"}", 3);
+    stats->observe("report_stage_duration_us{stage=\"reply_received\"}", 1);
+
+    QStringList lines(stats->prometheusText().split('\n', QString::SkipEmptyParts));
+
+    QCOMPARE(lines.count("# TYPE crash_reporter_report_stage_duration_us histogram"), 1);
+    QVERIFY(lines.contains("crash_reporter_report_stage_duration_us_bucket{stage=\"enqueued\",le=\"4\"} 1"));
+    QVERIFY(lines.contains("crash_reporter_report_stage_duration_us_bucket{stage=\"enqueued\",le=\"+Inf\"} 1"));
+    QVERIFY(lines.contains("crash_reporter_report_stage_duration_us_sum{stage=\"enqueued\"} 3"));
+    QVERIFY(lines.contains("crash_reporter_report_stage_duration_us_count{stage=\"reply_received\"} 1"));
+}
+
+void Ut_CReporterStats::testTextfile()
+{
+    QTemporaryDir dir;
+    QString path(dir.path() + "/ut_creporterstats.prom");
+
+    CReporterStats *stats = CReporterStats::instance();
+    stats->increment("uploads_total");
+
+    // Written right away when the export is enabled.
+    stats->setTextfilePath(path);
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(QString::fromUtf8(file.readAll()), stats->prometheusText());
+}
+
+void Ut_CReporterStats::benchmarkIncrement()
+{
+    CReporterStats *stats = CReporterStats::instance();
+    QString name("http_responses_total{status=\"200\"}");
+
+    QBENCHMARK {
+        stats->increment(name);
+        stats->observe("upload_duration_ms", 1234);
+    }
+}
+
+QTEST_MAIN(Ut_CReporterStats)
@@ -0,0 +1,31 @@
+include(../ut_common_top.pri)
+
+TARGET = ut_creporterstats
+
+INCLUDEPATH += . \
+               $$CREPORTER_SRC_DIR/libs/serviceif \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+# sources to be tested
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/utils/creporterstats.cpp \
+
+HEADERS += \
+	$${CREPORTER_SRC_DIR}/libs/autouploader_interface.h \
+	$${CREPORTER_SRC_DIR}/libs/utils/creporterstats.h \
+	$${CREPORTER_SRC_DIR}/libs/utils/creporterutils.h \
+	$${CREPORTER_SRC_DIR}/libs/utils/creportercrashinfo.h \
+	$${CREPORTER_SRC_DIR}/libs/utils/creportertrace.h \
+	ut_creporterstats.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+	$${CREPORTER_SRC_DIR}/libs/utils/creporterutils.cpp \
+	$${CREPORTER_SRC_DIR}/libs/utils/creportercrashinfo.cpp \
+	$${CREPORTER_SRC_DIR}/libs/utils/creportertrace.cpp \
+	$${CREPORTER_SRC_DIR}/libs/autouploader_interface.cpp \
+	ut_creporterstats.cpp \
+
+include(../ut_coverage.pri)
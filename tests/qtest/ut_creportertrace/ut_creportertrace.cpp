@@ -0,0 +1,157 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDateTime>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "creportertrace.h"
+#include "ut_creportertrace.h"
+
+void Ut_CReporterTrace::testMark()
+{
+    CReporterTrace trace;
+    QVERIFY(trace.isEmpty());
+
+    qint64 before = CReporterTrace::now();
+    trace.mark(CReporterTrace::Enqueued);
+    qint64 enqueued = trace.timestamp(CReporterTrace::Enqueued);
+
+    QVERIFY(!trace.isEmpty());
+    QVERIFY(enqueued >= before);
+    QVERIFY(enqueued <= CReporterTrace::now());
+    QCOMPARE(trace.timestamp(CReporterTrace::FirstByteSent), qint64(0));
+
+    // The first time is kept.
+    trace.mark(CReporterTrace::Enqueued);
+    QCOMPARE(trace.timestamp(CReporterTrace::Enqueued), enqueued);
+}
+
+void Ut_CReporterTrace::testFromDateTime()
+{
+    qint64 now = CReporterTrace::now();
+    qint64 past = CReporterTrace::fromDateTime(QDateTime::currentDateTimeUtc().addSecs(-1));
+
+    QVERIFY(past < now);
+    QVERIFY(now - past >= 900000);
+    QVERIFY(now - past < 60000000);
+
+    // Before boot.
+    QCOMPARE(CReporterTrace::fromDateTime(QDateTime::fromMSecsSinceEpoch(0)), qint64(0));
+}
+
+void Ut_CReporterTrace::testStringRoundTrip()
+{
+    CReporterTrace trace;
+    trace.setTimestamp(CReporterTrace::FileAppeared, 100);
+    trace.setTimestamp(CReporterTrace::DirectoryChanged, 250);
+    trace.setTimestamp(CReporterTrace::ReplyReceived, 9000);
+
+    QString text(trace.toString());
+    QCOMPARE(text, QString("appeared:100,directory_changed:250,reply_received:9000"));
+
+    CReporterTrace parsed(CReporterTrace::fromString(text));
+    for (int i = 0; i != CReporterTrace::StageCount; ++i) {
+        CReporterTrace::Stage stage = static_cast<CReporterTrace::Stage>(i);
+        QCOMPARE(parsed.timestamp(stage), trace.timestamp(stage));
+    }
+
+    // Unknown and malformed entries are skipped.
+    parsed = CReporterTrace::fromString("future_stage:5,garbage,enqueued:7");
+    QCOMPARE(parsed.toString(), QString("enqueued:7"));
+
+    QVERIFY(CReporterTrace::fromString(QString()).isEmpty());
+    QCOMPARE(CReporterTrace().toString(), QString());
+}
+
+void Ut_CReporterTrace::testDuration()
+{
+    CReporterTrace trace;
+    trace.setTimestamp(CReporterTrace::DirectoryChanged, 1000);
+    trace.setTimestamp(CReporterTrace::Notified, 1300);
+    trace.setTimestamp(CReporterTrace::Enqueued, 2000);
+
+    QCOMPARE(trace.duration(CReporterTrace::DirectoryChanged), qint64(-1));
+    QCOMPARE(trace.duration(CReporterTrace::DuplicateChecked), qint64(-1));
+    // Measured from the previous recorded stage.
+    QCOMPARE(trace.duration(CReporterTrace::Notified), qint64(300));
+    QCOMPARE(trace.duration(CReporterTrace::Enqueued), qint64(700));
+    QCOMPARE(trace.totalDuration(), qint64(1000));
+
+    // File times may be slightly ahead of the monotonic clock.
+    trace.setTimestamp(CReporterTrace::FileAppeared, 1200);
+    QCOMPARE(trace.duration(CReporterTrace::DirectoryChanged), qint64(0));
+}
+
+void Ut_CReporterTrace::testReadUploadLog()
+{
+    QTemporaryDir dir;
+    QString path(dir.path() + "/uploadlog");
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("old-1234-11-1.rcore.lzo https://example.com/crash/1\n"
+               "app-1234-11-2.rcore.lzo https://example.com/crash/2 enqueued:10,reply_received:50\n"
+               "\n"
+               "app-1234-11-3.rcore.lzo https://example.com/crash/3 enqueued:20,reply_received:90\n");
+    file.close();
+
+    QList<CReporterTrace> traces(CReporterTrace::readUploadLog(path));
+    QCOMPARE(traces.size(), 2);
+    QCOMPARE(traces.at(0).duration(CReporterTrace::ReplyReceived), qint64(40));
+    QCOMPARE(traces.at(1).duration(CReporterTrace::ReplyReceived), qint64(70));
+
+    QVERIFY(CReporterTrace::readUploadLog(dir.path() + "/missing").isEmpty());
+}
+
+void Ut_CReporterTrace::testSummary()
+{
+    QList<CReporterTrace> traces;
+    for (int i = 1; i <= 100; ++i) {
+        CReporterTrace trace;
+        trace.setTimestamp(CReporterTrace::Enqueued, 1000);
+        trace.setTimestamp(CReporterTrace::FirstByteSent, 1000 + i);
+        traces << trace;
+    }
+    // Traces without the stage don't count.
+    CReporterTrace partial;
+    partial.setTimestamp(CReporterTrace::Enqueued, 1);
+    traces << partial;
+
+    QVariantMap summary(CReporterTrace::summary(traces));
+    QVERIFY(!summary.contains("enqueued"));
+    QVERIFY(!summary.contains("reply_received"));
+
+    QVariantMap firstByte(summary.value("first_byte_sent").toMap());
+    QCOMPARE(firstByte.value("count").toInt(), 100);
+    QCOMPARE(firstByte.value("p50").toLongLong(), qint64(50));
+    QCOMPARE(firstByte.value("p90").toLongLong(), qint64(90));
+    QCOMPARE(firstByte.value("p99").toLongLong(), qint64(99));
+    QCOMPARE(firstByte.value("max").toLongLong(), qint64(100));
+
+    QVariantMap total(summary.value("total").toMap());
+    QCOMPARE(total.value("count").toInt(), 101);
+    QCOMPARE(total.value("p50").toLongLong(), qint64(50));
+
+    QVERIFY(CReporterTrace::summary(QList<CReporterTrace>()).isEmpty());
+}
+
+QTEST_MAIN(Ut_CReporterTrace)
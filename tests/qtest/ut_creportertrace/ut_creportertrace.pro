@@ -0,0 +1,22 @@
+include(../ut_common_top.pri)
+
+TARGET = ut_creportertrace
+
+INCLUDEPATH += . \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+# sources to be tested
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/utils/creportertrace.cpp \
+
+HEADERS += \
+	$${CREPORTER_SRC_DIR}/libs/utils/creportertrace.h \
+	ut_creportertrace.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+	ut_creportertrace.cpp \
+
+include(../ut_coverage.pri)
@@ -8,6 +8,7 @@ INCLUDEPATH += . \
                $${HTTPCLIENT_SRC_DIR} \
                $${CREPORTER_SRC_DIR}/libs \
                $${CREPORTER_SRC_DIR}/libs/settings \
+               $${CREPORTER_SRC_DIR}/libs/utils \
 
 DEPENDPATH += $$INCLUDEPATH \
 
@@ -20,9 +21,11 @@ HEADERS += $${HTTPCLIENT_SRC_DIR}/creporteruploadengine.h \
            $${HTTPCLIENT_SRC_DIR}/creporteruploadqueue.h \
            $${HTTPCLIENT_SRC_DIR}/creporteruploaditem.h \
            $${CREPORTER_SRC_DIR}/libs/settings/creporterapplicationsettings.h \
+           $${CREPORTER_SRC_DIR}/libs/settings/creporteruploadendpoint.h \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase.h \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase_p.h \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsinit_p.h \
+           $${CREPORTER_SRC_DIR}/libs/utils/creportertrace.h \
            ut_creporteruploadengine.h \
 
 # unit test and sources
@@ -30,8 +33,10 @@ SOURCES += $$TEST_SOURCES \
            $${HTTPCLIENT_SRC_DIR}/creporteruploadqueue.cpp \
            $${HTTPCLIENT_SRC_DIR}/creporteruploaditem.cpp \
            $${CREPORTER_SRC_DIR}/libs/settings/creporterapplicationsettings.cpp \
+           $${CREPORTER_SRC_DIR}/libs/settings/creporteruploadendpoint.cpp \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase.cpp \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsinit.cpp \
+           $${CREPORTER_SRC_DIR}/libs/utils/creportertrace.cpp \
            ut_creporteruploadengine.cpp \
 
 include(../ut_coverage.pri)
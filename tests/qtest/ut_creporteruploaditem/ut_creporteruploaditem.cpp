@@ -49,6 +49,11 @@ void CReporterHttpClient::initSession(bool deleteAfterSending)
     Q_UNUSED(deleteAfterSending);
 }
 
+void CReporterHttpClient::setTrace(const CReporterTrace &trace)
+{
+    Q_UNUSED(trace);
+}
+
 bool CReporterHttpClient::upload(const QString &file)
 {
     Q_UNUSED(file);
@@ -6,17 +6,20 @@ HTTPCLIENT_SRC_DIR = $${CREPORTER_SRC_DIR}/libs/httpclient
 
 INCLUDEPATH += . \
                $${HTTPCLIENT_SRC_DIR} \
-               $${CREPORTER_SRC_DIR}/libs
+               $${CREPORTER_SRC_DIR}/libs/utils \
+               $${CREPORTER_SRC_DIR}/libs \
 
 DEPENDPATH += $$INCLUDEPATH \
 
 TEST_SOURCES += $${HTTPCLIENT_SRC_DIR}/creporteruploaditem.cpp \
 
 HEADERS += $${HTTPCLIENT_SRC_DIR}/creporteruploaditem.h \
+           $${CREPORTER_SRC_DIR}/libs/utils/creportertrace.h \
            ut_creporteruploaditem.h \
 
 # unit test and sources
 SOURCES += $$TEST_SOURCES \
+           $${CREPORTER_SRC_DIR}/libs/utils/creportertrace.cpp \
            ut_creporteruploaditem.cpp \
 
 include(../ut_coverage.pri)
@@ -41,6 +41,16 @@ CReporterUploadItem::~CReporterUploadItem()
 {
 }
 
+CReporterTrace CReporterUploadItem::trace() const
+{
+    return m_trace;
+}
+
+void CReporterUploadItem::setTrace(const CReporterTrace &trace)
+{
+    m_trace = trace;
+}
+
 void CReporterUploadItem::emitDone()
 {
     emit done();
@@ -85,6 +95,19 @@ void Ut_CReporterUploadQueue::testEnqueueItems()
     QVERIFY(nextItemSpy.count() == 3);
 }
 
+void Ut_CReporterUploadQueue::testEnqueueMarksTrace()
+{
+    CReporterTrace trace;
+    trace.setTimestamp(CReporterTrace::UploaderNotified, 1);
+
+    CReporterUploadItem *item = new CReporterUploadItem("/tmp/app-1234-11-4321.rcore.lzo");
+    item->setTrace(trace);
+    m_Subject->enqueue(item);
+
+    QCOMPARE(item->trace().timestamp(CReporterTrace::UploaderNotified), qint64(1));
+    QVERIFY(item->trace().timestamp(CReporterTrace::Enqueued) > 1);
+}
+
 
 void Ut_CReporterUploadQueue::cleanup()
 {
@@ -27,6 +27,8 @@
 
 #include <QTest>
 
+#include "creportertrace.h"
+
 class CReporterUploadQueue;
 
 class CReporterUploadItem : public QObject
@@ -38,10 +40,16 @@ public:
 
     ~CReporterUploadItem();
 
+    CReporterTrace trace() const;
+    void setTrace(const CReporterTrace &trace);
+
     void emitDone();
 
 Q_SIGNALS:
     void done();
+
+private:
+    CReporterTrace m_trace;
 };
 
 class Ut_CReporterUploadQueue : public QObject
@@ -54,6 +62,7 @@ private Q_SLOTS:
     void init();
 
     void testEnqueueItems();
+    void testEnqueueMarksTrace();
 
     void cleanupTestCase();
     void cleanup();
@@ -6,6 +6,7 @@ HTTPCLIENT_SRC_DIR = $${CREPORTER_SRC_DIR}/libs/httpclient
 
 INCLUDEPATH += . \
                $${HTTPCLIENT_SRC_DIR} \
+               $${CREPORTER_SRC_DIR}/libs/utils \
                $${CREPORTER_SRC_DIR}/libs \
 
 DEPENDPATH += $$INCLUDEPATH \
@@ -13,10 +14,12 @@ DEPENDPATH += $$INCLUDEPATH \
 TEST_SOURCES += $${HTTPCLIENT_SRC_DIR}/creporteruploadqueue.cpp \
 
 HEADERS += $${HTTPCLIENT_SRC_DIR}/creporteruploadqueue.h \
+           $${CREPORTER_SRC_DIR}/libs/utils/creportertrace.h \
            ut_creporteruploadqueue.h \
 
 # unit test and sources
 SOURCES += $$TEST_SOURCES \
+           $${CREPORTER_SRC_DIR}/libs/utils/creportertrace.cpp \
            ut_creporteruploadqueue.cpp \
 
 include(../ut_coverage.pri)
@@ -107,6 +107,11 @@ void Ut_CReporterUtils::testParseCrashInfoFromFilename()
     QVERIFY(info.at(1) == "somehwid");
     QVERIFY(info.at(2) == "11");
     QVERIFY(info.at(3) == "4321");
+
+    // Fields are returned as they are in the name.
+    info = CReporterUtils::parseCrashInfoFromFilename("/tmp/app-hwid-x-007.rcore.lzo");
+    QCOMPARE(info.at(2), QString("x"));
+    QCOMPARE(info.at(3), QString("007"));
 }
 
 void Ut_CReporterUtils::testFileSizeToString()
@@ -17,10 +17,14 @@ TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/utils/creporterutils.cpp \
 HEADERS += \
 	$${CREPORTER_SRC_DIR}/libs/autouploader_interface.h \
 	$${CREPORTER_SRC_DIR}/libs/utils/creporterutils.h \
+	$${CREPORTER_SRC_DIR}/libs/utils/creportercrashinfo.h \
+	$${CREPORTER_SRC_DIR}/libs/utils/creportertrace.h \
 	ut_creporterutils.h \
 
 # unit test and sources
 SOURCES += $$TEST_SOURCES \
+	$${CREPORTER_SRC_DIR}/libs/utils/creportercrashinfo.cpp \
+	$${CREPORTER_SRC_DIR}/libs/utils/creportertrace.cpp \
 	$${CREPORTER_SRC_DIR}/libs/autouploader_interface.cpp \
 	ut_creporterutils.cpp \
 
@@ -0,0 +1,274 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <signal.h>
+#include <string.h>
+
+#include <QDateTime>
+#include <QSignalSpy>
+#include <QStringList>
+
+#include "pendinguploadsmodel.h"
+#include "ut_pendinguploadsmodel.h"
+
+namespace {
+
+// The files don't exist, so all reports have the same creation time and are
+// ordered by path.
+QString reportPath(const QString &name, int index)
+{
+    return QString("/crash-reporter-tests/core-dumps/%1%2-hwid-11-%3.rcore.lzo")
+            .arg(name).arg(index, 5, 10, QChar('0')).arg(1000 + index);
+}
+
+QStringList reports(const QString &name, int count)
+{
+    QStringList result;
+    for (int i = 0; i != count; ++i) {
+        result << reportPath(name, i);
+    }
+    return result;
+}
+
+QString filePathAt(const PendingUploadsModel &model, int row)
+{
+    return model.data(model.index(row), PendingUploadsModel::FilePath).toString();
+}
+
+} // namespace
+
+void Ut_PendingUploadsModel::testFetchMore()
+{
+    PendingUploadsModel model;
+    model.setData(reports("app", 250));
+
+    QCOMPARE(model.rowCount(QModelIndex()), 100);
+    QVERIFY(model.canFetchMore(QModelIndex()));
+
+    QSignalSpy insertedSpy(&model, SIGNAL(rowsInserted(QModelIndex, int, int)));
+    model.fetchMore(QModelIndex());
+    QCOMPARE(model.rowCount(QModelIndex()), 200);
+    QCOMPARE(insertedSpy.count(), 1);
+    QCOMPARE(insertedSpy.at(0).at(1).toInt(), 100);
+    QCOMPARE(insertedSpy.at(0).at(2).toInt(), 199);
+
+    model.fetchMore(QModelIndex());
+    QCOMPARE(model.rowCount(QModelIndex()), 250);
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+
+    model.fetchMore(QModelIndex());
+    QCOMPARE(model.rowCount(QModelIndex()), 250);
+}
+
+void Ut_PendingUploadsModel::testOrder()
+{
+    QStringList files(reports("app", 5));
+    QStringList shuffled;
+    shuffled << files[3] << files[0] << files[4] << files[2] << files[1];
+
+    PendingUploadsModel model;
+    model.setData(shuffled);
+
+    QCOMPARE(model.rowCount(QModelIndex()), 5);
+    for (int i = 0; i != files.size(); ++i) {
+        QCOMPARE(filePathAt(model, i), files.at(i));
+    }
+}
+
+void Ut_PendingUploadsModel::testMetadata()
+{
+    PendingUploadsModel model;
+    model.setData(QStringList() << reportPath("my-app", 7));
+
+    QModelIndex index(model.index(0));
+    QCOMPARE(model.data(index, PendingUploadsModel::Application).toString(),
+             QString("my-app00007"));
+    QCOMPARE(model.data(index, PendingUploadsModel::PID).toInt(), 1007);
+    QCOMPARE(model.data(index, PendingUploadsModel::Signal).toString(),
+             QString(strsignal(SIGSEGV)));
+}
+
+void Ut_PendingUploadsModel::testBatchedRemoval()
+{
+    QStringList files(reports("app", 10));
+
+    PendingUploadsModel model;
+    model.setData(files);
+
+    QSignalSpy removedSpy(&model, SIGNAL(rowsRemoved(QModelIndex, int, int)));
+
+    QStringList remaining(files);
+    remaining.erase(remaining.begin() + 2, remaining.begin() + 6);
+    remaining.removeLast();
+    model.setData(remaining);
+
+    // One range in the middle and one at the end.
+    QCOMPARE(removedSpy.count(), 2);
+    QCOMPARE(removedSpy.at(0).at(1).toInt(), 9);
+    QCOMPARE(removedSpy.at(0).at(2).toInt(), 9);
+    QCOMPARE(removedSpy.at(1).at(1).toInt(), 2);
+    QCOMPARE(removedSpy.at(1).at(2).toInt(), 5);
+
+    QCOMPARE(model.rowCount(QModelIndex()), remaining.size());
+    for (int i = 0; i != remaining.size(); ++i) {
+        QCOMPARE(filePathAt(model, i), remaining.at(i));
+    }
+}
+
+void Ut_PendingUploadsModel::testBatchedInsertion()
+{
+    QStringList files(reports("app", 10));
+
+    PendingUploadsModel model;
+    model.setData(QStringList() << files[0] << files[1] << files[9]);
+
+    QSignalSpy insertedSpy(&model, SIGNAL(rowsInserted(QModelIndex, int, int)));
+    model.setData(files);
+
+    QCOMPARE(insertedSpy.count(), 1);
+    QCOMPARE(insertedSpy.at(0).at(1).toInt(), 2);
+    QCOMPARE(insertedSpy.at(0).at(2).toInt(), 8);
+
+    QCOMPARE(model.rowCount(QModelIndex()), files.size());
+    for (int i = 0; i != files.size(); ++i) {
+        QCOMPARE(filePathAt(model, i), files.at(i));
+    }
+}
+
+void Ut_PendingUploadsModel::testUnchangedData()
+{
+    QStringList files(reports("app", 10));
+
+    PendingUploadsModel model;
+    model.setData(files);
+
+    QSignalSpy insertedSpy(&model, SIGNAL(rowsInserted(QModelIndex, int, int)));
+    QSignalSpy removedSpy(&model, SIGNAL(rowsRemoved(QModelIndex, int, int)));
+    model.setData(files);
+
+    QCOMPARE(insertedSpy.count(), 0);
+    QCOMPARE(removedSpy.count(), 0);
+}
+
+void Ut_PendingUploadsModel::testAddRemoveReport()
+{
+    QStringList files(reports("app", 5));
+
+    PendingUploadsModel model;
+    model.setData(QStringList() << files[0] << files[1] << files[3] << files[4]);
+
+    QSignalSpy insertedSpy(&model, SIGNAL(rowsInserted(QModelIndex, int, int)));
+    QSignalSpy removedSpy(&model, SIGNAL(rowsRemoved(QModelIndex, int, int)));
+
+    model.addReport(files[2]);
+    QCOMPARE(insertedSpy.count(), 1);
+    QCOMPARE(insertedSpy.at(0).at(1).toInt(), 2);
+    QCOMPARE(insertedSpy.at(0).at(2).toInt(), 2);
+
+    // Already in the model.
+    model.addReport(files[2]);
+    QCOMPARE(insertedSpy.count(), 1);
+
+    QCOMPARE(model.rowCount(QModelIndex()), files.size());
+    for (int i = 0; i != files.size(); ++i) {
+        QCOMPARE(filePathAt(model, i), files.at(i));
+    }
+
+    model.removeReport(files[1]);
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(removedSpy.at(0).at(1).toInt(), 1);
+    QCOMPARE(removedSpy.at(0).at(2).toInt(), 1);
+
+    // Not in the model.
+    model.removeReport(files[1]);
+    QCOMPARE(removedSpy.count(), 1);
+
+    QCOMPARE(model.rowCount(QModelIndex()), files.size() - 1);
+    QCOMPARE(filePathAt(model, 1), files.at(2));
+}
+
+void Ut_PendingUploadsModel::testRemoveReportKeepsFirstPage()
+{
+    QStringList files(reports("app", 150));
+
+    PendingUploadsModel model;
+    model.setData(files);
+    QCOMPARE(model.rowCount(QModelIndex()), 100);
+
+    // A hidden row moves into the first page.
+    model.removeReport(files[0]);
+    QCOMPARE(model.rowCount(QModelIndex()), 100);
+    QCOMPARE(filePathAt(model, 99), files.at(100));
+}
+
+void Ut_PendingUploadsModel::testSetRecords()
+{
+    CReporterCoreRecord older;
+    older.filePath = reportPath("older", 1);
+    older.modified = 1000;
+    older.applicationName = "older-app";
+    older.pid = 42;
+    older.signal = SIGABRT;
+
+    CReporterCoreRecord newer;
+    newer.filePath = reportPath("newer", 2);
+    newer.modified = 2000;
+    newer.applicationName = "newer-app";
+    newer.pid = 43;
+    newer.signal = SIGSEGV;
+
+    PendingUploadsModel model;
+    model.setRecords(CReporterCoreRecordList() << older << newer);
+
+    QCOMPARE(model.rowCount(QModelIndex()), 2);
+    QCOMPARE(filePathAt(model, 0), newer.filePath);
+    QCOMPARE(filePathAt(model, 1), older.filePath);
+
+    // Metadata come from the records, not from the file names.
+    QModelIndex index(model.index(1));
+    QCOMPARE(model.data(index, PendingUploadsModel::Application).toString(),
+             QString("older-app"));
+    QCOMPARE(model.data(index, PendingUploadsModel::PID).toInt(), 42);
+    QCOMPARE(model.data(index, PendingUploadsModel::Signal).toString(),
+             QString(strsignal(SIGABRT)));
+    QCOMPARE(model.data(index, PendingUploadsModel::DateCreated).toDateTime(),
+             QDateTime::fromMSecsSinceEpoch(1000));
+
+    QSignalSpy removedSpy(&model, SIGNAL(rowsRemoved(QModelIndex, int, int)));
+    model.setRecords(CReporterCoreRecordList() << older);
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(model.rowCount(QModelIndex()), 1);
+}
+
+void Ut_PendingUploadsModel::benchmarkSetData()
+{
+    QStringList files(reports("app", 10000));
+    QStringList changed(files.mid(1));
+    changed << reportPath("new", 0);
+
+    QBENCHMARK {
+        PendingUploadsModel model;
+        model.setData(files);
+        model.setData(changed);
+    }
+}
+
+QTEST_MAIN(Ut_PendingUploadsModel)
@@ -0,0 +1,28 @@
+include(../ut_common_top.pri)
+
+PLUGIN_SRC_DIR = $${CREPORTER_SRC_DIR}/sailfishui/plugin
+
+TARGET = ut_pendinguploadsmodel
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               $${PLUGIN_SRC_DIR} \
+               $$CREPORTER_SRC_DIR/libs/coredir \
+               $$CREPORTER_SRC_DIR/libs/serviceif \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+# unit
+TEST_SOURCES += $${PLUGIN_SRC_DIR}/pendinguploadsmodel.cpp \
+
+HEADERS += $${PLUGIN_SRC_DIR}/pendinguploadsmodel.h \
+           ut_pendinguploadsmodel.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_pendinguploadsmodel.cpp \
+
+include(../ut_coverage.pri)
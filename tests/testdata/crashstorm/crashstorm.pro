@@ -0,0 +1,13 @@
+include(../../../crash-reporter-conf.pri)
+
+TEMPLATE = app
+
+QT -= gui
+
+TARGET = crashstorm
+
+SOURCES = main.cpp
+
+target.path = $$CREPORTER_TESTS_TESTDATA_INSTALL_LIBS
+
+INSTALLS = target
@@ -0,0 +1,207 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2013 Jolla Ltd.
+ * Contact: Jakub Adam <jakub.adam@jollamobile.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+/*
+ * Writes synthetic rich core files into a core-dumps directory to simulate
+ * a crash storm. Files are named like the ones of rich-core-dumper, so the
+ * daemon handles them as crash reports; their content is random.
+ *
+ * Every file is first written under a temporary name and then renamed, so
+ * that it appears at once. With --manifest, a line
+ *   <CLOCK_BOOTTIME in microseconds> <kind> <path>
+ * is written for every file when it appears, kind being one of crash,
+ * duplicate, quickie, endurance or powerexcess.
+ */
+
+#include <time.h>
+#include <unistd.h>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+
+namespace {
+
+struct Crash {
+    QString application;
+    int signal;
+};
+
+qint64 bootTimeUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    return qint64(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+bool writeReport(const QString &directory, const QString &name,
+                 const QByteArray &content, qint64 size)
+{
+    QString tmpPath(directory + "/." + name + ".tmp");
+    QFile file(tmpPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    for (qint64 written = 0; written < size; written += content.size()) {
+        file.write(content.constData(), qMin<qint64>(content.size(), size - written));
+    }
+    file.close();
+
+    return ::rename(QFile::encodeName(tmpPath).constData(),
+                    QFile::encodeName(directory + '/' + name).constData()) == 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Writes synthetic rich core files at a given rate.");
+    parser.addHelpOption();
+
+    QCommandLineOption directoryOption(QStringList() << "d" << "directory",
+        "Core-dumps directory to write to.", "dir", "/var/cache/core-dumps");
+    QCommandLineOption countOption(QStringList() << "n" << "count",
+        "Number of files to write.", "count", "100");
+    QCommandLineOption rateOption(QStringList() << "r" << "rate",
+        "Files per second, 0 writes them as fast as possible.", "rate", "0");
+    QCommandLineOption sizesOption(QStringList() << "s" << "sizes",
+        "Comma separated file sizes in bytes, picked at random.", "sizes", "65536");
+    QCommandLineOption applicationsOption(QStringList() << "a" << "applications",
+        "Number of distinct crashing applications, by default every crash "
+        "is a different one.", "count", "0");
+    QCommandLineOption duplicatesOption("duplicates",
+        "Percentage of crashes repeating an earlier application and signal.",
+        "percent", "0");
+    QCommandLineOption nonCrashOption("non-crash",
+        "Percentage of quickie, endurance and power excess reports.", "percent", "0");
+    QCommandLineOption seedOption("seed", "Random seed.", "seed", "1");
+    QCommandLineOption manifestOption(QStringList() << "m" << "manifest",
+        "File to list the written reports in.", "file");
+
+    parser.addOption(directoryOption);
+    parser.addOption(countOption);
+    parser.addOption(rateOption);
+    parser.addOption(sizesOption);
+    parser.addOption(applicationsOption);
+    parser.addOption(duplicatesOption);
+    parser.addOption(nonCrashOption);
+    parser.addOption(seedOption);
+    parser.addOption(manifestOption);
+    parser.process(app);
+
+    QString directory(parser.value(directoryOption));
+    int count = parser.value(countOption).toInt();
+    double rate = parser.value(rateOption).toDouble();
+    int applications = parser.value(applicationsOption).toInt();
+    int duplicates = parser.value(duplicatesOption).toInt();
+    int nonCrash = parser.value(nonCrashOption).toInt();
+
+    QList<qint64> sizes;
+    foreach (const QString &size, parser.value(sizesOption).split(',', QString::SkipEmptyParts)) {
+        sizes << size.toLongLong();
+    }
+    if (sizes.isEmpty() || !QDir(directory).exists()) {
+        parser.showHelp(1);
+    }
+
+    QFile manifestFile;
+    QTextStream manifest;
+    if (parser.isSet(manifestOption)) {
+        manifestFile.setFileName(parser.value(manifestOption));
+        if (!manifestFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qWarning("Can't open the manifest.");
+            return 1;
+        }
+        manifest.setDevice(&manifestFile);
+    }
+
+    qsrand(parser.value(seedOption).toUInt());
+
+    // Random content, so that the reports don't compress.
+    QByteArray content(64 * 1024, '\0');
+    for (int i = 0; i < content.size(); ++i) {
+        content[i] = char(qrand());
+    }
+
+    static const int signalNumbers[] = { 6, 7, 8, 11 };
+    static const char *nonCrashPrefixes[][2] = {
+        { "Quickie", "quickie" },
+        { "Endurance", "endurance" },
+        { "PowerExcess", "powerexcess" },
+    };
+
+    QList<Crash> crashes;
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < count; ++i) {
+        if (rate > 0) {
+            qint64 due = qint64(i * 1000000 / rate);
+            qint64 now = timer.nsecsElapsed() / 1000;
+            if (due > now) {
+                usleep(due - now);
+            }
+        }
+
+        int pid = 10000 + i;
+        int roll = qrand() % 100;
+        QString name;
+        const char *kind;
+
+        if (roll < nonCrash) {
+            int which = qrand() % 3;
+            name = QString("%1-0123456789abcdef-%2-%3.rcore.lzo")
+                   .arg(nonCrashPrefixes[which][0]).arg(1).arg(pid);
+            kind = nonCrashPrefixes[which][1];
+        } else {
+            Crash crash;
+            if (roll < nonCrash + duplicates && !crashes.isEmpty()) {
+                crash = crashes.at(qrand() % crashes.size());
+                kind = "duplicate";
+            } else {
+                int application = applications > 0 ? crashes.size() % applications : i;
+                crash.application = QString("storm-app%1").arg(application);
+                crash.signal = signalNumbers[qrand() % 4];
+                crashes << crash;
+                kind = "crash";
+            }
+            name = QString("%1-0123456789abcdef-%2-%3.rcore.lzo")
+                   .arg(crash.application).arg(crash.signal).arg(pid);
+        }
+
+        if (!writeReport(directory, name, content, sizes.at(qrand() % sizes.size()))) {
+            qWarning("Failed to write %s.", qPrintable(name));
+            return 1;
+        }
+
+        if (manifest.device()) {
+            manifest << bootTimeUs() << ' ' << kind << ' ' << directory << '/' << name << '\n';
+        }
+    }
+
+    return 0;
+}
@@ -1,2 +1,2 @@
 TEMPLATE = subdirs
-SUBDIRS = crasher crashapplication core-dumps conf
+SUBDIRS = crasher crashapplication crashstorm core-dumps conf
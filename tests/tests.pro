@@ -1,2 +1,2 @@
 TEMPLATE = subdirs
-SUBDIRS = qtest testdata
+SUBDIRS = qtest benchmarks testdata usdt
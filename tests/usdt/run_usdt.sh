@@ -0,0 +1,42 @@
+#!/bin/sh
+#
+# Runs one of the bpftrace scripts attached to the crash-reporter USDT probes,
+# filling in the locations of the probed binaries. Stop with Ctrl-C to print
+# the histograms.
+#
+# Usage: run_usdt.sh <script.bt> [bpftrace options]
+
+SCRIPT_DIR=$(dirname "$0")
+SCRIPT=$1
+
+if [ -z "$SCRIPT" ]; then
+    echo "Usage: $0 <script.bt> [bpftrace options]" >&2
+    echo "Scripts:" >&2
+    ls "$SCRIPT_DIR"/*.bt >&2
+    exit 1
+fi
+shift
+
+[ -f "$SCRIPT" ] || SCRIPT=$SCRIPT_DIR/$SCRIPT
+
+for DIR in /usr/lib64 /usr/lib; do
+    if [ -e $DIR/libcrashreporter.so.0 ]; then
+        LIB=$DIR/libcrashreporter.so.0
+        break
+    fi
+done
+
+if [ -z "$LIB" ]; then
+    echo "libcrashreporter.so.0 not found" >&2
+    exit 1
+fi
+
+if ! readelf -n "$LIB" | grep -q crash_reporter; then
+    echo "$LIB was built without USDT probes" >&2
+    exit 1
+fi
+
+exec bpftrace "$@" -e "$(sed -e "s,@LIBCRASHREPORTER@,$LIB,g" \
+    -e "s,@DAEMON@,/usr/bin/crash-reporter-daemon,g" \
+    -e "s,@JOURNALSPY@,$DIR/crash-reporter/collector/libjournalspy.so,g" \
+    "$SCRIPT")"
@@ -0,0 +1,9 @@
+include(../../crash-reporter-conf.pri)
+TEMPLATE = subdirs
+
+SUBDIRS =
+
+usdt.path = $${CREPORTER_SYSTEM_SHARE}/crash-reporter-tests/usdt
+usdt.files += run_usdt.sh *.bt
+
+INSTALLS += usdt